@@ -42,6 +42,7 @@
 #include "hermes/VM/SymbolID.h"
 #include "hermes/VM/TimeLimitMonitor.h"
 
+#include "llvh/ADT/DenseMap.h"
 #include "llvh/Support/ConvertUTF.h"
 #include "llvh/Support/ErrorHandling.h"
 #include "llvh/Support/FileSystem.h"
@@ -51,7 +52,6 @@
 #include <algorithm>
 #include <atomic>
 #include <limits>
-#include <list>
 #include <mutex>
 #include <system_error>
 #include <unordered_map>
@@ -249,6 +249,45 @@ class StackRuntime {
 
 } // namespace
 
+class HostPropertySet {
+ public:
+  HostPropertySet(
+      std::vector<jsi::PropNameID> names,
+      llvh::DenseMap<vm::SymbolID, uint32_t> slots,
+      jsi::Array namesArray)
+      : names_(std::move(names)),
+        slots_(std::move(slots)),
+        namesArray_(std::move(namesArray)) {}
+
+  /// \return the index of \p id in the set, or -1 if it is not in the set.
+  int64_t lookup(vm::SymbolID id) const {
+    auto it = slots_.find(id);
+    return it == slots_.end() ? -1 : static_cast<int64_t>(it->second);
+  }
+
+  /// \return the names in the set as a JS array of symbols, which is built
+  /// once and returned for every property name enumeration.
+  const jsi::Array &getNamesArray() const {
+    return namesArray_;
+  }
+
+ private:
+  /// Keeps the symbols in slots_ alive.
+  std::vector<jsi::PropNameID> names_;
+  llvh::DenseMap<vm::SymbolID, uint32_t> slots_;
+  jsi::Array namesArray_;
+};
+
+void FixedHostObject::setSlot(
+    jsi::Runtime &rt,
+    size_t index,
+    const jsi::Value &) {
+  throw jsi::JSError(
+      rt,
+      "TypeError: Cannot assign to property " + std::to_string(index) +
+          " of fixed HostObject with default setter");
+}
+
 // Recording timing stats for every JS<->C++ transition has some overhead, so
 // applications where such transitions are extremely frequent may want to define
 // the HERMESJSI_DISABLE_STATS_TIMER symbol to save this overhead.
@@ -311,26 +350,17 @@ class HermesRuntimeImpl final : public HermesRuntime,
 #endif
     runtime_.addCustomRootsFunction(
         [this](vm::GC *, vm::RootAcceptor &acceptor) {
-          for (auto it = hermesValues_->begin(); it != hermesValues_->end();) {
-            if (it->get() == 0) {
-              it = hermesValues_->erase(it);
-            } else {
-              acceptor.accept(const_cast<vm::PinnedHermesValue &>(it->phv));
-              ++it;
-            }
-          }
+          hermesValues_.collect();
+          hermesValues_.forEach([&acceptor](HermesPointerValue &element) {
+            acceptor.accept(const_cast<vm::PinnedHermesValue &>(element.phv));
+          });
         });
     runtime_.addCustomWeakRootsFunction(
         [this](vm::GC *, vm::WeakRootAcceptor &acceptor) {
-          for (auto it = weakHermesValues_->begin();
-               it != weakHermesValues_->end();) {
-            if (it->get() == 0) {
-              it = weakHermesValues_->erase(it);
-            } else {
-              acceptor.acceptWeak(it->wr);
-              ++it;
-            }
-          }
+          weakHermesValues_.collect();
+          weakHermesValues_.forEach([&acceptor](WeakRefPointerValue &element) {
+            acceptor.acceptWeak(element.wr);
+          });
         });
     runtime_.addCustomSnapshotFunction(
         [this](vm::HeapSnapshot &snap) {
@@ -340,7 +370,7 @@ class HermesRuntimeImpl final : public HermesRuntime,
               "ManagedValues",
               vm::GCBase::IDTracker::reserved(
                   vm::GCBase::IDTracker::ReservedObjectID::JSIHermesValueList),
-              hermesValues_->size() * sizeof(HermesPointerValue),
+              hermesValues_.allocatedBytes(),
               0);
           snap.beginNode();
           snap.endNode(
@@ -349,7 +379,7 @@ class HermesRuntimeImpl final : public HermesRuntime,
               vm::GCBase::IDTracker::reserved(
                   vm::GCBase::IDTracker::ReservedObjectID::
                       JSIWeakHermesValueList),
-              weakHermesValues_->size() * sizeof(WeakRefPointerValue),
+              weakHermesValues_.allocatedBytes(),
               0);
         },
         [](vm::HeapSnapshot &snap) {
@@ -459,13 +489,11 @@ class HermesRuntimeImpl final : public HermesRuntime,
   T add(::hermes::vm::HermesValue hv) {
     static_assert(
         std::is_base_of<jsi::Pointer, T>::value, "this type cannot be added");
-    hermesValues_->emplace_front(hv);
-    return make<T>(&(hermesValues_->front()));
+    return make<T>(&hermesValues_.add(hv));
   }
 
   jsi::WeakObject addWeak(::hermes::vm::WeakRoot<vm::JSObject> wr) {
-    weakHermesValues_->emplace_front(wr);
-    return make<jsi::WeakObject>(&(weakHermesValues_->front()));
+    return make<jsi::WeakObject>(&weakHermesValues_.add(wr));
   }
 
   // overriden from jsi::Instrumentation
@@ -502,6 +530,8 @@ class HermesRuntimeImpl final : public HermesRuntime,
     BRIDGE_INFO(double, info, heapSize);
     BRIDGE_INFO(double, info, va);
     BRIDGE_INFO(int, info, numMarkStackOverflows);
+    BRIDGE_INFO(double, info, fragmentedBytes);
+    BRIDGE_INFO(int, info, numCompactedSegments);
     if (includeExpensive) {
       BRIDGE_INFO(double, info, mallocSizeEstimate);
     }
@@ -811,6 +841,62 @@ class HermesRuntimeImpl final : public HermesRuntime,
   void setValueAtIndexImpl(jsi::Array &, size_t i, const jsi::Value &value)
       override;
 
+  jsi::ArrayBuffer createExternalArrayBuffer(
+      uint8_t *data,
+      size_t size,
+      std::function<void()> finalizer);
+
+  std::shared_ptr<const HostPropertySet> createHostPropertySet(
+      const jsi::PropNameID *names,
+      size_t count);
+  jsi::Object createFixedHostObject(
+      std::shared_ptr<const HostPropertySet> props,
+      std::shared_ptr<FixedHostObject> ho);
+
+  // Batched accessors backing the corresponding HermesRuntime APIs.
+  void getProperties(
+      const jsi::Object &obj,
+      const jsi::PropNameID *names,
+      size_t count,
+      jsi::Value *out);
+  void setProperties(
+      jsi::Object &obj,
+      const jsi::PropNameID *names,
+      const jsi::Value *values,
+      size_t count);
+  void getArrayValues(
+      const jsi::Array &arr,
+      size_t start,
+      size_t count,
+      jsi::Value *out);
+  void setArrayValues(
+      jsi::Array &arr,
+      size_t start,
+      const jsi::Value *values,
+      size_t count);
+  void getArrayNumbers(
+      const jsi::Array &arr,
+      size_t start,
+      size_t count,
+      double *out);
+  void setArrayNumbers(
+      jsi::Array &arr,
+      size_t start,
+      const double *values,
+      size_t count);
+  /// Throw a JSError naming \p api if [start, start + count) is not within
+  /// the length of \p arr.
+  void checkArrayRange(
+      const char *api,
+      const jsi::Array &arr,
+      size_t start,
+      size_t count);
+  /// \return element \p i of \p arr, reading it directly from the indexed
+  /// storage when the array has no holes or indexed accessors at \p i.
+  vm::CallResult<vm::HermesValue> getArrayElement(
+      vm::Handle<vm::JSArray> arr,
+      size_t i);
+
   jsi::Function createFunctionFromHostFunction(
       const jsi::PropNameID &name,
       unsigned int paramCount,
@@ -844,16 +930,38 @@ class HermesRuntimeImpl final : public HermesRuntime,
     HermesRuntimeImpl &rt_;
     std::shared_ptr<jsi::HostObject> ho_;
 
+    /// For host objects created with createFixedHostObject, their property
+    /// set and ho_ as a FixedHostObject. Null otherwise.
+    std::shared_ptr<const HostPropertySet> props_;
+    FixedHostObject *fixed_{nullptr};
+
     JsiProxy(HermesRuntimeImpl &rt, std::shared_ptr<jsi::HostObject> ho)
         : rt_(rt), ho_(ho) {}
 
+    JsiProxy(
+        HermesRuntimeImpl &rt,
+        std::shared_ptr<const HostPropertySet> props,
+        std::shared_ptr<FixedHostObject> ho)
+        : rt_(rt), ho_(ho), props_(std::move(props)), fixed_(ho.get()) {}
+
+    /// \return the slot of \p id in props_, or -1 if it is not a fixed
+    /// property.
+    int64_t lookupSlot(vm::SymbolID id) const {
+      return props_ ? props_->lookup(id) : -1;
+    }
+
     vm::CallResult<vm::HermesValue> get(vm::SymbolID id) override {
       STATS_TIMER(rt_, "HostObject.get", hostFunction);
-      jsi::PropNameID sym =
-          rt_.add<jsi::PropNameID>(vm::HermesValue::encodeSymbolValue(id));
       jsi::Value ret;
       try {
-        ret = ho_->get(rt_, sym);
+        int64_t slot = lookupSlot(id);
+        if (slot >= 0) {
+          ret = fixed_->getSlot(rt_, slot);
+        } else {
+          jsi::PropNameID sym =
+              rt_.add<jsi::PropNameID>(vm::HermesValue::encodeSymbolValue(id));
+          ret = ho_->get(rt_, sym);
+        }
       } catch (const jsi::JSError &error) {
         return rt_.runtime_.setThrownValue(hvFromValue(error.value()));
       } catch (const std::exception &ex) {
@@ -883,10 +991,15 @@ class HermesRuntimeImpl final : public HermesRuntime,
 
     vm::CallResult<bool> set(vm::SymbolID id, vm::HermesValue value) override {
       STATS_TIMER(rt_, "HostObject.set", hostFunction);
-      jsi::PropNameID sym =
-          rt_.add<jsi::PropNameID>(vm::HermesValue::encodeSymbolValue(id));
       try {
-        ho_->set(rt_, sym, rt_.valueFromHermesValue(value));
+        int64_t slot = lookupSlot(id);
+        if (slot >= 0) {
+          fixed_->setSlot(rt_, slot, rt_.valueFromHermesValue(value));
+        } else {
+          jsi::PropNameID sym =
+              rt_.add<jsi::PropNameID>(vm::HermesValue::encodeSymbolValue(id));
+          ho_->set(rt_, sym, rt_.valueFromHermesValue(value));
+        }
       } catch (const jsi::JSError &error) {
         return rt_.runtime_.setThrownValue(hvFromValue(error.value()));
       } catch (const std::exception &ex) {
@@ -915,6 +1028,10 @@ class HermesRuntimeImpl final : public HermesRuntime,
 
     vm::CallResult<vm::Handle<vm::JSArray>> getHostPropertyNames() override {
       STATS_TIMER(rt_, "HostObject.getHostPropertyNames", hostFunction);
+      // The names array of a property set is only read by the caller, so it
+      // can be handed out directly.
+      if (props_)
+        return arrayHandle(props_->getNamesArray());
       try {
         auto names = ho_->getPropertyNames(rt_);
 
@@ -1007,43 +1124,217 @@ class HermesRuntimeImpl final : public HermesRuntime,
     HermesRuntimeImpl &hermesRuntimeImpl;
   };
 
+  /// Storage for the PointerValues handed out to JSI. Values are allocated
+  /// from fixed size chunks, so that they never move and adding one is usually
+  /// just a free list pop. A value is released by dropping its reference count
+  /// to zero, and released values are reclaimed in bulk by collect(), which
+  /// runs during GC and whenever the free list is exhausted.
   template <typename T>
-  struct ManagedValues {
+  class ManagedChunkedList {
+    static constexpr size_t kElementsPerChunk = 64;
+
+    /// After a collection, enough chunks are kept (or allocated) that at most
+    /// this fraction of the elements is occupied. This bounds the cost of
+    /// collections triggered by an empty free list to a constant per add.
+    static constexpr size_t kMaxOccupancyPercent = 50;
+
+    /// A slot in a chunk, which either holds a value or is on the free list.
+    class Element {
+     public:
+      Element() : nextFree_(nullptr) {}
+
+      ~Element() {
+        if (occupied_)
+          value_.~T();
+      }
+
+      bool isFree() const {
+        return !occupied_;
+      }
+
+      T &value() {
+        assert(occupied_ && "element is free");
+        return value_;
+      }
+
+      Element *getNextFree() const {
+        assert(!occupied_ && "element is occupied");
+        return nextFree_;
+      }
+
+      void setNextFree(Element *next) {
+        assert(!occupied_ && "element is occupied");
+        nextFree_ = next;
+      }
+
+      template <typename... Args>
+      void emplace(Args &&...args) {
+        assert(!occupied_ && "element is occupied");
+        new (&value_) T(std::forward<Args>(args)...);
+        occupied_ = true;
+      }
+
+      void free() {
+        assert(occupied_ && "element is already free");
+        value_.~T();
+        occupied_ = false;
+        nextFree_ = nullptr;
+      }
+
+     private:
+      union {
+        T value_;
+        Element *nextFree_;
+      };
+      bool occupied_{false};
+    };
+
+    struct Chunk {
+      Element elements[kElementsPerChunk];
+
+      /// \return true if no element of the chunk is occupied.
+      bool isEmpty() const {
+        return std::all_of(
+            std::begin(elements), std::end(elements), [](const Element &e) {
+              return e.isFree();
+            });
+      }
+    };
+
+    std::vector<std::unique_ptr<Chunk>> chunks_{};
+
+    /// Head of the list of free elements, in chunk order.
+    Element *freeList_{nullptr};
+
+    /// Free the elements whose values have been released, and release chunks
+    /// which are left empty, as long as the rest satisfies the occupancy
+    /// target. \return the number of occupied elements.
+    size_t sweep() {
+      size_t occupied = 0;
+      for (auto &chunk : chunks_) {
+        for (Element &element : chunk->elements) {
+          if (element.isFree())
+            continue;
+          if (element.value().get() == 0)
+            element.free();
+          else
+            ++occupied;
+        }
+      }
+      size_t minChunks = chunksFor(occupied);
+      if (chunks_.size() > minChunks) {
+        size_t excess = chunks_.size() - minChunks;
+        chunks_.erase(
+            std::remove_if(
+                chunks_.begin(),
+                chunks_.end(),
+                [&excess](const std::unique_ptr<Chunk> &chunk) {
+                  if (!excess || !chunk->isEmpty())
+                    return false;
+                  --excess;
+                  return true;
+                }),
+            chunks_.end());
+      }
+      return occupied;
+    }
+
+    /// \return the number of chunks needed to hold \p occupied elements
+    /// within the occupancy target.
+    static size_t chunksFor(size_t occupied) {
+      size_t capacity = occupied * 100 / kMaxOccupancyPercent;
+      return std::max<size_t>(
+          1, (capacity + kElementsPerChunk - 1) / kElementsPerChunk);
+    }
+
+    /// Link all free elements into the free list, lowest address chunks first
+    /// so that new values are packed together.
+    void rebuildFreeList() {
+      freeList_ = nullptr;
+      for (auto it = chunks_.rbegin(), e = chunks_.rend(); it != e; ++it) {
+        Element *elements = (*it)->elements;
+        for (size_t i = kElementsPerChunk; i-- > 0;) {
+          if (elements[i].isFree()) {
+            elements[i].setNextFree(freeList_);
+            freeList_ = &elements[i];
+          }
+        }
+      }
+    }
+
+   public:
+    ManagedChunkedList() = default;
+    ManagedChunkedList(const ManagedChunkedList &) = delete;
+    ManagedChunkedList &operator=(const ManagedChunkedList &) = delete;
+
 #ifdef ASSERT_ON_DANGLING_VM_REFS
     // If we have active HermesValuePointers when deconstructing, these will
     // now be dangling. We deliberately allocate and immediately leak heap
-    // memory to hold the internal list. This keeps alive memory holding the
+    // memory to hold the chunks. This keeps alive memory holding the
     // ref-count of the now dangling references, allowing them to detect the
     // dangling case safely and assert when they are eventually released. By
     // deferring the assert it's a bit easier to see what's holding the pointers
     // for too long.
-    ~ManagedValues() {
+    ~ManagedChunkedList() {
       bool anyDangling = false;
-      for (auto it = values.begin(); it != values.end();) {
-        if (it->get() == 0) {
-          it = values.erase(it);
-        } else {
-          anyDangling = true;
-          it->markDangling();
-          ++it;
-        }
-      }
+      forEach([&anyDangling](T &value) {
+        anyDangling = true;
+        value.markDangling();
+      });
       if (anyDangling) {
         // This is the deliberate memory leak described above.
-        new std::list<T>(std::move(values));
+        for (auto &chunk : chunks_)
+          (void)chunk.release();
       }
     }
 #endif
 
-    std::list<T> *operator->() {
-      return &values;
+    /// Construct a new value from \p args, with a reference count of one.
+    /// \return a reference to the value, which stays valid until it is
+    /// released and collected.
+    template <typename... Args>
+    T &add(Args &&...args) {
+      if (LLVM_UNLIKELY(!freeList_))
+        collect();
+      Element *element = freeList_;
+      freeList_ = element->getNextFree();
+      element->emplace(std::forward<Args>(args)...);
+      return element->value();
     }
 
-    const std::list<T> *operator->() const {
-      return &values;
+    /// Reclaim released values, and size the list so that it is at most
+    /// kMaxOccupancyPercent occupied.
+    void collect() {
+      size_t occupied = sweep();
+      for (size_t n = chunksFor(occupied); chunks_.size() < n;)
+        chunks_.emplace_back(new Chunk());
+      rebuildFreeList();
     }
 
-    std::list<T> values;
+    /// Call \p callback on each value which has not been released.
+    template <typename F>
+    void forEach(F callback) {
+      for (auto &chunk : chunks_) {
+        for (Element &element : chunk->elements) {
+          if (!element.isFree() && element.value().get() != 0)
+            callback(element.value());
+        }
+      }
+    }
+
+    /// \return the number of values which have not been released. This is
+    /// linear in the capacity of the list.
+    size_t size() const {
+      size_t count = 0;
+      const_cast<ManagedChunkedList *>(this)->forEach(
+          [&count](T &) { ++count; });
+      return count;
+    }
+
+    /// \return the number of bytes allocated for the chunks.
+    size_t allocatedBytes() const {
+      return chunks_.size() * sizeof(Chunk);
+    }
   };
 
  protected:
@@ -1056,8 +1347,8 @@ class HermesRuntimeImpl final : public HermesRuntime,
       unsigned int paramCount);
 
  public:
-  ManagedValues<HermesPointerValue> hermesValues_;
-  ManagedValues<WeakRefPointerValue> weakHermesValues_;
+  ManagedChunkedList<HermesPointerValue> hermesValues_;
+  ManagedChunkedList<WeakRefPointerValue> weakHermesValues_;
 #ifdef HERMESJSI_ON_STACK
   StackRuntime stackRuntime_;
 #else
@@ -1353,8 +1644,76 @@ jsi::Value HermesRuntime::evaluateJavaScriptWithSourceMap(
           buffer, sourceMapBuf, sourceURL));
 }
 
+std::shared_ptr<const HostPropertySet> HermesRuntime::createHostPropertySet(
+    const jsi::PropNameID *names,
+    size_t count) {
+  return impl(this)->createHostPropertySet(names, count);
+}
+
+jsi::Object HermesRuntime::createFixedHostObject(
+    std::shared_ptr<const HostPropertySet> props,
+    std::shared_ptr<FixedHostObject> ho) {
+  return impl(this)->createFixedHostObject(std::move(props), std::move(ho));
+}
+
+jsi::ArrayBuffer HermesRuntime::createExternalArrayBuffer(
+    uint8_t *data,
+    size_t size,
+    std::function<void()> finalizer) {
+  return impl(this)->createExternalArrayBuffer(
+      data, size, std::move(finalizer));
+}
+
+void HermesRuntime::getProperties(
+    const jsi::Object &obj,
+    const jsi::PropNameID *names,
+    size_t count,
+    jsi::Value *out) {
+  impl(this)->getProperties(obj, names, count, out);
+}
+
+void HermesRuntime::setProperties(
+    jsi::Object &obj,
+    const jsi::PropNameID *names,
+    const jsi::Value *values,
+    size_t count) {
+  impl(this)->setProperties(obj, names, values, count);
+}
+
+void HermesRuntime::getArrayValues(
+    const jsi::Array &arr,
+    size_t start,
+    size_t count,
+    jsi::Value *out) {
+  impl(this)->getArrayValues(arr, start, count, out);
+}
+
+void HermesRuntime::setArrayValues(
+    jsi::Array &arr,
+    size_t start,
+    const jsi::Value *values,
+    size_t count) {
+  impl(this)->setArrayValues(arr, start, values, count);
+}
+
+void HermesRuntime::getArrayNumbers(
+    const jsi::Array &arr,
+    size_t start,
+    size_t count,
+    double *out) {
+  impl(this)->getArrayNumbers(arr, start, count, out);
+}
+
+void HermesRuntime::setArrayNumbers(
+    jsi::Array &arr,
+    size_t start,
+    const double *values,
+    size_t count) {
+  impl(this)->setArrayNumbers(arr, start, values, count);
+}
+
 size_t HermesRuntime::rootsListLength() const {
-  return impl(this)->hermesValues_->size();
+  return impl(this)->hermesValues_.size();
 }
 
 namespace {
@@ -1473,6 +1832,36 @@ HermesRuntimeImpl::prepareJavaScript(
   return prepareJavaScriptWithSourceMap(jsiBuffer, nullptr, sourceURL);
 }
 
+std::shared_ptr<const jsi::PreparedJavaScript>
+HermesRuntime::prepareBytecodeImage(
+    const std::shared_ptr<const jsi::Buffer> &buffer,
+    std::string sourceURL) {
+  if (!isHermesBytecode(buffer->data(), buffer->size())) {
+    throw jsi::JSINativeException(
+        "Error preparing bytecode image: buffer is not bytecode");
+  }
+  auto bcErr = hbc::BCProviderFromBuffer::createBCProviderFromBuffer(
+      std::make_unique<BufferAdapter>(buffer));
+  if (!bcErr.first) {
+    LOG_EXCEPTION_CAUSE(
+        "Error preparing bytecode image: %s", bcErr.second.c_str());
+    throw jsi::JSINativeException(
+        "Error preparing bytecode image: " + bcErr.second);
+  }
+  // Materialize the tables that every runtime reads while loading and running
+  // the module, so that runtimes starting concurrently don't contend on
+  // decompressing them. These are no-ops for uncompressed bytecode.
+  bcErr.first->getStringStorage();
+  bcErr.first->getArrayBuffer();
+  bcErr.first->getObjectKeyBuffer();
+  bcErr.first->getObjectValueBuffer();
+
+  vm::RuntimeModuleFlags runtimeFlags{};
+  runtimeFlags.persistent = true;
+  return std::make_shared<const HermesPreparedJavaScript>(
+      std::move(bcErr.first), runtimeFlags, std::move(sourceURL));
+}
+
 jsi::Value HermesRuntimeImpl::evaluatePreparedJavaScript(
     const std::shared_ptr<const jsi::PreparedJavaScript> &js) {
   return maybeRethrow([&] {
@@ -1729,6 +2118,53 @@ jsi::Object HermesRuntimeImpl::createObject(
   });
 }
 
+std::shared_ptr<const HostPropertySet> HermesRuntimeImpl::createHostPropertySet(
+    const jsi::PropNameID *names,
+    size_t count) {
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&runtime_);
+    auto arrayRes = vm::JSArray::create(&runtime_, count, count);
+    checkStatus(arrayRes.getStatus());
+    vm::Handle<vm::JSArray> array = *arrayRes;
+
+    std::vector<jsi::PropNameID> ownNames;
+    ownNames.reserve(count);
+    llvh::DenseMap<vm::SymbolID, uint32_t> slots;
+    vm::MutableHandle<vm::SymbolID> tmpHandle{&runtime_};
+    for (size_t i = 0; i < count; ++i) {
+      vm::SymbolID id = phv(names[i]).getSymbol();
+      if (!slots.try_emplace(id, i).second) {
+        throw makeJSError(
+            *this,
+            "createHostPropertySet: duplicate property name '",
+            names[i].utf8(*this),
+            "'");
+      }
+      ownNames.push_back(jsi::PropNameID(*this, names[i]));
+      tmpHandle = id;
+      vm::JSArray::setElementAt(array, &runtime_, i, tmpHandle);
+    }
+    return std::make_shared<const HostPropertySet>(
+        std::move(ownNames),
+        std::move(slots),
+        add<jsi::Object>(array.getHermesValue()).getArray(*this));
+  });
+}
+
+jsi::Object HermesRuntimeImpl::createFixedHostObject(
+    std::shared_ptr<const HostPropertySet> props,
+    std::shared_ptr<FixedHostObject> ho) {
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&runtime_);
+
+    auto objRes = vm::HostObject::createWithoutPrototype(
+        &runtime_,
+        std::make_unique<JsiProxy>(*this, std::move(props), std::move(ho)));
+    checkStatus(objRes.getStatus());
+    return add<jsi::Object>(*objRes);
+  });
+}
+
 std::shared_ptr<jsi::HostObject> HermesRuntimeImpl::getHostObject(
     const jsi::Object &obj) {
   const vm::HostObjectProxy *proxy =
@@ -1951,6 +2387,195 @@ void HermesRuntimeImpl::setValueAtIndexImpl(
   });
 }
 
+jsi::ArrayBuffer HermesRuntimeImpl::createExternalArrayBuffer(
+    uint8_t *data,
+    size_t size,
+    std::function<void()> finalizer) {
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&runtime_);
+    if (LLVM_UNLIKELY(
+            size > std::numeric_limits<vm::JSArrayBuffer::size_type>::max())) {
+      throw makeJSError(
+          *this, "createExternalArrayBuffer: size ", size, " is too large");
+    }
+    auto buf = runtime_.makeHandle(vm::JSArrayBuffer::create(
+        &runtime_,
+        vm::Handle<vm::JSObject>::vmcast(&runtime_.arrayBufferPrototype)));
+    auto context =
+        std::make_unique<std::function<void()>>(std::move(finalizer));
+    checkStatus(buf->setExternalDataBlock(
+        &runtime_, data, size, context.get(), [](void *context) {
+          std::unique_ptr<std::function<void()>> finalizer{
+              static_cast<std::function<void()> *>(context)};
+          if (*finalizer)
+            (*finalizer)();
+        }));
+    context.release();
+    return add<jsi::Object>(buf.getHermesValue()).getArrayBuffer(*this);
+  });
+}
+
+void HermesRuntimeImpl::checkArrayRange(
+    const char *api,
+    const jsi::Array &arr,
+    size_t start,
+    size_t count) {
+  size_t length = size(arr);
+  if (LLVM_UNLIKELY(start > length || count > length - start)) {
+    throw makeJSError(
+        *this,
+        api,
+        ": index ",
+        std::max(start, length),
+        " is out of bounds [0, ",
+        length,
+        ")");
+  }
+}
+
+vm::CallResult<vm::HermesValue> HermesRuntimeImpl::getArrayElement(
+    vm::Handle<vm::JSArray> arr,
+    size_t i) {
+  if (LLVM_LIKELY(arr->hasFastIndexProperties())) {
+    vm::HermesValue hv = arr->at(&runtime_, i);
+    // Holes have to be looked up in the prototype chain.
+    if (LLVM_LIKELY(!hv.isEmpty()))
+      return hv;
+  }
+  auto res = vm::JSObject::getComputed_RJS(
+      arr,
+      &runtime_,
+      runtime_.makeHandle(vm::HermesValue::encodeNumberValue(i)));
+  if (LLVM_UNLIKELY(res == vm::ExecutionStatus::EXCEPTION))
+    return vm::ExecutionStatus::EXCEPTION;
+  return res->get();
+}
+
+void HermesRuntimeImpl::getProperties(
+    const jsi::Object &obj,
+    const jsi::PropNameID *names,
+    size_t count,
+    jsi::Value *out) {
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&runtime_);
+    auto h = handle(obj);
+    auto marker = gcScope.createMarker();
+    for (size_t i = 0; i < count; ++i) {
+      gcScope.flushToMarker(marker);
+      auto res = h->getNamedOrIndexed(h, &runtime_, phv(names[i]).getSymbol());
+      checkStatus(res.getStatus());
+      out[i] = valueFromHermesValue(res->get());
+    }
+  });
+}
+
+void HermesRuntimeImpl::setProperties(
+    jsi::Object &obj,
+    const jsi::PropNameID *names,
+    const jsi::Value *values,
+    size_t count) {
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&runtime_);
+    auto h = handle(obj);
+    auto marker = gcScope.createMarker();
+    for (size_t i = 0; i < count; ++i) {
+      gcScope.flushToMarker(marker);
+      checkStatus(h->putNamedOrIndexed(
+                       h,
+                       &runtime_,
+                       phv(names[i]).getSymbol(),
+                       vmHandleFromValue(values[i]),
+                       vm::PropOpFlags().plusThrowOnError())
+                      .getStatus());
+    }
+  });
+}
+
+void HermesRuntimeImpl::getArrayValues(
+    const jsi::Array &arr,
+    size_t start,
+    size_t count,
+    jsi::Value *out) {
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&runtime_);
+    checkArrayRange("getArrayValues", arr, start, count);
+    auto h = arrayHandle(arr);
+    auto marker = gcScope.createMarker();
+    for (size_t i = 0; i < count; ++i) {
+      gcScope.flushToMarker(marker);
+      auto res = getArrayElement(h, start + i);
+      checkStatus(res.getStatus());
+      out[i] = valueFromHermesValue(*res);
+    }
+  });
+}
+
+void HermesRuntimeImpl::setArrayValues(
+    jsi::Array &arr,
+    size_t start,
+    const jsi::Value *values,
+    size_t count) {
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&runtime_);
+    checkArrayRange("setArrayValues", arr, start, count);
+    auto h = arrayHandle(arr);
+    auto marker = gcScope.createMarker();
+    for (size_t i = 0; i < count; ++i) {
+      gcScope.flushToMarker(marker);
+      vm::JSArray::setElementAt(
+          h, &runtime_, start + i, vmHandleFromValue(values[i]));
+    }
+  });
+}
+
+void HermesRuntimeImpl::getArrayNumbers(
+    const jsi::Array &arr,
+    size_t start,
+    size_t count,
+    double *out) {
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&runtime_);
+    checkArrayRange("getArrayNumbers", arr, start, count);
+    auto h = arrayHandle(arr);
+    auto marker = gcScope.createMarker();
+    for (size_t i = 0; i < count; ++i) {
+      gcScope.flushToMarker(marker);
+      auto res = getArrayElement(h, start + i);
+      checkStatus(res.getStatus());
+      if (LLVM_UNLIKELY(!res->isNumber())) {
+        throw makeJSError(
+            *this,
+            "getArrayNumbers: element ",
+            start + i,
+            " is not a number");
+      }
+      out[i] = res->getNumber();
+    }
+  });
+}
+
+void HermesRuntimeImpl::setArrayNumbers(
+    jsi::Array &arr,
+    size_t start,
+    const double *values,
+    size_t count) {
+  return maybeRethrow([&] {
+    vm::GCScope gcScope(&runtime_);
+    checkArrayRange("setArrayNumbers", arr, start, count);
+    auto h = arrayHandle(arr);
+    auto marker = gcScope.createMarker();
+    for (size_t i = 0; i < count; ++i) {
+      gcScope.flushToMarker(marker);
+      vm::JSArray::setElementAt(
+          h,
+          &runtime_,
+          start + i,
+          runtime_.makeHandle(
+              vm::HermesValue::encodeUntrustedDoubleValue(values[i])));
+    }
+  });
+}
+
 jsi::Function HermesRuntimeImpl::createFunctionFromHostFunction(
     const jsi::PropNameID &name,
     unsigned int paramCount,
@@ -2132,39 +2757,18 @@ bool HermesRuntimeImpl::instanceOf(
 }
 
 jsi::Runtime::ScopeState *HermesRuntimeImpl::pushScope() {
-  hermesValues_->emplace_front(
-      vm::HermesValue::encodeNativeUInt32(kSentinelNativeValue));
-  return reinterpret_cast<ScopeState *>(&hermesValues_->front());
+  return reinterpret_cast<ScopeState *>(&hermesValues_.add(
+      vm::HermesValue::encodeNativeUInt32(kSentinelNativeValue)));
 }
 
 void HermesRuntimeImpl::popScope(ScopeState *prv) {
   HermesPointerValue *sentinel = reinterpret_cast<HermesPointerValue *>(prv);
   assert(sentinel->phv.isNativeValue());
   assert(sentinel->phv.getNativeUInt32() == kSentinelNativeValue);
-
-  for (auto it = hermesValues_->begin(); it != hermesValues_->end();) {
-    auto &value = *it;
-
-    if (&value == sentinel) {
-      hermesValues_->erase(it);
-      return;
-    }
-
-    if (value.phv.isNativeValue()) {
-      // We reached another sentinel value or we started added another native
-      // value to the hermesValue_ list. This should not happen.
-      std::terminate();
-    }
-
-    if (value.get() == 0) {
-      it = hermesValues_->erase(it);
-    } else {
-      ++it;
-    }
-  }
-
-  // We did not find a sentinel value.
-  std::terminate();
+  // Values created in the scope have been released when their owners were
+  // destroyed, so they are reclaimed along with the sentinel by the next
+  // collection of hermesValues_.
+  sentinel->dec();
 }
 
 void HermesRuntimeImpl::checkStatus(vm::ExecutionStatus status) {
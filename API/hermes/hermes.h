@@ -9,6 +9,7 @@
 #define HERMES_HERMES_H
 
 #include <exception>
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
@@ -56,6 +57,31 @@ class Debugger;
 
 class HermesRuntimeImpl;
 
+/// A fixed list of property names, interned once so that it can be shared by
+/// many host objects created with \c HermesRuntime::createFixedHostObject.
+/// Created by \c HermesRuntime::createHostPropertySet, and like other JSI
+/// values it must be released before the runtime that created it.
+class HostPropertySet;
+
+/// A HostObject whose properties are the names in a \c HostPropertySet.
+/// Reads and writes of those names are dispatched to \c getSlot and
+/// \c setSlot with the index of the name in the set, without creating a
+/// jsi::PropNameID per access. Other names still go through \c get and
+/// \c set, and \c getPropertyNames is not called: the names in the set are
+/// reported instead.
+///
+/// This is an experimental Hermes-specific API.
+class HERMES_EXPORT FixedHostObject : public jsi::HostObject {
+ public:
+  /// \return the value of the property at \p index in the property set.
+  virtual jsi::Value getSlot(jsi::Runtime &rt, size_t index) = 0;
+
+  /// Assign \p value to the property at \p index in the property set. The
+  /// default implementation throws, like jsi::HostObject::set.
+  virtual void
+  setSlot(jsi::Runtime &rt, size_t index, const jsi::Value &value);
+};
+
 /// Represents a Hermes JS runtime.
 class HERMES_EXPORT HermesRuntime : public jsi::Runtime {
  public:
@@ -75,6 +101,23 @@ class HERMES_EXPORT HermesRuntime : public jsi::Runtime {
       std::string *errorMessage = nullptr);
   static void setFatalHandler(void (*handler)(const std::string &));
 
+  /// Load the bytecode in \p buffer into an image which can be evaluated with
+  /// \c evaluatePreparedJavaScript by any number of runtimes, concurrently
+  /// from different threads. The bytecode is validated, and any compressed
+  /// sections it needs to run are decompressed, once for all runtimes, and
+  /// the bytecode buffer and those tables are shared rather than loaded again
+  /// by each runtime. Each runtime still creates its own module, since
+  /// identifiers and code blocks are per runtime.
+  /// Throws a jsi::JSINativeException if \p buffer is not valid bytecode.
+  /// Source code can't be shared like this, as it is compiled lazily.
+  ///
+  /// This is an experimental Hermes-specific API. In the future it may be
+  /// renamed, moved or combined with another API, but the provided
+  /// functionality will continue to be available in some form.
+  static std::shared_ptr<const jsi::PreparedJavaScript> prepareBytecodeImage(
+      const std::shared_ptr<const jsi::Buffer> &buffer,
+      std::string sourceURL);
+
   // Assuming that \p data is valid HBC bytecode data, returns a pointer to the
   // first element of the epilogue, data append to the end of the bytecode
   // stream. Return pair contain ptr to data and header.
@@ -219,6 +262,98 @@ class HERMES_EXPORT HermesRuntime : public jsi::Runtime {
       const std::shared_ptr<const jsi::Buffer> &sourceMapBuf,
       const std::string &sourceURL);
 
+  /// Create an ArrayBuffer over \p size bytes at \p data without copying
+  /// them. The memory must stay valid and must not be freed until
+  /// \p finalizer is called, which happens once the buffer is garbage
+  /// collected or the runtime is destroyed. The finalizer may be called on a
+  /// GC background thread and must not use the runtime. If this throws, the
+  /// finalizer is never called and the caller keeps ownership of the memory.
+  /// The size counts towards the external memory tracked by the GC.
+  ///
+  /// This is an experimental Hermes-specific API. In the future it may be
+  /// renamed, moved or combined with another API, but the provided
+  /// functionality will continue to be available in some form.
+  jsi::ArrayBuffer createExternalArrayBuffer(
+      uint8_t *data,
+      size_t size,
+      std::function<void()> finalizer);
+
+  /// Intern the property names \p names[0..count) as a set which can be
+  /// shared by any number of fixed host objects. The names must be distinct.
+  ///
+  /// This is an experimental Hermes-specific API.
+  std::shared_ptr<const HostPropertySet> createHostPropertySet(
+      const jsi::PropNameID *names,
+      size_t count);
+
+  /// Create a host object backed by \p ho whose properties are \p props.
+  /// \c getHostObject returns \p ho for the new object.
+  ///
+  /// This is an experimental Hermes-specific API.
+  jsi::Object createFixedHostObject(
+      std::shared_ptr<const HostPropertySet> props,
+      std::shared_ptr<FixedHostObject> ho);
+
+  /// Read the properties \p names[0..count) of \p obj into \p out[0..count),
+  /// as if by calling \c getProperty on each name in order, but without
+  /// re-entering the runtime for every property.
+  ///
+  /// This is an experimental Hermes-specific API. In the future it may be
+  /// renamed, moved or combined with another API, but the provided
+  /// functionality will continue to be available in some form.
+  void getProperties(
+      const jsi::Object &obj,
+      const jsi::PropNameID *names,
+      size_t count,
+      jsi::Value *out);
+
+  /// Assign \p values[i] to the property \p names[i] of \p obj for every i in
+  /// [0, count), in order. If a setter throws, the remaining properties are
+  /// left unchanged.
+  /// This is an experimental Hermes-specific API.
+  void setProperties(
+      jsi::Object &obj,
+      const jsi::PropNameID *names,
+      const jsi::Value *values,
+      size_t count);
+
+  /// Read the elements [start, start + count) of \p arr into \p out. Throws
+  /// a JSError if the range extends past the length of the array.
+  /// This is an experimental Hermes-specific API.
+  void getArrayValues(
+      const jsi::Array &arr,
+      size_t start,
+      size_t count,
+      jsi::Value *out);
+
+  /// Store \p values[0..count) into the elements [start, start + count) of
+  /// \p arr. Throws a JSError if the range extends past the length of the
+  /// array.
+  /// This is an experimental Hermes-specific API.
+  void setArrayValues(
+      jsi::Array &arr,
+      size_t start,
+      const jsi::Value *values,
+      size_t count);
+
+  /// Same as \c getArrayValues, but for arrays of numbers, which are copied
+  /// into \p out without creating a jsi::Value for each one. Throws a JSError
+  /// if an element in the range is not a number.
+  /// This is an experimental Hermes-specific API.
+  void getArrayNumbers(
+      const jsi::Array &arr,
+      size_t start,
+      size_t count,
+      double *out);
+
+  /// Same as \c setArrayValues, but storing the numbers \p values[0..count).
+  /// This is an experimental Hermes-specific API.
+  void setArrayNumbers(
+      jsi::Array &arr,
+      size_t start,
+      const double *values,
+      size_t count);
+
  private:
   // Only HermesRuntimeImpl can subclass this.
   HermesRuntime() = default;
@@ -9,6 +9,7 @@
 #define HERMES_BCGEN_HBC_BYTECODEDATAPROVIDER_H
 
 #include "hermes/BCGen/HBC/BytecodeFileFormat.h"
+#include "hermes/BCGen/HBC/CompressedSection.h"
 #include "hermes/BCGen/HBC/DebugInfo.h"
 #include "hermes/Public/Buffer.h"
 #include "hermes/SourceMap/SourceMapGenerator.h"
@@ -141,9 +142,31 @@ class BCProviderBase {
   /// We can use this to throw an exception to JSI.
   std::string errstr_{};
 
+  /// Whether the string storage and literal buffers above are stored
+  /// compressed, in which case they must be read through
+  /// getDecompressedRange() rather than directly.
+  bool compressedSections_{false};
+
   /// Create the global debug info data, called only when first time needed.
   virtual void createDebugInfo() = 0;
 
+  /// \return a pointer to the decompressed bytes [offset, offset + size) of
+  /// the compressed section \p kind. Only called when compressedSections_ is
+  /// set.
+  virtual const uint8_t *getDecompressedRange(
+      CompressedSectionKind kind,
+      uint32_t offset,
+      uint32_t size) const {
+    llvm_unreachable("provider has no compressed sections");
+  }
+
+  /// \return the entire decompressed section \p kind. Only called when
+  /// compressedSections_ is set.
+  virtual llvh::ArrayRef<unsigned char> getDecompressedSection(
+      CompressedSectionKind kind) const {
+    llvm_unreachable("provider has no compressed sections");
+  }
+
  public:
   /// Getters for every private data member.
   BytecodeOptions getBytecodeOptions() const {
@@ -165,17 +188,35 @@ class BCProviderBase {
     return identifierHashes_;
   }
   llvh::ArrayRef<unsigned char> getStringStorage() const {
+    if (LLVM_UNLIKELY(compressedSections_))
+      return getDecompressedSection(CompressedSectionKind::StringStorage);
     return stringStorage_;
   }
   llvh::ArrayRef<unsigned char> getArrayBuffer() const {
+    if (LLVM_UNLIKELY(compressedSections_))
+      return getDecompressedSection(CompressedSectionKind::ArrayBuffer);
     return arrayBuffer_;
   }
   llvh::ArrayRef<unsigned char> getObjectKeyBuffer() const {
+    if (LLVM_UNLIKELY(compressedSections_))
+      return getDecompressedSection(CompressedSectionKind::ObjectKeyBuffer);
     return objKeyBuffer_;
   }
   llvh::ArrayRef<unsigned char> getObjectValueBuffer() const {
+    if (LLVM_UNLIKELY(compressedSections_))
+      return getDecompressedSection(CompressedSectionKind::ObjectValueBuffer);
     return objValueBuffer_;
   }
+  /// \return a pointer to \p size bytes of string storage starting at
+  /// \p offset. Unlike getStringStorage(), this only decompresses the blocks
+  /// covering the range when the string storage is compressed.
+  const unsigned char *getStringStorageRange(uint32_t offset, uint32_t size)
+      const {
+    if (LLVM_UNLIKELY(compressedSections_))
+      return getDecompressedRange(
+          CompressedSectionKind::StringStorage, offset, size);
+    return stringStorage_.begin() + offset;
+  }
   llvh::ArrayRef<RegExpTableEntry> getRegExpTable() const {
     return regExpTable_;
   }
@@ -204,7 +245,8 @@ class BCProviderBase {
   llvh::StringRef getStringRefFromID(StringID stringID) const {
     auto entry = getStringTableEntry(stringID);
     return llvh::StringRef(
-        (const char *)getStringStorage().begin() + entry.getOffset(),
+        (const char *)getStringStorageRange(
+            entry.getOffset(), entry.getLength()),
         entry.getLength());
   }
 
@@ -337,6 +379,15 @@ class BCProviderFromBuffer final : public BCProviderBase {
   /// End of the bytecode file.
   const uint8_t *end_;
 
+  /// Lazily decompressed views of the compressed sections, indexed by
+  /// CompressedSectionKind. Only initialized if the bytecode options have
+  /// compressedSections set.
+  CompressedSection
+      compressedSectionViews_[static_cast<size_t>(CompressedSectionKind::_count)];
+
+  /// Bytes of the debug info section as stored in the buffer.
+  llvh::ArrayRef<uint8_t> storedDebugInfo_{};
+
   /// Tells any running warmup thread to abort and then joins that thread.
   void stopWarmup();
 
@@ -346,6 +397,22 @@ class BCProviderFromBuffer final : public BCProviderBase {
 
   void createDebugInfo() override;
 
+  const uint8_t *getDecompressedRange(
+      CompressedSectionKind kind,
+      uint32_t offset,
+      uint32_t size) const override {
+    return getCompressedSection(kind)->getRange(offset, size);
+  }
+
+  llvh::ArrayRef<unsigned char> getDecompressedSection(
+      CompressedSectionKind kind) const override {
+    return getCompressedSection(kind)->getAll();
+  }
+
+  /// Set up the lazily decompressed views of the compressed sections.
+  /// \return true on success, false if a section is malformed.
+  bool initCompressedSections();
+
   /// Helper function to fetch the exception table data given \p functionID.
   /// \returns the ArrayRef to the exception table data, along with a pointer
   /// to the DebugOffsets (or nullptr if there is none).
@@ -483,6 +550,23 @@ class BCProviderFromBuffer final : public BCProviderBase {
     return llvh::ArrayRef<uint8_t>(bufferPtr_, buffer_->size());
   }
 
+  /// \return whether the bytecode stores some sections compressed.
+  bool hasCompressedSections() const {
+    return compressedSections_;
+  }
+
+  /// \return the bytes of section \p kind as stored in the buffer, which are
+  /// compressed if hasCompressedSections() is true.
+  llvh::ArrayRef<uint8_t> getStoredSection(CompressedSectionKind kind) const;
+
+  /// \return the lazily decompressed view of section \p kind. Only valid if
+  /// hasCompressedSections() is true.
+  const CompressedSection *getCompressedSection(
+      CompressedSectionKind kind) const {
+    assert(compressedSections_ && "bytecode has no compressed sections");
+    return &compressedSectionViews_[static_cast<size_t>(kind)];
+  }
+
   ~BCProviderFromBuffer() {
     stopWarmup();
     delete debugInfo_;
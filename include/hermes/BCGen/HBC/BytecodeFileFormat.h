@@ -51,6 +51,9 @@ union BytecodeOptions {
     bool staticBuiltins : 1;
     bool cjsModulesStaticallyResolved : 1;
     bool hasAsync : 1;
+    /// Whether the sections listed in CompressedSectionKind are stored as
+    /// compressed sections (see CompressedSectionHeader).
+    bool compressedSections : 1;
   };
   uint8_t _flags;
 
@@ -388,8 +391,58 @@ struct DebugFileRegion {
   uint32_t sourceMappingUrlId;
 };
 
+/// Header of a section stored in compressed form, used when
+/// BytecodeOptions::compressedSections is set. The header is followed by
+/// blockCount + 1 uint32_t offsets delimiting each compressed block, relative
+/// to the end of the offset table, and then by the blocks themselves. Every
+/// block decompresses independently to blockSize bytes (the last one may be
+/// shorter), so a reader only needs to decompress the blocks it touches.
+struct CompressedSectionHeader {
+  /// Size of the section after decompression.
+  uint32_t rawSize;
+  /// Number of decompressed bytes in each block.
+  uint32_t blockSize;
+  /// Number of compressed blocks.
+  uint32_t blockCount;
+};
+
 LLVM_PACKED_END
 
+/// The sections which are stored compressed when
+/// BytecodeOptions::compressedSections is set. The file header records the
+/// stored (compressed) size of the string storage and literal buffers; the
+/// debug info section extends from debugInfoOffset to the file footer.
+enum class CompressedSectionKind : uint8_t {
+  StringStorage,
+  ArrayBuffer,
+  ObjectKeyBuffer,
+  ObjectValueBuffer,
+  DebugInfo,
+  _count,
+};
+
+/// Number of decompressed bytes per block of a compressed section.
+static constexpr uint32_t COMPRESSED_SECTION_BLOCK_SIZE = 16 * 1024;
+
+/// \return a human readable name for the section \p kind.
+inline const char *compressedSectionName(CompressedSectionKind kind) {
+  switch (kind) {
+    case CompressedSectionKind::StringStorage:
+      return "String storage";
+    case CompressedSectionKind::ArrayBuffer:
+      return "Array buffer";
+    case CompressedSectionKind::ObjectKeyBuffer:
+      return "Object key buffer";
+    case CompressedSectionKind::ObjectValueBuffer:
+      return "Object value buffer";
+    case CompressedSectionKind::DebugInfo:
+      return "Debug info";
+    case CompressedSectionKind::_count:
+      break;
+  }
+  return "<invalid>";
+}
+
 /// Visit each segment in a bytecode file in order.
 /// This function defines the order of the bytecode file segments.
 template <typename Visitor>
@@ -55,6 +55,10 @@ class BytecodeSerializer {
   uint32_t overflowStringEntryCount_{0};
   /// Hash of everything written in non-layout mode so far.
   llvh::SHA1 outputHasher_;
+  /// Compressed contents of each CompressedSectionKind, computed before the
+  /// layout run when options_.compressSections is set.
+  std::vector<uint8_t>
+      compressedSections_[static_cast<size_t>(CompressedSectionKind::_count)];
 
   /// Each subsection of a function's `info' section is aligned thusly.
   static constexpr uint32_t INFO_ALIGNMENT = 4;
@@ -97,6 +101,24 @@ class BytecodeSerializer {
 
   void serializeDebugInfo(BytecodeModule &BM);
 
+  /// Append the uncompressed debug info section of \p BM to \p out.
+  void encodeDebugInfo(BytecodeModule &BM, std::vector<uint8_t> &out);
+
+  /// Populate compressedSections_ from the contents of \p BM.
+  void compressSections(BytecodeModule &BM);
+
+  /// \return the compressed contents of section \p kind.
+  ArrayRef<uint8_t> getCompressedSection(CompressedSectionKind kind) const {
+    return compressedSections_[static_cast<size_t>(kind)];
+  }
+
+  /// \return the number of bytes section \p kind occupies in the file, given
+  /// its uncompressed size \p rawSize.
+  uint32_t storedSize(CompressedSectionKind kind, uint32_t rawSize) const {
+    return options_.compressSections ? getCompressedSection(kind).size()
+                                     : rawSize;
+  }
+
   void serializeArrayBuffer(BytecodeModule &BM);
 
   void serializeObjectBuffer(BytecodeModule &BM);
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_BCGEN_HBC_COMPRESSEDSECTION_H
+#define HERMES_BCGEN_HBC_COMPRESSEDSECTION_H
+
+#include "hermes/BCGen/HBC/BytecodeFileFormat.h"
+
+#include "llvh/ADT/ArrayRef.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace hermes {
+namespace hbc {
+
+/// Encode \p raw as a compressed section (header, block offset table and
+/// compressed blocks of \p blockSize bytes each) and append it to \p out.
+void compressSection(
+    llvh::ArrayRef<uint8_t> raw,
+    std::vector<uint8_t> &out,
+    uint32_t blockSize = COMPRESSED_SECTION_BLOCK_SIZE);
+
+/// A read-only view of a compressed section inside a bytecode buffer, which
+/// decompresses blocks into an owned cache the first time they are accessed.
+/// Accessors are const and thread safe, since bytecode providers may be
+/// shared between runtimes.
+class CompressedSection {
+  /// The stored section, pointing into the bytecode buffer.
+  llvh::ArrayRef<uint8_t> stored_{};
+
+  /// The block offset table from the stored section.
+  const uint32_t *blockOffsets_{nullptr};
+
+  /// Start of the compressed block data from the stored section.
+  const uint8_t *blockData_{nullptr};
+
+  /// Parsed header fields.
+  uint32_t rawSize_{0};
+  uint32_t blockSize_{0};
+  uint32_t blockCount_{0};
+
+  /// Decompressed contents, allocated on first access.
+  mutable std::unique_ptr<uint8_t[]> cache_{};
+
+  /// Which blocks of cache_ have been decompressed.
+  mutable std::vector<bool> present_{};
+
+  /// Number of set entries in present_.
+  mutable uint32_t presentCount_{0};
+
+  /// Set once every block has been decompressed, so that later accesses can
+  /// skip the lock.
+  mutable std::atomic<bool> complete_{false};
+
+  /// Guards cache_, present_ and presentCount_.
+  mutable std::mutex mutex_{};
+
+  /// Decompress blocks [first, last] that are not present yet. Must be called
+  /// with mutex_ held.
+  void decompressBlocks(uint32_t first, uint32_t last) const;
+
+ public:
+  CompressedSection() = default;
+  CompressedSection(const CompressedSection &) = delete;
+  CompressedSection &operator=(const CompressedSection &) = delete;
+
+  /// Parse the section header and block table of \p stored.
+  /// \return true on success, false on failure, in which case an error is
+  /// returned by reference.
+  bool init(llvh::ArrayRef<uint8_t> stored, std::string *outError);
+
+  /// \return the bytes of the section as stored in the bytecode buffer.
+  llvh::ArrayRef<uint8_t> getStored() const {
+    return stored_;
+  }
+
+  /// \return the size of the section after decompression.
+  uint32_t getRawSize() const {
+    return rawSize_;
+  }
+
+  uint32_t getBlockCount() const {
+    return blockCount_;
+  }
+
+  /// \return the number of blocks decompressed so far.
+  uint32_t getDecompressedBlockCount() const;
+
+  /// \return a pointer to the decompressed bytes [offset, offset + size),
+  /// decompressing only the blocks which cover that range.
+  const uint8_t *getRange(uint32_t offset, uint32_t size) const;
+
+  /// \return the whole decompressed section.
+  llvh::ArrayRef<uint8_t> getAll() const {
+    return {getRange(0, rawSize_), rawSize_};
+  }
+};
+
+} // namespace hbc
+} // namespace hermes
+
+#endif // HERMES_BCGEN_HBC_COMPRESSEDSECTION_H
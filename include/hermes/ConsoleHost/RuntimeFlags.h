@@ -79,6 +79,13 @@ static opt<bool> GCRandomizeAllocSpace(
     cat(GCCategory),
     init(false));
 
+static opt<bool> GCPretenure(
+    "gc-pretenure",
+    desc("Allocate objects from allocation sites whose objects usually survive "
+         "young generation collections directly in the old generation"),
+    cat(GCCategory),
+    init(GCConfig::getDefaultAllocationSitePretenuring()));
+
 static opt<MemorySize, false, MemorySizeParser> MinHeapSize(
     "gc-min-heap",
     desc("Minimum heap size.  Format: <unsigned>{{K,M,G}{iB}"),
@@ -169,6 +176,23 @@ static opt<uint32_t> VMExperimentFlags(
     llvh::cl::Hidden,
     cat(RuntimeCategory));
 
+static opt<unsigned> DictionaryThreshold(
+    "Xdictionary-threshold",
+    llvh::cl::desc(
+        "Number of properties after which objects switch to dictionary mode."),
+    llvh::cl::init(RuntimeConfig::getDefaultDictionaryThreshold()),
+    llvh::cl::Hidden,
+    cat(RuntimeCategory));
+
+static opt<unsigned> DictionaryReshapeThreshold(
+    "Xdictionary-reshape-threshold",
+    llvh::cl::desc(
+        "Number of uncached accesses to an unchanging dictionary object "
+        "after which it gets a shared hidden class again (0 to disable)."),
+    llvh::cl::init(RuntimeConfig::getDefaultDictionaryReshapeThreshold()),
+    llvh::cl::Hidden,
+    cat(RuntimeCategory));
+
 static opt<bool> EnableHermesInternal(
     "enable-hermes-internal",
     llvh::cl::desc("Enable the HermesInternal object."),
@@ -25,6 +25,7 @@
 #include "llvh/ADT/ilist_node.h"
 #include "llvh/ADT/iterator_range.h"
 #include "llvh/IR/SymbolTableListTraits.h"
+#include "llvh/Support/Allocator.h"
 #include "llvh/Support/Casting.h"
 #include "llvh/Support/MathExtras.h"
 #include "llvh/Support/raw_ostream.h"
@@ -432,19 +433,12 @@ class Value {
   UseListTy Users;
 
   // Instances of Value are not supposed to be deleted directly because we
-  // want to avoid defining a virtual destructor. The private operator
-  // delete can only be invoked by the \c destroy() method.
-
-  // Use sized deallocation to speed things up, if it is available
-#ifdef __cpp_sized_deallocation
-  void operator delete(void *p, size_t s) {
-    ::operator delete(p, s);
-  }
-#else
-  void operator delete(void *p) {
-    ::operator delete(p);
+  // want to avoid defining a virtual destructor. Their storage belongs to
+  // the arena of the owning Module, so the only way to dispose of a value is
+  // the \c destroy() method, which runs the destructor.
+  void operator delete(void *) {
+    llvm_unreachable("Values cannot be deleted directly");
   }
-#endif
 
  protected:
   explicit Value(ValueKind k) {
@@ -455,7 +449,16 @@ class Value {
   Value(const Value &) = delete;
   void operator=(const Value &) = delete;
 
-  /// Run a Value's destructor and deallocate its memory.
+  /// Allocate storage for a value from the arena of \p M. The memory is
+  /// released in bulk when the module is destroyed.
+  static void *operator new(size_t size, Module *M);
+
+  /// Only invoked if the constructor of a value allocated in \p M throws.
+  /// The storage is reclaimed along with the rest of the arena.
+  static void operator delete(void *, Module *) {}
+
+  /// Run a Value's destructor. Its storage is owned by the Module arena it
+  /// was allocated from and is not released until the module is destroyed.
   static void destroy(Value *V);
 
   /// \return the users of the value.
@@ -1816,6 +1819,10 @@ class Module : public Value {
  private:
   using GlobalObjectPropertyList = std::vector<GlobalObjectProperty *>;
 
+  /// Arena holding the storage of every Value allocated in this module. It
+  /// is declared first so that it outlives all of them.
+  llvh::BumpPtrAllocator valueAllocator_{};
+
   std::shared_ptr<Context> Ctx;
   /// Optionally specify the top level function, if it isn't the first one.
   Function *topLevelFunction_{};
@@ -1898,6 +1905,11 @@ class Module : public Value {
     return *Ctx;
   }
 
+  /// \return the arena from which the values of this module are allocated.
+  llvh::BumpPtrAllocator &getValueAllocator() {
+    return valueAllocator_;
+  }
+
   std::shared_ptr<Context> shareContext() const {
     return Ctx;
   }
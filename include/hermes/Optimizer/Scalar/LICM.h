@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_OPTIMIZER_SCALAR_LICM_H
+#define HERMES_OPTIMIZER_SCALAR_LICM_H
+
+#include "hermes/IR/IR.h"
+#include "hermes/Optimizer/PassManager/Pass.h"
+
+namespace hermes {
+
+/// Hoist loop invariant instructions out of natural loops, creating loop
+/// preheaders where necessary.
+class LICM : public FunctionPass {
+ public:
+  explicit LICM() : FunctionPass("LICM") {}
+  ~LICM() override = default;
+
+  bool runOnFunction(Function *F) override;
+};
+
+} // namespace hermes
+
+#endif // HERMES_OPTIMIZER_SCALAR_LICM_H
@@ -144,6 +144,11 @@ class SourceMap {
     return sourceFullPath;
   }
 
+  /// \return the mappings, as a list of segments for each generated line.
+  llvh::ArrayRef<SegmentList> getLines() const {
+    return lines_;
+  }
+
   /// \return the number of source paths.
   uint32_t getNumSourcePaths() const {
     assert(sources_.size() <= UINT32_MAX);
@@ -25,27 +25,51 @@ namespace hermes {
 /// implements.
 class SourceMapGenerator {
  public:
+  /// The shape of the JSON output.
+  enum class Format {
+    /// A single map whose line N holds the mappings of segment N.
+    Regular,
+    /// An index map with one section per segment, starting at line N. Each
+    /// section is a regular map with a single line, listing the sources known
+    /// when the segment was added.
+    Index,
+  };
+
+  explicit SourceMapGenerator(Format format = Format::Regular)
+      : format_(format) {}
+
   /// Add a line \p line represented as a list of Segments to the 'mappings'
   /// section.
   /// \param segmentID the ID of the segment ( = the BytecodeModule /
   /// RuntimeModule), used as the "line" when reporting stack traces from the
   /// VM.
-  void addMappingsLine(SourceMap::SegmentList line, uint32_t segmentID) {
-    if (lines_.size() <= segmentID) {
-      lines_.resize(segmentID + 1);
-    }
-    lines_[segmentID] = std::move(line);
+  void addMappingsLine(
+      llvh::ArrayRef<SourceMap::Segment> line,
+      uint32_t segmentID) {
+    startMappingsLine(segmentID);
+    addMappings(line);
   }
 
-  /// \return the list of mappings lines.
-  llvh::ArrayRef<SourceMap::SegmentList> getMappingsLines() const {
-    return lines_;
+  /// Start the mappings line for \p segmentID, which must not precede the
+  /// current line. Any lines skipped over are left empty.
+  void startMappingsLine(uint32_t segmentID);
+
+  /// Append \p segments to the current mappings line. They are encoded
+  /// immediately (and written out, if streaming), so the caller may reuse the
+  /// storage.
+  void addMappings(llvh::ArrayRef<SourceMap::Segment> segments);
+
+  /// \return the number of segments in each mappings line.
+  llvh::ArrayRef<uint32_t> getMappingsLineSizes() const {
+    return lineSizes_;
   }
 
   /// Set the list of input source maps to \p maps.
   /// The order should match the indexes used in the sourceIndex field of
-  /// Segment.
+  /// Segment. This must be called before any mappings are added, since they
+  /// are merged with the input maps as they are added.
   void setInputSourceMaps(std::vector<std::unique_ptr<SourceMap>> maps) {
+    assert(lineSizes_.empty() && "input source maps set after mappings");
     inputSourceMaps_ = std::move(maps);
   }
 
@@ -57,8 +81,15 @@ class SourceMapGenerator {
       llvh::StringRef filename,
       llvh::Optional<SourceMap::MetadataEntry> metadata = llvh::None);
 
+  /// Write the source map to \p OS as mappings are added, instead of buffering
+  /// them. This must be called before any mappings are added, and
+  /// outputAsJSON() must later be called with the same stream to finish the
+  /// map. Since the sources are only known at the end, a streamed regular map
+  /// has its "mappings" field before its "sources" field.
+  void streamTo(llvh::raw_ostream &OS);
+
   /// Output the given source map as JSON.
-  void outputAsJSON(llvh::raw_ostream &OS) const;
+  void outputAsJSON(llvh::raw_ostream &OS);
 
   /// Adds a list of function offsets indexed by function ID for a given
   /// bytecode segment. This list will be printed under
@@ -85,27 +116,35 @@ class SourceMapGenerator {
     int32_t nameIndex = 0;
   };
 
-  /// Implementation of outputAsJSON for a merged source map generator.
-  void outputAsJSONImpl(llvh::raw_ostream &OS) const;
+  /// \return the stream the output is currently written to: either the
+  /// stream passed to streamTo(), or \p bufferOS.
+  llvh::raw_ostream &out(llvh::raw_string_ostream &bufferOS) {
+    return streamOS_ ? *streamOS_ : bufferOS;
+  }
 
-  /// \return the mappings encoded in VLQ format.
-  std::string getVLQMappingsString() const;
+  /// Write whatever follows the current line to \p OS.
+  void endMappingsLine(llvh::raw_ostream &OS);
 
-  /// \return a list of sources, in order.
-  /// This list refers to internals of the StringMap and is invalidated by
-  /// addSource().
-  std::vector<llvh::StringRef> getSources() const;
+  /// Add \p filename with \p metadata to the sources \p table, whose metadata
+  /// is \p metadataList, as described in addSource().
+  static uint32_t addSourceTo(
+      StringSetVector &table,
+      SourceMap::MetadataList &metadataList,
+      llvh::StringRef filename,
+      llvh::Optional<SourceMap::MetadataEntry> metadata);
 
   /// Encode the list \p segments into \p OS using the SourceMap
   /// Base64-VLQ scheme, delta-encoded with \p lastState as the starting state.
+  /// \param first whether the segments start a line.
   static SourceMapGenerator::State encodeSourceLocations(
       const SourceMapGenerator::State &lastState,
       llvh::ArrayRef<SourceMap::Segment> segments,
+      bool first,
       llvh::raw_ostream &OS);
 
-  /// Merge the input source maps with the state in this generator,
-  /// and return a new generator which contains a merged representation.
-  SourceMapGenerator mergedWithInputSourceMaps() const;
+  /// \return \p seg with its represented location translated through the
+  /// input source maps, and its source index referring to mergedSources_.
+  SourceMap::Segment mergeWithInputSourceMaps(const SourceMap::Segment &seg);
 
   /// \return the input source map segment for \p seg if the input source map
   /// exists and has a valid location for \p seg. The input segment may be
@@ -113,7 +152,25 @@ class SourceMapGenerator {
   std::pair<llvh::Optional<SourceMap::Segment>, const SourceMap *>
   getInputSegmentForSegment(const SourceMap::Segment &seg) const;
 
-  bool hasSourcesMetadata() const;
+  /// \return the sources listed in the output, which are those added with
+  /// addSource() unless the mappings are merged with input source maps.
+  const StringSetVector &getOutputSources() const {
+    return inputSourceMaps_.empty() ? filenameTable_ : mergedSources_;
+  }
+
+  /// \return the metadata of the sources listed in the output.
+  const SourceMap::MetadataList &getOutputSourcesMetadata() const {
+    return inputSourceMaps_.empty() ? sourcesMetadata_
+                                    : mergedSourcesMetadata_;
+  }
+
+  /// Write the "sources" field of the output to \p OS, preceded by a comma,
+  /// and the "x_facebook_sources" field if there is any metadata.
+  void outputSources(llvh::raw_ostream &OS) const;
+
+  /// Write the "x_hermes_function_offsets" field to \p OS, preceded by a
+  /// comma, if there are any function offsets.
+  void outputFunctionOffsets(llvh::raw_ostream &OS) const;
 
   /// \return metadata for source \index, if we have any.
   llvh::Optional<SourceMap::MetadataEntry> getSourceMetadata(
@@ -124,11 +181,23 @@ class SourceMapGenerator {
     return sourcesMetadata_[index];
   }
 
-  /// The list of symbol names, populating the names field.
-  std::vector<std::string> symbolNames_;
+  /// The shape of the output.
+  Format format_;
 
-  /// The list of segments in our VLQ scheme.
-  std::vector<SourceMap::SegmentList> lines_;
+  /// The stream the output is written to as it is generated, if any.
+  llvh::raw_ostream *streamOS_{nullptr};
+
+  /// The output generated so far, when not streaming: the "mappings" field of
+  /// a regular map, or the "sections" of an index map, without the tail of
+  /// the current line.
+  std::string buffer_;
+
+  /// The number of segments in each line added so far. The last line is the
+  /// current one.
+  std::vector<uint32_t> lineSizes_;
+
+  /// The delta encoding state after the last segment added.
+  State state_{};
 
   /// The list of input source maps, such that the input file i has the
   /// SourceMap at index i. If no map was provided for a file, this list
@@ -142,6 +211,11 @@ class SourceMapGenerator {
   /// x_facebook_sources field in the JSON source map.
   SourceMap::MetadataList sourcesMetadata_;
 
+  /// The sources referred to by mappings merged with the input source maps,
+  /// in order of first use, and their metadata.
+  StringSetVector mergedSources_{};
+  SourceMap::MetadataList mergedSourcesMetadata_;
+
   ///  Maps segmentID to a vector of function offsets indexed by their
   /// function id.
   llvh::DenseMap<uint32_t, std::vector<uint32_t>> functionOffsets_{};
@@ -50,6 +50,23 @@ class SourceMapParser {
     int32_t nameIndex = 0;
   };
 
+  /// Parse the regular (not index) source map \p json, reporting errors at
+  /// \p loc. Its metadata refers to storage in \p alloc.
+  static std::unique_ptr<SourceMap> parseRegularMap(
+      const parser::JSONObject *json,
+      const std::shared_ptr<parser::JSLexer::Allocator> &alloc,
+      SMLoc loc,
+      SourceErrorManager &sm);
+
+  /// Parse the index map \p json, flattening its sections into a single
+  /// map, reporting errors at \p loc. Its metadata refers to storage in
+  /// \p alloc.
+  static std::unique_ptr<SourceMap> parseIndexMap(
+      const parser::JSONObject *json,
+      const std::shared_ptr<parser::JSLexer::Allocator> &alloc,
+      SMLoc loc,
+      SourceErrorManager &sm);
+
   /// Parse "mappings" section from \p sourceMappings. The parsed line mappings
   /// are returned in \p lines.
   static bool parseMappings(
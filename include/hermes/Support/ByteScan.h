@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_SUPPORT_BYTESCAN_H
+#define HERMES_SUPPORT_BYTESCAN_H
+
+#include "llvh/Support/MathExtras.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HERMES_BYTESCAN_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define HERMES_BYTESCAN_NEON 1
+#endif
+
+/// Helpers for skipping runs of uninteresting bytes in a buffer, 16 bytes at
+/// a time where the target has SSE2 or NEON.
+///
+/// Every function takes the current position \p p and the end of the buffer
+/// \p end, and never reads at or past \p end. They return a position in
+/// [p, end] such that every byte before it belongs to the run being skipped,
+/// but they may stop early when fewer than 16 bytes are left (or always, on
+/// targets without vector support), so callers must finish the run with
+/// their regular byte-at-a-time loop.
+namespace hermes {
+namespace bytescan {
+
+#if defined(HERMES_BYTESCAN_SSE2) || defined(HERMES_BYTESCAN_NEON)
+
+namespace detail {
+
+/// Number of bytes examined at a time.
+constexpr unsigned kWidth = 16;
+
+#ifdef HERMES_BYTESCAN_SSE2
+using Vec = __m128i;
+
+inline Vec load(const char *p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+inline Vec eq(Vec v, char c) {
+  return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+inline Vec either(Vec a, Vec b) {
+  return _mm_or_si128(a, b);
+}
+/// Lanes whose byte has the top bit set.
+inline Vec nonASCII(Vec v) {
+  return _mm_cmplt_epi8(v, _mm_setzero_si128());
+}
+/// Lanes whose byte is in [lo, hi], for ASCII \p lo and \p hi.
+inline Vec inRange(Vec v, char lo, char hi) {
+  return _mm_and_si128(
+      _mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)),
+      _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+}
+/// \return the index of the first lane set in \p m, or kWidth if none is.
+inline unsigned firstSet(Vec m) {
+  unsigned mask = _mm_movemask_epi8(m);
+  return mask ? llvh::countTrailingZeros(mask) : kWidth;
+}
+/// \return the index of the first lane clear in \p m, or kWidth if none is.
+inline unsigned firstClear(Vec m) {
+  unsigned mask = ~_mm_movemask_epi8(m) & 0xffff;
+  return mask ? llvh::countTrailingZeros(mask) : kWidth;
+}
+#else
+using Vec = uint8x16_t;
+
+inline Vec load(const char *p) {
+  return vld1q_u8(reinterpret_cast<const uint8_t *>(p));
+}
+inline Vec eq(Vec v, char c) {
+  return vceqq_u8(v, vdupq_n_u8((uint8_t)c));
+}
+inline Vec either(Vec a, Vec b) {
+  return vorrq_u8(a, b);
+}
+inline Vec nonASCII(Vec v) {
+  return vcgeq_u8(v, vdupq_n_u8(0x80));
+}
+inline Vec inRange(Vec v, char lo, char hi) {
+  return vandq_u8(
+      vcgeq_u8(v, vdupq_n_u8((uint8_t)lo)),
+      vcleq_u8(v, vdupq_n_u8((uint8_t)hi)));
+}
+/// Narrow each lane of \p m to 4 bits, since NEON has no movemask.
+inline uint64_t nibbleMask(Vec m) {
+  return vget_lane_u64(
+      vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+}
+inline unsigned firstSet(Vec m) {
+  uint64_t mask = nibbleMask(m);
+  return mask ? llvh::countTrailingZeros(mask) / 4 : kWidth;
+}
+inline unsigned firstClear(Vec m) {
+  uint64_t mask = ~nibbleMask(m);
+  return mask ? llvh::countTrailingZeros(mask) / 4 : kWidth;
+}
+#endif
+
+} // namespace detail
+
+/// Skip ASCII bytes other than \p a, \p b, \p c and \p d.
+inline const char *
+skipUntil(const char *p, const char *end, char a, char b, char c, char d) {
+  using namespace detail;
+  while ((size_t)(end - p) >= kWidth) {
+    Vec v = load(p);
+    unsigned i = firstSet(either(
+        either(either(eq(v, a), eq(v, b)), either(eq(v, c), eq(v, d))),
+        nonASCII(v)));
+    p += i;
+    if (i != kWidth)
+      break;
+  }
+  return p;
+}
+
+/// Skip spaces and tabs.
+inline const char *skipSpacesAndTabs(const char *p, const char *end) {
+  using namespace detail;
+  while ((size_t)(end - p) >= kWidth) {
+    Vec v = load(p);
+    unsigned i = firstClear(either(eq(v, ' '), eq(v, '\t')));
+    p += i;
+    if (i != kWidth)
+      break;
+  }
+  return p;
+}
+
+/// Skip ASCII identifier parts: letters, digits, '_' and '$'.
+inline const char *skipASCIIIdentifierParts(const char *p, const char *end) {
+  using namespace detail;
+  while ((size_t)(end - p) >= kWidth) {
+    Vec v = load(p);
+    unsigned i = firstClear(either(
+        either(inRange(v, 'a', 'z'), inRange(v, 'A', 'Z')),
+        either(inRange(v, '0', '9'), either(eq(v, '_'), eq(v, '$')))));
+    p += i;
+    if (i != kWidth)
+      break;
+  }
+  return p;
+}
+
+#else
+
+inline const char *
+skipUntil(const char *p, const char *, char, char, char, char) {
+  return p;
+}
+inline const char *skipSpacesAndTabs(const char *p, const char *) {
+  return p;
+}
+inline const char *skipASCIIIdentifierParts(const char *p, const char *) {
+  return p;
+}
+
+#endif
+
+} // namespace bytescan
+} // namespace hermes
+
+#endif // HERMES_SUPPORT_BYTESCAN_H
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_SUPPORT_LZBLOCK_H
+#define HERMES_SUPPORT_LZBLOCK_H
+
+#include "llvh/ADT/ArrayRef.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace hermes {
+
+/// The lzblock namespace contains a small, dependency-free LZ77 codec for
+/// independently decompressable blocks of data. The format is a sequence of
+/// (literal run, back reference) pairs in the style of LZ4:
+///   token:    one byte, high nibble = literal length, low nibble = match
+///             length - kMinMatch. A nibble of 15 is followed by extension
+///             bytes, each adding up to 255, ending at the first byte < 255.
+///   literals: the literal bytes.
+///   offset:   two bytes, little endian, distance back to the match start.
+///             Omitted in the last sequence, which carries only literals.
+/// Decompression is bounds checked and never reads outside its input or
+/// writes outside its output.
+namespace lzblock {
+
+/// The shortest back reference the encoder emits.
+static constexpr uint32_t kMinMatch = 4;
+
+/// Compress \p input and append the compressed bytes to \p output.
+void compress(llvh::ArrayRef<uint8_t> input, std::vector<uint8_t> &output);
+
+/// Decompress \p input, which must decompress to exactly \p output.size()
+/// bytes, into \p output.
+/// \return true on success, false if the input was malformed.
+bool decompress(
+    llvh::ArrayRef<uint8_t> input,
+    llvh::MutableArrayRef<uint8_t> output);
+
+} // namespace lzblock
+
+} // namespace hermes
+
+#endif // HERMES_SUPPORT_LZBLOCK_H
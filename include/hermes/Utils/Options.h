@@ -59,6 +59,10 @@ struct BytecodeGenerationOptions {
   /// Strip the source map URL.
   bool stripSourceMappingURL = false;
 
+  /// Store the string storage, literal buffers and debug info as compressed
+  /// sections, decompressed lazily when loaded.
+  bool compressSections = false;
+
   /* implicit */ BytecodeGenerationOptions(OutputFormatKind format)
       : format(format) {}
 
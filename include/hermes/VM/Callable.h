@@ -311,8 +311,23 @@ class Callable : public JSObject {
       JSObject *parent,
       HiddenClass *clazz,
       Handle<Environment> env)
-      : JSObject(runtime, vt, parent, clazz),
-        environment_(runtime, *env, &runtime->getHeap()) {}
+      : Callable(
+            runtime,
+            vt,
+            parent,
+            clazz,
+            env,
+            GCPointerBase::NoBarriers()) {}
+  template <typename NeedsBarriers>
+  Callable(
+      Runtime *runtime,
+      const VTable *vt,
+      JSObject *parent,
+      HiddenClass *clazz,
+      Handle<Environment> env,
+      NeedsBarriers needsBarriers)
+      : JSObject(runtime, vt, parent, clazz, needsBarriers),
+        environment_(runtime, *env, &runtime->getHeap(), needsBarriers) {}
   Callable(
       Runtime *runtime,
       const VTable *vt,
@@ -843,6 +858,7 @@ class JSFunction : public Callable {
   GCPointer<Domain> domain_;
 
  public:
+  template <typename NeedsBarriers>
   JSFunction(
       Runtime *runtime,
       const VTable *vtp,
@@ -850,15 +866,53 @@ class JSFunction : public Callable {
       Handle<JSObject> parent,
       Handle<HiddenClass> clazz,
       Handle<Environment> environment,
-      CodeBlock *codeBlock)
-      : Callable(runtime, vtp, *parent, *clazz, environment),
+      CodeBlock *codeBlock,
+      NeedsBarriers needsBarriers)
+      : Callable(runtime, vtp, *parent, *clazz, environment, needsBarriers),
         codeBlock_(codeBlock),
-        domain_(runtime, *domain, &runtime->getHeap()) {
+        domain_(runtime, *domain, &runtime->getHeap(), needsBarriers) {
     assert(
         !vt.base.base.finalize_ == (kHasFinalizer != HasFinalizer::Yes) &&
         "kHasFinalizer invalid value");
   }
 
+  JSFunction(
+      Runtime *runtime,
+      const VTable *vtp,
+      Handle<Domain> domain,
+      Handle<JSObject> parent,
+      Handle<HiddenClass> clazz,
+      Handle<Environment> environment,
+      CodeBlock *codeBlock)
+      : JSFunction(
+            runtime,
+            vtp,
+            domain,
+            parent,
+            clazz,
+            environment,
+            codeBlock,
+            GCPointerBase::NoBarriers()) {}
+
+  template <typename NeedsBarriers>
+  JSFunction(
+      Runtime *runtime,
+      Handle<Domain> domain,
+      Handle<JSObject> parent,
+      Handle<HiddenClass> clazz,
+      Handle<Environment> environment,
+      CodeBlock *codeBlock,
+      NeedsBarriers needsBarriers)
+      : JSFunction(
+            runtime,
+            &vt.base.base,
+            domain,
+            parent,
+            clazz,
+            environment,
+            codeBlock,
+            needsBarriers) {}
+
   JSFunction(
       Runtime *runtime,
       Handle<Domain> domain,
@@ -893,6 +947,16 @@ class JSFunction : public Callable {
       Handle<Environment> envHandle,
       CodeBlock *codeBlock);
 
+  /// Like create(), but allocate the function directly in the old generation.
+  /// Used for closures created at allocation sites whose objects are expected
+  /// to be long-lived.
+  static PseudoHandle<JSFunction> createLongLived(
+      Runtime *runtime,
+      Handle<Domain> domain,
+      Handle<JSObject> parentHandle,
+      Handle<Environment> envHandle,
+      CodeBlock *codeBlock);
+
   /// Create a Function with no environment and a CodeBlock simply returning
   /// undefined, with the prototype property auto-initialized to new Object().
   static PseudoHandle<JSFunction> create(
@@ -931,6 +995,13 @@ class JSFunction : public Callable {
   void addLocationToSnapshot(HeapSnapshot &snap, HeapSnapshot::NodeID id) const;
 
  protected:
+  /// Create the 'this' object for a constructor call, with room for as many
+  /// properties as earlier objects had when the constructor returned.
+  static CallResult<PseudoHandle<JSObject>> _newObjectImpl(
+      Handle<Callable> selfHandle,
+      Runtime *runtime,
+      Handle<JSObject> parentHandle);
+
   /// Call the JavaScript function with arguments already on the stack.
   static CallResult<PseudoHandle<>> _callImpl(
       Handle<Callable> selfHandle,
@@ -1199,7 +1270,8 @@ class GeneratorInnerFunction final : public JSFunction {
   void restoreStack(Runtime *runtime);
 
   /// Saves the stack variables needed to resume execution from a SuspendedYield
-  /// state, and places them in an internal property.
+  /// state, and places them in an internal property. Only the registers that
+  /// changed since they were last saved are written.
   void saveStack(Runtime *runtime);
 
   void setNextIP(const Inst *ip) {
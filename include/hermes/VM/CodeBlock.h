@@ -57,6 +57,16 @@ class CodeBlock final
   /// cache.
   const uint32_t writePropCacheOffset_;
 
+  /// The largest number of properties that an object constructed by this
+  /// function had when the function returned. Objects it constructs later are
+  /// allocated with room for that many properties.
+  uint32_t constructedPropertyCount_{0};
+
+  /// Bytecode offsets of the allocating instructions in this function whose
+  /// objects are allocated directly in the old generation. Null until there
+  /// is one.
+  std::unique_ptr<llvh::DenseSet<uint32_t>> pretenuredSites_;
+
 #ifndef HERMESVM_LEAN
   /// Compiles a lazy CodeBlock. Intended to be called from lazyCompile.
   void lazyCompileImpl(Runtime *runtime);
@@ -268,6 +278,34 @@ class CodeBlock final
     return &propertyCache()[writePropCacheOffset_ + idx];
   }
 
+  /// \return the number of properties to reserve in objects constructed by
+  /// this function.
+  uint32_t getConstructedPropertyCount() const {
+    return constructedPropertyCount_;
+  }
+
+  /// Record that an object constructed by this function had \p numProperties
+  /// properties when the function returned.
+  void recordConstructedObject(uint32_t numProperties) {
+    if (LLVM_UNLIKELY(numProperties > constructedPropertyCount_))
+      constructedPropertyCount_ = numProperties;
+  }
+
+  /// \return true if the allocating instruction at \p offset allocates its
+  /// objects directly in the old generation.
+  bool isPretenuredSite(uint32_t offset) const {
+    return LLVM_UNLIKELY(pretenuredSites_ != nullptr) &&
+        pretenuredSites_->count(offset);
+  }
+
+  /// Make the allocating instruction at \p offset allocate its objects
+  /// directly in the old generation.
+  void addPretenuredSite(uint32_t offset) {
+    if (!pretenuredSites_)
+      pretenuredSites_ = std::make_unique<llvh::DenseSet<uint32_t>>();
+    pretenuredSites_->insert(offset);
+  }
+
   // Mark all hidden classes in the property cache as roots.
   void markCachedHiddenClasses(Runtime *runtime, WeakRootAcceptor &acceptor);
 
@@ -280,7 +318,8 @@ class CodeBlock final
   /// \return an estimate of the size of additional memory used by this
   /// CodeBlock.
   size_t additionalMemorySize() const {
-    return propertyCacheSize_ * sizeof(PropertyCacheEntry);
+    return propertyCacheSize_ * sizeof(PropertyCacheEntry) +
+        (pretenuredSites_ ? pretenuredSites_->getMemorySize() : 0);
   }
 
 #ifdef HERMES_ENABLE_DEBUGGER
@@ -36,6 +36,7 @@
 #include "llvh/ADT/ArrayRef.h"
 #include "llvh/ADT/BitVector.h"
 #include "llvh/ADT/DenseMap.h"
+#include "llvh/ADT/STLExtras.h"
 #include "llvh/Support/ErrorHandling.h"
 
 #include <cassert>
@@ -43,6 +44,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <limits>
 #include <list>
 #include <random>
 #include <system_error>
@@ -52,9 +54,6 @@ namespace hermes {
 namespace vm {
 
 /// Forward declarations;
-namespace detail {
-struct WeakRefKey;
-}
 template <CellKind C>
 class JSWeakMapImpl;
 using JSWeakMap = JSWeakMapImpl<CellKind::WeakMapKind>;
@@ -485,6 +484,13 @@ class GCBase {
     /// Cumulative number of mark stack overflows in full collections
     /// (zero if non-generational GC).
     unsigned numMarkStackOverflows{0};
+    /// Bytes of the old generation's capacity that are not allocated, and are
+    /// therefore lost to fragmentation until they are reused or compacted
+    /// (zero if the GC doesn't track it).
+    gcheapsize_t fragmentedBytes{0};
+    /// Cumulative number of heap segments that were evacuated by compaction
+    /// (zero if the GC doesn't compact).
+    unsigned numCompactedSegments{0};
     /// Stats for full collections (zeroes if non-generational GC).
     CumulativeHeapStats fullStats;
     /// Stats for collections in the young generation (zeroes if
@@ -669,6 +675,108 @@ class GCBase {
     size_t nextSample();
   };
 
+  /// Tracks how many of the objects allocated by bytecode allocation sites
+  /// survive young generation collections, so that sites whose objects
+  /// usually survive can allocate them directly in the old generation.
+  /// Allocations are sampled by the interpreter; a GC with a young generation
+  /// checks which sampled objects survived while it collects it.
+  class AllocationSiteTracker final {
+   public:
+    /// Sample one in this many allocations at the tracked sites.
+    static constexpr uint32_t kSampleInterval = 64;
+
+    /// Number of samples a site needs before it can be pretenured.
+    static constexpr uint32_t kMinSamples = 32;
+
+    /// Sites whose sampled objects survive at least this often are
+    /// pretenured.
+    static constexpr double kSurvivalThreshold = 0.9;
+
+    /// Stop tracking new sites once this many are tracked.
+    static constexpr uint32_t kMaxSites = 1 << 14;
+
+    /// Cumulative counters, reported in the GC stats.
+    struct Stats {
+      uint64_t sampledObjects{0};
+      uint64_t survivedObjects{0};
+      uint64_t pretenuredSites{0};
+      uint64_t pretenuredObjects{0};
+      uint64_t pretenuredBytes{0};
+    };
+
+    bool isEnabled() const {
+      return enabled_;
+    }
+
+    /// Start sampling allocations. Only GCs that call updateSurvival should
+    /// enable tracking.
+    void enable() {
+      enabled_ = true;
+      countdown_ = kSampleInterval;
+    }
+
+    /// \return true if the allocation being made now should be sampled. When
+    /// tracking is disabled the countdown starts so high that this almost
+    /// never returns true, and sample() ignores it when it does.
+    bool shouldSample() {
+      return LLVM_UNLIKELY(--countdown_ == 0);
+    }
+
+    /// Record that \p cell was allocated in the young generation by the
+    /// instruction at \p offset in \p codeBlock.
+    /// \return true if the site has been pretenured, in which case \p cell
+    ///   isn't sampled.
+    bool sample(const void *codeBlock, uint32_t offset, GCCell *cell);
+
+    /// Record that a pretenured site allocated \p sz bytes in the old
+    /// generation.
+    void recordPretenured(uint32_t sz) {
+      stats_.pretenuredObjects++;
+      stats_.pretenuredBytes += sz;
+    }
+
+    /// Must be called while collecting the young generation, after live
+    /// objects were evacuated and before the young generation is reset.
+    /// \param survived returns whether a sampled young gen cell survived.
+    /// \return the number of sites that were pretenured by this call.
+    uint32_t updateSurvival(llvh::function_ref<bool(GCCell *)> survived);
+
+    /// Drop the samples taken since the last young gen collection without
+    /// counting them, e.g. when the whole young gen is promoted.
+    void clearSamples() {
+      samples_.clear();
+    }
+
+    const Stats &getStats() const {
+      return stats_;
+    }
+
+   private:
+    struct Site {
+      uint32_t sampled{0};
+      uint32_t survived{0};
+      bool pretenured{false};
+    };
+
+    bool enabled_{false};
+
+    /// Allocations left until the next sample.
+    uint32_t countdown_{std::numeric_limits<uint32_t>::max()};
+
+    /// Index into sites_ of each tracked site. CodeBlocks may be freed while
+    /// their entry is still here, so the keys are never dereferenced. A new
+    /// CodeBlock at the same address inherits the entry, which can only
+    /// affect where its objects are allocated.
+    llvh::DenseMap<std::pair<const void *, uint32_t>, uint32_t> siteIndex_;
+
+    std::vector<Site> sites_;
+
+    /// Cells sampled since the last young gen collection, and their site.
+    std::vector<std::pair<GCCell *, uint32_t>> samples_;
+
+    Stats stats_;
+  };
+
   class IDTracker final {
    public:
     /// These are IDs that are reserved for special objects.
@@ -1201,59 +1309,6 @@ class GCBase {
 
   /// Utilities for WeakMap marking.
 
-  /// \return a list of pointers to all the WeakRefKeys in \p weakMap.
-  /// The \p gc argument is passed to methods that verify they're only
-  /// called during GC.
-  static std::vector<detail::WeakRefKey *> buildKeyList(
-      GC *gc,
-      JSWeakMap *weakMap);
-
-  /// For all non-null keys in \p weakMap that are unreachable, clear
-  /// the key (clear the pointer in the WeakRefSlot) and value (set it
-  /// to undefined).
-  template <typename KeyReachableFunc>
-  static void clearEntriesWithUnreachableKeys(
-      GC *gc,
-      JSWeakMap *weakMap,
-      KeyReachableFunc keyReachable);
-
-  /// For all reachable keys in \p weakMap, mark from the
-  /// corresponding value using the given \p acceptor, reaching a
-  /// transitive closure.  The acceptor is required to have a property
-  /// we don't normally require: it must be idempotent.  I.e., it must
-  /// function properly when applied multiple times to the same
-  /// pointer slot during a collection.  "Mark-in-place" acceptors
-  /// will generally have this property.  Uses \p objIsMarked to
-  /// determine whether an object is marked, and, for entries whose
-  /// keys are marked, invokes \p checkValIsMarked on the
-  /// corresponding value.  These have the following specs:
-  ///
-  ///  * objIsMarked: (GCCell*) ==> bool
-  ///    Returns whether a GCCell is marked.
-  ///
-  ///  * markFromVal: GCCell *cell, GCHermesValue &cellRef) ==> bool
-  ///    If the argument is unmarked, mark it, schedule for scanning.
-  ///    Returns whether the object was newly marked.
-  ///
-  /// If the \p unreachableKeys map has an entry for \p weakMap, assumes the
-  /// list of WeakRefKeys contains all possibly-unreachable keys; any
-  /// other keys are assumed to have already been found reachable.
-  /// Ensures that \p unreachableKeys has an accurate value for \p
-  /// weakMap before return.  \return whether any previously-unmarked
-  /// values were marked.
-  template <
-      typename Acceptor,
-      typename ObjIsMarkedFunc,
-      typename MarkFromValFunc>
-  static bool markFromReachableWeakMapKeys(
-      GC *gc,
-      JSWeakMap *weakMap,
-      Acceptor &acceptor,
-      llvh::DenseMap<JSWeakMap *, std::vector<detail::WeakRefKey *>>
-          *unreachableKeys,
-      ObjIsMarkedFunc objIsMarked,
-      MarkFromValFunc markFromVal);
-
   /// \return A reference to the mutex that controls accessing any WeakRef.
   ///   This mutex must be held if a WeakRef is created or modified.
   WeakRefMutex &weakRefMutex() {
@@ -1268,6 +1323,7 @@ class GCBase {
   /// traversal of the WeakMaps.  We assume that WeakMaps found newly
   /// reachable are added to \p reachableWeakMaps, and do not assume
   /// we've reached transitive closure until all maps are scanned.
+  /// Then remove the entries whose keys are unreachable.
   /// Uses \p objIsMarked to determine whether an object is marked,
   /// and, for entries whose keys are marked, invokes \p
   /// checkValIsMarked on the corresponding value.  Used \p
@@ -1282,9 +1338,10 @@ class GCBase {
   ///
   ///  * markFromVal: (GCCell *cell, HermesValue &cellRef) ==> bool
   ///    Requires that \p cell is non-null, and the value of \p
-  ///    cellRef.  If the argument is unmarked, ensure that its
-  ///    transitive closure is marked.  Returns whether the object was
-  ///    newly marked.
+  ///    cellRef.  If the argument is unmarked, mark it and schedule it
+  ///    for scanning; its transitive closure is marked by the next call
+  ///    to \p drainMarkStack.  Returns whether the object was newly
+  ///    marked.
   ///
   ///  * drainMarkStack: (Acceptor &acceptor) ==> void
   ///    Ensures that the mark stack used by the collector is empty;
@@ -1347,6 +1404,10 @@ class GCBase {
     return samplingAllocationTracker_;
   }
 
+  AllocationSiteTracker &getAllocationSiteTracker() {
+    return allocationSiteTracker_;
+  }
+
   /// \name Snapshot ID methods
   /// \{
   // This set of methods are all mirrors of IDTracker, except with pointer
@@ -1627,6 +1688,9 @@ class GCBase {
   /// Attaches stack-traces to objects when enabled.
   SamplingAllocationLocationTracker samplingAllocationTracker_;
 
+  /// Decides which allocation sites allocate in the old generation.
+  AllocationSiteTracker allocationSiteTracker_;
+
 #ifndef NDEBUG
   /// The number of reasons why no allocation is allowed in this heap right
   /// now.
@@ -16,10 +16,13 @@
 #include "hermes/VM/GCBase.h"
 #include "hermes/VM/VMExperiments.h"
 
+#include "llvh/ADT/SmallVector.h"
 #include "llvh/ADT/SparseBitVector.h"
 #include "llvh/Support/ErrorOr.h"
 #include "llvh/Support/PointerLikeTypeTraits.h"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
@@ -544,6 +547,10 @@ class HadesGC final : public GCBase {
     /// \post The returned index is less than kNumFreelistBuckets.
     static uint32_t getFreelistBucket(uint32_t size);
 
+    /// \return the index of the smallest bucket in which every cell is at least
+    /// \p size bytes, or kNumFreelistBuckets if there is no such bucket.
+    static uint32_t getFitFreelistBucket(uint32_t size);
+
     /// Adds the given region of memory to the free list for the segment that is
     /// currently being swept. This does not update the Freelist bits, those
     /// should all be updated in a single pass at the end of sweeping.
@@ -580,17 +587,18 @@ class HadesGC final : public GCBase {
 
     /// The freelist buckets are split into two sections. In the "small"
     /// section, there is one bucket for each size, in multiples of heapAlign.
-    /// In the "large" section, there is a bucket for each power of 2. The
-    /// bucket for a large block is obtained by rounding down to the nearest
-    /// power of 2.
+    /// In the "large" section, each power of 2 is split into
+    /// kNumLargeFreelistSubBuckets equally sized ranges, and there is a bucket
+    /// for each range. The bucket for a large block is obtained by rounding
+    /// down to the start of its range.
 
     /// So for instance, with a heap alignment of 8 bytes, 256 small buckets,
-    /// and a maximum allocation size of 2^21, we would get:
+    /// 4 sub-buckets, and a maximum allocation size of 2^21, we would get:
 
-    /// |    Small section      |  Large section   |
-    /// +----+----+----+   +--------------+   +----+
-    /// | 0  | 8  | 16 |...|2040|2048|4096|...|2^21|
-    /// +----+----+----+   +--------------+   +----+
+    /// |    Small section      |         Large section          |
+    /// +----+----+----+   +--------------------------+   +----+
+    /// | 0  | 8  | 16 |...|2040|2048|2560|3072|3584|...|2^21|
+    /// +----+----+----+   +--------------------------+   +----+
 
     static constexpr size_t kLogNumSmallFreelistBuckets = 8;
     static constexpr size_t kNumSmallFreelistBuckets = 1
@@ -599,16 +607,21 @@ class HadesGC final : public GCBase {
         kLogNumSmallFreelistBuckets + LogHeapAlign;
     static constexpr size_t kMinSizeForLargeBlock = 1
         << kLogMinSizeForLargeBlock;
+    static constexpr size_t kLogNumLargeFreelistSubBuckets = 2;
+    static constexpr size_t kNumLargeFreelistSubBuckets = 1
+        << kLogNumLargeFreelistSubBuckets;
     static constexpr size_t kNumLargeFreelistBuckets =
-        llvh::detail::ConstantLog2<HeapSegment::maxSize()>::value -
-        kLogMinSizeForLargeBlock + 1;
+        (llvh::detail::ConstantLog2<HeapSegment::maxSize()>::value -
+         kLogMinSizeForLargeBlock + 1)
+        << kLogNumLargeFreelistSubBuckets;
     static constexpr size_t kNumFreelistBuckets =
         kNumSmallFreelistBuckets + kNumLargeFreelistBuckets;
 
     /// The below data structures should be used as follows.
-    /// 1. When looking for a given size, first find the smallest appropriate
-    ///    bucket that has any elements at all, by scanning
-    ///    freelistBucketBitArray_.
+    /// 1. When looking for a given size, first find the smallest bucket that
+    ///    has any elements at all and only holds cells that are large enough,
+    ///    by scanning freelistBucketBitArray_. Only if there is none, search
+    ///    the cells of the smaller buckets that may be large enough.
     /// 2. Once a bucket is identified, find a segment that contains cells for
     ///    that bucket using freelistBucketSegmentBitArray_.
     /// 3. Finally, with the given pair of bucket and segment index, obtain the
@@ -779,13 +792,19 @@ class HadesGC final : public GCBase {
   uint64_t ygExternalBytes_{0};
 
   struct CompacteeState {
-    /// \return true if the pointer lives in the segment that is being marked or
-    /// evacuated for compaction.
+    /// The most segments that a single OG collection selects for compaction.
+    static constexpr size_t kMaxSegments = 8;
+
+    /// \return true if the pointer lives in one of the segments that are being
+    /// marked or evacuated for compaction.
     bool contains(const void *p) const {
-      return start == AlignedStorage::start(p);
+      return containsStart(
+          reinterpret_cast<uintptr_t>(AlignedStorage::start(p)),
+          starts,
+          filter);
     }
     bool contains(CompressedPointer p) const {
-      return p.getSegmentStart() == startCP;
+      return containsStart(p.getSegmentStart().getRaw(), startCPs, filterCP);
     }
 
     /// \return true if the pointer lives in the segment that is currently being
@@ -802,58 +821,125 @@ class HadesGC final : public GCBase {
       return evacStart != reinterpret_cast<void *>(kInvalidCompacteeStart);
     }
 
-#ifndef NDEBUG
-    /// \return true if the compactee has not been assigned.
+    /// \return true if there are no segments selected for compaction.
     bool empty() const {
-      void *const invalid = reinterpret_cast<void *>(kInvalidCompacteeStart);
-      return evacStart == invalid && start == invalid && !segment;
+      return segments.empty();
     }
-#endif
+
+    /// \return the segment that the next compacting YG collection evacuates.
+    HeapSegment &front() const {
+      assert(!empty() && "No compactee segments");
+      return *segments.front().segment;
+    }
+
+    /// \return the sum of the allocated bytes of all compactee segments.
+    uint64_t allocatedBytes() const {
+      uint64_t bytes = 0;
+      for (const auto &entry : segments)
+        bytes += entry.allocatedBytes;
+      return bytes;
+    }
+
+    /// Add \p segment, which holds \p allocatedBytes, to the segments that
+    /// will be compacted.
+    void add(
+        PointerBase *base,
+        std::shared_ptr<HeapSegment> segment,
+        uint32_t allocatedBytes);
+
+    /// Order the segments so that the sparsest ones are evacuated first.
+    void sortByAllocatedBytes();
+
+    /// Mark the first segment as the one the next YG collection evacuates.
+    void startEvacuation(PointerBase *base);
+
+    /// Remove the segment that was just evacuated, and start evacuating the
+    /// next one if there is any.
+    /// \return the evacuated segment.
+    std::shared_ptr<HeapSegment> finishEvacuation(PointerBase *base);
 
     /// The following variables track the state of compactions.
-    /// 1. To trigger a compaction, segment and start should be set at the
-    /// beginning of marking. This ensures that all cards containing pointers to
-    /// the compactee will be dirtied.
-    /// 2. Once marking is done, completeMarking should then set evacStart, so
-    /// that the next YG collection will evacuate the segment.
-    /// 3. On completion, the YG collection will reset all these variables.
+    /// 1. To trigger a compaction, segments should be added at the beginning
+    /// of marking. This ensures that all cards containing pointers to the
+    /// compactees will be dirtied.
+    /// 2. Once marking is done, completeMarking should then set evacStart to
+    /// the first segment, so that the next YG collection will evacuate it.
+    /// 3. Each YG collection that evacuates a segment removes it and moves
+    /// evacStart to the next one, so the segments are evacuated incrementally
+    /// over several YG collections. The state is reset after the last one.
 
     /// In order to keep the "contains" check cheap, this can be any non-null
     /// value that cannot correspond to the start of a segment.
     static constexpr uintptr_t kInvalidCompacteeStart = 0x1;
 
-    /// The start address of the segment that will be compacted next. This is
-    /// used during marking and by write barriers to determine whether a pointer
-    /// is in the compactee segment.
-    void *start{reinterpret_cast<void *>(kInvalidCompacteeStart)};
-    AssignableCompressedPointer startCP{
-        CompressedPointer::fromRaw(kInvalidCompacteeStart)};
-
     /// The start address of the segment that is currently being compacted. When
     /// this is set, the next YG will evacuate objects in this segment. This is
-    /// always going to be equal to "start" or nullptr.
+    /// always going to be equal to the start of the first segment, or invalid.
     void *evacStart{reinterpret_cast<void *>(kInvalidCompacteeStart)};
     AssignableCompressedPointer evacStartCP{
         CompressedPointer::fromRaw(kInvalidCompacteeStart)};
 
-    /// The segment being compacted. This should be removed from the OG right
-    /// after it is identified, and freed entirely once the compaction is
-    /// complete.
-    std::shared_ptr<HeapSegment> segment;
+    struct Entry {
+      /// The segment being compacted. This should be removed from the OG right
+      /// after it is identified, and freed entirely once it is evacuated.
+      std::shared_ptr<HeapSegment> segment;
+
+      /// The number of bytes in the segment, should be set before the segment
+      /// is removed from the OG.
+      uint32_t allocatedBytes;
+    };
 
-    /// The number of bytes in the compactee, should be set before the compactee
-    /// is removed from the OG.
-    uint32_t allocatedBytes{0};
+    /// The segments being compacted, in the order they will be evacuated.
+    llvh::SmallVector<Entry, kMaxSegments> segments;
+
+   private:
+    /// The start addresses of the segments, as raw pointers and raw
+    /// compressed pointers, with the unused slots set to
+    /// kInvalidCompacteeStart. They are used by the write barrier and the
+    /// marker to determine whether a pointer is into a compactee.
+    using Starts = std::array<uintptr_t, kMaxSegments>;
+    Starts starts = invalidStarts();
+    Starts startCPs = invalidStarts();
+
+    /// A bit per segment-sized slot of the address space, modulo 64, which is
+    /// set for every compactee. This lets contains() reject most pointers
+    /// with a single test.
+    uint64_t filter{0};
+    uint64_t filterCP{0};
+
+    static Starts invalidStarts() {
+      Starts result;
+      result.fill(kInvalidCompacteeStart);
+      return result;
+    }
+
+    static uint64_t filterBit(uintptr_t start) {
+      return uint64_t{1} << ((start >> AlignedStorage::kLogSize) & 63);
+    }
+
+    static bool
+    containsStart(uintptr_t start, const Starts &all, uint64_t filterBits) {
+      if (LLVM_LIKELY(!(filterBits & filterBit(start))))
+        return false;
+      return std::find(all.begin(), all.end(), start) != all.end();
+    }
+
+    /// Recompute the start addresses and filters from segments.
+    void updateStarts(PointerBase *base);
   } compactee_;
 
   /// If compaction completes before sweeping, there is a possibility that
-  /// dangling pointers into the now freed compactee may remain in the OG heap
+  /// dangling pointers into the now freed compactees may remain in the OG heap
   /// until sweeping finishes. In certain cases, like when scanning dirty cards,
   /// this could cause a segfault if you attempt to say, compress a pointer. To
   /// handle this case, if compaction completes while sweeping is still in
-  /// progress, this shared_ptr will keep the compactee segment alive until the
-  /// end of sweeping.
-  std::shared_ptr<HeapSegment> compacteeHandleForSweep_;
+  /// progress, these shared_ptrs will keep the compactee segments alive until
+  /// the end of sweeping.
+  std::vector<std::shared_ptr<HeapSegment>> compacteeHandlesForSweep_;
+
+  /// The number of segments that were evacuated by compactions and returned
+  /// to the storage provider.
+  unsigned numCompactedSegments_{0};
 
   struct NativeIDs {
     HeapSnapshot::NodeID ygFinalizables{IDTracker::kInvalidNode};
@@ -955,19 +1041,23 @@ class HadesGC final : public GCBase {
   /// heap limit. Should be called at the start of completeMarking.
   void updateOldGenThreshold();
 
-  /// Select a segment to compact and initialise any state needed for
-  /// compaction.
-  /// \param forceCompaction If true, a compactee will be prepared regardless of
+  /// Select the segments to compact and initialise any state needed for
+  /// compaction. When the OG is larger than its target, the sparsest segments
+  /// are selected, up to the number needed to bring it back to its target.
+  /// \param forceCompaction If true, compactees will be prepared regardless of
   ///   heap conditions. Note that if there are no OG heap segments, a
   ///   compaction cannot occur no matter what.
   void prepareCompactee(bool forceCompaction);
 
   /// Search a single segment for pointers that may need to be updated as the
   /// YG/compactee are evacuated.
+  /// \param visitUnmarked If false, skip objects that were not marked by the
+  ///   last OG collection, since they may contain dangling pointers.
   template <bool CompactionEnabled>
   void scanDirtyCardsForSegment(
       SlotVisitor<EvacAcceptor<CompactionEnabled>> &visitor,
-      HeapSegment &segment);
+      HeapSegment &segment,
+      bool visitUnmarked);
 
   /// Find all pointers from OG into the YG/compactee during a YG collection.
   /// This is done quickly through use of write barriers that detect the
@@ -57,6 +57,7 @@ HERMES_VM_GCOBJECT(JSRegExp);
 HERMES_VM_GCOBJECT(JSDate);
 HERMES_VM_GCOBJECT(JSError);
 HERMES_VM_GCOBJECT(JSGenerator);
+HERMES_VM_GCOBJECT(JSPromise);
 HERMES_VM_GCOBJECT(Domain);
 HERMES_VM_GCOBJECT(RequireContext);
 HERMES_VM_GCOBJECT(HashMapEntry);
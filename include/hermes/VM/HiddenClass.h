@@ -18,6 +18,7 @@
 
 #include <functional>
 #include "llvh/ADT/ArrayRef.h"
+#include "llvh/ADT/SmallVector.h"
 
 namespace hermes {
 namespace vm {
@@ -48,6 +49,15 @@ struct ClassFlags {
   /// hidden class is never added to an property cache.
   uint8_t dictionaryNoCacheMode : 1;
 
+  /// If dictionaryMode is set, this indicates that the class never switches
+  /// to dictionaryNoCacheMode. Instead, every deletion or flags update of an
+  /// existing property moves the property map to a fresh dictionary class.
+  /// Since the slot of a property can't change otherwise, property caches
+  /// keyed on the class act as property cells which are invalidated by those
+  /// changes. This is used for the global object, whose properties are
+  /// accessed through caches in most functions.
+  uint8_t dictionaryCellMode : 1;
+
   /// Set when we have index-like named properties (e.g. "0", "1", etc) defined
   /// using defineOwnProperty. Array accesses will have to check the named
   /// properties first. The absence of this flag is important as it indicates
@@ -104,11 +114,21 @@ struct ClassFlags {
 ///
 /// Dictionary Mode
 /// ===============
-/// When more than a predefined number of properties are added (\c
-/// kDictionaryThreshold) or if a property is deleted, a new class is created
-/// without a parent and placed in "dictionary mode". In that mode the class
-/// is not shared - it belongs to exactly one object - and updates are done "in
-/// place" instead of creating new child classes.
+/// When more than a configurable number of properties are added (\c
+/// Runtime::getDictionaryThreshold()) or if a property other than the last
+/// added one is deleted, a new class is created without a parent and placed in
+/// "dictionary mode". In that mode the class is not shared - it belongs to
+/// exactly one object - and updates are done "in place" instead of creating
+/// new child classes.
+///
+/// Deleting the property that was added last simply transitions back to the
+/// parent class, which describes exactly the remaining properties.
+///
+/// A dictionary which has been modified more than once can no longer be used
+/// for property caching (see \c ClassFlags::dictionaryNoCacheMode). If such an
+/// object then stops changing and keeps being accessed, it is "re-shaped":
+/// its properties are added again, in order, starting from the root class,
+/// and it switches to the resulting shared class.
 ///
 /// Property Maps
 /// =============
@@ -275,9 +295,13 @@ class HiddenClass final : public GCCell {
 
  public:
   using Transition = detail::Transition;
-  /// Adding more than this number of properties will switch to "dictionary
-  /// mode".
-  static constexpr unsigned kDictionaryThreshold = 64;
+  /// The largest number of properties after which adding more properties
+  /// switches to "dictionary mode" that can be configured.
+  static constexpr unsigned kMaxDictionaryThreshold = 1024;
+
+  /// The largest supported dictionary re-shape threshold, since lookups are
+  /// counted in a 16-bit field.
+  static constexpr unsigned kMaxDictionaryReshapeThreshold = UINT16_MAX;
 
   static const VTable vt;
 
@@ -319,6 +343,22 @@ class HiddenClass final : public GCCell {
     return flags_.dictionaryNoCacheMode;
   }
 
+  /// \return true if this class is a dictionary in "cell mode", which stays
+  /// cacheable however its properties are modified.
+  bool isDictionaryCellMode() const {
+    assert(
+        (!flags_.dictionaryCellMode || flags_.dictionaryMode) &&
+        "dictionaryCellMode should only be set if dictionaryMode is set.");
+    return flags_.dictionaryCellMode;
+  }
+
+  /// \return true if writes to existing properties of objects with this class
+  /// may be cached. Dictionaries outside of cell mode may update property
+  /// flags in place, which would make a cached write unsafe.
+  bool canCachePropertyWrites() const {
+    return !isDictionary() || isDictionaryCellMode();
+  }
+
   bool getHasIndexLikeProperties() const {
     return flags_.hasIndexLikeProperties;
   }
@@ -452,9 +492,9 @@ class HiddenClass final : public GCCell {
       Runtime *runtime);
 
   /// Update the flags for the properties in the list \p props with \p
-  /// flagsToClear and \p flagsToSet. If in dictionary mode, the properties are
-  /// updated on the hidden class directly; otherwise, create a new dictionary
-  /// hidden class as result. Updating the properties mutates the property map
+  /// flagsToClear and \p flagsToSet. If in dictionary mode (but not cell mode),
+  /// the properties are updated on the hidden class directly; otherwise,
+  /// create a new dictionary hidden class as result. Updating the properties mutates the property map
   /// directly without creating transitions.
   /// \p flagsToClear and \p flagsToSet are masks for updating the property
   /// flags.
@@ -470,6 +510,32 @@ class HiddenClass final : public GCCell {
       PropertyFlags flagsToSet,
       OptValue<llvh::ArrayRef<SymbolID>> props);
 
+  /// Record a property access to an object of this class that could not be
+  /// cached because the class is in dictionaryNoCacheMode.
+  /// \return true if the object has not changed its properties for
+  /// Runtime::getDictionaryReshapeThreshold() such accesses and should now be
+  /// re-shaped. This is returned at most once per class.
+  bool recordNoCacheAccess(Runtime *runtime);
+
+  /// Create a shared class describing the same properties as the dictionary
+  /// \p selfHandle, by adding them again in insertion order starting from the
+  /// root class. Properties get consecutive slots in that order.
+  /// \param[out] oldSlots is set so that the property in slot \c i of the new
+  /// class is in slot \c oldSlots[i] of \p selfHandle.
+  /// \return the new class, or a null handle if the properties can't be
+  ///   described by a shared class.
+  static Handle<HiddenClass> reshapeDictionary(
+      Handle<HiddenClass> selfHandle,
+      Runtime *runtime,
+      llvh::SmallVectorImpl<SlotIndex> &oldSlots);
+
+  /// Move the properties of this class to a new dictionary class in cell mode.
+  /// \pre the class is not in dictionaryNoCacheMode.
+  /// \return the new class.
+  static Handle<HiddenClass> copyToCellDictionary(
+      Handle<HiddenClass> selfHandle,
+      Runtime *runtime);
+
   /// Create a new class where the next slot is reserved, by calling addProperty
   /// with an internal property name. Only slots with index less than
   /// InternalProperty::NumInternalProperties can be reserved.
@@ -572,6 +638,10 @@ class HiddenClass final : public GCCell {
   /// Flags associated with this hidden class.
   ClassFlags flags_{};
 
+  /// In dictionaryNoCacheMode, the number of uncached property accesses since
+  /// the properties were last changed, saturating at the re-shape threshold.
+  uint16_t noCacheAccesses_{0};
+
   /// Total number of properties encoded in the entire chain from this class
   /// to the root. Note that some transitions do not introduce a new property,
   /// so this is not the same as the length of the transition chain.
@@ -133,6 +133,7 @@ class Interpreter {
       InterpreterState &state);
 
   /// Populates an object with literal values from the object buffer.
+  /// \param sizeHint the number of properties in the object literal.
   /// \param numLiterals the amount of literals to read from the buffer.
   /// \param keyBufferIndex the first element of the key buffer to read.
   /// \param valBufferIndex the first element of the val buffer to read.
@@ -140,6 +141,7 @@ class Interpreter {
   static CallResult<PseudoHandle<>> createObjectFromBuffer(
       Runtime *runtime,
       CodeBlock *curCodeBlock,
+      unsigned sizeHint,
       unsigned numLiterals,
       unsigned keyBufferIndex,
       unsigned valBufferIndex);
@@ -326,6 +326,12 @@ class JSArray final : public ArrayImpl {
   static CallResult<Handle<JSArray>>
   create(Runtime *runtime, size_type capacity, size_type length);
 
+  /// Create an instance of Array like create() above, but allocate it and its
+  /// storage directly in the old generation, for allocation sites whose arrays
+  /// usually survive.
+  static CallResult<Handle<JSArray>>
+  createLongLived(Runtime *runtime, size_type capacity, size_type length);
+
   /// A convenience method for setting the \c .length property of the array.
   /// It performs the necessary checks and updates the property. It could fail
   /// if the property is not writable or if there are read-only index-like
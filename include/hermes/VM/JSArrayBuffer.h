@@ -24,6 +24,10 @@ class JSArrayBuffer final : public JSObject {
   // amount is larger than 2 ^ 32 - 1.
   using size_type = std::uint32_t;
 
+  /// A function releasing an external data block, called with the context
+  /// passed to \c setExternalDataBlock.
+  typedef void (*FinalizeExternalDataPtr)(void *context);
+
   static const ObjectVTable vt;
 
   static bool classof(const GCCell *cell) {
@@ -59,6 +63,28 @@ class JSArrayBuffer final : public JSObject {
   ExecutionStatus
   createDataBlock(Runtime *runtime, size_type size, bool zero = true);
 
+  /// Replaces the currently used data block with \p size bytes at \p data,
+  /// which are owned by the caller and are not copied. When the buffer is
+  /// detached or garbage collected, \p finalizePtr is called with \p context
+  /// to release the memory. It may be called on a GC background thread, and
+  /// must not call into the runtime.
+  /// The size counts as external memory of this object, so that holding on
+  /// to large external blocks still triggers collections.
+  /// \return ExecutionStatus::RETURNED iff the block was attached. On failure
+  ///   the finalizer is not called and the caller still owns the memory.
+  ExecutionStatus setExternalDataBlock(
+      Runtime *runtime,
+      uint8_t *data,
+      size_type size,
+      void *context,
+      FinalizeExternalDataPtr finalizePtr);
+
+  /// \return whether the data block is owned by the embedder rather than
+  ///   by this object.
+  bool isExternal() const {
+    return externalFinalize_ != nullptr;
+  }
+
   /// Retrieves a pointer to the held buffer.
   /// \return A pointer to the buffer owned by this object. This can be null
   ///   if the ArrayBuffer is empty.
@@ -97,6 +123,15 @@ class JSArrayBuffer final : public JSObject {
   size_type size_;
   bool attached_;
 
+  /// If the data block is external, the function releasing it and its
+  /// argument. Null for blocks allocated by this object.
+  FinalizeExternalDataPtr externalFinalize_{nullptr};
+  void *externalContext_{nullptr};
+
+  /// Release the data block, whether it is owned by this object or external,
+  /// and debit its size from \p gc.
+  void freeDataBlock(GC *gc);
+
  public:
   JSArrayBuffer(
       Runtime *runtime,
@@ -390,10 +390,23 @@ class JSObject : public GCCell {
       Runtime *runtime,
       Handle<JSObject> parentHandle);
 
+  /// Attempts to allocate a JSObject with the given prototype and room for
+  /// \p capacity properties in its property storage. If allocation fails,
+  /// the GC declares an OOM.
+  static PseudoHandle<JSObject> create(
+      Runtime *runtime,
+      Handle<JSObject> parentHandle,
+      PropStorage::size_type capacity);
+
   /// Attempts to allocate a JSObject with the standard Object prototype.
   /// If allocation fails, the GC declares an OOM.
   static PseudoHandle<JSObject> create(Runtime *runtime);
 
+  /// Allocates a JSObject with the standard Object prototype directly in the
+  /// old generation, for allocation sites whose objects usually survive.
+  /// If allocation fails, the GC declares an OOM.
+  static PseudoHandle<JSObject> createLongLived(Runtime *runtime);
+
   /// Attempts to allocate a JSObject with the standard Object prototype and
   /// property storage preallocated. If allocation fails, the GC declares an
   /// OOM.
@@ -406,9 +419,12 @@ class JSObject : public GCCell {
   /// preallocated. If allocation fails, the GC declares an
   /// OOM.
   /// \param clazz the hidden class for the new object.
+  /// \param capacity the number of properties to reserve room for, if it is
+  ///   larger than the number of properties in \p clazz.
   static PseudoHandle<JSObject> create(
       Runtime *runtime,
-      Handle<HiddenClass> clazz);
+      Handle<HiddenClass> clazz,
+      PropStorage::size_type capacity = 0);
 
   ~JSObject() = default;
 
@@ -1220,6 +1236,20 @@ class JSObject : public GCCell {
       PropertyFlags flagsToSet,
       OptValue<llvh::ArrayRef<SymbolID>> props);
 
+  /// Switch \p selfHandle to a dictionary class in cell mode, so that cached
+  /// accesses to its properties remain valid until a property is deleted or
+  /// redefined. See \c ClassFlags::dictionaryCellMode.
+  static void convertToCellDictionary(
+      Handle<JSObject> selfHandle,
+      Runtime *runtime);
+
+  /// Give \p selfHandle, whose class is a dictionary, a shared class
+  /// describing the same properties, moving the property values to the slots
+  /// of the new class. See \c HiddenClass::reshapeDictionary.
+  /// \return true if the object was re-shaped. If false is returned, nothing
+  ///   was allocated.
+  static bool reshapeDictionary(Handle<JSObject> selfHandle, Runtime *runtime);
+
   /// First call \p indexedCB, passing each indexed property's \c uint32_t
   /// index and \c ComputedPropertyDescriptor. Then call \p namedCB passing each
   /// named property's \c SymbolID and \c  NamedPropertyDescriptor as
@@ -1317,10 +1347,14 @@ class JSObject : public GCCell {
       ObjectVTable::CheckAllOwnIndexedMode mode);
 
   /// Allocate an instance of property storage with the specified size.
+  /// \param capacity the number of properties to reserve room for, so that
+  ///   adding them later doesn't reallocate the storage. Values smaller than
+  ///   \p size are ignored.
   static inline ExecutionStatus allocatePropStorage(
       Handle<JSObject> selfHandle,
       Runtime *runtime,
-      PropStorage::size_type size);
+      PropStorage::size_type size,
+      PropStorage::size_type capacity = 0);
 
   /// Allocate an instance of property storage with the specified size.
   /// If an allocation is required, a handle is allocated internally and the
@@ -1329,7 +1363,8 @@ class JSObject : public GCCell {
   static inline CallResult<PseudoHandle<JSObject>> allocatePropStorage(
       PseudoHandle<JSObject> self,
       Runtime *runtime,
-      PropStorage::size_type size);
+      PropStorage::size_type size,
+      PropStorage::size_type capacity = 0);
 
   /// @}
 
@@ -1626,12 +1661,16 @@ bool JSObject::forEachOwnPropertyWhile(
 inline ExecutionStatus JSObject::allocatePropStorage(
     Handle<JSObject> selfHandle,
     Runtime *runtime,
-    PropStorage::size_type size) {
-  if (LLVM_LIKELY(size <= DIRECT_PROPERTY_SLOTS))
+    PropStorage::size_type size,
+    PropStorage::size_type capacity) {
+  capacity = std::max(size, capacity);
+  if (LLVM_LIKELY(capacity <= DIRECT_PROPERTY_SLOTS))
     return ExecutionStatus::RETURNED;
 
   auto res = PropStorage::create(
-      runtime, size - DIRECT_PROPERTY_SLOTS, size - DIRECT_PROPERTY_SLOTS);
+      runtime,
+      capacity - DIRECT_PROPERTY_SLOTS,
+      size > DIRECT_PROPERTY_SLOTS ? size - DIRECT_PROPERTY_SLOTS : 0);
   if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION))
     return ExecutionStatus::EXCEPTION;
 
@@ -1643,13 +1682,15 @@ inline ExecutionStatus JSObject::allocatePropStorage(
 inline CallResult<PseudoHandle<JSObject>> JSObject::allocatePropStorage(
     PseudoHandle<JSObject> self,
     Runtime *runtime,
-    PropStorage::size_type size) {
-  if (LLVM_LIKELY(size <= DIRECT_PROPERTY_SLOTS))
+    PropStorage::size_type size,
+    PropStorage::size_type capacity) {
+  if (LLVM_LIKELY(
+          size <= DIRECT_PROPERTY_SLOTS && capacity <= DIRECT_PROPERTY_SLOTS))
     return self;
 
   Handle<JSObject> selfHandle = runtime->makeHandle(std::move(self));
   if (LLVM_UNLIKELY(
-          allocatePropStorage(selfHandle, runtime, size) ==
+          allocatePropStorage(selfHandle, runtime, size, capacity) ==
           ExecutionStatus::EXCEPTION)) {
     return ExecutionStatus::EXCEPTION;
   }
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef HERMES_VM_JSPROMISE_H
+#define HERMES_VM_JSPROMISE_H
+
+#include "hermes/VM/ArrayStorage.h"
+#include "hermes/VM/Callable.h"
+#include "hermes/VM/JSObject.h"
+
+namespace hermes {
+namespace vm {
+
+/// ES6.0 25.4 Promise Objects.
+///
+/// The resolution procedure follows the `promise` npm package that Hermes
+/// used to ship as a JS polyfill, so that the ordering of jobs observed by
+/// existing code does not change: a promise resolved with another native
+/// promise adopts its state synchronously instead of going through a
+/// PromiseResolveThenableJob, and foreign thenables are called synchronously.
+///
+/// Reactions are stored natively as (onFulfilled, onRejected, target)
+/// triples. The first one lives inline in the promise, since most promises
+/// only ever have a single reaction; further ones are appended to an
+/// ArrayStorage. When a promise settles, each reaction becomes a job that is
+/// run by \c runReactionJob:
+/// - If the handler is callable, it is called with the settled value and its
+///   completion resolves or rejects the target promise.
+/// - If the handler is undefined, the settled value is passed through to the
+///   target promise.
+/// - If the handler is the GeneratorInnerFunction of an async function (which
+///   user code can never obtain), the async function is resumed with the
+///   settled value and the target is its result promise.
+class JSPromise final : public JSObject {
+  using Super = JSObject;
+  friend void PromiseBuildMeta(const GCCell *cell, Metadata::Builder &mb);
+
+  const static ObjectVTable vt;
+
+ public:
+  /// The [[PromiseState]] internal slot, plus the Adopted state in which the
+  /// promise forwards everything to the promise stored in result_.
+  enum class State : uint8_t {
+    Pending,
+    Fulfilled,
+    Rejected,
+    Adopted,
+  };
+
+  static bool classof(const GCCell *cell) {
+    return cell->getKind() == CellKind::PromiseKind;
+  }
+
+  static CallResult<PseudoHandle<JSPromise>> create(
+      Runtime *runtime,
+      Handle<JSObject> parentHandle);
+
+  /// Create a pending promise whose parent is %PromisePrototype%.
+  static CallResult<PseudoHandle<JSPromise>> create(Runtime *runtime);
+
+  State getState() const {
+    return state_;
+  }
+
+  /// \return the value or reason of a settled promise.
+  HermesValue getResult() const {
+    return result_;
+  }
+
+  /// Follow the chain of adopted promises starting at \p self.
+  /// \return the promise that actually holds the state.
+  static JSPromise *getSettledSource(JSPromise *self);
+
+  /// Resolve \p self with \p resolution.
+  /// Any exception thrown while inspecting \p resolution rejects \p self.
+  /// \return EXCEPTION only for uncatchable errors, or if scheduling a job or
+  /// the rejection tracker failed.
+  static ExecutionStatus
+  resolve(Handle<JSPromise> self, Runtime *runtime, Handle<> resolution);
+
+  /// Resolve \p self with the foreign \p thenable, whose `then` property was
+  /// already read as \p then, by calling it synchronously with resolving
+  /// functions for \p self.
+  static ExecutionStatus resolveWithThen(
+      Handle<JSPromise> self,
+      Runtime *runtime,
+      Handle<JSObject> thenable,
+      Handle<Callable> then);
+
+  /// Reject \p self with \p reason.
+  static ExecutionStatus
+  reject(Handle<JSPromise> self, Runtime *runtime, Handle<> reason);
+
+  /// Register a reaction on \p self, scheduling it right away if \p self is
+  /// already settled. \p onFulfilled and \p onRejected must be callable or
+  /// undefined, and \p target must be a JSPromise or undefined.
+  static ExecutionStatus addReaction(
+      Handle<JSPromise> self,
+      Runtime *runtime,
+      Handle<> onFulfilled,
+      Handle<> onRejected,
+      Handle<> target);
+
+  /// Create the resolving functions of \p self in \p resolveOut and \p
+  /// rejectOut. Between them, they settle \p self at most once.
+  static ExecutionStatus createResolvingFunctions(
+      Handle<JSPromise> self,
+      Runtime *runtime,
+      MutableHandle<NativeFunction> &resolveOut,
+      MutableHandle<NativeFunction> &rejectOut);
+
+  /// \return \p value if it is a promise, otherwise a new promise resolved
+  /// with \p value.
+  static CallResult<Handle<JSPromise>> promiseResolve(
+      Runtime *runtime,
+      Handle<> value);
+
+  /// Native functions taking part in the promise machinery keep their state
+  /// in an ArrayStorage record, stored in their single internal slot.
+  /// \return a record holding \p values.
+  static CallResult<Handle<ArrayStorage>> createRecord(
+      Runtime *runtime,
+      llvh::ArrayRef<Handle<>> values);
+
+  /// Create a native function whose internal slot holds \p record.
+  static Handle<NativeFunction> createRecordFunction(
+      Runtime *runtime,
+      void *context,
+      NativeFunctionPtr functionPtr,
+      unsigned paramCount,
+      Handle<ArrayStorage> record);
+
+  /// \return the record of the native function currently being executed,
+  /// which must have been created by \c createRecordFunction.
+  static ArrayStorage *getCalleeRecord(Runtime *runtime);
+
+  /// Run a reaction job previously scheduled through \c enqueueReactionJob.
+  /// \param handler the handler of the reaction chosen by the settled state.
+  /// \param target the promise to settle with the outcome of the handler.
+  /// \param argument the value or reason of the settled promise.
+  /// \param rejected whether the settled promise was rejected.
+  static ExecutionStatus runReactionJob(
+      Runtime *runtime,
+      Handle<> handler,
+      Handle<> target,
+      Handle<> argument,
+      bool rejected);
+
+  /// Drive the async function whose body is \p inner with the given value
+  /// and action until it either awaits or completes, settling \p outer on
+  /// completion.
+  static ExecutionStatus asyncFunctionResume(
+      Runtime *runtime,
+      Handle<GeneratorInnerFunction> inner,
+      Handle<JSPromise> outer,
+      Handle<> value,
+      GeneratorInnerFunction::Action action);
+
+ public:
+  JSPromise(
+      Runtime *runtime,
+      Handle<JSObject> parent,
+      Handle<HiddenClass> clazz)
+      : JSObject(runtime, &vt.base, *parent, *clazz),
+        reactionOnFulfilled_(
+            HermesValue::encodeEmptyValue(),
+            &runtime->getHeap()) {}
+
+ private:
+  /// Settle \p self and schedule its reactions.
+  static ExecutionStatus settle(
+      Handle<JSPromise> self,
+      Runtime *runtime,
+      State state,
+      Handle<> result);
+
+  /// Schedule a job running a reaction of a promise settled with \p argument.
+  static ExecutionStatus enqueueReactionJob(
+      Runtime *runtime,
+      Handle<> handler,
+      Handle<> target,
+      Handle<> argument,
+      bool rejected);
+
+  /// Report to the rejection tracker registered through
+  /// HermesInternal.enablePromiseRejectionTracker, if any.
+  static ExecutionStatus trackRejection(
+      Handle<JSPromise> self,
+      Runtime *runtime,
+      bool handled);
+
+  /// The number of slots a reaction takes in moreReactions_.
+  static constexpr uint32_t kReactionSize = 3;
+
+  /// [[PromiseState]].
+  State state_{State::Pending};
+
+  /// Whether a reaction has ever been registered on this promise, which
+  /// decides whether a rejection is reported as unhandled.
+  bool isHandled_{false};
+
+  /// [[PromiseResult]], or the adopted promise in the Adopted state.
+  GCHermesValue result_;
+
+  /// The first reaction. reactionOnFulfilled_ is empty when there is none.
+  GCHermesValue reactionOnFulfilled_;
+  GCHermesValue reactionOnRejected_;
+  GCHermesValue reactionTarget_;
+
+  /// Further reactions, in registration order, kReactionSize slots each.
+  GCPointer<ArrayStorage> moreReactions_{nullptr};
+};
+
+} // namespace vm
+} // namespace hermes
+
+#endif
@@ -13,107 +13,24 @@
 #include "hermes/VM/GCPointer.h"
 #include "hermes/VM/JSObject.h"
 #include "hermes/VM/Runtime.h"
+#include "hermes/VM/SegmentedArray.h"
 #include "hermes/VM/WeakRef.h"
 
 namespace hermes {
 namespace vm {
 
-namespace detail {
-
-/// Used as the key to the DenseMap in JSWeakMapImpl.
-/// Packages the hash with the WeakRef itself.
-/// Uses WeakRefs using invalid locations as slots for empty and tombstone keys.
-struct WeakRefKey {
-  /// Actual weak ref stored as the key.
-  WeakRef<JSObject> ref;
-
-  /// GC-stable hash value of the JSObject pointed to by ref, while it's alive.
-  uint32_t hash;
-
-  WeakRefKey(WeakRef<JSObject> ref, uint32_t hash) : ref(ref), hash(hash) {}
-
-  /// Returns the object reference of ref; returns null if ref is not valid.
-  /// Should only be called during GC; the \param gc argument is used only to
-  /// verify this.
-  JSObject *getObject(GC *gc) const;
-};
-
-/// Enable using WeakRef<JSObject> in DenseMap.
-struct WeakRefInfo {
- public:
-  /// \return Empty key which is simply null.
-  static inline WeakRefKey getEmptyKey() {
-    return WeakRefKey{
-        WeakRef<JSObject>(
-            reinterpret_cast<WeakRefSlot *>(static_cast<uintptr_t>(kEmptyKey))),
-        kEmptyKey};
-  }
-  /// \return Empty key which is simply a pointer to 0x1 - don't dereference.
-  static inline WeakRefKey getTombstoneKey() {
-    return WeakRefKey{
-        WeakRef<JSObject>(reinterpret_cast<WeakRefSlot *>(
-            static_cast<uintptr_t>(kTombstoneKey))),
-        kTombstoneKey};
-  }
-  /// \return the hash in \p key.
-  static inline unsigned getHashValue(const WeakRefKey &key) {
-    return key.hash;
-  }
-  /// \return true both arguments are empty, both are tombstone,
-  /// or both point to the same JSObject.
-  /// \pre The weak ref mutex needs to be held before this function is called.
-  static inline bool isEqual(const WeakRefKey &a, const WeakRefKey &b) {
-    const auto *aSlot = a.ref.unsafeGetSlot();
-    const auto *bSlot = b.ref.unsafeGetSlot();
-    // Check if the keys are empty or tombstones, to avoid deferencing them.
-    if (aSlot == bSlot) {
-      return true;
-    }
-    if (reinterpret_cast<uintptr_t>(aSlot) <= kTombstoneKey ||
-        reinterpret_cast<uintptr_t>(bSlot) <= kTombstoneKey) {
-      // aSlot != bSlot and one or both are empty or tombstone.
-      return false;
-    }
-    // Check if the refs are valid.
-    // The underlying object may have been collected already,
-    // but markWeakRefs may not have run at this point.
-    // The value will be cleared on the next GC cycle, but for now,
-    // isValid needs to be checked to avoid an invalid vmcast.
-    return WeakRef<JSObject>::isSlotValid(aSlot) &&
-        WeakRef<JSObject>::isSlotValid(bSlot) &&
-        vmcast<JSObject>(aSlot->value()) == vmcast<JSObject>(bSlot->value());
-  }
-
- private:
-  /// The empty key (used as a pointer and a hash).
-  static constexpr uint32_t kEmptyKey = 0;
-
-  /// The tombstone key (used as a pointer and a hash).
-  static constexpr uint32_t kTombstoneKey = 1;
-
-  static_assert(
-      kEmptyKey < kTombstoneKey,
-      "empty key must be less than tombstone key");
-};
-
-} // namespace detail
-
 /// Base implementation of JSWeakMapImpl methods,
 /// used by both WeakMap and WeakSet, with no templating.
 class JSWeakMapImplBase : public JSObject {
   using Super = JSObject;
-  using WeakRefKey = detail::WeakRefKey;
-  using DenseMapT = llvh::DenseMap<WeakRefKey, uint32_t, detail::WeakRefInfo>;
 
  protected:
   JSWeakMapImplBase(
       Runtime *runtime,
       const VTable *vtp,
       Handle<JSObject> parent,
-      Handle<HiddenClass> clazz,
-      Handle<BigStorage> valueStorage)
-      : JSObject(runtime, vtp, *parent, *clazz),
-        valueStorage_(runtime, *valueStorage, &runtime->getHeap()) {}
+      Handle<HiddenClass> clazz)
+      : JSObject(runtime, vtp, *parent, *clazz) {}
 
  public:
   static const ObjectVTable vt;
@@ -156,156 +73,149 @@ class JSWeakMapImplBase : public JSObject {
       Runtime *runtime,
       Handle<JSObject> key);
 
-  /// \return the size of the internal map, after freeing any freeable slots.
+  /// \return the number of entries in the map, after removing the ones whose
+  /// keys have been collected.
   /// Used for testing purposes.
   static uint32_t
   debugFreeSlotsAndGetSize(PointerBase *base, GC *gc, JSWeakMapImplBase *self);
 
-  /// An iterator over the keys of the map.
-  struct KeyIterator {
-    DenseMapT::iterator mapIter;
+  /// Call \p func(JSObject *key, GCHermesValue &value) for every entry in the
+  /// table, where \p key is null if it has already been collected. \p func
+  /// may pass \p value to \c clearEntryDirect, but must not otherwise modify
+  /// the map. May only be called by the GC, holding the weak ref mutex if the
+  /// mutator is running.
+  /// \param gc Used to verify that the call is during GC, and provides
+  /// a PointerBase.
+  template <typename Func>
+  void forEachEntryDirect(GC *gc, Func func);
 
-    KeyIterator &operator++(int /*dummy*/) {
-      mapIter++;
-      return *this;
-    }
+  /// Remove the entry whose value is \p value, which must have been passed
+  /// to a \c forEachEntryDirect callback during the same GC. The WeakRefSlot
+  /// of its key is no longer marked, and is freed by the GC.
+  /// \param gc Used to verify that the call is during GC.
+  void clearEntryDirect(GC *gc, GCHermesValue &value);
 
-    WeakRefKey &operator*() {
-      return mapIter->first;
-    }
+  /// Return a reference to the slot that contains the pointer to the table.
+  /// Note that this returns a pointer into the interior of an object; must
+  /// not be used in contexts where the object might move.
+  /// \param gc Used to verify that the call is during GC.
+  GCPointerBase &getTableRef(GC *gc);
 
-    WeakRefKey *operator->() {
-      return &mapIter->first;
-    }
+ protected:
+  /// Mark the WeakRefSlots of the keys in the table.
+  /// \pre The weak ref mutex must be held.
+  static void _markWeakImpl(GCCell *cell, WeakRefAcceptor &acceptor);
 
-    bool operator!=(const KeyIterator &other) {
-      return mapIter != other.mapIter;
-    }
-  };
+ private:
+  /// The initial number of entries in the table.
+  static constexpr uint32_t kInitialCapacity = 8;
 
-  // Return begin and end iterators for the keys of the map.
-  KeyIterator keys_begin();
-  KeyIterator keys_end();
+  /// The number of table slots used by a single entry: the key and the value.
+  static constexpr uint32_t kEntrySize = 2;
 
-  /// Returns a pointer to the HermesValue corresponding to the given \p key.
-  /// Returns nullptr if \p key is not in the map.  May only be
-  /// called during GC.  Note that this returns a pointer into the interior
-  /// of an object; must not be used in contexts where the object might move.
-  /// \param gc Used to verify that the call is during GC, and provides
-  /// a PointerBase.
-  GCHermesValue *getValueDirect(GC *gc, const WeakRefKey &key);
-
-  /// Return a reference to the slot that contains the pointer to the storage
-  /// for the values of the weak map.  Note that this returns a pointer into the
-  /// interior of an object; must not be used in contexts where the object might
-  /// move.
-  /// \param GC Used to verify that the call is during GC.
-  GCPointerBase &getValueStorageRef(GC *GC);
-
-  /// If the given \p key is in the map, clears the entry
-  /// corresponding to \p key -- clears the slot of the WeakRef in
-  /// key, and sets the value to the empty HermesValue.  May only be
-  /// called during GC.
-  /// \param gc Used to verify that the call is during GC, and provides
-  /// a PointerBase.
-  /// \return whether the key was in the map.
-  bool clearEntryDirect(GC *gc, const WeakRefKey &key);
+  /// Return value of \c findEntry when the key isn't in the table.
+  static constexpr uint32_t kNotFound = UINT32_MAX;
 
- protected:
-  static void _finalizeImpl(GCCell *cell, GC *gc) {
-    auto *self = vmcast<JSWeakMapImplBase>(cell);
-    self->~JSWeakMapImplBase();
+  /// The key of an unused entry.
+  static HermesValue emptyKey() {
+    return HermesValue::encodeEmptyValue();
   }
 
-  /// Mark weak references and set hasFreeableSlots_ if invalidated slots
-  /// were found.
-  /// \pre The weak ref mutex must be held.
-  static void _markWeakImpl(GCCell *cell, WeakRefAcceptor &acceptor);
-
-  static size_t _mallocSizeImpl(GCCell *cell) {
-    auto *self = vmcast<JSWeakMapImplBase>(cell);
-    return self->getMallocSize();
+  /// The key of a deleted entry. Unlike an unused entry, it doesn't end a
+  /// lookup.
+  static HermesValue deletedKey() {
+    return HermesValue::encodeNativeUInt32(0);
   }
 
-  static void _snapshotAddEdgesImpl(GCCell *cell, GC *gc, HeapSnapshot &snap);
-  static void _snapshotAddNodesImpl(GCCell *cell, GC *gc, HeapSnapshot &snap);
-
-  /// Iterate the slots in map_ and call deleteInternal on any invalid
-  /// references, adding all available slots to the free list.
-  void findAndDeleteFreeSlots(PointerBase *base, GC *gc);
+  /// \return whether \p key is the key of an entry that is in use.
+  static bool isLiveKey(HermesValue key) {
+    return key.isDouble();
+  }
 
-  /// Erase the map entry and corresponding valueStorage entry
-  /// pointed to by the iterator \p it.
-  /// Add the newly opened valueStorage slot to the free list.
-  void deleteInternal(PointerBase *base, GC *gc, DenseMapT::iterator it);
+  /// \return the WeakRefSlot stored in the key \p key of an entry in use.
+  static WeakRefSlot *getKeySlot(HermesValue key) {
+    assert(isLiveKey(key) && "not the key of an entry in use");
+    return key.getNativePointer<WeakRefSlot>();
+  }
 
- private:
-  /// Get the index to insert a new value into valueStorage_.
-  /// Resize valueStorage_ if no such spots exist.
-  /// \return the index into which to insert, or EXCEPTION if resize failed.
-  static CallResult<uint32_t> getFreeValueStorageIndex(
+  /// \return the number of entries the table has room for.
+  uint32_t capacity(PointerBase *base) const;
+
+  /// \return the hash of \p key, whose object ID must have been assigned.
+  static uint32_t hashKey(JSObject *key);
+
+  /// \return the index of the entry whose key is \p key, which hashes to \p
+  /// hash, or kNotFound.
+  uint32_t findEntry(PointerBase *base, JSObject *key, uint32_t hash) const;
+
+  /// Store \p slot and \p value in the first unused or deleted entry for
+  /// \p hash in \p table. The key must not already be in \p table.
+  /// \return whether a deleted entry was reused.
+  static bool insertEntry(
+      BigStorage *table,
+      GC *gc,
+      uint32_t hash,
+      WeakRefSlot *slot,
+      HermesValue value);
+
+  /// Turn the entry at \p index into a deleted entry.
+  void deleteEntry(PointerBase *base, GC *gc, uint32_t index);
+
+  /// Make room for at least one more entry, allocating a new table large
+  /// enough for twice the live entries, and dropping the deleted entries and
+  /// the ones whose keys have been collected.
+  static ExecutionStatus rehash(
       Handle<JSWeakMapImplBase> self,
       Runtime *runtime);
 
- public:
-  // Public for tests.
-
-  /// Lazily fetches the ID for the DenseMap used in this class. After it has
-  /// been assigned once it'll stay constant.
-  HeapSnapshot::NodeID getMapID(GC *gc);
+  /// The hash table, with kEntrySize slots per entry: the key is an encoded
+  /// native pointer to the WeakRefSlot of the key object, and the value
+  /// follows it. The table is linearly probed, and its capacity is a power of
+  /// two. Keeping the values next to their keys in a GC-managed cell lets the
+  /// GC visit the entries of a WeakMap in order, without any lookups.
+  /// Null until the first entry is added.
+  GCPointer<BigStorage> table_{nullptr};
 
-  /// \return the number of bytes allocated by this object on the heap.
-  size_t getMallocSize() const {
-    return map_.getMemorySize();
-  }
+  /// The number of entries with a key, including the ones whose keys have
+  /// been collected but which haven't been removed yet.
+  uint32_t numEntries_{0};
 
- private:
-  /// The underlying weak value map.
-  DenseMapT map_;
-
-  /// Value storage, used to keep the HermesValues out of the DenseMap.
-  /// If a value is kFreeListInvalid it's free to use.
-  /// If a value can be found by following indices starting at freeListHead_,
-  /// it's also free to use.
-  /// The last member of this linked list of free spots is kFreeListInvalid.
-  GCPointer<BigStorage> valueStorage_;
-
-  /// Number indicating the end of the free list.
-  static constexpr uint32_t kFreeListInvalid{UINT32_MAX};
-
-  /// Index of the first free spot in the valueStorage_ free list.
-  /// If kFreeListInvalid, then the free list is completely empty,
-  /// and the nextIndex_ should be used.
-  uint32_t freeListHead_{kFreeListInvalid};
-
-  /// Next index to use when the free list runs out of elements.
-  uint32_t nextIndex_{0};
-
-  /// This is set to true when markWeakRefs sees an invalid slot which can be
-  /// freed later.
-  /// When set to true, the WeakMap should look for free slots the next time
-  /// the user tries to add an element.
-  bool hasFreeableSlots_{false};
+  /// The number of deleted entries, which still take part in lookups.
+  uint32_t numDeleted_{0};
 };
 
+template <typename Func>
+void JSWeakMapImplBase::forEachEntryDirect(GC *gc, Func func) {
+  assert(gc->calledByGC() && "Should only be used by the GC implementation.");
+  BigStorage *table = table_.get(gc->getPointerBase());
+  if (!table) {
+    return;
+  }
+  for (uint32_t i = 0, e = table->size(); i < e; i += kEntrySize) {
+    GCHermesValue &key = table->atRef(i);
+    if (!isLiveKey(key)) {
+      continue;
+    }
+    WeakRefSlot *slot = getKeySlot(key);
+    func(
+        slot->hasPointer() ? static_cast<JSObject *>(slot->getPointer())
+                           : nullptr,
+        table->atRef(i + 1));
+  }
+}
+
 /// Underlying representation of the WeakMap and WeakSet objects.
 ///
-/// The keys are stored in a `DenseMap<WeakRefKey, uint32_t>`,
-/// which allows storing the hashes with the keys,
-/// so that the DenseMap can compute the hashes
-/// without being given a Runtime.
-/// We can't store the hashes separately because the DenseMap
-/// needs to be able to compute hashes based on only the KeyT,
-/// because the map rehashes when growing itself,
-/// and it doesn't store the LookupKeyT if using find_as or insert_as.
+/// The keys and values are stored next to each other in an open addressing
+/// hash table, which is a GC-managed BigStorage. Keys are held through
+/// WeakRefs, hashed by the object ID of the key, which doesn't change when
+/// the key moves.
 ///
-/// The values in the map_ are indices into valueStorage_,
-/// which is where we store the actual values.
-/// valueStorage_ is a GC-managed PropStorage,
-/// and the indices in map_ are gotten either via the free list
-/// or, if that's empty, via the nextIndex_ field.
-/// If we run out of slots, we double the size of valueStorage_.
-/// Currently, we never shrink it.
+/// WeakMaps are ephemeron tables: the GC only marks the value of an entry once
+/// its key has been found reachable, and removes the entries whose keys are
+/// unreachable (see GCBase::completeWeakMapMarking). WeakSets have no values to
+/// worry about, so their tables are marked normally, and entries whose keys
+/// were collected are removed the next time the table is rehashed.
 template <CellKind C>
 class JSWeakMapImpl final : public JSWeakMapImplBase {
   using Super = JSWeakMapImplBase;
@@ -327,9 +237,8 @@ class JSWeakMapImpl final : public JSWeakMapImplBase {
   JSWeakMapImpl(
       Runtime *runtime,
       Handle<JSObject> parent,
-      Handle<HiddenClass> clazz,
-      Handle<BigStorage> valueStorage)
-      : JSWeakMapImplBase(runtime, &vt.base, parent, clazz, valueStorage) {}
+      Handle<HiddenClass> clazz)
+      : JSWeakMapImplBase(runtime, &vt.base, parent, clazz) {}
 };
 
 using JSWeakMap = JSWeakMapImpl<CellKind::WeakMapKind>;
@@ -10,6 +10,7 @@
 
 #include "hermes/VM/SymbolID.h"
 #include "llvh/ADT/DenseMap.h"
+#include "llvh/ADT/DenseSet.h"
 
 namespace hermes {
 namespace inst {
@@ -51,8 +52,11 @@ class InlineCacheProfiler {
     }
 
     /// Increment the inline caching hit count for a pair of hidden classes.
-    void incrementHit() {
+    /// \p recovered indicates that the hit was on a recovered hidden class.
+    void incrementHit(bool recovered) {
       ++hitCount;
+      if (recovered)
+        ++recoveredHitCount;
     }
 
     /// Total number of inline caching misses at the source location.
@@ -61,6 +65,10 @@ class InlineCacheProfiler {
     /// Total number of inline caching hits at the source location.
     uint64_t hitCount{0};
 
+    /// Number of inline caching hits at the source location on recovered
+    /// hidden classes.
+    uint64_t recoveredHitCount{0};
+
     /// Internal map that keeps track of the mapping between
     /// <property, object hidden class, cached hidden class> and its frequency.
     llvh::DenseMap<ICMissKey, uint64_t> hiddenClasses;
@@ -80,8 +88,13 @@ class InlineCacheProfiler {
       ClassId objectHiddenClassId,
       ClassId cachedHiddenClassId);
 
-  /// Record an inline caching hit.
-  bool insertICHit(CodeBlock *codeblock, uint32_t instOffset);
+  /// Record an inline caching hit on the hidden class \p classId.
+  bool insertICHit(CodeBlock *codeblock, uint32_t instOffset, ClassId classId);
+
+  /// Record that an object left dictionary mode for the shared hidden class
+  /// \p classId, either by deleting its last added property or by being
+  /// re-shaped. Cache hits on such classes are reported as recovered.
+  void insertRecoveredClass(ClassId classId);
 
   /// Get the total number of inline caching misses.
   uint32_t getTotalMisses() {
@@ -159,6 +172,16 @@ class InlineCacheProfiler {
   /// Total number of inline caching hits during the program execution.
   uint64_t totalHits_{0};
 
+  /// Total number of inline caching hits on recovered hidden classes.
+  uint64_t totalRecoveredHits_{0};
+
+  /// Number of times an object was moved to a recovered hidden class.
+  uint64_t totalRecoveries_{0};
+
+  /// Hidden classes that objects were moved to instead of staying in, or
+  /// entering, dictionary mode.
+  llvh::DenseSet<ClassId> recoveredClasses_;
+
   /// Store the data structure of all inline caching misses information.
   /// The map is keyed by pairs <instruction offset, CodeBlock> and maps
   /// to ICMiss objects, which keeps track of hidden classes and frequency.
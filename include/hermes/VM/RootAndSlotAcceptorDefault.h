@@ -122,6 +122,10 @@ class WeakAcceptorDefault : public WeakRefAcceptor, public WeakRootAcceptor {
 
   void acceptWeak(WeakRootBase &ptr) final;
 
+  PointerBase *getPointerBase() const final {
+    return pointerBaseForWeakRoot_;
+  }
+
   /// Subclasses override this implementation instead of accept(WeakRootBase &).
   virtual void acceptWeak(GCCell *&ptr) = 0;
 
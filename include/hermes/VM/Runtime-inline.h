@@ -22,7 +22,23 @@ inline Callable *Runtime::getBuiltinCallable(unsigned builtinMethodID) {
 }
 
 inline void Runtime::enqueueJob(Callable *job) {
-  jobQueue_.push_back(job);
+  jobQueue_.push_back(
+      Job{HermesValue::encodeObjectValue(job),
+          HermesValue::encodeUndefinedValue(),
+          HermesValue::encodeUndefinedValue(),
+          Job::Kind::Thunk});
+}
+
+inline void Runtime::enqueuePromiseJob(
+    HermesValue handler,
+    HermesValue target,
+    HermesValue argument,
+    bool rejected) {
+  jobQueue_.push_back(
+      Job{handler,
+          target,
+          argument,
+          rejected ? Job::Kind::Rejected : Job::Kind::Fulfilled});
 }
 
 inline Handle<HiddenClass> Runtime::getHiddenClassForPrototype(
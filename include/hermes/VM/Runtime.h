@@ -394,6 +394,14 @@ class Runtime : public HandleRootOwner,
   /// See \c jobQueue_ for how the Jobs and Job Queues are set up in Hermes.
   inline void enqueueJob(Callable *job);
 
+  /// Enqueue a Promise reaction job, to be run natively by
+  /// \c JSPromise::runReactionJob with the given arguments.
+  inline void enqueuePromiseJob(
+      HermesValue handler,
+      HermesValue target,
+      HermesValue argument,
+      bool rejected);
+
   /// ES6-ES11 8.6 RunJobs ( )
   /// Draining the job queue by invoking the queued jobs in FIFO order.
   ///
@@ -852,6 +860,18 @@ class Runtime : public HandleRootOwner,
     return hasIntl_;
   }
 
+  /// \return the number of properties after which hidden classes switch to
+  /// dictionary mode.
+  unsigned getDictionaryThreshold() const {
+    return dictionaryThreshold_;
+  }
+
+  /// \return the number of uncached accesses after which an unchanging
+  /// non-cacheable dictionary object is re-shaped, or 0 if never.
+  unsigned getDictionaryReshapeThreshold() const {
+    return dictionaryReshapeThreshold_;
+  }
+
   bool useJobQueue() const {
     return getVMExperimentFlags() & experiments::JobQueue;
   }
@@ -929,6 +949,10 @@ class Runtime : public HandleRootOwner,
       HiddenClass *objectHiddenClass,
       HiddenClass *cachedHiddenClass);
 
+  /// Record that an object moved to the shared class \p hc instead of
+  /// staying in, or entering, dictionary mode.
+  void recordRecoveredHiddenClass(HiddenClass *hc);
+
   /// Resolve HiddenClass pointers from its hidden class Id.
   HiddenClass *resolveHiddenClassId(ClassId classId);
 
@@ -1109,6 +1133,14 @@ class Runtime : public HandleRootOwner,
   /// Set to true if we should randomize stack placement etc.
   const bool shouldRandomizeMemoryLayout_;
 
+  /// Number of properties after which hidden classes switch to dictionary
+  /// mode.
+  const unsigned dictionaryThreshold_;
+
+  /// Number of uncached accesses after which an unchanging non-cacheable
+  /// dictionary object is given a shared class again. 0 disables it.
+  const unsigned dictionaryReshapeThreshold_;
+
   // Percentage in [0,100] of bytecode we should eagerly read into page cache.
   const uint8_t bytecodeWarmupPercent_;
 
@@ -1230,11 +1262,12 @@ class Runtime : public HandleRootOwner,
   /// But it is also possible to implement the HTML defined `queueMicrotask`,
   /// which is polyfill-able via Promise, by directly enqueuing into this job.
   ///
-  /// Job are represented as callables with no parameters and would be invoked
-  /// via \c executeCall0 in Hermes. It's safe to do so because:
-  /// - Promise Jobs enqueued from Promise internal bytecode are thunks (or, in
-  /// the ES12 wording, Promise Jobs are Abstract Closure with no parameters).
-  /// - `queueMicrotask` take a JSFunction but only invoke it with 0 arguments.
+  /// Jobs enqueued through \c enqueueJob are callables with no parameters and
+  /// are invoked via \c executeCall0, since `queueMicrotask` takes a
+  /// JSFunction but only invokes it with 0 arguments.
+  /// Promise Jobs are enqueued by the native Promise implementation as plain
+  /// records of the reaction to run, so that neither enqueuing nor running
+  /// them allocates a closure.
   ///
   /// Although ES12 (9.4 Jobs and Host Operations to Enqueue Jobs) changed the
   /// meta-language to ask hosts to schedule Promise Job to integrate with the
@@ -1242,7 +1275,22 @@ class Runtime : public HandleRootOwner,
   /// approach, similar to other engines, e.g. V8/JSC, which is more efficient
   /// (being able to batch the job invocations) and sufficient to express the
   /// HTML spec specified "perform a microtask checkpoint" algorithm.
-  std::deque<Callable *> jobQueue_{};
+  struct Job {
+    enum class Kind : uint8_t {
+      /// A thunk stored in handler.
+      Thunk,
+      /// A reaction to a promise fulfilled with argument.
+      Fulfilled,
+      /// A reaction to a promise rejected with argument.
+      Rejected,
+    };
+
+    PinnedHermesValue handler;
+    PinnedHermesValue target;
+    PinnedHermesValue argument;
+    Kind kind;
+  };
+  std::deque<Job> jobQueue_{};
 
 #ifdef HERMESVM_PROFILER_BB
   BasicBlockExecutionInfo basicBlockExecInfo_;
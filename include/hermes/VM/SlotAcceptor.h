@@ -43,6 +43,9 @@ struct SlotAcceptor {
 struct WeakRefAcceptor {
   virtual ~WeakRefAcceptor() = default;
   virtual void accept(WeakRefBase &wr) = 0;
+  /// \return the PointerBase used to decompress the pointers of the cell
+  /// whose weak references are being accepted.
+  virtual PointerBase *getPointerBase() const = 0;
 };
 
 struct RootSectionAcceptor {
@@ -571,6 +571,44 @@ BCProviderFromBuffer::BCProviderFromBuffer(
   cjsModuleTable_ = fields.cjsModuleTable;
   cjsModuleTableStatic_ = fields.cjsModuleTableStatic;
   functionSourceTable_ = fields.functionSourceTable;
+  // The debug info runs until the footer.
+  storedDebugInfo_ = llvh::ArrayRef<uint8_t>(
+      bufferPtr_ + debugInfoOffset_,
+      bufferPtr_ + fileHeader->fileLength - sizeof(BytecodeFileFooter));
+  if (options_.compressedSections && !initCompressedSections()) {
+    return;
+  }
+}
+
+bool BCProviderFromBuffer::initCompressedSections() {
+  for (size_t i = 0; i < static_cast<size_t>(CompressedSectionKind::_count);
+       ++i) {
+    auto kind = static_cast<CompressedSectionKind>(i);
+    if (!compressedSectionViews_[i].init(getStoredSection(kind), &errstr_)) {
+      return false;
+    }
+  }
+  compressedSections_ = true;
+  return true;
+}
+
+llvh::ArrayRef<uint8_t> BCProviderFromBuffer::getStoredSection(
+    CompressedSectionKind kind) const {
+  switch (kind) {
+    case CompressedSectionKind::StringStorage:
+      return stringStorage_;
+    case CompressedSectionKind::ArrayBuffer:
+      return arrayBuffer_;
+    case CompressedSectionKind::ObjectKeyBuffer:
+      return objKeyBuffer_;
+    case CompressedSectionKind::ObjectValueBuffer:
+      return objValueBuffer_;
+    case CompressedSectionKind::DebugInfo:
+      return storedDebugInfo_;
+    case CompressedSectionKind::_count:
+      break;
+  }
+  llvm_unreachable("invalid compressed section kind");
 }
 
 llvh::ArrayRef<uint8_t> BCProviderFromBuffer::getEpilogue() const {
@@ -605,13 +643,17 @@ SHA1 BCProviderFromBuffer::getSourceHashFromBytecode(
 }
 
 void BCProviderFromBuffer::createDebugInfo() {
-  const auto *buf = bufferPtr_ + debugInfoOffset_;
+  llvh::ArrayRef<uint8_t> section = compressedSections_
+      ? getDecompressedSection(CompressedSectionKind::DebugInfo)
+      : storedDebugInfo_;
+  const auto *buf = section.begin();
+  const auto *end = section.end();
   const auto *header = castData<hbc::DebugInfoHeader>(buf);
 
   auto filenameTable =
-      castArrayRef<StringTableEntry>(buf, header->filenameCount, end_);
+      castArrayRef<StringTableEntry>(buf, header->filenameCount, end);
   auto filenameStorage =
-      castArrayRef<unsigned char>(buf, header->filenameStorageSize, end_);
+      castArrayRef<unsigned char>(buf, header->filenameStorageSize, end);
 
   hbc::DebugInfo::DebugFileRegionList files;
   for (unsigned i = 0; i < header->fileRegionCount; i++) {
@@ -132,6 +132,7 @@ void BytecodeDisassembler::disassembleBytecodeFileHeader(raw_ostream &OS) {
   OS << "    staticBuiltins: " << bcopts.staticBuiltins << "\n";
   OS << "    cjsModulesStaticallyResolved: "
      << bcopts.cjsModulesStaticallyResolved << "\n";
+  OS << "    compressedSections: " << bcopts.compressedSections << "\n";
   OS << "\n";
 }
 
@@ -791,20 +792,20 @@ BytecodeSectionWalker::BytecodeSectionWalker(
       bcProvider->getOverflowStringTableEntries().end());
   addSection(
       "String storage",
-      bcProvider->getStringStorage().begin(),
-      bcProvider->getStringStorage().end());
+      bcProvider->getStoredSection(CompressedSectionKind::StringStorage).begin(),
+      bcProvider->getStoredSection(CompressedSectionKind::StringStorage).end());
   addSection(
       "Array buffer",
-      bcProvider->getArrayBuffer().begin(),
-      bcProvider->getArrayBuffer().end());
+      bcProvider->getStoredSection(CompressedSectionKind::ArrayBuffer).begin(),
+      bcProvider->getStoredSection(CompressedSectionKind::ArrayBuffer).end());
   addSection(
       "Object key buffer",
-      bcProvider->getObjectKeyBuffer().begin(),
-      bcProvider->getObjectKeyBuffer().end());
+      bcProvider->getStoredSection(CompressedSectionKind::ObjectKeyBuffer).begin(),
+      bcProvider->getStoredSection(CompressedSectionKind::ObjectKeyBuffer).end());
   addSection(
       "Object value buffer",
-      bcProvider->getObjectValueBuffer().begin(),
-      bcProvider->getObjectValueBuffer().end());
+      bcProvider->getStoredSection(CompressedSectionKind::ObjectValueBuffer).begin(),
+      bcProvider->getStoredSection(CompressedSectionKind::ObjectValueBuffer).end());
   addSection(
       "Regular expression table",
       bcProvider->getRegExpTable().begin(),
@@ -7,12 +7,19 @@
 
 #include "hermes/BCGen/HBC/BytecodeStream.h"
 
+#include "hermes/BCGen/HBC/CompressedSection.h"
+
 using namespace hermes;
 using namespace hbc;
 
 // ============================ File ============================
 void BytecodeSerializer::serialize(BytecodeModule &BM, const SHA1 &sourceHash) {
   bytecodeModule_ = &BM;
+  if (isLayout_ && options_.compressSections) {
+    compressSections(BM);
+  }
+  BytecodeOptions bytecodeOptions = BM.getBytecodeOptions();
+  bytecodeOptions.compressedSections = options_.compressSections;
   uint32_t cjsModuleCount = BM.getBytecodeOptions().cjsModulesStaticallyResolved
       ? BM.getCJSModuleTableStatic().size()
       : BM.getCJSModuleTable().size();
@@ -27,17 +34,21 @@ void BytecodeSerializer::serialize(BytecodeModule &BM, const SHA1 &sourceHash) {
       BM.getIdentifierCount(),
       BM.getStringTableSize(),
       overflowStringEntryCount_,
-      BM.getStringStorageSize(),
+      storedSize(
+          CompressedSectionKind::StringStorage, BM.getStringStorageSize()),
       static_cast<uint32_t>(BM.getRegExpTable().size()),
       static_cast<uint32_t>(BM.getRegExpStorage().size()),
-      BM.getArrayBufferSize(),
-      BM.getObjectKeyBufferSize(),
-      BM.getObjectValueBufferSize(),
+      storedSize(CompressedSectionKind::ArrayBuffer, BM.getArrayBufferSize()),
+      storedSize(
+          CompressedSectionKind::ObjectKeyBuffer, BM.getObjectKeyBufferSize()),
+      storedSize(
+          CompressedSectionKind::ObjectValueBuffer,
+          BM.getObjectValueBufferSize()),
       BM.getSegmentID(),
       cjsModuleCount,
       static_cast<uint32_t>(BM.getFunctionSourceTable().size()),
       debugInfoOffset_,
-      BM.getBytecodeOptions()};
+      bytecodeOptions};
   writeBinary(header);
   // Sizes of file and function headers are tuned for good cache line packing.
   // If you reorder the format, try to avoid headers crossing cache lines.
@@ -88,15 +99,33 @@ void BytecodeSerializer::serializeFunctionTable(BytecodeModule &BM) {
 // ========================== DebugInfo ==========================
 void BytecodeSerializer::serializeDebugInfo(BytecodeModule &BM) {
   pad(BYTECODE_ALIGNMENT);
-  const DebugInfo &info = BM.getDebugInfo();
   debugInfoOffset_ = loc_;
 
+  if (options_.compressSections) {
+    writeBinaryArray(getCompressedSection(CompressedSectionKind::DebugInfo));
+    return;
+  }
+
+  std::vector<uint8_t> raw;
+  encodeDebugInfo(BM, raw);
+  writeBinaryArray(llvh::makeArrayRef(raw));
+}
+
+void BytecodeSerializer::encodeDebugInfo(
+    BytecodeModule &BM,
+    std::vector<uint8_t> &out) {
+  auto append = [&out](const void *p, size_t size) {
+    const auto *bytes = reinterpret_cast<const uint8_t *>(p);
+    out.insert(out.end(), bytes, bytes + size);
+  };
+
   if (options_.stripDebugInfoSection) {
     const DebugInfoHeader empty = {0, 0, 0, 0, 0};
-    writeBinary(empty);
+    append(&empty, sizeof(empty));
     return;
   }
 
+  const DebugInfo &info = BM.getDebugInfo();
   const llvh::ArrayRef<StringTableEntry> filenameTable =
       info.getFilenameTable();
   const auto filenameStorage = info.getFilenameStorage();
@@ -110,13 +139,33 @@ void BytecodeSerializer::serializeDebugInfo(BytecodeModule &BM) {
       (uint32_t)files.size(),
       lexOffset,
       (uint32_t)data.size()};
-  writeBinary(header);
-  writeBinaryArray(filenameTable);
-  writeBinaryArray(filenameStorage);
+  append(&header, sizeof(header));
+  append(filenameTable.data(), filenameTable.size() * sizeof(StringTableEntry));
+  append(filenameStorage.data(), filenameStorage.size());
   for (auto &file : files) {
-    writeBinary(file);
+    append(&file, sizeof(file));
   }
-  writeBinaryArray(data.getData());
+  append(data.getData().data(), data.size());
+}
+
+// ====================== Compressed Sections =======================
+void BytecodeSerializer::compressSections(BytecodeModule &BM) {
+  auto compress = [this](CompressedSectionKind kind, ArrayRef<uint8_t> raw) {
+    auto &out = compressedSections_[static_cast<size_t>(kind)];
+    out.clear();
+    compressSection(raw, out);
+  };
+  compress(CompressedSectionKind::StringStorage, BM.getStringStorage());
+  compress(CompressedSectionKind::ArrayBuffer, BM.getArrayBuffer());
+  auto objectKeyValBufferPair = BM.getObjectBuffer();
+  compress(
+      CompressedSectionKind::ObjectKeyBuffer, objectKeyValBufferPair.first);
+  compress(
+      CompressedSectionKind::ObjectValueBuffer, objectKeyValBufferPair.second);
+
+  std::vector<uint8_t> debugInfo;
+  encodeDebugInfo(BM, debugInfo);
+  compress(CompressedSectionKind::DebugInfo, debugInfo);
 }
 
 // ===================== CommonJS Module Table ======================
@@ -284,22 +333,41 @@ void BytecodeSerializer::visitOverflowStringTable() {
 
 void BytecodeSerializer::visitStringStorage() {
   pad(BYTECODE_ALIGNMENT);
+  if (options_.compressSections) {
+    writeBinaryArray(
+        getCompressedSection(CompressedSectionKind::StringStorage));
+    return;
+  }
   writeBinaryArray(bytecodeModule_->getStringStorage());
 }
 
 void BytecodeSerializer::visitArrayBuffer() {
   pad(BYTECODE_ALIGNMENT);
+  if (options_.compressSections) {
+    writeBinaryArray(getCompressedSection(CompressedSectionKind::ArrayBuffer));
+    return;
+  }
   serializeArrayBuffer(*bytecodeModule_);
 }
 
 void BytecodeSerializer::visitObjectKeyBuffer() {
   pad(BYTECODE_ALIGNMENT);
+  if (options_.compressSections) {
+    writeBinaryArray(
+        getCompressedSection(CompressedSectionKind::ObjectKeyBuffer));
+    return;
+  }
   auto objectKeyValBufferPair = bytecodeModule_->getObjectBuffer();
   writeBinaryArray(objectKeyValBufferPair.first);
 }
 
 void BytecodeSerializer::visitObjectValueBuffer() {
   pad(BYTECODE_ALIGNMENT);
+  if (options_.compressSections) {
+    writeBinaryArray(
+        getCompressedSection(CompressedSectionKind::ObjectValueBuffer));
+    return;
+  }
   auto objectKeyValBufferPair = bytecodeModule_->getObjectBuffer();
   writeBinaryArray(objectKeyValBufferPair.second);
 }
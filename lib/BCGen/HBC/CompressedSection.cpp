@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/BCGen/HBC/CompressedSection.h"
+
+#include "hermes/Support/ErrorHandling.h"
+#include "hermes/Support/LZBlock.h"
+
+#include "llvh/Support/raw_ostream.h"
+
+#include <cstring>
+
+namespace hermes {
+namespace hbc {
+
+void compressSection(
+    llvh::ArrayRef<uint8_t> raw,
+    std::vector<uint8_t> &out,
+    uint32_t blockSize) {
+  assert(blockSize > 0 && "blocks must not be empty");
+  uint32_t blockCount = (raw.size() + blockSize - 1) / blockSize;
+
+  std::vector<uint8_t> data;
+  std::vector<uint32_t> offsets;
+  offsets.reserve(blockCount + 1);
+  for (size_t start = 0; start < raw.size(); start += blockSize) {
+    offsets.push_back(data.size());
+    lzblock::compress(
+        raw.slice(start, std::min<size_t>(blockSize, raw.size() - start)),
+        data);
+  }
+  offsets.push_back(data.size());
+
+  CompressedSectionHeader header{
+      static_cast<uint32_t>(raw.size()), blockSize, blockCount};
+  auto append = [&out](const void *p, size_t size) {
+    const auto *bytes = reinterpret_cast<const uint8_t *>(p);
+    out.insert(out.end(), bytes, bytes + size);
+  };
+  append(&header, sizeof(header));
+  append(offsets.data(), offsets.size() * sizeof(uint32_t));
+  append(data.data(), data.size());
+}
+
+bool CompressedSection::init(
+    llvh::ArrayRef<uint8_t> stored,
+    std::string *outError) {
+  auto fail = [outError](const char *msg) {
+    if (outError) {
+      llvh::raw_string_ostream errs(*outError);
+      errs << "Malformed compressed section: " << msg;
+    }
+    return false;
+  };
+
+  if (stored.size() < sizeof(CompressedSectionHeader))
+    return fail("missing header");
+  CompressedSectionHeader header;
+  std::memcpy(&header, stored.data(), sizeof(header));
+  if (header.blockSize == 0 ||
+      header.blockCount !=
+          (uint64_t(header.rawSize) + header.blockSize - 1) / header.blockSize)
+    return fail("inconsistent block count");
+
+  size_t tableSize = (size_t(header.blockCount) + 1) * sizeof(uint32_t);
+  if (stored.size() - sizeof(header) < tableSize)
+    return fail("truncated block table");
+  assert(
+      reinterpret_cast<uintptr_t>(stored.data()) % alignof(uint32_t) == 0 &&
+      "compressed section is misaligned");
+  blockOffsets_ =
+      reinterpret_cast<const uint32_t *>(stored.data() + sizeof(header));
+  blockData_ = stored.data() + sizeof(header) + tableSize;
+  size_t dataSize = stored.size() - sizeof(header) - tableSize;
+  for (uint32_t i = 0; i < header.blockCount; ++i) {
+    if (blockOffsets_[i] > blockOffsets_[i + 1])
+      return fail("block offsets out of order");
+  }
+  if (blockOffsets_[header.blockCount] > dataSize)
+    return fail("block extends past end of section");
+
+  stored_ = stored;
+  rawSize_ = header.rawSize;
+  blockSize_ = header.blockSize;
+  blockCount_ = header.blockCount;
+  present_.assign(blockCount_, false);
+  complete_.store(blockCount_ == 0, std::memory_order_release);
+  return true;
+}
+
+uint32_t CompressedSection::getDecompressedBlockCount() const {
+  std::lock_guard<std::mutex> lk{mutex_};
+  return presentCount_;
+}
+
+void CompressedSection::decompressBlocks(uint32_t first, uint32_t last) const {
+  if (!cache_)
+    cache_.reset(new uint8_t[rawSize_]);
+  for (uint32_t i = first; i <= last; ++i) {
+    if (present_[i])
+      continue;
+    uint32_t start = i * blockSize_;
+    uint32_t size = std::min(blockSize_, rawSize_ - start);
+    llvh::ArrayRef<uint8_t> block{
+        blockData_ + blockOffsets_[i], blockOffsets_[i + 1] - blockOffsets_[i]};
+    if (!lzblock::decompress(block, {cache_.get() + start, size}))
+      hermes_fatal("corrupt compressed bytecode section");
+    present_[i] = true;
+    ++presentCount_;
+  }
+  if (presentCount_ == blockCount_)
+    complete_.store(true, std::memory_order_release);
+}
+
+const uint8_t *CompressedSection::getRange(uint32_t offset, uint32_t size)
+    const {
+  assert(
+      uint64_t(offset) + size <= rawSize_ &&
+      "range extends past end of section");
+  if (LLVM_LIKELY(complete_.load(std::memory_order_acquire)))
+    return cache_.get() + offset;
+
+  std::lock_guard<std::mutex> lk{mutex_};
+  if (rawSize_ > 0) {
+    // An empty range still needs a valid pointer into the cache.
+    uint32_t first = std::min(offset, rawSize_ - 1) / blockSize_;
+    uint32_t last = size ? (offset + size - 1) / blockSize_ : first;
+    decompressBlocks(first, last);
+  }
+  return cache_.get() + offset;
+}
+
+} // namespace hbc
+} // namespace hermes
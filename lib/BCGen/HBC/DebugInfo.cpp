@@ -344,18 +344,22 @@ void DebugInfo::populateSourceMap(
     return segment;
   };
 
+  // Hand the segments over one function at a time, so that only a single
+  // function's worth is held here before being encoded.
+  sourceMap->startMappingsLine(segmentID);
   std::vector<SourceMap::Segment> segments;
   llvh::ArrayRef<uint8_t> locsData = sourceLocationsData();
   uint32_t offset = 0;
   while (offset < locsData.size()) {
     FunctionDebugInfoDeserializer fdid(locsData, offset);
     uint32_t offsetInFile = functionOffsets[fdid.getFunctionIndex()];
+    segments.clear();
     segments.push_back(segmentFor(fdid.getCurrent(), offsetInFile, offset));
     while (auto loc = fdid.next())
       segments.push_back(segmentFor(*loc, offsetInFile, offset));
+    sourceMap->addMappings(segments);
     offset = fdid.getOffset();
   }
-  sourceMap->addMappingsLine(std::move(segments), segmentID);
   sourceMap->addFunctionOffsets(std::move(functionOffsets), segmentID);
 }
 #endif
@@ -42,6 +42,7 @@
 #include "llvh/Support/CommandLine.h"
 #include "llvh/Support/Debug.h"
 #include "llvh/Support/FileSystem.h"
+#include "llvh/Support/Format.h"
 #include "llvh/Support/MemoryBuffer.h"
 #include "llvh/Support/Path.h"
 #include "llvh/Support/Process.h"
@@ -50,6 +51,8 @@
 
 #include "zip/src/zip.h"
 
+#include <algorithm>
+#include <chrono>
 #include <sstream>
 
 #define DEBUG_TYPE "hermes"
@@ -142,9 +145,7 @@ static OptionCategory CompilerCategory(
 
 list<std::string> InputFilenames(desc("<file1> <file2>..."), Positional);
 
-#if !defined(NDEBUG) || defined(LLVM_ENABLE_STATS)
 static opt<bool> PrintStats("print-stats", desc("Print statistics"));
-#endif
 
 enum class OptLevel {
   O0,
@@ -368,6 +369,12 @@ static opt<bool> OutputSourceMap(
     desc("Emit a source map to the output filename with .map extension"),
     cat(CompilerCategory));
 
+static opt<bool> OutputIndexSourceMap(
+    "output-index-source-map",
+    desc("With -output-source-map, emit an index map with a section per "
+         "bytecode segment"),
+    cat(CompilerCategory));
+
 static opt<bool> DumpOperandRegisters(
     "dump-operand-registers",
     desc("Dump registers assigned to instruction operands"),
@@ -412,16 +419,12 @@ static opt<bool> DumpBetweenPasses(
     desc("Print IR after every optimization pass"),
     cat(CompilerCategory));
 
-#ifndef NDEBUG
-
 static opt<bool> LexerOnly(
     "Xlexer-only",
-    desc("Only run the lexer on the input (debug builds only)"),
+    desc("Only run the lexer on the input and report its throughput"),
     Hidden,
     cat(CompilerCategory));
 
-#endif
-
 static opt<int> MaxDiagnosticWidth(
     "max-diagnostic-width",
     llvh::cl::desc("Preferred diagnostic maximum width"),
@@ -514,6 +517,14 @@ static CLFlag StripFunctionNames(
     "Strip function names to reduce string table size",
     CompilerCategory);
 
+static opt<bool> CompressSections(
+    "compress-sections",
+    desc(
+        "Store string storage, literal buffers and debug info as compressed "
+        "sections which are decompressed lazily at runtime"),
+    init(false),
+    cat(CompilerCategory));
+
 static opt<bool> EnableTDZ(
     "Xenable-tdz",
     init(false),
@@ -957,6 +968,8 @@ bool validateFlags() {
     if (cl::DumpTarget != EmitBundle)
       err("-output-source-map only works with -emit-binary");
   }
+  if (cl::OutputIndexSourceMap && !cl::OutputSourceMap)
+    err("-output-index-source-map requires -output-source-map");
 
   // Validate bytecode dumping flags.
   if (cl::BytecodeMode && cl::DumpTarget != Execute) {
@@ -1334,6 +1347,11 @@ llvh::Optional<ModuleIDsTable> readModuleIDs(
     segmentIDs.push_back(segmentID);
   }
 
+  // Segments are compiled in this order, and their source map lines must be
+  // generated in increasing order. Otherwise keep the order of the metadata,
+  // which is also the order of the manifest.
+  if (cl::OutputSourceMap)
+    std::sort(segmentIDs.begin(), segmentIDs.end());
   return metadata;
 }
 
@@ -1770,11 +1788,13 @@ CompileResult processSourceFiles(
   assert(
       rawFinalHash.size() == SHA1_NUM_BYTES && "Incorrect length of SHA1 hash");
   std::copy(rawFinalHash.begin(), rawFinalHash.end(), sourceHash.begin());
-#ifndef NDEBUG
   if (cl::LexerOnly) {
     unsigned count = 0;
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
     for (auto &entry : fileBufs) {
       for (auto &fileAndMap : entry.second) {
+        bytes += fileAndMap.file->getBufferSize();
         parser::JSLexer jsLexer(
             std::move(fileAndMap.file),
             context->getSourceErrorManager(),
@@ -1783,10 +1803,18 @@ CompileResult processSourceFiles(
           ++count;
       }
     }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
     llvh::outs() << count << " tokens lexed\n";
+    if (cl::PrintStats) {
+      llvh::outs() << llvh::format(
+          "Lexed %zu bytes in %.3f ms (%.1f MB/s)\n",
+          bytes,
+          elapsed.count() * 1e3,
+          bytes / elapsed.count() / (1 << 20));
+    }
     return Success;
   }
-#endif
 
   // A list of parsed global definition files.
   DeclarationFileListTy declFileList;
@@ -1814,10 +1842,17 @@ CompileResult processSourceFiles(
     }
   }
 
-  // Create the source map if requested.
+  // Create the source map if requested. It is written out as the bytecode is
+  // generated, rather than held in memory until the end.
   llvh::Optional<SourceMapGenerator> sourceMapGen{};
+  OutputStream sourceMapOS;
   if (cl::OutputSourceMap) {
-    sourceMapGen = SourceMapGenerator{};
+    sourceMapGen.emplace(
+        cl::OutputIndexSourceMap ? SourceMapGenerator::Format::Index
+                                 : SourceMapGenerator::Format::Regular);
+    if (!sourceMapOS.open(cl::BytecodeOutputFilename + ".map", F_Text))
+      return OutputFileError;
+    sourceMapGen->streamTo(sourceMapOS.os());
   }
 
   Module M(context);
@@ -1946,6 +1981,7 @@ CompileResult processSourceFiles(
       cl::OutputSourceMap || cl::DebugInfoLevel == cl::DebugLevel::g0;
 
   genOptions.stripFunctionNames = cl::StripFunctionNames;
+  genOptions.compressSections = cl::CompressSections;
 
   // If the dump target is None, return bytecode in an executable form.
   if (cl::DumpTarget == Execute) {
@@ -2037,13 +2073,10 @@ CompileResult processSourceFiles(
     result = Success;
   }
 
-  // Output the source map if requested.
+  // Finish the source map if requested.
   if (cl::OutputSourceMap) {
-    OutputStream OS;
-    if (!OS.open(base.str() + ".map", F_Text))
-      return OutputFileError;
-    sourceMapGen->outputAsJSON(OS.os());
-    if (!OS.close())
+    sourceMapGen->outputAsJSON(sourceMapOS.os());
+    if (!sourceMapOS.close())
       return OutputFileError;
   }
 
@@ -2171,7 +2204,14 @@ CompileResult compileFromCommandLineOptions() {
   } else {
     std::shared_ptr<Context> context =
         createContext(std::move(resolutionTable), std::move(segments));
-    return processSourceFiles(context, std::move(fileBufs));
+    CompileResult result = processSourceFiles(context, std::move(fileBufs));
+    if (cl::PrintStats) {
+      // The compiler front end releases its arenas in bulk, so the peak is
+      // the interesting number rather than the current footprint.
+      llvh::errs() << "Compiler peak RSS: " << oscompat::peak_rss()
+                   << " bytes\n";
+    }
+    return result;
   }
 }
 } // namespace driver
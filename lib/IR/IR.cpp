@@ -49,6 +49,10 @@ using llvh::dyn_cast;
 #include "hermes/IR/ValueKinds.def"
 #undef QUOTE
 
+void *Value::operator new(size_t size, Module *M) {
+  return M->getValueAllocator().Allocate(size, alignof(std::max_align_t));
+}
+
 void Value::destroy(Value *V) {
   if (!V)
     return;
@@ -58,7 +62,7 @@ void Value::destroy(Value *V) {
       llvm_unreachable("Invalid kind");
 #define DEF_VALUE(XX, PARENT) \
   case ValueKind::XX##Kind:   \
-    delete cast<XX>(V);       \
+    cast<XX>(V)->~XX();       \
     break;
 #include "hermes/IR/ValueKinds.def"
   }
@@ -571,7 +575,8 @@ GlobalObjectProperty *Module::addGlobalProperty(
   auto &ref = globalPropertyMap_[name];
 
   if (!ref) {
-    ref = new GlobalObjectProperty(this, getLiteralString(name), declared);
+    ref = new (this)
+        GlobalObjectProperty(this, getLiteralString(name), declared);
     globalPropertyList_.push_back(ref);
   } else {
     ref->orDeclared(declared);
@@ -756,7 +761,7 @@ LiteralNumber *Module::getLiteralNumber(double value) {
   if (LiteralNumber *LN = literalNumbers.FindNodeOrInsertPos(ID, InsertPos))
     return LN;
 
-  auto New = new LiteralNumber(value);
+  auto New = new (this) LiteralNumber(value);
   literalNumbers.InsertNode(New, InsertPos);
   return New;
 }
@@ -772,7 +777,7 @@ LiteralString *Module::getLiteralString(Identifier value) {
   if (LiteralString *LS = literalStrings.FindNodeOrInsertPos(ID, InsertPos))
     return LS;
 
-  auto New = new LiteralString(value);
+  auto New = new (this) LiteralString(value);
   literalStrings.InsertNode(New, InsertPos);
   return New;
 }
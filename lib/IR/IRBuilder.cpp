@@ -20,7 +20,7 @@ using llvh::isa;
 
 BasicBlock *IRBuilder::createBasicBlock(Function *Parent) {
   assert(Parent && "Invalid insertion point");
-  return new BasicBlock(Parent);
+  return new (M) BasicBlock(Parent);
 }
 
 Function *IRBuilder::createFunction(
@@ -37,7 +37,7 @@ Function *IRBuilder::createFunction(
   if (!OriginalName.isValid()) {
     OriginalName = createIdentifier("");
   }
-  return new Function(
+  return new (M) Function(
       M,
       OriginalName,
       definitionKind,
@@ -60,7 +60,7 @@ GeneratorFunction *IRBuilder::createGeneratorFunction(
     // Eventually we will give it a properly inferred name.
     OriginalName = createIdentifier("");
   }
-  return new GeneratorFunction(
+  return new (M) GeneratorFunction(
       M,
       OriginalName,
       definitionKind,
@@ -82,7 +82,7 @@ GeneratorInnerFunction *IRBuilder::createGeneratorInnerFunction(
     // Eventually we will give it a properly inferred name.
     OriginalName = createIdentifier("");
   }
-  return new GeneratorInnerFunction(
+  return new (M) GeneratorInnerFunction(
       M,
       OriginalName,
       definitionKind,
@@ -95,7 +95,7 @@ GeneratorInnerFunction *IRBuilder::createGeneratorInnerFunction(
 ExternalScope *IRBuilder::createExternalScope(
     Function *function,
     int32_t depth) {
-  return new ExternalScope(function, depth);
+  return new (M) ExternalScope(function, depth);
 }
 
 Function *IRBuilder::createTopLevelFunction(
@@ -145,7 +145,7 @@ AsyncFunction *IRBuilder::createAsyncFunction(
     // Eventually we will give it a properly inferred name.
     OriginalName = createIdentifier("");
   }
-  return new AsyncFunction(
+  return new (M) AsyncFunction(
       M,
       OriginalName,
       definitionKind,
@@ -169,7 +169,7 @@ GlobalObjectProperty *IRBuilder::createGlobalObjectProperty(
 }
 
 Parameter *IRBuilder::createParameter(Function *Parent, Identifier Name) {
-  return new Parameter(Parent, Name);
+  return new (M) Parameter(Parent, Name);
 }
 
 Parameter *IRBuilder::createParameter(Function *Parent, StringRef Name) {
@@ -180,7 +180,7 @@ Variable *IRBuilder::createVariable(
     VariableScope *Parent,
     Variable::DeclKind declKind,
     Identifier Name) {
-  return new Variable(Parent, declKind, Name);
+  return new (M) Variable(Parent, declKind, Name);
 }
 
 Variable *IRBuilder::createVariable(
@@ -245,32 +245,32 @@ Identifier IRBuilder::createIdentifier(StringRef str) {
 }
 
 BranchInst *IRBuilder::createBranchInst(BasicBlock *Destination) {
-  auto *BI = new BranchInst(getInsertionBlock(), Destination);
+  auto *BI = new (M) BranchInst(getInsertionBlock(), Destination);
   insert(BI);
   return BI;
 }
 
 CondBranchInst *
 IRBuilder::createCondBranchInst(Value *Cond, BasicBlock *T, BasicBlock *F) {
-  auto *CBI = new CondBranchInst(getInsertionBlock(), Cond, T, F);
+  auto *CBI = new (M) CondBranchInst(getInsertionBlock(), Cond, T, F);
   insert(CBI);
   return CBI;
 }
 
 ReturnInst *IRBuilder::createReturnInst(Value *Val) {
-  auto *RI = new ReturnInst(Val);
+  auto *RI = new (M) ReturnInst(Val);
   insert(RI);
   return RI;
 }
 
 CatchInst *IRBuilder::createCatchInst() {
-  auto *CI = new CatchInst();
+  auto *CI = new (M) CatchInst();
   insert(CI);
   return CI;
 }
 
 ThrowInst *IRBuilder::createThrowInst(Value *thrownValue) {
-  auto *TI = new ThrowInst(thrownValue);
+  auto *TI = new (M) ThrowInst(thrownValue);
   insert(TI);
   return TI;
 }
@@ -281,7 +281,7 @@ CheckHasInstanceInst *IRBuilder::createCheckHasInstanceInst(
     Value *right,
     BasicBlock *onTrue,
     BasicBlock *onFalse) {
-  auto *TI = new CheckHasInstanceInst(result, left, right, onTrue, onFalse);
+  auto *TI = new (M) CheckHasInstanceInst(result, left, right, onTrue, onFalse);
   insert(TI);
   return TI;
 }
@@ -289,13 +289,13 @@ CheckHasInstanceInst *IRBuilder::createCheckHasInstanceInst(
 TryStartInst *IRBuilder::createTryStartInst(
     BasicBlock *tryBodyBlock,
     BasicBlock *catchTargetBlock) {
-  auto *I = new TryStartInst(tryBodyBlock, catchTargetBlock);
+  auto *I = new (M) TryStartInst(tryBodyBlock, catchTargetBlock);
   insert(I);
   return I;
 }
 
 TryEndInst *IRBuilder::createTryEndInst() {
-  auto *I = new TryEndInst();
+  auto *I = new (M) TryEndInst();
   insert(I);
   return I;
 }
@@ -306,43 +306,43 @@ AllocStackInst *IRBuilder::createAllocStackInst(StringRef varName) {
 }
 
 AllocStackInst *IRBuilder::createAllocStackInst(Identifier varName) {
-  auto *AHI = new AllocStackInst(varName);
+  auto *AHI = new (M) AllocStackInst(varName);
   insert(AHI);
   return AHI;
 }
 
 AsNumberInst *IRBuilder::createAsNumberInst(Value *val) {
-  auto *ANI = new AsNumberInst(val);
+  auto *ANI = new (M) AsNumberInst(val);
   insert(ANI);
   return ANI;
 }
 
 AsInt32Inst *IRBuilder::createAsInt32Inst(Value *val) {
-  auto *AII = new AsInt32Inst(val);
+  auto *AII = new (M) AsInt32Inst(val);
   insert(AII);
   return AII;
 }
 
 AddEmptyStringInst *IRBuilder::createAddEmptyStringInst(Value *val) {
-  auto *I = new AddEmptyStringInst(val);
+  auto *I = new (M) AddEmptyStringInst(val);
   insert(I);
   return I;
 }
 
 CreateFunctionInst *IRBuilder::createCreateFunctionInst(Function *code) {
-  auto CFI = new CreateFunctionInst(code);
+  auto CFI = new (M) CreateFunctionInst(code);
   insert(CFI);
   return CFI;
 }
 
 LoadFrameInst *IRBuilder::createLoadFrameInst(Variable *ptr) {
-  auto LI = new LoadFrameInst(ptr);
+  auto LI = new (M) LoadFrameInst(ptr);
   insert(LI);
   return LI;
 }
 
 LoadStackInst *IRBuilder::createLoadStackInst(AllocStackInst *ptr) {
-  auto LI = new LoadStackInst(ptr);
+  auto LI = new (M) LoadStackInst(ptr);
   insert(LI);
   return LI;
 }
@@ -350,7 +350,7 @@ LoadStackInst *IRBuilder::createLoadStackInst(AllocStackInst *ptr) {
 StoreFrameInst *IRBuilder::createStoreFrameInst(
     Value *storedValue,
     Variable *ptr) {
-  auto SI = new StoreFrameInst(storedValue, ptr);
+  auto SI = new (M) StoreFrameInst(storedValue, ptr);
   insert(SI);
   return SI;
 }
@@ -358,7 +358,7 @@ StoreFrameInst *IRBuilder::createStoreFrameInst(
 StoreStackInst *IRBuilder::createStoreStackInst(
     Value *storedValue,
     AllocStackInst *ptr) {
-  auto SI = new StoreStackInst(storedValue, ptr);
+  auto SI = new (M) StoreStackInst(storedValue, ptr);
   insert(SI);
   return SI;
 }
@@ -367,7 +367,7 @@ CallInst *IRBuilder::createCallInst(
     Value *callee,
     Value *thisValue,
     ArrayRef<Value *> args) {
-  auto CI = new CallInst(ValueKind::CallInstKind, callee, thisValue, args);
+  auto CI = new (M) CallInst(ValueKind::CallInstKind, callee, thisValue, args);
   insert(CI);
   return CI;
 }
@@ -376,7 +376,7 @@ HBCCallNInst *IRBuilder::createHBCCallNInst(
     Value *callee,
     Value *thisValue,
     ArrayRef<Value *> args) {
-  auto CI = new HBCCallNInst(callee, thisValue, args);
+  auto CI = new (M) HBCCallNInst(callee, thisValue, args);
   insert(CI);
   return CI;
 }
@@ -384,7 +384,7 @@ HBCCallNInst *IRBuilder::createHBCCallNInst(
 ConstructInst *IRBuilder::createConstructInst(
     Value *constructor,
     ArrayRef<Value *> args) {
-  auto *inst = new ConstructInst(constructor, getLiteralUndefined(), args);
+  auto *inst = new (M) ConstructInst(constructor, getLiteralUndefined(), args);
   insert(inst);
   return inst;
 }
@@ -392,14 +392,14 @@ ConstructInst *IRBuilder::createConstructInst(
 LoadPropertyInst *IRBuilder::createLoadPropertyInst(
     Value *object,
     Value *property) {
-  auto LPI = new LoadPropertyInst(object, property);
+  auto LPI = new (M) LoadPropertyInst(object, property);
   insert(LPI);
   return LPI;
 }
 
 TryLoadGlobalPropertyInst *IRBuilder::createTryLoadGlobalPropertyInst(
     LiteralString *property) {
-  auto *inst = new TryLoadGlobalPropertyInst(getGlobalObject(), property);
+  auto *inst = new (M) TryLoadGlobalPropertyInst(getGlobalObject(), property);
   insert(inst);
   return inst;
 }
@@ -412,7 +412,7 @@ TryLoadGlobalPropertyInst *IRBuilder::createTryLoadGlobalPropertyInst(
 DeletePropertyInst *IRBuilder::createDeletePropertyInst(
     Value *object,
     Value *property) {
-  auto DPI = new DeletePropertyInst(object, property);
+  auto DPI = new (M) DeletePropertyInst(object, property);
   insert(DPI);
   return DPI;
 }
@@ -421,15 +421,15 @@ StorePropertyInst *IRBuilder::createStorePropertyInst(
     Value *storedValue,
     Value *object,
     Value *property) {
-  auto SPI = new StorePropertyInst(storedValue, object, property);
+  auto SPI = new (M) StorePropertyInst(storedValue, object, property);
   insert(SPI);
   return SPI;
 }
 TryStoreGlobalPropertyInst *IRBuilder::createTryStoreGlobalPropertyInst(
     Value *storedValue,
     LiteralString *property) {
-  auto *inst =
-      new TryStoreGlobalPropertyInst(storedValue, getGlobalObject(), property);
+  auto *inst = new (M)
+      TryStoreGlobalPropertyInst(storedValue, getGlobalObject(), property);
   insert(inst);
   return inst;
 }
@@ -444,7 +444,7 @@ StoreOwnPropertyInst *IRBuilder::createStoreOwnPropertyInst(
     Value *object,
     Value *property,
     PropEnumerable isEnumerable) {
-  auto SPI = new StoreOwnPropertyInst(
+  auto SPI = new (M) StoreOwnPropertyInst(
       storedValue,
       object,
       property,
@@ -457,7 +457,7 @@ StoreNewOwnPropertyInst *IRBuilder::createStoreNewOwnPropertyInst(
     Value *object,
     Literal *property,
     PropEnumerable isEnumerable) {
-  auto *inst = new StoreNewOwnPropertyInst(
+  auto *inst = new (M) StoreNewOwnPropertyInst(
       storedValue,
       object,
       property,
@@ -472,7 +472,7 @@ StoreGetterSetterInst *IRBuilder::createStoreGetterSetterInst(
     Value *object,
     Value *property,
     PropEnumerable isEnumerable) {
-  auto *SGSI = new StoreGetterSetterInst(
+  auto *SGSI = new (M) StoreGetterSetterInst(
       storedGetter,
       storedSetter,
       object,
@@ -518,7 +518,7 @@ LoadPropertyInst *IRBuilder::createLoadPropertyInst(
 
 TryLoadGlobalPropertyInst *IRBuilder::createTryLoadGlobalPropertyInst(
     Identifier property) {
-  auto *inst = new TryLoadGlobalPropertyInst(
+  auto *inst = new (M) TryLoadGlobalPropertyInst(
       getGlobalObject(), getLiteralString(property));
   insert(inst);
   return inst;
@@ -542,7 +542,7 @@ StorePropertyInst *IRBuilder::createStorePropertyInst(
 TryStoreGlobalPropertyInst *IRBuilder::createTryStoreGlobalPropertyInst(
     Value *storedValue,
     Identifier property) {
-  auto *inst = new TryStoreGlobalPropertyInst(
+  auto *inst = new (M) TryStoreGlobalPropertyInst(
       storedValue, getGlobalObject(), getLiteralString(property));
   insert(inst);
   return inst;
@@ -551,7 +551,7 @@ TryStoreGlobalPropertyInst *IRBuilder::createTryStoreGlobalPropertyInst(
 AllocObjectInst *IRBuilder::createAllocObjectInst(
     uint32_t size,
     Value *parent) {
-  auto AOI = new AllocObjectInst(
+  auto AOI = new (M) AllocObjectInst(
       M->getLiteralNumber(size), parent ? parent : getEmptySentinel());
   insert(AOI);
   return AOI;
@@ -560,7 +560,7 @@ AllocObjectInst *IRBuilder::createAllocObjectInst(
 AllocArrayInst *IRBuilder::createAllocArrayInst(
     LiteralNumber *sizeHint,
     AllocArrayInst::ArrayValueList val_list) {
-  auto AAI = new AllocArrayInst(val_list, sizeHint);
+  auto AAI = new (M) AllocArrayInst(val_list, sizeHint);
   insert(AAI);
   return AAI;
 }
@@ -572,25 +572,25 @@ AllocArrayInst *IRBuilder::createAllocArrayInst(
 }
 
 CreateArgumentsInst *IRBuilder::createCreateArgumentsInst() {
-  auto CAI = new CreateArgumentsInst();
+  auto CAI = new (M) CreateArgumentsInst();
   insert(CAI);
   return CAI;
 }
 
 GetNewTargetInst *IRBuilder::createGetNewTargetInst() {
-  auto *inst = new GetNewTargetInst();
+  auto *inst = new (M) GetNewTargetInst();
   insert(inst);
   return inst;
 }
 
 ThrowIfEmptyInst *IRBuilder::createThrowIfEmptyInst(Value *checkedValue) {
-  auto *inst = new ThrowIfEmptyInst(checkedValue);
+  auto *inst = new (M) ThrowIfEmptyInst(checkedValue);
   insert(inst);
   return inst;
 }
 
 HBCGetGlobalObjectInst *IRBuilder::createHBCGetGlobalObjectInst() {
-  auto inst = new HBCGetGlobalObjectInst();
+  auto inst = new (M) HBCGetGlobalObjectInst();
   insert(inst);
   return inst;
 }
@@ -598,8 +598,8 @@ HBCGetGlobalObjectInst *IRBuilder::createHBCGetGlobalObjectInst() {
 CreateRegExpInst *IRBuilder::createRegExpInst(
     Identifier pattern,
     Identifier flags) {
-  auto res =
-      new CreateRegExpInst(getLiteralString(pattern), getLiteralString(flags));
+  auto res = new (M)
+      CreateRegExpInst(getLiteralString(pattern), getLiteralString(flags));
   insert(res);
   return res;
 }
@@ -607,7 +607,7 @@ CreateRegExpInst *IRBuilder::createRegExpInst(
 UnaryOperatorInst *IRBuilder::createUnaryOperatorInst(
     Value *value,
     UnaryOperatorInst::OpKind opKind) {
-  auto UOI = new UnaryOperatorInst(value, opKind);
+  auto UOI = new (M) UnaryOperatorInst(value, opKind);
   insert(UOI);
   return UOI;
 }
@@ -616,7 +616,7 @@ BinaryOperatorInst *IRBuilder::createBinaryOperatorInst(
     Value *left,
     Value *right,
     BinaryOperatorInst::OpKind opKind) {
-  auto BOI = new BinaryOperatorInst(left, right, opKind);
+  auto BOI = new (M) BinaryOperatorInst(left, right, opKind);
   insert(BOI);
   return BOI;
 }
@@ -626,7 +626,7 @@ SwitchInst *IRBuilder::createSwitchInst(
     BasicBlock *defaultBlock,
     const SwitchInst::ValueListType &values,
     const SwitchInst::BasicBlockListType &blocks) {
-  auto SI = new SwitchInst(input, defaultBlock, values, blocks);
+  auto SI = new (M) SwitchInst(input, defaultBlock, values, blocks);
   insert(SI);
   return SI;
 }
@@ -641,7 +641,7 @@ PhiInst *IRBuilder::createPhiInst() {
 PhiInst *IRBuilder::createPhiInst(
     const PhiInst::ValueListType &values,
     const PhiInst::BasicBlockListType &blocks) {
-  auto PI = new PhiInst(values, blocks);
+  auto PI = new (M) PhiInst(values, blocks);
   insert(PI);
   return PI;
 }
@@ -653,7 +653,7 @@ GetPNamesInst *IRBuilder::createGetPNamesInst(
     Value *sizeAddr,
     BasicBlock *onEmpty,
     BasicBlock *onSome) {
-  auto GP = new GetPNamesInst(
+  auto GP = new (M) GetPNamesInst(
       getInsertionBlock(),
       iteratorAddr,
       baseAddr,
@@ -673,7 +673,7 @@ GetNextPNameInst *IRBuilder::createGetNextPNameInst(
     Value *iteratorAddr,
     BasicBlock *onLast,
     BasicBlock *onSome) {
-  auto GNP = new GetNextPNameInst(
+  auto GNP = new (M) GetNextPNameInst(
       getInsertionBlock(),
       propertyAddr,
       baseAddr,
@@ -687,25 +687,25 @@ GetNextPNameInst *IRBuilder::createGetNextPNameInst(
 }
 
 MovInst *IRBuilder::createMovInst(Value *input) {
-  auto MI = new MovInst(input);
+  auto MI = new (M) MovInst(input);
   insert(MI);
   return MI;
 }
 
 ImplicitMovInst *IRBuilder::createImplicitMovInst(Value *input) {
-  auto IMI = new ImplicitMovInst(input);
+  auto IMI = new (M) ImplicitMovInst(input);
   insert(IMI);
   return IMI;
 }
 
 CoerceThisNSInst *IRBuilder::createCoerceThisNSInst(Value *input) {
-  auto *inst = new CoerceThisNSInst(input);
+  auto *inst = new (M) CoerceThisNSInst(input);
   insert(inst);
   return inst;
 }
 
 DebuggerInst *IRBuilder::createDebuggerInst() {
-  auto DI = new DebuggerInst();
+  auto DI = new (M) DebuggerInst();
   insert(DI);
   return DI;
 }
@@ -713,32 +713,32 @@ DebuggerInst *IRBuilder::createDebuggerInst() {
 SaveAndYieldInst *IRBuilder::createSaveAndYieldInst(
     Value *result,
     BasicBlock *nextBlock) {
-  auto *I = new SaveAndYieldInst(result, nextBlock);
+  auto *I = new (M) SaveAndYieldInst(result, nextBlock);
   insert(I);
   return I;
 }
 
 CreateGeneratorInst *IRBuilder::createCreateGeneratorInst(Function *innerFn) {
-  auto *I = new CreateGeneratorInst(innerFn);
+  auto *I = new (M) CreateGeneratorInst(innerFn);
   insert(I);
   return I;
 }
 
 StartGeneratorInst *IRBuilder::createStartGeneratorInst() {
-  auto *I = new StartGeneratorInst();
+  auto *I = new (M) StartGeneratorInst();
   insert(I);
   return I;
 }
 
 ResumeGeneratorInst *IRBuilder::createResumeGeneratorInst(Value *isReturn) {
-  auto *I = new ResumeGeneratorInst(isReturn);
+  auto *I = new (M) ResumeGeneratorInst(isReturn);
   insert(I);
   return I;
 }
 
 HBCResolveEnvironment *IRBuilder::createHBCResolveEnvironment(
     VariableScope *scope) {
-  auto RSC = new HBCResolveEnvironment(scope);
+  auto RSC = new (M) HBCResolveEnvironment(scope);
   insert(RSC);
   return RSC;
 }
@@ -747,7 +747,7 @@ HBCStoreToEnvironmentInst *IRBuilder::createHBCStoreToEnvironmentInst(
     Value *env,
     Value *toPut,
     Variable *var) {
-  auto PSI = new HBCStoreToEnvironmentInst(env, toPut, var);
+  auto PSI = new (M) HBCStoreToEnvironmentInst(env, toPut, var);
   insert(PSI);
   return PSI;
 }
@@ -755,7 +755,7 @@ HBCStoreToEnvironmentInst *IRBuilder::createHBCStoreToEnvironmentInst(
 HBCLoadFromEnvironmentInst *IRBuilder::createHBCLoadFromEnvironmentInst(
     Value *env,
     Variable *var) {
-  auto GSI = new HBCLoadFromEnvironmentInst(env, var);
+  auto GSI = new (M) HBCLoadFromEnvironmentInst(env, var);
   insert(GSI);
   return GSI;
 }
@@ -767,64 +767,64 @@ SwitchImmInst *IRBuilder::createSwitchImmInst(
     LiteralNumber *size,
     const SwitchImmInst::ValueListType &values,
     const SwitchImmInst::BasicBlockListType &blocks) {
-  auto inst =
-      new SwitchImmInst(input, defaultBlock, minValue, size, values, blocks);
+  auto inst = new (M)
+      SwitchImmInst(input, defaultBlock, minValue, size, values, blocks);
   insert(inst);
   return inst;
 }
 
 DirectEvalInst *IRBuilder::createDirectEvalInst(Value *operand) {
-  auto *inst = new DirectEvalInst(operand);
+  auto *inst = new (M) DirectEvalInst(operand);
   insert(inst);
   return inst;
 }
 
 HBCLoadConstInst *IRBuilder::createHBCLoadConstInst(Literal *value) {
-  auto inst = new HBCLoadConstInst(value);
+  auto inst = new (M) HBCLoadConstInst(value);
   insert(inst);
   return inst;
 }
 
 HBCLoadParamInst *IRBuilder::createHBCLoadParamInst(LiteralNumber *value) {
-  auto inst = new HBCLoadParamInst(value);
+  auto inst = new (M) HBCLoadParamInst(value);
   insert(inst);
   return inst;
 }
 
 HBCCreateEnvironmentInst *IRBuilder::createHBCCreateEnvironmentInst() {
-  auto inst = new HBCCreateEnvironmentInst();
+  auto inst = new (M) HBCCreateEnvironmentInst();
   insert(inst);
   return inst;
 }
 
 HBCGetThisNSInst *IRBuilder::createHBCGetThisNSInst() {
-  auto inst = new HBCGetThisNSInst();
+  auto inst = new (M) HBCGetThisNSInst();
   insert(inst);
   return inst;
 }
 HBCGetArgumentsPropByValInst *IRBuilder::createHBCGetArgumentsPropByValInst(
     Value *index,
     AllocStackInst *lazyReg) {
-  auto inst = new HBCGetArgumentsPropByValInst(index, lazyReg);
+  auto inst = new (M) HBCGetArgumentsPropByValInst(index, lazyReg);
   insert(inst);
   return inst;
 }
 HBCGetArgumentsLengthInst *IRBuilder::createHBCGetArgumentsLengthInst(
     AllocStackInst *lazyReg) {
-  auto inst = new HBCGetArgumentsLengthInst(lazyReg);
+  auto inst = new (M) HBCGetArgumentsLengthInst(lazyReg);
   insert(inst);
   return inst;
 }
 HBCReifyArgumentsInst *IRBuilder::createHBCReifyArgumentsInst(
     AllocStackInst *lazyReg) {
-  auto inst = new HBCReifyArgumentsInst(lazyReg);
+  auto inst = new (M) HBCReifyArgumentsInst(lazyReg);
   insert(inst);
   return inst;
 }
 HBCCreateThisInst *IRBuilder::createHBCCreateThisInst(
     Value *prototype,
     Value *closure) {
-  auto inst = new HBCCreateThisInst(prototype, closure);
+  auto inst = new (M) HBCCreateThisInst(prototype, closure);
   insert(inst);
   return inst;
 }
@@ -832,7 +832,7 @@ HBCConstructInst *IRBuilder::createHBCConstructInst(
     Value *closure,
     Value *thisValue,
     ArrayRef<Value *> arguments) {
-  auto inst = new HBCConstructInst(closure, thisValue, arguments);
+  auto inst = new (M) HBCConstructInst(closure, thisValue, arguments);
   insert(inst);
   return inst;
 }
@@ -840,13 +840,13 @@ HBCGetConstructedObjectInst *IRBuilder::createHBCGetConstructedObjectInst(
     HBCCreateThisInst *thisValue,
     HBCConstructInst *constructorReturnValue) {
   auto inst =
-      new HBCGetConstructedObjectInst(thisValue, constructorReturnValue);
+      new (M) HBCGetConstructedObjectInst(thisValue, constructorReturnValue);
   insert(inst);
   return inst;
 }
 
 HBCProfilePointInst *IRBuilder::createHBCProfilePointInst(uint16_t pointIndex) {
-  auto inst = new HBCProfilePointInst(pointIndex);
+  auto inst = new (M) HBCProfilePointInst(pointIndex);
   insert(inst);
   return inst;
 }
@@ -854,7 +854,7 @@ HBCProfilePointInst *IRBuilder::createHBCProfilePointInst(uint16_t pointIndex) {
 CallBuiltinInst *IRBuilder::createCallBuiltinInst(
     BuiltinMethod::Enum builtinIndex,
     ArrayRef<Value *> arguments) {
-  auto *inst = new CallBuiltinInst(
+  auto *inst = new (M) CallBuiltinInst(
       getLiteralNumber(builtinIndex), getLiteralUndefined(), arguments);
   insert(inst);
   return inst;
@@ -862,7 +862,7 @@ CallBuiltinInst *IRBuilder::createCallBuiltinInst(
 
 GetBuiltinClosureInst *IRBuilder::createGetBuiltinClosureInst(
     BuiltinMethod::Enum builtinIndex) {
-  auto *inst = new GetBuiltinClosureInst(getLiteralNumber(builtinIndex));
+  auto *inst = new (M) GetBuiltinClosureInst(getLiteralNumber(builtinIndex));
   insert(inst);
   return inst;
 }
@@ -872,7 +872,7 @@ CallIntrinsicInst *IRBuilder::createCallIntrinsicInst(
     WasmIntrinsics::Enum intrinsicsIndex,
     ArrayRef<Value *> arguments) {
   auto *inst =
-      new CallIntrinsicInst(getLiteralNumber(intrinsicsIndex), arguments);
+      new (M) CallIntrinsicInst(getLiteralNumber(intrinsicsIndex), arguments);
   insert(inst);
   return inst;
 }
@@ -882,7 +882,7 @@ HBCCallDirectInst *IRBuilder::createHBCCallDirectInst(
     Function *callee,
     Value *thisValue,
     ArrayRef<Value *> arguments) {
-  auto *inst = new HBCCallDirectInst(callee, thisValue, arguments);
+  auto *inst = new (M) HBCCallDirectInst(callee, thisValue, arguments);
   insert(inst);
   return inst;
 }
@@ -890,13 +890,13 @@ HBCCallDirectInst *IRBuilder::createHBCCallDirectInst(
 HBCCreateFunctionInst *IRBuilder::createHBCCreateFunctionInst(
     Function *function,
     Value *env) {
-  auto inst = new HBCCreateFunctionInst(function, env);
+  auto inst = new (M) HBCCreateFunctionInst(function, env);
   insert(inst);
   return inst;
 }
 
 HBCSpillMovInst *IRBuilder::createHBCSpillMovInst(Instruction *value) {
-  auto *inst = new HBCSpillMovInst(value);
+  auto *inst = new (M) HBCSpillMovInst(value);
   insert(inst);
   return inst;
 }
@@ -904,7 +904,7 @@ HBCSpillMovInst *IRBuilder::createHBCSpillMovInst(Instruction *value) {
 HBCCreateGeneratorInst *IRBuilder::createHBCCreateGeneratorInst(
     Function *function,
     Value *env) {
-  auto *inst = new HBCCreateGeneratorInst(function, env);
+  auto *inst = new (M) HBCCreateGeneratorInst(function, env);
   insert(inst);
   return inst;
 }
@@ -913,14 +913,14 @@ HBCAllocObjectFromBufferInst *IRBuilder::createHBCAllocObjectFromBufferInst(
     HBCAllocObjectFromBufferInst::ObjectPropertyMap prop_map,
     uint32_t size) {
   auto *inst =
-      new HBCAllocObjectFromBufferInst(M->getLiteralNumber(size), prop_map);
+      new (M) HBCAllocObjectFromBufferInst(M->getLiteralNumber(size), prop_map);
   insert(inst);
   return inst;
 }
 
 AllocObjectLiteralInst *IRBuilder::createAllocObjectLiteralInst(
     const AllocObjectLiteralInst::ObjectPropertyMap &propMap) {
-  auto *inst = new AllocObjectLiteralInst(propMap);
+  auto *inst = new (M) AllocObjectLiteralInst(propMap);
   insert(inst);
   return inst;
 }
@@ -932,14 +932,14 @@ CompareBranchInst *IRBuilder::createCompareBranchInst(
     BasicBlock *trueBlock,
     BasicBlock *falseBlock) {
   auto *inst =
-      new CompareBranchInst(left, right, opKind, trueBlock, falseBlock);
+      new (M) CompareBranchInst(left, right, opKind, trueBlock, falseBlock);
   insert(inst);
   return inst;
 }
 
 IteratorBeginInst *IRBuilder::createIteratorBeginInst(
     AllocStackInst *sourceOrNext) {
-  auto *I = new IteratorBeginInst(sourceOrNext);
+  auto *I = new (M) IteratorBeginInst(sourceOrNext);
   insert(I);
   return I;
 }
@@ -947,7 +947,7 @@ IteratorBeginInst *IRBuilder::createIteratorBeginInst(
 IteratorNextInst *IRBuilder::createIteratorNextInst(
     AllocStackInst *iterator,
     AllocStackInst *sourceOrNext) {
-  auto *I = new IteratorNextInst(iterator, sourceOrNext);
+  auto *I = new (M) IteratorNextInst(iterator, sourceOrNext);
   insert(I);
   return I;
 }
@@ -956,13 +956,13 @@ IteratorCloseInst *IRBuilder::createIteratorCloseInst(
     AllocStackInst *iterator,
     bool ignoreInnerException) {
   auto *I =
-      new IteratorCloseInst(iterator, getLiteralBool(ignoreInnerException));
+      new (M) IteratorCloseInst(iterator, getLiteralBool(ignoreInnerException));
   insert(I);
   return I;
 }
 
 UnreachableInst *IRBuilder::createUnreachableInst() {
-  auto *I = new UnreachableInst();
+  auto *I = new (M) UnreachableInst();
   insert(I);
   return I;
 }
@@ -1056,9 +1056,9 @@ Instruction *IRBuilder::cloneInst(
   Instruction *inst;
   switch (source->getKind()) {
 #define INCLUDE_ALL_INSTRS
-#define DEF_VALUE(name, parent)                    \
-  case ValueKind::name##Kind:                      \
-    inst = new name(cast<name>(source), operands); \
+#define DEF_VALUE(name, parent)                        \
+  case ValueKind::name##Kind:                          \
+    inst = new (M) name(cast<name>(source), operands); \
     break;
 
 #include "hermes/IR/Instrs.def"
@@ -62,6 +62,10 @@ void hermes::runFullOptimizationPasses(Module &M) {
   PM.addStackPromotion();
   PM.addInlining();
   PM.addStackPromotion();
+  // Inlining exposes object literals that don't escape. Replace them with
+  // stack locations and promote those to registers right away.
+  PM.addScalarReplacement();
+  PM.addMem2Reg();
   PM.addInstSimplify();
   PM.addDCE();
 
@@ -76,6 +80,7 @@ void hermes::runFullOptimizationPasses(Module &M) {
   PM.addTypeInference();
   PM.addCSE();
   PM.addTDZDedup();
+  PM.addLICM();
   PM.addSimplifyCFG();
 
   PM.addInstSimplify();
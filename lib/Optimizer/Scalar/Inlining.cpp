@@ -13,6 +13,7 @@
 #include "hermes/Optimizer/Scalar/Utils.h"
 #include "hermes/Support/Statistic.h"
 
+#include "llvh/ADT/DenseSet.h"
 #include "llvh/Support/Debug.h"
 
 using llvh::cast;
@@ -20,6 +21,14 @@ using llvh::dyn_cast;
 using llvh::isa;
 
 STATISTIC(NumInlinedCalls, "Number of inlined calls");
+STATISTIC(
+    NumInlinedExportCalls,
+    "Number of inlined calls to functions exported from other modules");
+
+/// Maximum number of instructions in an exported function for it to be inlined
+/// into a call site in another module. Unlike single use functions, exported
+/// functions are duplicated by inlining, so only small ones are considered.
+static constexpr unsigned kMaxExportInlineSize = 32;
 
 namespace hermes {
 
@@ -261,6 +270,277 @@ static Value *inlineFunction(
   return returnValue ? returnValue : cast<Value>(builder.getLiteralUndefined());
 }
 
+/// Inline the function \p FC at the call \p CI, splitting the block of the
+/// call and replacing the call with the inlined body.
+static void inlineCall(Module *M, Function *FC, CallInst *CI) {
+  Function *intoFunction = CI->getParent()->getParent();
+
+  LLVM_DEBUG(llvh::dbgs() << "Inlining function '" << FC->getInternalNameStr()
+                          << "' ";
+             FC->getContext().getSourceErrorManager().dumpCoords(
+                 llvh::dbgs(), FC->getSourceRange().Start);
+             llvh::dbgs() << " into function '"
+                          << intoFunction->getInternalNameStr() << "' ";
+             FC->getContext().getSourceErrorManager().dumpCoords(
+                 llvh::dbgs(), intoFunction->getSourceRange().Start);
+             llvh::dbgs() << "\n";);
+
+  IRBuilder builder(M);
+
+  // Split the block in two and move all instructions following the call
+  // to the new block.
+  BasicBlock *nextBlock = builder.createBasicBlock(intoFunction);
+  builder.setInsertionBlock(nextBlock);
+
+  // Move the rest of the instructions.
+  auto it = CI->getIterator();
+  ++it; // Skip over the call.
+  auto e = CI->getParent()->end();
+  while (it != e)
+    builder.transferInstructionToCurrentBlock(&*it++);
+
+  // Perform the inlining.
+  builder.setInsertionPointAfter(CI);
+
+  auto *returnValue = inlineFunction(builder, FC, CI, nextBlock);
+  CI->replaceAllUsesWith(returnValue);
+  CI->eraseFromParent();
+}
+
+namespace {
+
+/// What we know about the exports object of a CJS module.
+struct ModuleExports {
+  /// Functions which are known to be the values of the corresponding
+  /// properties of the exports object whenever other code can observe it.
+  llvh::DenseMap<Identifier, Function *> stable{};
+
+  /// Properties whose values are only ever functions that don't use `this`, so
+  /// calling them as methods doesn't leak the exports object.
+  llvh::DenseSet<Identifier> thisSafe{};
+};
+
+/// Analyze the exports of the CJS module function \p F. An export is stable if
+/// the module assigns a function expression to it exactly once, before running
+/// any code that could observe the exports object, and the exports object is
+/// otherwise only read from.
+/// \return the analyzed exports, which have no stable entries if the module
+///   does anything with `exports` or `module` that we can't reason about.
+ModuleExports analyzeExports(Function *F) {
+  ModuleExports result{};
+  if (F->getParameters().size() != 3)
+    return result;
+  Parameter *exportsParam = F->getParameters()[0];
+  Parameter *moduleParam = F->getParameters()[2];
+
+  // `module.exports` could be replaced, and `this` is another reference to the
+  // exports object.
+  if (moduleParam->hasUsers() || F->getThisParameter()->hasUsers())
+    return result;
+
+  llvh::DenseMap<Identifier, unsigned> storeCount{};
+  llvh::DenseSet<Identifier> usesThis{};
+  for (Instruction *user : exportsParam->getUsers()) {
+    if (auto *LPI = dyn_cast<LoadPropertyInst>(user)) {
+      if (LPI->getObject() == exportsParam)
+        continue;
+    } else if (auto *SPI = dyn_cast<StorePropertyInst>(user)) {
+      auto *prop = dyn_cast<LiteralString>(SPI->getProperty());
+      if (SPI->getObject() == exportsParam &&
+          SPI->getStoredValue() != exportsParam && prop) {
+        Identifier name = prop->getValue();
+        ++storeCount[name];
+        auto *CFI = dyn_cast<CreateFunctionInst>(SPI->getStoredValue());
+        if (!CFI || CFI->getFunctionCode()->getThisParameter()->hasUsers())
+          usesThis.insert(name);
+        continue;
+      }
+    }
+    // The exports object escapes or is modified in some other way.
+    return result;
+  }
+
+  for (auto &entry : storeCount) {
+    if (!usesThis.count(entry.first))
+      result.thisSafe.insert(entry.first);
+  }
+
+  // Only the stores at the start of the entry block are guaranteed to have
+  // happened before anyone can read the exports object.
+  for (Instruction &I : *F->begin()) {
+    auto *SPI = dyn_cast<StorePropertyInst>(&I);
+    if (SPI && SPI->getObject() == exportsParam) {
+      Identifier name = cast<LiteralString>(SPI->getProperty())->getValue();
+      auto *CFI = dyn_cast<CreateFunctionInst>(SPI->getStoredValue());
+      if (CFI && storeCount[name] == 1)
+        result.stable[name] = CFI->getFunctionCode();
+      continue;
+    }
+    if (I.mayExecute())
+      break;
+  }
+  return result;
+}
+
+/// Collect the property loads which read from the exports object \p V,
+/// following it through store-once frame and stack variables, into \p loads.
+/// The object may also be passed as `this` to the methods in \p thisSafe.
+/// \return false if the value is used in any other way.
+bool collectPropertyLoads(
+    Value *V,
+    const llvh::DenseSet<Identifier> &thisSafe,
+    llvh::SmallVectorImpl<LoadPropertyInst *> &loads) {
+  for (Instruction *user : V->getUsers()) {
+    if (auto *LPI = dyn_cast<LoadPropertyInst>(user)) {
+      if (LPI->getObject() == V && isa<LiteralString>(LPI->getProperty())) {
+        loads.push_back(LPI);
+        continue;
+      }
+      return false;
+    }
+    if (auto *CI = dyn_cast<CallInst>(user)) {
+      auto *callee = dyn_cast<LoadPropertyInst>(CI->getCallee());
+      if (!callee || callee->getObject() != V || CI->getThis() != V)
+        return false;
+      auto *prop = dyn_cast<LiteralString>(callee->getProperty());
+      if (!prop || !thisSafe.count(prop->getValue()))
+        return false;
+      for (unsigned i = 1, e = CI->getNumArguments(); i != e; ++i) {
+        if (CI->getArgument(i) == V)
+          return false;
+      }
+      continue;
+    }
+    if (auto *SFI = dyn_cast<StoreFrameInst>(user)) {
+      Variable *var = SFI->getVariable();
+      if (isStoreOnceVariable(var) != V)
+        return false;
+      for (Instruction *varUser : var->getUsers()) {
+        if (varUser == SFI)
+          continue;
+        if (!isa<LoadFrameInst>(varUser) ||
+            !collectPropertyLoads(varUser, thisSafe, loads))
+          return false;
+      }
+      continue;
+    }
+    if (auto *SSI = dyn_cast<StoreStackInst>(user)) {
+      auto *AS = dyn_cast<AllocStackInst>(SSI->getPtr());
+      if (!AS || isStoreOnceStackLocation(AS) != V)
+        return false;
+      for (Instruction *stackUser : AS->getUsers()) {
+        if (stackUser == SSI)
+          continue;
+        if (!isa<LoadStackInst>(stackUser) ||
+            !collectPropertyLoads(stackUser, thisSafe, loads))
+          return false;
+      }
+      continue;
+    }
+    return false;
+  }
+  return true;
+}
+
+/// \return true if the function \p F, which is exported from another module,
+///   can be inlined into \p intoFunction.
+bool canInlineExport(Function *F, Function *intoFunction) {
+  if (F == intoFunction || !canBeInlined(F, intoFunction))
+    return false;
+
+  unsigned size = 0;
+  for (BasicBlock &BB : *F) {
+    for (Instruction &I : BB) {
+      if (++size > kMaxExportInlineSize)
+        return false;
+      // The call site is not nested in the scope of the exporting module, so
+      // the callee can't access any variables.
+      for (unsigned i = 0, e = I.getNumOperands(); i != e; ++i) {
+        if (isa<Variable>(I.getOperand(i)))
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+/// Inline calls to small functions exported from other CJS modules, which
+/// have the form `require("./mod").fn()` after static require resolution.
+/// \return true if anything was inlined.
+bool inlineExportCalls(Module *M) {
+  llvh::DenseMap<uint32_t, ModuleExports> exportsByModule{};
+  for (const auto &module : M->getCJSModules()) {
+    ModuleExports exports = analyzeExports(module.function);
+    if (!exports.stable.empty())
+      exportsByModule[module.id] = std::move(exports);
+  }
+  if (exportsByModule.empty())
+    return false;
+
+  // Find all reads of exports objects. A module whose exports object escapes
+  // anywhere can't be reasoned about.
+  llvh::DenseMap<uint32_t, llvh::SmallVector<LoadPropertyInst *, 4>> reads{};
+  llvh::SmallDenseSet<uint32_t, 4> escaped{};
+  for (Function &F : *M) {
+    for (BasicBlock &BB : F) {
+      for (Instruction &I : BB) {
+        auto *CBI = dyn_cast<CallBuiltinInst>(&I);
+        if (!CBI ||
+            CBI->getBuiltinIndex() != BuiltinMethod::HermesBuiltin_requireFast)
+          continue;
+        // A module loaded by a computed ID could be any of them.
+        auto *idLit = CBI->getNumArguments() > 1
+            ? dyn_cast<LiteralNumber>(CBI->getArgument(1))
+            : nullptr;
+        if (!idLit)
+          return false;
+        auto id = idLit->truncateToUInt32();
+        auto it = exportsByModule.find(id);
+        if (it == exportsByModule.end())
+          continue;
+        if (!collectPropertyLoads(CBI, it->second.thisSafe, reads[id]))
+          escaped.insert(id);
+      }
+    }
+  }
+
+  bool changed = false;
+  for (auto &entry : reads) {
+    if (escaped.count(entry.first))
+      continue;
+    const auto &stable = exportsByModule[entry.first].stable;
+    for (LoadPropertyInst *LPI : entry.second) {
+      auto it =
+          stable.find(cast<LiteralString>(LPI->getProperty())->getValue());
+      if (it == stable.end())
+        continue;
+      Function *FC = it->second;
+
+      // Copy the users, since inlining erases calls.
+      llvh::SmallVector<Instruction *, 2> users{
+          LPI->getUsers().begin(), LPI->getUsers().end()};
+      for (Instruction *user : users) {
+        auto *CI = dyn_cast<CallInst>(user);
+        if (!CI || CI->getKind() != ValueKind::CallInstKind ||
+            !isDirectCallee(LPI, CI) ||
+            !canInlineExport(FC, CI->getParent()->getParent()))
+          continue;
+        inlineCall(M, FC, CI);
+        ++NumInlinedExportCalls;
+        changed = true;
+      }
+
+      // The property is an own data property of an ordinary object, so loading
+      // it has no side effects.
+      if (!LPI->hasUsers())
+        LPI->eraseFromParent();
+    }
+  }
+  return changed;
+}
+
+} // namespace
+
 bool Inlining::runOnModule(Module *M) {
   if (!M->getContext().getOptimizationSettings().inlining)
     return false;
@@ -285,48 +565,19 @@ bool Inlining::runOnModule(Module *M) {
       if (!isDirectCallee(CFI, CI))
         continue;
 
-      Function *intoFunction = CI->getParent()->getParent();
-
       auto *FC = CFI->getFunctionCode();
-      if (!canBeInlined(FC, intoFunction))
+      if (!canBeInlined(FC, CI->getParent()->getParent()))
         continue;
 
-      LLVM_DEBUG(llvh::dbgs() << "Inlining function '"
-                              << FC->getInternalNameStr() << "' ";
-                 FC->getContext().getSourceErrorManager().dumpCoords(
-                     llvh::dbgs(), FC->getSourceRange().Start);
-                 llvh::dbgs() << " into function '"
-                              << intoFunction->getInternalNameStr() << "' ";
-                 FC->getContext().getSourceErrorManager().dumpCoords(
-                     llvh::dbgs(), intoFunction->getSourceRange().Start);
-                 llvh::dbgs() << "\n";);
-
-      IRBuilder builder(M);
-
-      // Split the block in two and move all instructions following the call
-      // to the new block.
-      BasicBlock *nextBlock = builder.createBasicBlock(intoFunction);
-      builder.setInsertionBlock(nextBlock);
-
-      // Move the rest of the instructions.
-      auto it = CI->getIterator();
-      ++it; // Skip over the call.
-      auto e = CI->getParent()->end();
-      while (it != e)
-        builder.transferInstructionToCurrentBlock(&*it++);
-
-      // Perform the inlining.
-      builder.setInsertionPointAfter(CI);
-
-      auto *returnValue = inlineFunction(builder, FC, CI, nextBlock);
-      CI->replaceAllUsesWith(returnValue);
-      CI->eraseFromParent();
-
+      inlineCall(M, FC, CI);
       ++NumInlinedCalls;
       changed = true;
     }
   }
 
+  if (M->getCJSModulesResolved())
+    changed |= inlineExportCalls(M);
+
   return changed;
 }
 
@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#define DEBUG_TYPE "licm"
+
+#include "hermes/Optimizer/Scalar/LICM.h"
+#include "hermes/IR/Analysis.h"
+#include "hermes/IR/CFG.h"
+#include "hermes/IR/IRBuilder.h"
+#include "hermes/IR/Instrs.h"
+#include "hermes/Optimizer/Scalar/Utils.h"
+#include "hermes/Support/Statistic.h"
+
+#include "llvh/ADT/DenseSet.h"
+#include "llvh/ADT/SmallPtrSet.h"
+#include "llvh/ADT/SmallVector.h"
+#include "llvh/Support/Debug.h"
+
+#include <algorithm>
+
+using namespace hermes;
+using llvh::dbgs;
+using llvh::dyn_cast;
+using llvh::isa;
+
+STATISTIC(NumHoisted, "Number of instructions hoisted out of loops");
+STATISTIC(NumPreheaders, "Number of loop preheaders created");
+
+namespace {
+
+/// A natural loop: the header and all blocks which can reach a back edge to
+/// the header without going through it.
+struct Loop {
+  BasicBlock *header;
+  llvh::SmallPtrSet<BasicBlock *, 8> blocks{};
+
+  explicit Loop(BasicBlock *header) : header(header) {}
+
+  bool contains(const BasicBlock *BB) const {
+    return blocks.count(const_cast<BasicBlock *>(BB));
+  }
+};
+
+/// Find all natural loops in the function whose blocks in reverse post order
+/// are \p RPO. Back edges to the same header are merged into one loop.
+/// \return the loops ordered so that inner loops precede the loops that
+///   contain them.
+std::vector<Loop> findLoops(
+    llvh::ArrayRef<BasicBlock *> RPO,
+    const DominanceInfo &DT) {
+  std::vector<Loop> loops{};
+  for (BasicBlock *header : RPO) {
+    llvh::SmallVector<BasicBlock *, 8> worklist{};
+    for (BasicBlock *pred : predecessors(header)) {
+      // Only back edges from reachable blocks form loops.
+      if (DT.getNode(pred) && DT.dominates(header, pred))
+        worklist.push_back(pred);
+    }
+    if (worklist.empty())
+      continue;
+
+    Loop loop{header};
+    loop.blocks.insert(header);
+    while (!worklist.empty()) {
+      BasicBlock *BB = worklist.pop_back_val();
+      if (!loop.blocks.insert(BB).second)
+        continue;
+      for (BasicBlock *pred : predecessors(BB)) {
+        if (DT.getNode(pred))
+          worklist.push_back(pred);
+      }
+    }
+    loops.push_back(std::move(loop));
+  }
+
+  // A loop nested in another has strictly fewer blocks.
+  std::stable_sort(
+      loops.begin(), loops.end(), [](const Loop &a, const Loop &b) {
+        return a.blocks.size() < b.blocks.size();
+      });
+  return loops;
+}
+
+/// \return true if \p I is a numeric conversion of a value which is already a
+/// number. These are only removed by InstSimplify, which runs after LICM, but
+/// they don't write memory.
+bool isNoopConversion(Instruction *I) {
+  auto *ANI = dyn_cast<AsNumberInst>(I);
+  return ANI && ANI->getSingleOperand()->getType().isNumberType();
+}
+
+/// Memory that may be written by the instructions of a loop.
+class LoopClobbers {
+  /// True if the loop may write memory other than the variables in
+  /// storedVariables_.
+  bool clobbersAll_{false};
+
+  /// Frame variables stored in the loop.
+  llvh::SmallPtrSet<Variable *, 4> storedVariables_{};
+
+ public:
+  explicit LoopClobbers(const Loop &loop) {
+    for (BasicBlock *BB : loop.blocks) {
+      for (Instruction &I : *BB) {
+        if (auto *SFI = dyn_cast<StoreFrameInst>(&I)) {
+          storedVariables_.insert(SFI->getVariable());
+        } else if (isNoopConversion(&I)) {
+          continue;
+        } else if (I.mayWriteMemory()) {
+          clobbersAll_ = true;
+          return;
+        }
+      }
+    }
+  }
+
+  /// \return true if \p V may be written in the loop.
+  bool clobbers(Variable *V) const {
+    return clobbersAll_ || storedVariables_.count(V);
+  }
+};
+
+/// \return true if \p I computes the same value on every iteration of \p loop,
+/// given that all of its operands do, and can be executed speculatively.
+bool isHoistable(Instruction *I, const LoopClobbers &clobbers) {
+  if (isSimpleSideEffectFreeInstruction(I))
+    return true;
+  // Loading a variable doesn't throw, so it can be hoisted as long as the
+  // variable isn't stored in the loop.
+  if (auto *LFI = dyn_cast<LoadFrameInst>(I))
+    return !clobbers.clobbers(LFI->getLoadVariable());
+  return false;
+}
+
+/// Collect the instructions of \p loop, visiting its blocks in \p RPO order,
+/// which can be moved to its preheader into \p hoisted. Operands are always
+/// collected before the instructions which use them.
+void collectInvariants(
+    const Loop &loop,
+    llvh::ArrayRef<BasicBlock *> RPO,
+    llvh::SmallVectorImpl<Instruction *> &hoisted) {
+  LoopClobbers clobbers{loop};
+  llvh::SmallPtrSet<Instruction *, 8> invariant{};
+  for (BasicBlock *BB : RPO) {
+    if (!loop.contains(BB))
+      continue;
+    for (Instruction &I : *BB) {
+      if (!isHoistable(&I, clobbers))
+        continue;
+      bool operandsInvariant = true;
+      for (unsigned i = 0, e = I.getNumOperands(); i != e; ++i) {
+        auto *op = dyn_cast<Instruction>(I.getOperand(i));
+        if (op && loop.contains(op->getParent()) && !invariant.count(op)) {
+          operandsInvariant = false;
+          break;
+        }
+      }
+      if (!operandsInvariant)
+        continue;
+      invariant.insert(&I);
+      hoisted.push_back(&I);
+    }
+  }
+}
+
+/// \return the preheader of \p loop: a block outside of the loop whose only
+/// successor is the header, and which is the only way into the loop. If there
+/// is none, create one. \return nullptr if a preheader can't be created
+/// because the loop is entered through an unusual terminator.
+BasicBlock *getOrCreatePreheader(const Loop &loop) {
+  BasicBlock *header = loop.header;
+  llvh::SmallVector<BasicBlock *, 4> outside{};
+  for (BasicBlock *pred : predecessors(header)) {
+    if (!loop.contains(pred) &&
+        std::find(outside.begin(), outside.end(), pred) == outside.end())
+      outside.push_back(pred);
+  }
+  if (outside.empty())
+    return nullptr;
+  if (outside.size() == 1 &&
+      outside[0]->getTerminator()->getNumSuccessors() == 1)
+    return outside[0];
+
+  for (BasicBlock *pred : outside) {
+    auto *term = pred->getTerminator();
+    if (!isa<BranchInst>(term) && !isa<CondBranchInst>(term))
+      return nullptr;
+  }
+
+  Function *F = header->getParent();
+  IRBuilder builder(F);
+  BasicBlock *preheader = builder.createBasicBlock(F);
+  // Place the preheader right before the header so that it falls through.
+  auto &blocks = F->getBasicBlockList();
+  blocks.splice(header->getIterator(), blocks, preheader->getIterator());
+  builder.setInsertionBlock(preheader);
+
+  // Incoming phi values from outside the loop now come from the preheader,
+  // merged by a new phi if there is more than one.
+  for (Instruction &I : *header) {
+    auto *phi = dyn_cast<PhiInst>(&I);
+    if (!phi)
+      break;
+    if (outside.size() == 1) {
+      for (unsigned i = 0, e = phi->getNumEntries(); i != e; ++i) {
+        auto entry = phi->getEntry(i);
+        if (entry.second == outside[0])
+          phi->updateEntry(i, entry.first, preheader);
+      }
+      continue;
+    }
+    PhiInst *merged = builder.createPhiInst();
+    for (unsigned i = 0; i < phi->getNumEntries();) {
+      auto entry = phi->getEntry(i);
+      if (loop.contains(entry.second)) {
+        ++i;
+        continue;
+      }
+      merged->addEntry(entry.first, entry.second);
+      phi->removeEntry(i);
+    }
+    phi->addEntry(merged, preheader);
+  }
+  builder.setLocation(header->front().getLocation());
+  builder.createBranchInst(header);
+
+  for (BasicBlock *pred : outside) {
+    auto *term = pred->getTerminator();
+    for (unsigned i = 0, e = term->getNumSuccessors(); i != e; ++i) {
+      if (term->getSuccessor(i) == header)
+        term->setSuccessor(i, preheader);
+    }
+  }
+  ++NumPreheaders;
+  return preheader;
+}
+
+} // namespace
+
+bool LICM::runOnFunction(Function *F) {
+  bool changed = false;
+  // Creating preheaders changes the CFG, so recompute the analyses and start
+  // over after each loop that has a new one. Loops that have been visited
+  // keep their preheader, so this terminates.
+  for (;;) {
+    PostOrderAnalysis PO(F);
+    llvh::SmallVector<BasicBlock *, 16> RPO(PO.rbegin(), PO.rend());
+    DominanceInfo DT(F);
+
+    bool cfgChanged = false;
+    for (const Loop &loop : findLoops(RPO, DT)) {
+      llvh::SmallVector<Instruction *, 8> hoisted{};
+      collectInvariants(loop, RPO, hoisted);
+      if (hoisted.empty())
+        continue;
+
+      auto numBlocks = F->getBasicBlockList().size();
+      BasicBlock *preheader = getOrCreatePreheader(loop);
+      if (!preheader)
+        continue;
+
+      LLVM_DEBUG(
+          dbgs() << "Hoisting " << hoisted.size()
+                 << " instructions out of a loop in function '"
+                 << F->getInternalNameStr() << "'\n");
+      Instruction *term = preheader->getTerminator();
+      for (Instruction *I : hoisted)
+        I->moveBefore(term);
+      NumHoisted += hoisted.size();
+      changed = true;
+
+      if (F->getBasicBlockList().size() != numBlocks) {
+        cfgChanged = true;
+        break;
+      }
+    }
+    if (!cfgChanged)
+      return changed;
+  }
+}
+
+Pass *hermes::createLICM() {
+  return new LICM();
+}
+
+#undef DEBUG_TYPE
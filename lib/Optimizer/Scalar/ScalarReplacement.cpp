@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#define DEBUG_TYPE "scalarreplacement"
+
+#include "hermes/Optimizer/Scalar/ScalarReplacement.h"
+#include "hermes/IR/IRBuilder.h"
+#include "hermes/IR/Instrs.h"
+#include "hermes/Support/Statistic.h"
+
+#include "llvh/ADT/DenseMap.h"
+#include "llvh/ADT/SmallVector.h"
+#include "llvh/Support/Debug.h"
+
+using namespace hermes;
+using llvh::dbgs;
+using llvh::dyn_cast;
+using llvh::isa;
+
+STATISTIC(NumObjectsReplaced, "Number of object allocations replaced");
+STATISTIC(NumPropsReplaced, "Number of object properties replaced");
+
+namespace {
+
+/// The own properties of an object allocation, mapped to the stack locations
+/// which replace them.
+using PropertyMap = llvh::SmallDenseMap<Identifier, AllocStackInst *, 4>;
+
+/// \return the name of the literal string property \p prop, or an empty
+///   Identifier if it is not a literal string.
+Identifier literalPropName(Value *prop) {
+  if (auto *str = dyn_cast<LiteralString>(prop))
+    return str->getValue();
+  return Identifier{};
+}
+
+/// \return true if \p I has \p V as one of its operands.
+bool usesValue(Instruction *I, Value *V) {
+  for (unsigned i = 0, e = I->getNumOperands(); i != e; ++i) {
+    if (I->getOperand(i) == V)
+      return true;
+  }
+  return false;
+}
+
+/// Check whether the object allocated by \p alloc, which must be an
+/// AllocObjectInst or AllocObjectLiteralInst, can be replaced by scalars and
+/// collect its own properties into \p props.
+///
+/// The object is replaceable if it never escapes: it is only used as the
+/// object operand of loads and stores of literal property names. Loads and
+/// stores must refer to own data properties that are defined when the object
+/// is created, so that they can't reach the prototype chain.
+bool isReplaceable(Instruction *alloc, PropertyMap &props) {
+  if (auto *AOL = dyn_cast<AllocObjectLiteralInst>(alloc)) {
+    for (unsigned i = 0, e = AOL->getKeyValuePairCount(); i != e; ++i) {
+      Identifier name = literalPropName(AOL->getKey(i));
+      if (!name.isValid())
+        return false;
+      props[name] = nullptr;
+    }
+  } else {
+    // An explicit parent could have accessors for the properties that are
+    // accessed.
+    if (!isa<EmptySentinel>(cast<AllocObjectInst>(alloc)->getParentObject()))
+      return false;
+
+    // The properties are defined by the StoreNewOwnPropertyInsts following the
+    // allocation, which must all precede any other use of the object.
+    bool seenOtherUse = false;
+    for (auto it = std::next(alloc->getIterator()),
+              e = alloc->getParent()->end();
+         it != e;
+         ++it) {
+      if (!usesValue(&*it, alloc))
+        continue;
+      auto *SNOP = dyn_cast<StoreNewOwnPropertyInst>(&*it);
+      if (!SNOP) {
+        seenOtherUse = true;
+        continue;
+      }
+      Identifier name = literalPropName(SNOP->getProperty());
+      if (seenOtherUse || !name.isValid())
+        return false;
+      props[name] = nullptr;
+    }
+  }
+
+  for (Instruction *U : alloc->getUsers()) {
+    Value *object;
+    Value *prop;
+    Value *storedValue = nullptr;
+    switch (U->getKind()) {
+      case ValueKind::LoadPropertyInstKind: {
+        auto *LPI = cast<LoadPropertyInst>(U);
+        object = LPI->getObject();
+        prop = LPI->getProperty();
+        break;
+      }
+      case ValueKind::StorePropertyInstKind: {
+        auto *SPI = cast<StorePropertyInst>(U);
+        object = SPI->getObject();
+        prop = SPI->getProperty();
+        storedValue = SPI->getStoredValue();
+        break;
+      }
+      case ValueKind::StoreOwnPropertyInstKind:
+      case ValueKind::StoreNewOwnPropertyInstKind: {
+        auto *SOPI = cast<StoreOwnPropertyInst>(U);
+        object = SOPI->getObject();
+        prop = SOPI->getProperty();
+        storedValue = SOPI->getStoredValue();
+        break;
+      }
+      default:
+        return false;
+    }
+    if (object != alloc || storedValue == alloc)
+      return false;
+    Identifier name = literalPropName(prop);
+    if (!name.isValid() || !props.count(name))
+      return false;
+  }
+  return true;
+}
+
+/// Replace the object allocated by \p alloc with the stack locations in
+/// \p props, which have already been created.
+void replaceObject(
+    IRBuilder &builder,
+    Instruction *alloc,
+    const PropertyMap &props) {
+  IRBuilder::InstructionDestroyer destroyer;
+
+  if (auto *AOL = dyn_cast<AllocObjectLiteralInst>(alloc)) {
+    builder.setInsertionPoint(AOL);
+    builder.setLocation(AOL->getLocation());
+    for (unsigned i = 0, e = AOL->getKeyValuePairCount(); i != e; ++i) {
+      builder.createStoreStackInst(
+          AOL->getValue(i), props.lookup(literalPropName(AOL->getKey(i))));
+    }
+  }
+
+  for (Instruction *U : alloc->getUsers()) {
+    builder.setInsertionPoint(U);
+    builder.setLocation(U->getLocation());
+    if (auto *LPI = dyn_cast<LoadPropertyInst>(U)) {
+      auto *load = builder.createLoadStackInst(
+          props.lookup(literalPropName(LPI->getProperty())));
+      LPI->replaceAllUsesWith(load);
+    } else if (auto *SPI = dyn_cast<StorePropertyInst>(U)) {
+      builder.createStoreStackInst(
+          SPI->getStoredValue(),
+          props.lookup(literalPropName(SPI->getProperty())));
+    } else {
+      auto *SOPI = cast<StoreOwnPropertyInst>(U);
+      builder.createStoreStackInst(
+          SOPI->getStoredValue(),
+          props.lookup(literalPropName(SOPI->getProperty())));
+    }
+    destroyer.add(U);
+  }
+  destroyer.add(alloc);
+}
+
+} // namespace
+
+bool ScalarReplacement::runOnFunction(Function *F) {
+  llvh::SmallVector<Instruction *, 4> allocs{};
+  for (BasicBlock &BB : *F) {
+    for (Instruction &I : BB) {
+      if (isa<AllocObjectInst>(&I) || isa<AllocObjectLiteralInst>(&I))
+        allocs.push_back(&I);
+    }
+  }
+
+  IRBuilder builder(F);
+  bool changed = false;
+  for (Instruction *alloc : allocs) {
+    PropertyMap props{};
+    if (!isReplaceable(alloc, props))
+      continue;
+
+    LLVM_DEBUG(
+        dbgs() << "Replacing object with " << props.size()
+               << " properties in function '" << F->getInternalNameStr()
+               << "'\n");
+
+    // Create the stack locations at the start of the function, like all other
+    // stack allocations.
+    BasicBlock &entry = F->front();
+    builder.setInsertionBlock(&entry);
+    for (auto &prop : props) {
+      prop.second = builder.createAllocStackInst(prop.first);
+      prop.second->moveBefore(&*entry.begin());
+    }
+
+    replaceObject(builder, alloc, props);
+    NumPropsReplaced += props.size();
+    ++NumObjectsReplaced;
+    changed = true;
+  }
+  return changed;
+}
+
+Pass *hermes::createScalarReplacement() {
+  return new ScalarReplacement();
+}
+
+#undef DEBUG_TYPE
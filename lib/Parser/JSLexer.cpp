@@ -8,6 +8,7 @@
 #include "hermes/Parser/JSLexer.h"
 
 #include "dtoa/dtoa.h"
+#include "hermes/Support/ByteScan.h"
 #include "hermes/Support/Conversions.h"
 
 #include "llvh/ADT/ScopeExit.h"
@@ -377,9 +378,13 @@ const Token *JSLexer::advance(GrammarContext grammarContext) {
       case '\t':
       case ' ':
         // Spaces frequently come in groups, so use a tight inner loop to skip.
-        do
-          ++curCharPtr_;
-        while (*curCharPtr_ == '\t' || *curCharPtr_ == ' ');
+        // Longer runs, like indentation, are skipped a vector at a time.
+        ++curCharPtr_;
+        if (*curCharPtr_ == '\t' || *curCharPtr_ == ' ') {
+          curCharPtr_ = bytescan::skipSpacesAndTabs(curCharPtr_, bufferEnd_);
+          while (*curCharPtr_ == '\t' || *curCharPtr_ == ' ')
+            ++curCharPtr_;
+        }
         continue;
 
       // No-break space \u00A0 is UTF8 encoded as: c2 a0
@@ -1262,7 +1267,7 @@ llvh::StringRef JSLexer::lineCommentHelper(const char *start) {
         if (LLVM_UNLIKELY(isUTF8Start(*cur)))
           _decodeUTF8SlowPath(cur);
         else
-          ++cur;
+          cur = bytescan::skipUntil(cur + 1, bufferEnd_, '\r', '\n', 0, 0);
         break;
     }
   }
@@ -1341,7 +1346,7 @@ const char *JSLexer::skipBlockComment(const char *start) {
         if (LLVM_UNLIKELY(isUTF8Start(*cur)))
           _decodeUTF8SlowPath(cur);
         else
-          ++cur;
+          cur = bytescan::skipUntil(cur + 1, bufferEnd_, '*', '\r', '\n', 0);
         break;
     }
   }
@@ -1641,16 +1646,14 @@ TokenKind JSLexer::scanReservedWord(const char *start, unsigned length) {
 
 template <JSLexer::IdentifierMode Mode>
 void JSLexer::scanIdentifierFastPath(const char *start) {
-  const char *end = start;
-
-  // Quickly consume the ASCII identifier part.
-  char ch;
-  do
-    ch = (unsigned char)*++end;
+  // Quickly consume the ASCII identifier part, a vector at a time first.
+  const char *end = bytescan::skipASCIIIdentifierParts(start + 1, bufferEnd_);
+  char ch = (unsigned char)*end;
   while (ch == '_' || ch == '$' || ((ch | 32) >= 'a' && (ch | 32) <= 'z') ||
          (ch >= '0' && ch <= '9') ||
          (Mode == IdentifierMode::JSX && ch == '-') ||
-         (Mode == IdentifierMode::Flow && ch == '@'));
+         (Mode == IdentifierMode::Flow && ch == '@'))
+    ch = (unsigned char)*++end;
 
   // Check whether a slow part of the identifier follows.
   if (LLVM_UNLIKELY(ch == '\\')) {
@@ -1862,8 +1865,14 @@ void JSLexer::scanString() {
         // Decode and re-encode the character and append it to the string
         // storage
         appendUnicodeToStorage(_decodeUTF8SlowPath(curCharPtr_));
-      } else {
+      } else if (JSX) {
         tmpStorage_.push_back(*curCharPtr_++);
+      } else {
+        // Copy runs of plain characters in bulk.
+        const char *runEnd = bytescan::skipUntil(
+            curCharPtr_ + 1, bufferEnd_, quoteCh, '\\', '\r', '\n');
+        tmpStorage_.append(curCharPtr_, runEnd);
+        curCharPtr_ = runEnd;
       }
     }
   }
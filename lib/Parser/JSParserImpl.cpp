@@ -690,11 +690,53 @@ Optional<ESTree::BlockStatementNode *> JSParserImpl::parseFunctionBody(
     bool paramAwait,
     JSLexer::GrammarContext grammarContext,
     bool parseDirectives) {
+  if (pass_ == PreParse && !eagerly && canSkipFunctionBodies()) {
+    auto startLoc = tok_->getStartLoc();
+    switch (skipFunctionBody()) {
+      case SkipResult::Error:
+        return None;
+      case SkipResult::MustParse:
+        break;
+      case SkipResult::Skipped: {
+        const PreParsedFunctionInfo &functionInfo =
+            preParsed_->functionInfo[startLoc];
+        SMLoc endLoc = functionInfo.end;
+        setStrictMode(functionInfo.strictMode);
+        advance(grammarContext);
+        return setLocation(
+            startLoc,
+            endLoc,
+            new (context_) ESTree::BlockStatementNode({}));
+      }
+    }
+  }
+
   if (pass_ == LazyParse && !eagerly) {
     auto startLoc = tok_->getStartLoc();
-    assert(
-        preParsed_->functionInfo.count(startLoc) == 1 &&
-        "no function info stored during preparse");
+    if (!preParsed_->functionInfo.count(startLoc)) {
+      // Functions nested in a body which was skipped during preparsing have
+      // not been indexed yet. Skip them now to find out their extent, then
+      // rewind and treat them like the others.
+      assert(
+          canSkipFunctionBodies() &&
+          "no function info stored during preparse");
+      JSLexer::SavePoint savePoint{&lexer_};
+      switch (skipFunctionBody()) {
+        case SkipResult::Error:
+          return None;
+        case SkipResult::MustParse:
+          break;
+        case SkipResult::Skipped:
+          savePoint.restore();
+          tok_ = lexer_.getCurToken();
+          break;
+      }
+    }
+  }
+
+  if (pass_ == LazyParse && !eagerly &&
+      preParsed_->functionInfo.count(tok_->getStartLoc())) {
+    auto startLoc = tok_->getStartLoc();
     PreParsedFunctionInfo functionInfo = preParsed_->functionInfo[startLoc];
     SMLoc endLoc = functionInfo.end;
     if ((unsigned)(endLoc.getPointer() - startLoc.getPointer()) >=
@@ -745,6 +787,160 @@ Optional<ESTree::BlockStatementNode *> JSParserImpl::parseFunctionBody(
   return body;
 }
 
+JSParserImpl::SkipResult JSParserImpl::skipFunctionBody() {
+  assert(check(TokenKind::l_brace) && "function body must start with '{'");
+  SMLoc startLoc = tok_->getStartLoc();
+  JSLexer::SavePoint savePoint{&lexer_};
+  unsigned errorCount = sm_.getErrorCount();
+  PreParsedFunctionInfo functionInfo{};
+
+  auto mustParse = [this, &savePoint, errorCount]() {
+    if (sm_.getErrorCount() != errorCount)
+      return SkipResult::Error;
+    savePoint.restore();
+    tok_ = lexer_.getCurToken();
+    return SkipResult::MustParse;
+  };
+
+  {
+    SaveStrictModeAndSeenDirectives saveStrictModeAndSeenDirectives{this};
+
+    // Process the directive prologue exactly like parseDirective(), since
+    // "use strict" affects both the function and how its body is scanned.
+    advance();
+    while (lexer_.isCurrentTokenADirective()) {
+      processDirective(tok_->getStringLiteral());
+      advance(JSLexer::AllowDiv);
+      if (check(TokenKind::semi))
+        advance();
+    }
+    functionInfo.strictMode = isStrictMode();
+    functionInfo.directives = copySeenDirectives();
+
+    /// Brackets which are currently open.
+    enum class Open : uint8_t { Brace, Paren, ControlParen, Square, Template };
+    llvh::SmallVector<Open, 32> open{Open::Brace};
+
+    // The previous two token kinds, used to recognize the parentheses after
+    // 'for await'.
+    TokenKind prevKind = TokenKind::l_brace;
+    TokenKind prevPrevKind = TokenKind::none;
+
+    for (;;) {
+      // Set when the token that was just closed is the ')' of an if, for,
+      // while or with statement, which is followed by a statement rather
+      // than a division.
+      bool closedControlParen = false;
+
+      switch (tok_->getKind()) {
+        case TokenKind::eof:
+          // Let the parser report the missing brace.
+          return mustParse();
+        case TokenKind::l_brace:
+          open.push_back(Open::Brace);
+          break;
+        case TokenKind::template_head:
+          open.push_back(Open::Template);
+          break;
+        case TokenKind::l_square:
+          open.push_back(Open::Square);
+          break;
+        case TokenKind::l_paren: {
+          bool control = prevKind == TokenKind::rw_if ||
+              prevKind == TokenKind::rw_for ||
+              prevKind == TokenKind::rw_while ||
+              prevKind == TokenKind::rw_with ||
+              (prevKind == TokenKind::identifier &&
+               prevPrevKind == TokenKind::rw_for);
+          open.push_back(control ? Open::ControlParen : Open::Paren);
+          break;
+        }
+        case TokenKind::r_brace:
+          if (open.back() == Open::Template) {
+            tok_ = lexer_.rescanRBraceInTemplateLiteral();
+            if (tok_->getKind() == TokenKind::template_tail)
+              open.pop_back();
+            break;
+          }
+          if (open.back() != Open::Brace)
+            return mustParse();
+          open.pop_back();
+          break;
+        case TokenKind::r_paren:
+          if (open.back() != Open::Paren && open.back() != Open::ControlParen)
+            return mustParse();
+          closedControlParen = open.back() == Open::ControlParen;
+          open.pop_back();
+          break;
+        case TokenKind::r_square:
+          if (open.back() != Open::Square)
+            return mustParse();
+          open.pop_back();
+          break;
+        default:
+          break;
+      }
+
+      if (open.empty())
+        break;
+
+      // Decide whether a '/' after the current token is a division or starts
+      // a regexp. When that depends on more context than is available here,
+      // scan it as a division and give up if one actually follows.
+      JSLexer::GrammarContext grammarContext = JSLexer::AllowRegExp;
+      bool ambiguous = false;
+      switch (tok_->getKind()) {
+        case TokenKind::identifier:
+          grammarContext = JSLexer::AllowDiv;
+          ambiguous = tok_->getIdentifier() == yieldIdent_ ||
+              tok_->getIdentifier() == awaitIdent_ ||
+              tok_->getIdentifier() == ofIdent_;
+          break;
+        case TokenKind::private_identifier:
+        case TokenKind::numeric_literal:
+        case TokenKind::string_literal:
+        case TokenKind::regexp_literal:
+        case TokenKind::no_substitution_template:
+        case TokenKind::template_tail:
+        case TokenKind::r_square:
+        case TokenKind::rw_this:
+        case TokenKind::rw_super:
+        case TokenKind::rw_null:
+        case TokenKind::rw_true:
+        case TokenKind::rw_false:
+        case TokenKind::plusplus:
+        case TokenKind::minusminus:
+          grammarContext = JSLexer::AllowDiv;
+          break;
+        case TokenKind::r_paren:
+          if (!closedControlParen)
+            grammarContext = JSLexer::AllowDiv;
+          break;
+        case TokenKind::r_brace:
+          // Could be the end of a block or of an object literal.
+          grammarContext = JSLexer::AllowDiv;
+          ambiguous = true;
+          break;
+        default:
+          break;
+      }
+
+      prevPrevKind = prevKind;
+      prevKind = tok_->getKind();
+      advance(grammarContext);
+      if (sm_.getErrorCount() != errorCount)
+        return SkipResult::Error;
+      if (ambiguous &&
+          (check(TokenKind::slash) || check(TokenKind::slashequal)))
+        return mustParse();
+    }
+  }
+
+  functionInfo.end = tok_->getEndLoc();
+  preParsed_->functionInfo[startLoc] = std::move(functionInfo);
+  return SkipResult::Skipped;
+}
+
 Optional<ESTree::Node *> JSParserImpl::parseDeclaration(Param param) {
   CHECK_RECURSION;
 
@@ -679,6 +679,32 @@ class JSParserImpl {
       JSLexer::GrammarContext grammarContext = JSLexer::AllowRegExp,
       bool parseDirectives = false);
 
+  /// Outcome of \c skipFunctionBody().
+  enum class SkipResult {
+    /// The body was skipped and its info recorded in \c preParsed_. The
+    /// current token is the closing '}'.
+    Skipped,
+    /// The body cannot be skipped reliably at the token level and must be
+    /// parsed. The parser has been rewound to the opening '{'.
+    MustParse,
+    /// A lexical error was reported.
+    Error,
+  };
+
+  /// \return true if function bodies can be skipped by matching brackets,
+  /// which is not the case when JSX or type annotations may change how
+  /// tokens are scanned.
+  bool canSkipFunctionBodies() const {
+    return !context_.getParseJSX() && !context_.getParseTypes();
+  }
+
+  /// Skip over the function body starting at the current '{' token without
+  /// building an AST: only the directive prologue is processed, and the rest
+  /// of the body is scanned token by token to find the matching '}'. Syntax
+  /// errors other than lexical ones are reported when the function is
+  /// eventually parsed.
+  SkipResult skipFunctionBody();
+
   /// Parse a declaration.
   /// \param param [Yield]
   Optional<ESTree::Node *> parseDeclaration(Param param);
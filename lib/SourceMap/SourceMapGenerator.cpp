@@ -26,22 +26,49 @@ struct VLQ {
 llvh::raw_ostream &operator<<(llvh::raw_ostream &OS, VLQ vlq) {
   return base64vlq::encode(OS, vlq.val);
 }
+
+/// Write the start of the index map section for \p line to \p OS, up to the
+/// opening quote of its "mappings" field.
+void outputSectionHeader(llvh::raw_ostream &OS, uint32_t line) {
+  OS << "{\"offset\":{\"line\":" << line
+     << ",\"column\":0},\"map\":{\"version\":3,\"mappings\":\"";
+}
+
+/// \return whether any source in \p metadataList has metadata.
+bool hasSourcesMetadata(const SourceMap::MetadataList &metadataList) {
+  for (const auto &entry : metadataList) {
+    if (entry.hasValue() &&
+        entry.getValue()->getKind() != parser::JSONKind::Null) {
+      return true;
+    }
+  }
+  return false;
+}
+
 } // namespace
 
-uint32_t SourceMapGenerator::addSource(
+uint32_t SourceMapGenerator::addSourceTo(
+    StringSetVector &table,
+    SourceMap::MetadataList &metadataList,
     llvh::StringRef filename,
     llvh::Optional<SourceMap::MetadataEntry> metadata) {
-  uint32_t index = filenameTable_.insert(filename);
-  if (sourcesMetadata_.size() <= index) {
-    sourcesMetadata_.resize(index + 1);
+  uint32_t index = table.insert(filename);
+  if (metadataList.size() <= index) {
+    metadataList.resize(index + 1);
   }
   if (metadata.hasValue() &&
       metadata.getValue()->getKind() != parser::JSONKind::Null) {
-    sourcesMetadata_[index] = metadata.getValue();
+    metadataList[index] = metadata.getValue();
   }
   return index;
 }
 
+uint32_t SourceMapGenerator::addSource(
+    llvh::StringRef filename,
+    llvh::Optional<SourceMap::MetadataEntry> metadata) {
+  return addSourceTo(filenameTable_, sourcesMetadata_, filename, metadata);
+}
+
 std::pair<llvh::Optional<SourceMap::Segment>, const SourceMap *>
 SourceMapGenerator::getInputSegmentForSegment(
     const SourceMap::Segment &seg) const {
@@ -67,24 +94,14 @@ SourceMapGenerator::getInputSegmentForSegment(
   return std::make_pair(inputSeg, inputMap);
 }
 
-bool SourceMapGenerator::hasSourcesMetadata() const {
-  for (const auto &entry : sourcesMetadata_) {
-    if (entry.hasValue() &&
-        entry.getValue()->getKind() != parser::JSONKind::Null) {
-      return true;
-    }
-  }
-  return false;
-}
-
 SourceMapGenerator::State SourceMapGenerator::encodeSourceLocations(
     const SourceMapGenerator::State &lastState,
     llvh::ArrayRef<SourceMap::Segment> segments,
+    bool first,
     llvh::raw_ostream &OS) {
   // Currently we only support a single source, so the source ID (and its delta)
   // is always 0.
   SourceMapGenerator::State state = lastState, prevState = lastState;
-  bool first = true;
   for (const SourceMap::Segment &seg : segments) {
     // Segments are separated by commas.
     state.generatedColumn = seg.generatedColumn;
@@ -109,110 +126,137 @@ SourceMapGenerator::State SourceMapGenerator::encodeSourceLocations(
   return prevState;
 }
 
-std::string SourceMapGenerator::getVLQMappingsString() const {
-  std::string result;
-  llvh::raw_string_ostream OS(result);
-  State state;
-  for (const SourceMap::SegmentList &segments : lines_) {
-    // The generated column (unlike other fields) resets with each new line.
-    state.generatedColumn = 0;
-    state = encodeSourceLocations(state, segments, OS);
-    OS << ';';
+SourceMap::Segment SourceMapGenerator::mergeWithInputSourceMaps(
+    const SourceMap::Segment &seg) {
+  auto pair = getInputSegmentForSegment(seg);
+  auto inputSeg = pair.first;
+  auto inputMap = pair.second;
+
+  SourceMap::Segment newSeg = seg;
+  newSeg.representedLocation = llvh::None;
+
+  if (inputSeg.hasValue() && inputSeg->representedLocation.hasValue()) {
+    // We have an input source map and were able to find a merged source
+    // location.
+
+    auto loc = inputSeg->representedLocation.getValue();
+    // Our _output_ sourceRoot is empty, so make sure to canonicalize
+    // the path based on the input map's sourceRoot.
+    std::string filename = inputMap->getSourceFullPath(loc.sourceIndex);
+
+    newSeg.representedLocation = SourceMap::Segment::SourceLocation(
+        addSourceTo(
+            mergedSources_,
+            mergedSourcesMetadata_,
+            filename,
+            inputMap->getSourceMetadata(loc.sourceIndex)),
+        loc.lineIndex,
+        loc.columnIndex
+        // TODO: Handle name index
+    );
+  }
+
+  if (!inputMap && !newSeg.representedLocation.hasValue() &&
+      seg.representedLocation.hasValue()) {
+    // Failed to find a merged location because there is no input source
+    // map. Use the existing location, but copy over the source file name.
+    newSeg.representedLocation = seg.representedLocation;
+    newSeg.representedLocation->sourceIndex = addSourceTo(
+        mergedSources_,
+        mergedSourcesMetadata_,
+        filenameTable_[seg.representedLocation->sourceIndex],
+        getSourceMetadata(seg.representedLocation->sourceIndex));
   }
-  OS.flush();
-  return result;
-}
 
-std::vector<llvh::StringRef> SourceMapGenerator::getSources() const {
-  return std::vector<llvh::StringRef>(
-      filenameTable_.begin(), filenameTable_.end());
+  // Return the new segment even if it has no represented location. If there
+  // is an input source map, all locations we emit will be in terms of it, or
+  // be explicitly unmapped.
+  return newSeg;
 }
 
-SourceMapGenerator SourceMapGenerator::mergedWithInputSourceMaps() const {
+void SourceMapGenerator::startMappingsLine(uint32_t segmentID) {
   assert(
-      !inputSourceMaps_.empty() &&
-      "Cannot merge source maps without input source maps");
-
-  auto sources = getSources();
-
-  // Create a new SourceMapGenerator with the merged data.
-  SourceMapGenerator merged;
-
-  for (uint32_t i = 0, e = lines_.size(); i < e; ++i) {
-    SourceMap::SegmentList newLine{};
-
-    for (const auto &seg : lines_[i]) {
-      auto pair = getInputSegmentForSegment(seg);
-      auto inputSeg = pair.first;
-      auto inputMap = pair.second;
-
-      SourceMap::Segment newSeg = seg;
-      newSeg.representedLocation = llvh::None;
-
-      if (inputSeg.hasValue() && inputSeg->representedLocation.hasValue()) {
-        // We have an input source map and were able to find a merged source
-        // location.
-
-        auto loc = inputSeg->representedLocation.getValue();
-        // Our _output_ sourceRoot is empty, so make sure to canonicalize
-        // the path based on the input map's sourceRoot.
-        std::string filename = inputMap->getSourceFullPath(loc.sourceIndex);
-
-        newSeg.representedLocation = SourceMap::Segment::SourceLocation(
-            merged.addSource(
-                filename, inputMap->getSourceMetadata(loc.sourceIndex)),
-            loc.lineIndex,
-            loc.columnIndex
-            // TODO: Handle name index
-        );
-      }
-
-      if (!inputMap && !newSeg.representedLocation.hasValue() &&
-          seg.representedLocation.hasValue()) {
-        // Failed to find a merged location because there is no input source
-        // map. Use the existing location, but copy over the source file name.
-        newSeg.representedLocation = seg.representedLocation;
-        newSeg.representedLocation->sourceIndex = merged.addSource(
-            sources[seg.representedLocation->sourceIndex],
-            getSourceMetadata(seg.representedLocation->sourceIndex));
-      }
-
-      // Push the new segment even if it has no represented location. If there
-      // is an input source map, all locations we emit will be in terms of it,
-      // or be explicitly unmapped.
-      newLine.push_back(std::move(newSeg));
-    }
+      segmentID + 1 >= lineSizes_.size() &&
+      "mappings lines must be added in order");
+  if (segmentID + 1 == lineSizes_.size())
+    return;
+
+  llvh::raw_string_ostream bufferOS(buffer_);
+  llvh::raw_ostream &OS = out(bufferOS);
+  if (!lineSizes_.empty()) {
+    endMappingsLine(OS);
+    if (format_ == Format::Index)
+      OS << ',';
+  }
+  // Skipped lines are left empty, and have no section in an index map.
+  while (lineSizes_.size() < segmentID) {
+    if (format_ == Format::Regular)
+      OS << ';';
+    lineSizes_.push_back(0);
+  }
+  lineSizes_.push_back(0);
 
-    merged.addMappingsLine(std::move(newLine), i);
+  if (format_ == Format::Index) {
+    // Each section is a separate map, so its encoding starts afresh.
+    state_ = State{};
+    outputSectionHeader(OS, segmentID);
+  } else {
+    // The generated column (unlike other fields) resets with each new line.
+    state_.generatedColumn = 0;
   }
-  merged.functionOffsets_ = functionOffsets_;
-  return merged;
 }
 
-void SourceMapGenerator::outputAsJSON(llvh::raw_ostream &OS) const {
+void SourceMapGenerator::addMappings(
+    llvh::ArrayRef<SourceMap::Segment> segments) {
+  assert(!lineSizes_.empty() && "no mappings line has been started");
+  llvh::raw_string_ostream bufferOS(buffer_);
+  llvh::raw_ostream &OS = out(bufferOS);
+  bool first = lineSizes_.back() == 0;
   if (inputSourceMaps_.empty()) {
-    this->outputAsJSONImpl(OS);
+    state_ = encodeSourceLocations(state_, segments, first, OS);
   } else {
-    // If there are input source maps, we must merge them into a new
-    // SourceMapGenerator before output.
-    mergedWithInputSourceMaps().outputAsJSONImpl(OS);
+    for (const SourceMap::Segment &seg : segments) {
+      state_ = encodeSourceLocations(
+          state_, mergeWithInputSourceMaps(seg), first, OS);
+      first = false;
+    }
   }
+  lineSizes_.back() += segments.size();
 }
 
-void SourceMapGenerator::outputAsJSONImpl(llvh::raw_ostream &OS) const {
-  JSONEmitter json(OS);
-  json.openDict();
-  json.emitKeyValue("version", 3);
+void SourceMapGenerator::endMappingsLine(llvh::raw_ostream &OS) {
+  if (format_ == Format::Regular) {
+    OS << ';';
+    return;
+  }
+  OS << '"';
+  outputSources(OS);
+  OS << "}}";
+}
 
-  json.emitKey("sources");
-  json.openArray();
-  json.emitValues(llvh::makeArrayRef(getSources()));
-  json.closeArray();
+void SourceMapGenerator::streamTo(llvh::raw_ostream &OS) {
+  assert(lineSizes_.empty() && "streaming must start before any mappings");
+  streamOS_ = &OS;
+  OS << (format_ == Format::Index ? "{\"version\":3,\"sections\":["
+                                  : "{\"version\":3,\"mappings\":\"");
+}
+
+void SourceMapGenerator::outputSources(llvh::raw_ostream &OS) const {
+  const StringSetVector &sources = getOutputSources();
+  OS << ",\"sources\":";
+  JSONEmitter sourcesJSON(OS);
+  sourcesJSON.openArray();
+  for (const std::string &source : sources) {
+    sourcesJSON.emitValue(source);
+  }
+  sourcesJSON.closeArray();
 
-  if (hasSourcesMetadata()) {
-    json.emitKey("x_facebook_sources");
+  const SourceMap::MetadataList &metadataList = getOutputSourcesMetadata();
+  if (hasSourcesMetadata(metadataList)) {
+    OS << ",\"x_facebook_sources\":";
+    JSONEmitter json(OS);
     json.openArray();
-    for (const auto &source : sourcesMetadata_) {
+    for (const auto &source : metadataList) {
       if (source.hasValue()) {
         source.getValue()->emitInto(json);
       } else {
@@ -221,22 +265,59 @@ void SourceMapGenerator::outputAsJSONImpl(llvh::raw_ostream &OS) const {
     }
     json.closeArray();
   }
+}
 
-  json.emitKeyValue("mappings", getVLQMappingsString());
+void SourceMapGenerator::outputFunctionOffsets(llvh::raw_ostream &OS) const {
+  if (functionOffsets_.empty())
+    return;
+  OS << ",\"x_hermes_function_offsets\":";
+  JSONEmitter json(OS);
+  json.openDict();
+  for (const auto &entry : functionOffsets_) {
+    const auto &segmentFunctionOffsets = entry.second;
+    json.emitKey(std::to_string(entry.first));
+    json.openArray();
+    json.emitValues((llvh::ArrayRef<uint32_t>)segmentFunctionOffsets);
+    json.closeArray();
+  }
+  json.closeDict();
+}
 
-  if (!functionOffsets_.empty()) {
-    json.emitKey("x_hermes_function_offsets");
-    json.openDict();
-    for (const auto &entry : functionOffsets_) {
-      const auto &segmentFunctionOffsets = entry.second;
-      json.emitKey(std::to_string(entry.first));
-      json.openArray();
-      json.emitValues((llvh::ArrayRef<uint32_t>)segmentFunctionOffsets);
-      json.closeArray();
+void SourceMapGenerator::outputAsJSON(llvh::raw_ostream &OS) {
+  if (streamOS_) {
+    assert(&OS == streamOS_ && "streamed map finished on another stream");
+    if (!lineSizes_.empty())
+      endMappingsLine(OS);
+    if (format_ == Format::Regular) {
+      OS << '"';
+      outputSources(OS);
+    } else {
+      OS << ']';
     }
-    json.closeDict();
+    outputFunctionOffsets(OS);
+    OS << '}';
+    OS.flush();
+    streamOS_ = nullptr;
+    return;
   }
-  json.closeDict();
+
+  // Everything but the buffered part is written here, so that the output can
+  // be repeated.
+  if (format_ == Format::Regular) {
+    OS << "{\"version\":3";
+    outputSources(OS);
+    OS << ",\"mappings\":\"" << buffer_;
+    if (!lineSizes_.empty())
+      endMappingsLine(OS);
+    OS << '"';
+  } else {
+    OS << "{\"version\":3,\"sections\":[" << buffer_;
+    if (!lineSizes_.empty())
+      endMappingsLine(OS);
+    OS << ']';
+  }
+  outputFunctionOffsets(OS);
+  OS << '}';
   OS.flush();
 }
 
@@ -9,6 +9,7 @@
 
 #include "hermes/Parser/JSONParser.h"
 #include "hermes/Support/Base64vlq.h"
+#include "hermes/Support/StringSetVector.h"
 
 #include <algorithm>
 #include <memory>
@@ -39,24 +40,44 @@ std::unique_ptr<SourceMap> SourceMapParser::parse(
   //  1. 'file' field
   //  2. 'names' field
   //  3. 'sourcesContent' field.
-  //  4. Index map.
+  //  4. 'url' field of index map sections.
   //  5. Facebook segments extension.
   auto *json = llvh::dyn_cast_or_null<JSONObject>(parsedMap.getValue());
   if (json == nullptr) {
     sm.error(genericLoc, "Expected a source map object");
     return nullptr;
   }
+  if (json->get("sections") != nullptr) {
+    return parseIndexMap(json, alloc, genericLoc, sm);
+  }
+  return parseRegularMap(json, alloc, genericLoc, sm);
+}
 
+/// Check that \p json has version 3, reporting an error at \p loc if not.
+static bool checkVersion(
+    const JSONObject *json,
+    SMLoc loc,
+    SourceErrorManager &sm) {
   auto *version = llvh::dyn_cast_or_null<JSONNumber>(json->get("version"));
   if (version == nullptr) {
-    sm.error(genericLoc, "Source map does not contain a version field");
-    return nullptr;
+    sm.error(loc, "Source map does not contain a version field");
+    return false;
   }
   if ((uint64_t)version->getValue() != 3) {
-    sm.error(genericLoc, "Source map version != 3");
-    return nullptr;
+    sm.error(loc, "Source map version != 3");
+    return false;
   }
+  return true;
+}
 
+std::unique_ptr<SourceMap> SourceMapParser::parseRegularMap(
+    const parser::JSONObject *json,
+    const std::shared_ptr<parser::JSLexer::Allocator> &alloc,
+    SMLoc genericLoc,
+    SourceErrorManager &sm) {
+  if (!checkVersion(json, genericLoc, sm)) {
+    return nullptr;
+  }
   // sourceRoot is optional.
   std::string sourceRoot;
   auto *sourceRootJson =
@@ -111,6 +132,103 @@ std::unique_ptr<SourceMap> SourceMapParser::parse(
       std::move(sourcesMetadata));
 }
 
+std::unique_ptr<SourceMap> SourceMapParser::parseIndexMap(
+    const parser::JSONObject *json,
+    const std::shared_ptr<parser::JSLexer::Allocator> &alloc,
+    SMLoc genericLoc,
+    SourceErrorManager &sm) {
+  if (!checkVersion(json, genericLoc, sm)) {
+    return nullptr;
+  }
+  auto *sectionsJson = llvh::dyn_cast<JSONArray>(json->get("sections"));
+  if (sectionsJson == nullptr) {
+    sm.error(genericLoc, "'sections' of index map is not an array");
+    return nullptr;
+  }
+
+  // The sections are flattened into a single map, with the sources of all
+  // sections merged.
+  StringSetVector sources;
+  SourceMap::MetadataList sourcesMetadata;
+  std::vector<SourceMap::SegmentList> lines;
+  for (unsigned i = 0, e = sectionsJson->size(); i < e; ++i) {
+    std::string sectionName = "Index map section #" + std::to_string(i);
+    auto *section = llvh::dyn_cast_or_null<JSONObject>(sectionsJson->at(i));
+    auto *offset = section
+        ? llvh::dyn_cast_or_null<JSONObject>(section->get("offset"))
+        : nullptr;
+    auto *line = offset
+        ? llvh::dyn_cast_or_null<JSONNumber>(offset->get("line"))
+        : nullptr;
+    auto *column = offset
+        ? llvh::dyn_cast_or_null<JSONNumber>(offset->get("column"))
+        : nullptr;
+    if (line == nullptr || column == nullptr) {
+      sm.error(genericLoc, sectionName + " has no valid offset");
+      return nullptr;
+    }
+    auto *mapJson = llvh::dyn_cast_or_null<JSONObject>(section->get("map"));
+    if (mapJson == nullptr) {
+      sm.error(genericLoc, sectionName + " has no map");
+      return nullptr;
+    }
+    uint32_t lineOffset = line->getValue();
+    int32_t columnOffset = column->getValue();
+    // Sections must be in order, and may only share the line where one ends
+    // and the next begins.
+    if (lineOffset + 1 < lines.size()) {
+      sm.error(genericLoc, sectionName + " is out of order");
+      return nullptr;
+    }
+
+    std::unique_ptr<SourceMap> map =
+        parseRegularMap(mapJson, alloc, genericLoc, sm);
+    if (!map) {
+      return nullptr;
+    }
+
+    std::vector<int32_t> sourceIndices(map->getNumSourcePaths());
+    for (uint32_t j = 0, je = sourceIndices.size(); j < je; ++j) {
+      sourceIndices[j] = sources.insert(map->getSourceFullPath(j));
+      if (sourcesMetadata.size() <= (size_t)sourceIndices[j]) {
+        sourcesMetadata.resize(sourceIndices[j] + 1);
+      }
+      if (auto metadata = map->getSourceMetadata(j)) {
+        sourcesMetadata[sourceIndices[j]] = metadata;
+      }
+    }
+
+    llvh::ArrayRef<SourceMap::SegmentList> mapLines = map->getLines();
+    if (lines.size() < lineOffset + mapLines.size()) {
+      lines.resize(lineOffset + mapLines.size());
+    }
+    for (uint32_t j = 0, je = mapLines.size(); j < je; ++j) {
+      for (SourceMap::Segment seg : mapLines[j]) {
+        // Only the first line of the section is offset horizontally.
+        if (j == 0) {
+          seg.generatedColumn += columnOffset;
+        }
+        if (seg.representedLocation.hasValue()) {
+          int32_t &sourceIndex = seg.representedLocation->sourceIndex;
+          if (sourceIndex < 0 ||
+              (size_t)sourceIndex >= sourceIndices.size()) {
+            sm.error(genericLoc, sectionName + " has an invalid source index");
+            return nullptr;
+          }
+          sourceIndex = sourceIndices[sourceIndex];
+        }
+        lines[lineOffset + j].push_back(std::move(seg));
+      }
+    }
+  }
+
+  return std::make_unique<SourceMap>(
+      "",
+      std::vector<std::string>(sources.begin(), sources.end()),
+      std::move(lines),
+      std::move(sourcesMetadata));
+}
+
 bool SourceMapParser::parseMappings(
     llvh::StringRef sourceMappings,
     std::vector<SourceMap::SegmentList> &lines) {
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/LZBlock.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace hermes {
+namespace lzblock {
+
+namespace {
+
+/// Number of bits used to index the match finder hash table.
+constexpr unsigned kHashBits = 12;
+
+/// Farthest distance a back reference can reach (offsets are 16 bits).
+constexpr uint32_t kMaxOffset = 0xffff;
+
+/// Nibble value indicating that a length continues in extension bytes.
+constexpr uint32_t kNibbleMax = 15;
+
+inline uint32_t read32(const uint8_t *p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline uint32_t hash4(const uint8_t *p) {
+  return (read32(p) * 2654435761u) >> (32 - kHashBits);
+}
+
+/// Append the extension bytes for a length whose nibble was kNibbleMax.
+void writeLengthExtension(uint32_t len, std::vector<uint8_t> &out) {
+  len -= kNibbleMax;
+  while (len >= 255) {
+    out.push_back(255);
+    len -= 255;
+  }
+  out.push_back(static_cast<uint8_t>(len));
+}
+
+/// Emit one sequence: \p litLen literals starting at \p lit, followed (unless
+/// \p matchLen is 0) by a back reference of \p matchLen bytes at \p offset.
+void writeSequence(
+    const uint8_t *lit,
+    uint32_t litLen,
+    uint32_t offset,
+    uint32_t matchLen,
+    std::vector<uint8_t> &out) {
+  uint32_t matchCode = matchLen ? matchLen - kMinMatch : 0;
+  uint8_t token = (std::min(litLen, kNibbleMax) << 4) |
+      std::min(matchCode, kNibbleMax);
+  out.push_back(token);
+  if (litLen >= kNibbleMax)
+    writeLengthExtension(litLen, out);
+  out.insert(out.end(), lit, lit + litLen);
+  if (!matchLen)
+    return;
+  out.push_back(static_cast<uint8_t>(offset));
+  out.push_back(static_cast<uint8_t>(offset >> 8));
+  if (matchCode >= kNibbleMax)
+    writeLengthExtension(matchCode, out);
+}
+
+/// Read a length from the token nibble \p nibble and any extension bytes at
+/// \p ip. \return false if the input ends before the length does.
+bool readLength(
+    uint32_t nibble,
+    const uint8_t *&ip,
+    const uint8_t *end,
+    size_t &len) {
+  len = nibble;
+  if (nibble != kNibbleMax)
+    return true;
+  uint8_t b;
+  do {
+    if (ip == end)
+      return false;
+    b = *ip++;
+    len += b;
+  } while (b == 255);
+  return true;
+}
+
+} // namespace
+
+void compress(llvh::ArrayRef<uint8_t> input, std::vector<uint8_t> &output) {
+  const uint8_t *const base = input.data();
+  const uint8_t *const end = base + input.size();
+  const uint8_t *anchor = base;
+
+  if (input.size() >= kMinMatch) {
+    // Positions (relative to base) of the most recent occurrence of each
+    // hashed 4-byte sequence.
+    std::vector<uint32_t> table(1u << kHashBits, UINT32_MAX);
+    const uint8_t *const matchLimit = end - kMinMatch;
+    const uint8_t *ip = base;
+    while (ip <= matchLimit) {
+      uint32_t h = hash4(ip);
+      uint32_t candPos = table[h];
+      uint32_t pos = ip - base;
+      table[h] = pos;
+      if (candPos == UINT32_MAX || pos - candPos > kMaxOffset ||
+          read32(base + candPos) != read32(ip)) {
+        ++ip;
+        continue;
+      }
+      const uint8_t *match = base + candPos;
+      uint32_t matchLen = kMinMatch;
+      while (ip + matchLen < end && ip[matchLen] == match[matchLen])
+        ++matchLen;
+      writeSequence(anchor, ip - anchor, pos - candPos, matchLen, output);
+      ip += matchLen;
+      anchor = ip;
+    }
+  }
+
+  // The final sequence carries the remaining literals and no match.
+  writeSequence(anchor, end - anchor, 0, 0, output);
+}
+
+bool decompress(
+    llvh::ArrayRef<uint8_t> input,
+    llvh::MutableArrayRef<uint8_t> output) {
+  const uint8_t *ip = input.data();
+  const uint8_t *const iend = ip + input.size();
+  uint8_t *op = output.data();
+  uint8_t *const oend = op + output.size();
+
+  for (;;) {
+    if (ip == iend)
+      return false;
+    uint8_t token = *ip++;
+
+    size_t litLen;
+    if (!readLength(token >> 4, ip, iend, litLen))
+      return false;
+    if (litLen > size_t(iend - ip) || litLen > size_t(oend - op))
+      return false;
+    if (litLen)
+      std::memcpy(op, ip, litLen);
+    ip += litLen;
+    op += litLen;
+
+    // The last sequence ends the input right after its literals.
+    if (ip == iend)
+      return op == oend;
+
+    if (iend - ip < 2)
+      return false;
+    uint32_t offset = ip[0] | (uint32_t(ip[1]) << 8);
+    ip += 2;
+    size_t matchLen;
+    if (!readLength(token & 0xf, ip, iend, matchLen))
+      return false;
+    matchLen += kMinMatch;
+    if (offset == 0 || offset > size_t(op - output.data()) ||
+        matchLen > size_t(oend - op))
+      return false;
+
+    // Copy byte by byte: the source may overlap the destination.
+    const uint8_t *match = op - offset;
+    for (size_t i = 0; i < matchLen; ++i)
+      op[i] = match[i];
+    op += matchLen;
+  }
+}
+
+} // namespace lzblock
+} // namespace hermes
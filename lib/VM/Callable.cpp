@@ -14,6 +14,7 @@
 #include "hermes/VM/JSError.h"
 #include "hermes/VM/JSMapImpl.h"
 #include "hermes/VM/JSNativeFunctions.h"
+#include "hermes/VM/JSPromise.h"
 #include "hermes/VM/JSProxy.h"
 #include "hermes/VM/JSRegExp.h"
 #include "hermes/VM/JSTypedArray.h"
@@ -26,6 +27,8 @@
 
 #include "llvh/ADT/ArrayRef.h"
 
+#include <algorithm>
+
 namespace hermes {
 namespace vm {
 
@@ -1093,6 +1096,26 @@ PseudoHandle<JSFunction> JSFunction::create(
   return self;
 }
 
+PseudoHandle<JSFunction> JSFunction::createLongLived(
+    Runtime *runtime,
+    Handle<Domain> domain,
+    Handle<JSObject> parentHandle,
+    Handle<Environment> envHandle,
+    CodeBlock *codeBlock) {
+  auto *cell = runtime->makeAFixed<JSFunction, kHasFinalizer, LongLived::Yes>(
+      runtime,
+      domain,
+      parentHandle,
+      runtime->getHiddenClassForPrototype(
+          *parentHandle, numOverlapSlots<JSFunction>()),
+      envHandle,
+      codeBlock,
+      GCPointerBase::YesBarriers());
+  auto self = JSObjectInit::initToPseudoHandle(runtime, cell);
+  self->flags_.lazyObject = 1;
+  return self;
+}
+
 void JSFunction::addLocationToSnapshot(
     HeapSnapshot &snap,
     HeapSnapshot::NodeID id) const {
@@ -1105,6 +1128,18 @@ void JSFunction::addLocationToSnapshot(
   }
 }
 
+CallResult<PseudoHandle<JSObject>> JSFunction::_newObjectImpl(
+    Handle<Callable> selfHandle,
+    Runtime *runtime,
+    Handle<JSObject> parentHandle) {
+  return JSObject::create(
+      runtime,
+      parentHandle,
+      vmcast<JSFunction>(*selfHandle)
+          ->getCodeBlock()
+          ->getConstructedPropertyCount());
+}
+
 CallResult<PseudoHandle<>> JSFunction::_callImpl(
     Handle<Callable> selfHandle,
     Runtime *runtime) {
@@ -1413,12 +1448,26 @@ void GeneratorInnerFunction::saveStack(Runtime *runtime) {
   assert(
       first + frameSize <= runtime->getStackPointer() &&
       "reading off the end of the stack");
-  // Use GCHermesValue::copy to ensure write barriers are executed.
-  GCHermesValue::copy(
-      first,
-      first + frameSize,
-      savedContext_.get(runtime)->data() + frameOffset,
-      &runtime->getHeap());
+  GCHermesValue *dst = savedContext_.get(runtime)->data() + frameOffset;
+  // Most registers still hold what they held at the previous yield (e.g. the
+  // locals of a loop around the yield), so only store the ones that changed.
+  // Skipping an identical store needs no write barrier: the GC has already
+  // seen the value, and updates both copies whenever it moves the pointee.
+  // Registers are compared a block at a time so that the common case of an
+  // unchanged block is a branch-free loop.
+  constexpr uint32_t kBlockSize = 8;
+  for (uint32_t i = 0; i < frameSize; i += kBlockSize) {
+    const uint32_t end = std::min(i + kBlockSize, frameSize);
+    uint64_t diff = 0;
+    for (uint32_t j = i; j < end; ++j)
+      diff |= dst[j].getRaw() ^ first[j].getRaw();
+    if (LLVM_LIKELY(!diff))
+      continue;
+    for (uint32_t j = i; j < end; ++j) {
+      if (dst[j].getRaw() != first[j].getRaw())
+        dst[j].set(first[j], &runtime->getHeap());
+    }
+  }
 }
 
 } // namespace vm
@@ -287,6 +287,10 @@ struct EdgeAddingAcceptor : public SnapshotAcceptor, public WeakRefAcceptor {
     acceptHV(hv, name);
   }
 
+  PointerBase *getPointerBase() const override {
+    return gc_.getPointerBase();
+  }
+
   void accept(WeakRefBase &wr) override {
     WeakRefSlot *slot = wr.unsafeGetSlot();
     if (slot->state() == WeakSlotState::Free) {
@@ -769,7 +773,9 @@ void GCBase::printStats(JSONEmitter &json) {
   json.emitKeyValue("Current Dirty", oscompat::current_private_dirty());
   json.emitKeyValue("Heap size", info.heapSize);
   json.emitKeyValue("Allocated bytes", info.allocatedBytes);
+  json.emitKeyValue("Fragmented bytes", info.fragmentedBytes);
   json.emitKeyValue("Num collections", info.numCollections);
+  json.emitKeyValue("Num compacted segments", info.numCompactedSegments);
   json.emitKeyValue("Malloc size", info.mallocSizeEstimate);
   json.closeDict();
 
@@ -967,21 +973,6 @@ GCBASE_BARRIER_1(weakRefReadBarrier, HermesValue);
 #undef GCBASE_BARRIER_2
 #endif
 
-/*static*/
-std::vector<detail::WeakRefKey *> GCBase::buildKeyList(
-    GC *gc,
-    JSWeakMap *weakMap) {
-  std::vector<detail::WeakRefKey *> res;
-  for (auto iter = weakMap->keys_begin(), end = weakMap->keys_end();
-       iter != end;
-       iter++) {
-    if (iter->getObject(gc)) {
-      res.push_back(&(*iter));
-    }
-  }
-  return res;
-}
-
 HeapSnapshot::NodeID GCBase::getObjectID(const GCCell *cell) {
   assert(cell && "Called getObjectID on a null pointer");
   return getObjectID(
@@ -1580,6 +1571,54 @@ void GCBase::SamplingAllocationLocationTracker::updateSize(
   sample.size = newSize;
 }
 
+bool GCBase::AllocationSiteTracker::sample(
+    const void *codeBlock,
+    uint32_t offset,
+    GCCell *cell) {
+  if (!enabled_) {
+    countdown_ = std::numeric_limits<uint32_t>::max();
+    return false;
+  }
+  countdown_ = kSampleInterval;
+  auto it = siteIndex_.find({codeBlock, offset});
+  uint32_t idx;
+  if (it != siteIndex_.end()) {
+    idx = it->second;
+    if (sites_[idx].pretenured)
+      return true;
+  } else {
+    if (sites_.size() >= kMaxSites)
+      return false;
+    idx = sites_.size();
+    sites_.emplace_back();
+    siteIndex_[{codeBlock, offset}] = idx;
+  }
+  samples_.emplace_back(cell, idx);
+  return false;
+}
+
+uint32_t GCBase::AllocationSiteTracker::updateSurvival(
+    llvh::function_ref<bool(GCCell *)> survived) {
+  uint32_t newlyPretenured = 0;
+  for (const auto &sample : samples_) {
+    Site &site = sites_[sample.second];
+    site.sampled++;
+    stats_.sampledObjects++;
+    if (survived(sample.first)) {
+      site.survived++;
+      stats_.survivedObjects++;
+    }
+    if (!site.pretenured && site.sampled >= kMinSamples &&
+        site.survived >= kSurvivalThreshold * site.sampled) {
+      site.pretenured = true;
+      stats_.pretenuredSites++;
+      newlyPretenured++;
+    }
+  }
+  samples_.clear();
+  return newlyPretenured;
+}
+
 size_t GCBase::SamplingAllocationLocationTracker::nextSample() {
   return (*dist_)(randomEngine_);
 }
@@ -13,6 +13,7 @@
 #include "hermes/VM/JSArray.h"
 #include "hermes/VM/JSObject.h"
 #include "hermes/VM/Operations.h"
+#include "hermes/VM/Runtime-inline.h"
 #include "hermes/VM/StringView.h"
 
 #include "llvh/Support/Debug.h"
@@ -354,14 +355,47 @@ Handle<HiddenClass> HiddenClass::deleteProperty(
     Handle<HiddenClass> selfHandle,
     Runtime *runtime,
     PropertyPos pos) {
+  // Deleting the property added by the transition to this class leaves
+  // exactly the properties of the parent, in the same slots. Going back to
+  // the parent keeps the object shared and cacheable, and adding the property
+  // again finds this class through the parent's transition table. Objects
+  // don't clear their fastIndexProperties flag again, so a class must not lose
+  // hasIndexLikeProperties.
+  if (LLVM_LIKELY(!selfHandle->isDictionary()) && selfHandle->parent_ &&
+      !selfHandle->propertyFlags_.flagsTransition &&
+      !selfHandle->flags_.hasIndexLikeProperties &&
+      selfHandle->propertyMap_ &&
+      DictPropertyMap::getDescriptorPair(
+          selfHandle->propertyMap_.getNonNull(runtime), pos)
+              ->first == selfHandle->symbolID_) {
+    auto parentHandle =
+        runtime->makeHandle(selfHandle->parent_.getNonNull(runtime));
+    assert(
+        parentHandle->numProperties_ + 1 == selfHandle->numProperties_ &&
+        "parent of a property transition must have one less property");
+    LLVM_DEBUG(
+        dbgs() << "Deleting from Class:" << selfHandle->getDebugAllocationId()
+               << " returns to parent Class:"
+               << parentHandle->getDebugAllocationId() << "\n");
+#ifdef HERMESVM_PROFILER_BB
+    runtime->recordRecoveredHiddenClass(*parentHandle);
+#endif
+    return parentHandle;
+  }
+
   // We convert to dictionary if we're not yet a dictionary
   // (transition to a cacheable dictionary), or if we are, but not yet
   // in no-cache mode (transition to no-cache mode).
+  // Cell mode dictionaries always get a new cacheable class.
   auto newHandle = LLVM_UNLIKELY(!selfHandle->isDictionaryNoCache())
-      ? copyToNewDictionary(selfHandle, runtime, selfHandle->isDictionary())
+      ? copyToNewDictionary(
+            selfHandle,
+            runtime,
+            selfHandle->isDictionary() && !selfHandle->isDictionaryCellMode())
       : selfHandle;
 
   --newHandle->numProperties_;
+  newHandle->noCacheAccesses_ = 0;
 
   DictPropertyMap::erase(newHandle->propertyMap_.get(runtime), runtime, pos);
 
@@ -406,6 +440,7 @@ CallResult<std::pair<Handle<HiddenClass>, SlotIndex>> HiddenClass::addProperty(
     }
 
     ++selfHandle->numProperties_;
+    selfHandle->noCacheAccesses_ = 0;
     return std::make_pair(selfHandle, newSlot);
   }
 
@@ -449,7 +484,8 @@ CallResult<std::pair<Handle<HiddenClass>, SlotIndex>> HiddenClass::addProperty(
   }
 
   // Do we need to convert to dictionary?
-  if (LLVM_UNLIKELY(selfHandle->numProperties_ == kDictionaryThreshold)) {
+  if (LLVM_UNLIKELY(
+          selfHandle->numProperties_ >= runtime->getDictionaryThreshold())) {
     // Do it.
     auto childHandle = copyToNewDictionary(selfHandle, runtime);
 
@@ -547,9 +583,12 @@ Handle<HiddenClass> HiddenClass::updateProperty(
     DictPropertyMap::getDescriptorPair(
         selfHandle->propertyMap_.get(runtime), pos)
         ->second.flags = newFlags;
-    // If it's still cacheable, make it non-cacheable.
+    selfHandle->noCacheAccesses_ = 0;
+    // If it's still cacheable, make it non-cacheable, unless it is in cell
+    // mode, where a new class invalidates the caches instead.
     if (!selfHandle->isDictionaryNoCache()) {
-      selfHandle = copyToNewDictionary(selfHandle, runtime, /*noCache*/ true);
+      selfHandle = copyToNewDictionary(
+          selfHandle, runtime, !selfHandle->isDictionaryCellMode());
     }
     return selfHandle;
   }
@@ -739,11 +778,12 @@ Handle<HiddenClass> HiddenClass::updatePropertyFlagsWithoutTransitions(
     OptValue<llvh::ArrayRef<SymbolID>> props) {
   // Result must be in dictionary mode, since it's a non-empty orphan.
   MutableHandle<HiddenClass> classHandle{runtime};
-  if (selfHandle->isDictionary()) {
+  if (selfHandle->isDictionary() && !selfHandle->isDictionaryCellMode()) {
     classHandle = *selfHandle;
   } else {
     classHandle = *copyToNewDictionary(selfHandle, runtime);
   }
+  classHandle->noCacheAccesses_ = 0;
 
   auto mapHandle =
       runtime->makeHandle<DictPropertyMap>(classHandle->propertyMap_);
@@ -773,6 +813,79 @@ Handle<HiddenClass> HiddenClass::updatePropertyFlagsWithoutTransitions(
   return std::move(classHandle);
 }
 
+bool HiddenClass::recordNoCacheAccess(Runtime *runtime) {
+  assert(isDictionaryNoCache() && "only non-cacheable classes are re-shaped");
+  unsigned threshold = runtime->getDictionaryReshapeThreshold();
+  if (noCacheAccesses_ >= threshold)
+    return false;
+  return ++noCacheAccesses_ == threshold;
+}
+
+Handle<HiddenClass> HiddenClass::reshapeDictionary(
+    Handle<HiddenClass> selfHandle,
+    Runtime *runtime,
+    llvh::SmallVectorImpl<SlotIndex> &oldSlots) {
+  assert(selfHandle->isDictionary() && "only dictionaries can be re-shaped");
+  // A shared class with this many properties would be a dictionary again.
+  // Index-like properties are left alone, since a shared class rebuilt
+  // without the deleted ones must not lose hasIndexLikeProperties.
+  if (selfHandle->numProperties_ > runtime->getDictionaryThreshold() ||
+      selfHandle->flags_.hasIndexLikeProperties)
+    return Runtime::makeNullHandle<HiddenClass>();
+
+  // Collect the properties in insertion order. Their names are kept alive by
+  // the property map of selfHandle.
+  using Property = std::pair<SymbolID, PropertyFlags>;
+  llvh::SmallVector<Property, 8> properties;
+  properties.reserve(selfHandle->numProperties_);
+  oldSlots.clear();
+  bool reservedSlotsKept = true;
+  forEachPropertyNoAlloc(
+      *selfHandle,
+      runtime,
+      [&properties, &oldSlots, &reservedSlotsKept](
+          SymbolID id, NamedPropertyDescriptor desc) {
+        // Reserved slots are accessed by index, so they must not move.
+        if (InternalProperty::isInternal(id) && desc.slot != oldSlots.size())
+          reservedSlotsKept = false;
+        properties.emplace_back(id, desc.flags);
+        oldSlots.push_back(desc.slot);
+      });
+  if (!reservedSlotsKept)
+    return Runtime::makeNullHandle<HiddenClass>();
+
+  MutableHandle<HiddenClass> classHandle{
+      runtime, runtime->getHiddenClassForPrototypeRaw(nullptr, 0)};
+  GCScopeMarkerRAII marker{runtime};
+  for (const Property &prop : properties) {
+    auto addResult =
+        addProperty(classHandle, runtime, prop.first, prop.second);
+    assert(
+        addResult != ExecutionStatus::EXCEPTION &&
+        "Could not possibly grow larger than the limit");
+    classHandle = *addResult->first;
+    marker.flush();
+  }
+  assert(
+      !classHandle->isDictionary() &&
+      classHandle->numProperties_ == selfHandle->numProperties_ &&
+      "re-shaped class must be shared and have the same properties");
+
+  LLVM_DEBUG(
+      dbgs() << "Re-shaped dictionary Class:"
+             << selfHandle->getDebugAllocationId()
+             << " to Class:" << classHandle->getDebugAllocationId() << "\n");
+  return std::move(classHandle);
+}
+
+Handle<HiddenClass> HiddenClass::copyToCellDictionary(
+    Handle<HiddenClass> selfHandle,
+    Runtime *runtime) {
+  auto newHandle = copyToNewDictionary(selfHandle, runtime);
+  newHandle->flags_.dictionaryCellMode = true;
+  return newHandle;
+}
+
 CallResult<std::pair<Handle<HiddenClass>, SlotIndex>> HiddenClass::reserveSlot(
     Handle<HiddenClass> selfHandle,
     Runtime *runtime) {
@@ -511,6 +511,30 @@ ExecutionStatus Interpreter::putByValTransient_RJS(
   return putByIdTransient_RJS(runtime, base, **idRes, value, strictMode);
 }
 
+/// Sample the allocation of \p cell by the instruction at \p ip, if the heap's
+/// allocation site tracker asks for a sample. Once enough sampled objects from
+/// the site have survived young generation collections, the site allocates
+/// directly in the old generation from then on.
+static inline void sampleAllocationSite(
+    Runtime *runtime,
+    CodeBlock *curCodeBlock,
+    const Inst *ip,
+    GCCell *cell) {
+  auto &tracker = runtime->getHeap().getAllocationSiteTracker();
+  if (LLVM_LIKELY(!tracker.shouldSample()))
+    return;
+  uint32_t offset = curCodeBlock->getOffsetOf(ip);
+  if (tracker.sample(curCodeBlock, offset, cell))
+    curCodeBlock->addPretenuredSite(offset);
+}
+
+/// Record that \p cell was allocated directly in the old generation by a
+/// pretenured allocation site.
+static inline void recordPretenured(Runtime *runtime, GCCell *cell) {
+  runtime->getHeap().getAllocationSiteTracker().recordPretenured(
+      cell->getAllocatedSize());
+}
+
 static Handle<HiddenClass> getHiddenClassForBuffer(
     Runtime *runtime,
     CodeBlock *curCodeBlock,
@@ -566,15 +590,17 @@ static Handle<HiddenClass> getHiddenClassForBuffer(
 CallResult<PseudoHandle<>> Interpreter::createObjectFromBuffer(
     Runtime *runtime,
     CodeBlock *curCodeBlock,
+    unsigned sizeHint,
     unsigned numLiterals,
     unsigned keyBufferIndex,
     unsigned valBufferIndex) {
   // Create a new object using the built-in constructor or cached hidden class.
   // Note that the built-in constructor is empty, so we don't actually need to
-  // call it.
+  // call it. Reserve room for the properties which the literal adds after the
+  // ones from the buffer.
   auto clazz = getHiddenClassForBuffer(
       runtime, curCodeBlock, numLiterals, keyBufferIndex);
-  auto obj = runtime->makeHandle(JSObject::create(runtime, clazz));
+  auto obj = runtime->makeHandle(JSObject::create(runtime, clazz, sizeHint));
 
   auto valGen =
       curCodeBlock->getObjectBufferValueIter(valBufferIndex, numLiterals);
@@ -918,7 +944,7 @@ CallResult<HermesValue> Interpreter::interpretFunction(
   // Make sure that the cache can use an optimization by avoiding a branch to
   // access the property storage.
   static_assert(
-      HiddenClass::kDictionaryThreshold <=
+      HiddenClass::kMaxDictionaryThreshold <=
           SegmentedArray::kValueToSegmentThreshold,
       "Cannot avoid branches in cache check if the dictionary "
       "crossover point is larger than the inline storage");
@@ -1814,6 +1840,17 @@ tailCall:
         // Store the return value.
         res = O1REG(Ret);
 
+        // Remember how many properties the constructor gave its new object,
+        // so that the next objects it constructs have room for them.
+        if (LLVM_UNLIKELY(FRAME.isConstructorCall()) &&
+            FRAME.getThisArgRef().isObject()) {
+          curCodeBlock->recordConstructedObject(std::min(
+              vmcast<JSObject>(FRAME.getThisArgRef())
+                  ->getClass(runtime)
+                  ->getNumProperties(),
+              runtime->getDictionaryThreshold()));
+        }
+
         ip = FRAME.getSavedIP();
         curCodeBlock = FRAME.getSavedCodeBlock();
 
@@ -1994,15 +2031,34 @@ tailCall:
       }
     createClosure : {
       auto *runtimeModule = curCodeBlock->getRuntimeModule();
-      CAPTURE_IP(
-          O1REG(CreateClosure) =
-              JSFunction::create(
-                  runtime,
-                  runtimeModule->getDomain(runtime),
-                  Handle<JSObject>::vmcast(&runtime->functionPrototype),
-                  Handle<Environment>::vmcast(&O2REG(CreateClosure)),
-                  runtimeModule->getCodeBlockMayAllocate(idVal))
-                  .getHermesValue());
+      if (LLVM_UNLIKELY(curCodeBlock->isPretenuredSite(
+              curCodeBlock->getOffsetOf(ip)))) {
+        CAPTURE_IP(
+            O1REG(CreateClosure) =
+                JSFunction::createLongLived(
+                    runtime,
+                    runtimeModule->getDomain(runtime),
+                    Handle<JSObject>::vmcast(&runtime->functionPrototype),
+                    Handle<Environment>::vmcast(&O2REG(CreateClosure)),
+                    runtimeModule->getCodeBlockMayAllocate(idVal))
+                    .getHermesValue());
+        recordPretenured(runtime, vmcast<GCCell>(O1REG(CreateClosure)));
+      } else {
+        CAPTURE_IP(
+            O1REG(CreateClosure) =
+                JSFunction::create(
+                    runtime,
+                    runtimeModule->getDomain(runtime),
+                    Handle<JSObject>::vmcast(&runtime->functionPrototype),
+                    Handle<Environment>::vmcast(&O2REG(CreateClosure)),
+                    runtimeModule->getCodeBlockMayAllocate(idVal))
+                    .getHermesValue());
+        sampleAllocationSite(
+            runtime,
+            curCodeBlock,
+            ip,
+            vmcast<GCCell>(O1REG(CreateClosure)));
+      }
       gcScope.flushToSmallCount(KEEP_HANDLES);
       ip = nextIP;
       DISPATCH;
@@ -2327,6 +2383,19 @@ tailCall:
           // those cases.
           HiddenClass *clazz =
               vmcast<HiddenClass>(clazzPtr.getNonNull(runtime));
+          if (LLVM_UNLIKELY(clazz->isDictionaryNoCache()) &&
+              LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED) &&
+              clazz->recordNoCacheAccess(runtime)) {
+            // The properties of the object have stopped changing. Give it a
+            // shared class and execute the instruction again to cache it.
+            CAPTURE_IP_ASSIGN(
+                bool reshaped,
+                JSObject::reshapeDictionary(
+                    Handle<JSObject>::vmcast(&O2REG(GetById)), runtime));
+            if (reshaped) {
+              DISPATCH;
+            }
+          }
           if (LLVM_LIKELY(!clazz->isDictionaryNoCache()) &&
               LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
 #ifdef HERMES_SLOW_DEBUG
@@ -2512,7 +2581,19 @@ tailCall:
           // those cases.
           HiddenClass *clazz =
               vmcast<HiddenClass>(clazzPtr.getNonNull(runtime));
-          if (LLVM_LIKELY(!clazz->isDictionary()) &&
+          if (LLVM_UNLIKELY(clazz->isDictionaryNoCache()) &&
+              LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED) &&
+              clazz->recordNoCacheAccess(runtime)) {
+            // See the comment in getById.
+            CAPTURE_IP_ASSIGN(
+                bool reshaped,
+                JSObject::reshapeDictionary(
+                    Handle<JSObject>::vmcast(&O1REG(PutById)), runtime));
+            if (reshaped) {
+              DISPATCH;
+            }
+          }
+          if (LLVM_LIKELY(clazz->canCachePropertyWrites()) &&
               LLVM_LIKELY(cacheIdx != hbc::PROPERTY_CACHING_DISABLED)) {
 #ifdef HERMES_SLOW_DEBUG
             if (cacheEntry->clazz && cacheEntry->clazz != clazzPtr)
@@ -2925,8 +3006,18 @@ tailCall:
         // Create a new object using the built-in constructor. Note that the
         // built-in constructor is empty, so we don't actually need to call
         // it.
-        CAPTURE_IP(
-            O1REG(NewObject) = JSObject::create(runtime).getHermesValue());
+        if (LLVM_UNLIKELY(curCodeBlock->isPretenuredSite(
+                curCodeBlock->getOffsetOf(ip)))) {
+          CAPTURE_IP(
+              O1REG(NewObject) =
+                  JSObject::createLongLived(runtime).getHermesValue());
+          recordPretenured(runtime, vmcast<GCCell>(O1REG(NewObject)));
+        } else {
+          CAPTURE_IP(
+              O1REG(NewObject) = JSObject::create(runtime).getHermesValue());
+          sampleAllocationSite(
+              runtime, curCodeBlock, ip, vmcast<GCCell>(O1REG(NewObject)));
+        }
         assert(
             gcScope.getHandleCountDbg() == KEEP_HANDLES &&
             "Should not create handles.");
@@ -2956,6 +3047,7 @@ tailCall:
             resPH = Interpreter::createObjectFromBuffer(
                 runtime,
                 curCodeBlock,
+                ip->iNewObjectWithBuffer.op2,
                 ip->iNewObjectWithBuffer.op3,
                 ip->iNewObjectWithBuffer.op4,
                 ip->iNewObjectWithBuffer.op5));
@@ -2973,6 +3065,7 @@ tailCall:
             resPH = Interpreter::createObjectFromBuffer(
                 runtime,
                 curCodeBlock,
+                ip->iNewObjectWithBufferLong.op2,
                 ip->iNewObjectWithBufferLong.op3,
                 ip->iNewObjectWithBufferLong.op4,
                 ip->iNewObjectWithBufferLong.op5));
@@ -2989,7 +3082,18 @@ tailCall:
         // Create a new array using the built-in constructor. Note that the
         // built-in constructor is empty, so we don't actually need to call
         // it.
-        {
+        if (LLVM_UNLIKELY(curCodeBlock->isPretenuredSite(
+                curCodeBlock->getOffsetOf(ip)))) {
+          CAPTURE_IP_ASSIGN(
+              auto createRes,
+              JSArray::createLongLived(
+                  runtime, ip->iNewArray.op2, ip->iNewArray.op2));
+          if (createRes == ExecutionStatus::EXCEPTION) {
+            goto exception;
+          }
+          O1REG(NewArray) = createRes->getHermesValue();
+          recordPretenured(runtime, vmcast<GCCell>(O1REG(NewArray)));
+        } else {
           CAPTURE_IP_ASSIGN(
               auto createRes,
               JSArray::create(runtime, ip->iNewArray.op2, ip->iNewArray.op2));
@@ -2997,6 +3101,8 @@ tailCall:
             goto exception;
           }
           O1REG(NewArray) = createRes->getHermesValue();
+          sampleAllocationSite(
+              runtime, curCodeBlock, ip, vmcast<GCCell>(O1REG(NewArray)));
         }
         gcScope.flushToSmallCount(KEEP_HANDLES);
         ip = NEXTINST(NewArray);
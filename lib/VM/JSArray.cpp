@@ -562,6 +562,34 @@ JSArray::create(Runtime *runtime, size_type capacity, size_type length) {
       length);
 }
 
+CallResult<Handle<JSArray>> JSArray::createLongLived(
+    Runtime *runtime,
+    size_type capacity,
+    size_type length) {
+  assert(length <= capacity && "length must be <= capacity");
+  auto self = JSObjectInit::initToHandle(
+      runtime,
+      runtime->makeAFixed<JSArray, HasFinalizer::No, LongLived::Yes>(
+          runtime,
+          Handle<JSObject>::vmcast(&runtime->arrayPrototype),
+          Handle<HiddenClass>::vmcast(&runtime->arrayClass),
+          GCPointerBase::YesBarriers()));
+
+  if (capacity) {
+    if (LLVM_UNLIKELY(capacity > StorageType::maxElements()))
+      return runtime->raiseRangeError("Out of memory for array elements");
+    auto arrRes = StorageType::createLongLived(runtime, capacity);
+    if (arrRes == ExecutionStatus::EXCEPTION) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    self->setIndexedStorage(runtime, arrRes->get(), &runtime->getHeap());
+  }
+  auto shv = SmallHermesValue::encodeNumberValue(length, runtime);
+  putLength(self.get(), runtime, shv);
+
+  return self;
+}
+
 CallResult<bool> JSArray::setLength(
     Handle<JSArray> selfHandle,
     Runtime *runtime,
@@ -117,14 +117,14 @@ void JSArrayBuffer::_finalizeImpl(GCCell *cell, GC *gc) {
   auto *self = vmcast<JSArrayBuffer>(cell);
   // Need to untrack the native memory that may have been tracked by snapshots.
   gc->getIDTracker().untrackNative(self->data_);
-  gc->debitExternalMemory(self, self->size_);
-  free(self->data_);
+  self->freeDataBlock(gc);
   self->~JSArrayBuffer();
 }
 
 size_t JSArrayBuffer::_mallocSizeImpl(GCCell *cell) {
   const auto *buffer = vmcast<JSArrayBuffer>(cell);
-  return buffer->size_;
+  // External blocks are not allocated with malloc.
+  return buffer->isExternal() ? 0 : buffer->size_;
 }
 
 gcheapsize_t JSArrayBuffer::_externalMemorySizeImpl(
@@ -168,15 +168,25 @@ void JSArrayBuffer::_snapshotAddNodesImpl(
       0);
 }
 
-void JSArrayBuffer::detach(GC *gc) {
-  if (data_) {
+void JSArrayBuffer::freeDataBlock(GC *gc) {
+  if (externalFinalize_) {
+    // External blocks may be empty but still need to be released.
+    gc->debitExternalMemory(this, size_);
+    externalFinalize_(externalContext_);
+    externalFinalize_ = nullptr;
+    externalContext_ = nullptr;
+  } else if (data_) {
     gc->debitExternalMemory(this, size_);
     free(data_);
-    data_ = nullptr;
-    size_ = 0;
   } else {
     assert(size_ == 0);
   }
+  data_ = nullptr;
+  size_ = 0;
+}
+
+void JSArrayBuffer::detach(GC *gc) {
+  freeDataBlock(gc);
   // Note that whether a buffer is attached is independent of whether
   // it has allocated data.
   attached_ = false;
@@ -214,5 +224,26 @@ JSArrayBuffer::createDataBlock(Runtime *runtime, size_type size, bool zero) {
   }
 }
 
+ExecutionStatus JSArrayBuffer::setExternalDataBlock(
+    Runtime *runtime,
+    uint8_t *data,
+    size_type size,
+    void *context,
+    FinalizeExternalDataPtr finalizePtr) {
+  assert(finalizePtr && "external data blocks need a finalizer");
+  if (LLVM_UNLIKELY(!runtime->getHeap().canAllocExternalMemory(size))) {
+    return runtime->raiseRangeError(
+        "Cannot attach an external data block to the ArrayBuffer");
+  }
+  detach(&runtime->getHeap());
+  data_ = data;
+  size_ = size;
+  attached_ = true;
+  externalFinalize_ = finalizePtr;
+  externalContext_ = context;
+  runtime->getHeap().creditExternalMemory(this, size);
+  return ExecutionStatus::RETURNED;
+}
+
 } // namespace vm
 } // namespace hermes
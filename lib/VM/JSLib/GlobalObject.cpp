@@ -518,6 +518,9 @@ void initGlobalObject(Runtime *runtime, const JSLibFlags &jsLibFlags) {
   // "Forward declaration" of WeakSet.prototype.
   runtime->weakSetPrototype = JSObject::create(runtime).getHermesValue();
 
+  // "Forward declaration" of Promise.prototype.
+  runtime->promisePrototype = JSObject::create(runtime).getHermesValue();
+
   // "Forward declaration" of %ArrayIteratorPrototype%.
   runtime->arrayIteratorPrototype =
       JSObject::create(
@@ -647,6 +650,11 @@ void initGlobalObject(Runtime *runtime, const JSLibFlags &jsLibFlags) {
     createProxyConstructor(runtime);
   }
 
+  // Promise constructor.
+  if (runtime->hasES6Promise()) {
+    createPromiseConstructor(runtime);
+  }
+
   // Define the global Math object
   runtime->ignoreAllocationFailure(JSObject::defineOwnProperty(
       runtime->getGlobal(),
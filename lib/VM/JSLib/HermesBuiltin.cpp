@@ -12,7 +12,9 @@
 #include "hermes/VM/Callable.h"
 #include "hermes/VM/JSArray.h"
 #include "hermes/VM/JSArrayBuffer.h"
+#include "hermes/VM/JSGenerator.h"
 #include "hermes/VM/JSLib.h"
+#include "hermes/VM/JSPromise.h"
 #include "hermes/VM/Operations.h"
 #include "hermes/VM/StackFrame-inline.h"
 #include "hermes/VM/StringView.h"
@@ -772,6 +774,63 @@ hermesBuiltinExportAll(void *, Runtime *runtime, NativeArgs args) {
   return HermesValue::encodeUndefinedValue();
 }
 
+/// \code
+///   HermesBuiltin.spawnAsync(genF, self, args) -> Promise
+/// \endcode
+/// Run the async function whose body was compiled to the generator function
+/// \p genF, called with \p self and the arguments object \p args, and return
+/// the promise of its result.
+CallResult<HermesValue>
+hermesBuiltinSpawnAsync(void *, Runtime *runtime, NativeArgs args) {
+  GCScope gcScope{runtime};
+
+  Handle<Callable> genF = args.dyncastArg<Callable>(0);
+  Handle<JSObject> genArgs = args.dyncastArg<JSObject>(2);
+  if (LLVM_UNLIKELY(!genF || !genArgs)) {
+    return runtime->raiseTypeError("Invalid arguments to spawnAsync");
+  }
+
+  auto outerRes = JSPromise::create(runtime);
+  if (LLVM_UNLIKELY(outerRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto outer = runtime->makeHandle(std::move(*outerRes));
+
+  auto genRes = Callable::executeCall(
+      genF,
+      runtime,
+      Runtime::getUndefinedValue(),
+      args.getArgHandle(1),
+      genArgs);
+  if (LLVM_UNLIKELY(genRes == ExecutionStatus::EXCEPTION)) {
+    if (isUncatchableError(runtime->getThrownValue())) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    auto reason = runtime->makeHandle(runtime->getThrownValue());
+    runtime->clearThrownValue();
+    if (LLVM_UNLIKELY(
+            JSPromise::reject(outer, runtime, reason) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    return outer.getHermesValue();
+  }
+
+  auto inner = runtime->makeHandle(JSGenerator::getInnerFunction(
+      runtime, vmcast<JSGenerator>(genRes->get())));
+  if (LLVM_UNLIKELY(
+          JSPromise::asyncFunctionResume(
+              runtime,
+              inner,
+              outer,
+              Runtime::getUndefinedValue(),
+              GeneratorInnerFunction::Action::Next) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return outer.getHermesValue();
+}
+
 void createHermesBuiltins(
     Runtime *runtime,
     llvh::MutableArrayRef<Callable *> builtins) {
@@ -847,6 +906,16 @@ void createHermesBuiltins(
   // Define the 'requireFast' function, which takes a number argument.
   defineInternMethod(
       B::HermesBuiltin_requireFast, P::requireFast, requireFast, 1);
+
+  // Async functions are driven natively when Promise is enabled. Otherwise
+  // the internal bytecode provides a spawnAsync that throws.
+  if (runtime->hasES6Promise()) {
+    defineInternMethod(
+        B::HermesBuiltin_spawnAsync,
+        P::spawnAsync,
+        hermesBuiltinSpawnAsync,
+        3);
+  }
 }
 
 } // namespace vm
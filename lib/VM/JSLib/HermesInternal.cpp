@@ -15,6 +15,7 @@
 #include "hermes/VM/JSArrayBuffer.h"
 #include "hermes/VM/JSLib.h"
 #include "hermes/VM/JSLib/RuntimeCommonStorage.h"
+#include "hermes/VM/JSPromise.h"
 #include "hermes/VM/JSTypedArray.h"
 #include "hermes/VM/JSWeakMapImpl.h"
 #include "hermes/VM/Operations.h"
@@ -600,6 +601,45 @@ hermesInternalHasPromise(void *, Runtime *runtime, NativeArgs args) {
   return HermesValue::encodeBoolValue(runtime->hasES6Promise());
 }
 
+/// \code
+///   HermesInternal.getPromiseState = function (promise) {}
+/// \endcode
+/// \return [state, result] for a native promise, where state is 0 when it is
+/// pending, 1 when it is fulfilled and 2 when it is rejected, following any
+/// promise it adopted; undefined if the argument is not a native promise.
+CallResult<HermesValue>
+hermesInternalGetPromiseState(void *, Runtime *runtime, NativeArgs args) {
+  auto promise = args.dyncastArg<JSPromise>(0);
+  if (!promise) {
+    return HermesValue::encodeUndefinedValue();
+  }
+  JSPromise *source = JSPromise::getSettledSource(*promise);
+  double state;
+  switch (source->getState()) {
+    case JSPromise::State::Fulfilled:
+      state = 1;
+      break;
+    case JSPromise::State::Rejected:
+      state = 2;
+      break;
+    default:
+      state = 0;
+      break;
+  }
+  auto result = runtime->makeHandle(
+      state ? source->getResult() : HermesValue::encodeUndefinedValue());
+
+  auto arrRes = JSArray::create(runtime, 2, 2);
+  if (LLVM_UNLIKELY(arrRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  Handle<JSArray> arr = *arrRes;
+  auto stateHandle = runtime->makeHandle(HermesValue::encodeNumberValue(state));
+  JSArray::setElementAt(arr, runtime, 0, stateHandle);
+  JSArray::setElementAt(arr, runtime, 1, result);
+  return arr.getHermesValue();
+}
+
 CallResult<HermesValue>
 hermesInternalUseEngineQueue(void *, Runtime *runtime, NativeArgs args) {
   return HermesValue::encodeBoolValue(runtime->useJobQueue());
@@ -782,13 +822,11 @@ hermesInternalGetFunctionLocation(void *, Runtime *runtime, NativeArgs args) {
 ///   HermesInternal.setPromiseRejectionTrackingHook = function (func) {}
 /// \endcode
 /// Register the function which can be used to *enable* Promise rejection
-/// tracking when the user calls it.
-/// For example, when using the npm `promise` polyfill:
-/// \code
-///   HermesInternal.setPromiseRejectionTrackingHook(
-///     require('./rejection-tracking.js').enable
-///   );
-/// \endcode
+/// tracking when the user calls it. The hook is called with the options and
+/// returns the tracker that the native Promise calls as
+/// `tracker(promise, handled, reason)`, first with `handled` false when a
+/// promise without reactions is rejected, then with `handled` true if a
+/// reaction is registered on it later.
 CallResult<HermesValue> hermesInternalSetPromiseRejectionTrackingHook(
     void *,
     Runtime *runtime,
@@ -812,9 +850,15 @@ CallResult<HermesValue> hermesInternalEnablePromiseRejectionTracker(
     return runtime->raiseTypeError(
         "Promise rejection tracking hook was not registered");
   }
-  return Callable::executeCall1(
-             func, runtime, Runtime::getUndefinedValue(), opts.getHermesValue())
-      .toCallResultHermesValue();
+  auto trackerRes = Callable::executeCall1(
+      func, runtime, Runtime::getUndefinedValue(), opts.getHermesValue());
+  if (LLVM_UNLIKELY(trackerRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (vmisa<Callable>(trackerRes->get())) {
+    runtime->promiseRejectionTracker_ = trackerRes->get();
+  }
+  return HermesValue::encodeUndefinedValue();
 }
 
 Handle<JSObject> createHermesInternalObject(
@@ -912,6 +956,7 @@ Handle<JSObject> createHermesInternalObject(
   defineInternMethod(P::ttiReached, hermesInternalTTIReached);
   defineInternMethod(P::ttrcReached, hermesInternalTTRCReached);
   defineInternMethod(P::getFunctionLocation, hermesInternalGetFunctionLocation);
+  defineInternMethod(P::getPromiseState, hermesInternalGetPromiseState);
 
   // HermesInternal function that are only meant to be used for testing purpose.
   // They can change language semantics and are security risks.
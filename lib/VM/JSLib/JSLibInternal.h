@@ -392,6 +392,9 @@ Handle<JSObject> createWeakMapConstructor(Runtime *runtime);
 /// Create the WeakSet constructor and populate methods.
 Handle<JSObject> createWeakSetConstructor(Runtime *runtime);
 
+/// Create the Promise constructor and populate methods.
+Handle<JSObject> createPromiseConstructor(Runtime *runtime);
+
 /// Create the Symbol constructor and populate methods.
 Handle<JSObject> createSymbolConstructor(Runtime *runtime);
 
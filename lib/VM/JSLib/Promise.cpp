@@ -0,0 +1,679 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+//===----------------------------------------------------------------------===//
+/// \file
+/// ES6.0 25.4 Promise Objects.
+/// The promise machinery itself lives in JSPromise; this file only defines the
+/// Promise constructor and its methods on top of it.
+//===----------------------------------------------------------------------===//
+#include "JSLibInternal.h"
+
+#include "hermes/VM/JSArray.h"
+#include "hermes/VM/JSPromise.h"
+#include "hermes/VM/Operations.h"
+
+namespace hermes {
+namespace vm {
+
+namespace {
+
+/// Records of the executors passed to subclass constructors by then().
+struct ThenExecutorRecordIndexes {
+  enum { promise, onFulfilled, onRejected, COUNT };
+};
+
+/// Records of the handlers installed by finally() and of the thunks they
+/// chain. Whether they throw is their context.
+struct FinallyRecordIndexes {
+  enum { value, COUNT };
+};
+
+/// Record shared by the elements of a single all() call. The functions
+/// storing the outcome of each element get its index as their context.
+struct AllRecordIndexes {
+  enum { values, remaining, promise, COUNT };
+};
+
+/// \return \p value if it is callable, undefined otherwise.
+Handle<> callableOrUndefined(Handle<> value) {
+  return vmisa<Callable>(*value) ? value : Runtime::getUndefinedValue();
+}
+
+/// Create a pending promise and its resolving functions.
+CallResult<Handle<JSPromise>> createPromiseCapability(
+    Runtime *runtime,
+    MutableHandle<NativeFunction> &resolveOut,
+    MutableHandle<NativeFunction> &rejectOut) {
+  auto promiseRes = JSPromise::create(runtime);
+  if (LLVM_UNLIKELY(promiseRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto promise = runtime->makeHandle(std::move(*promiseRes));
+  if (LLVM_UNLIKELY(
+          JSPromise::createResolvingFunctions(
+              promise, runtime, resolveOut, rejectOut) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return promise;
+}
+
+/// Call \p this.then(onFulfilled, onRejected) through a property lookup, so
+/// that overriding then() affects catch() and finally() as well.
+CallResult<HermesValue> invokeThen(
+    Runtime *runtime,
+    Handle<> thisArg,
+    Handle<> onFulfilled,
+    Handle<> onRejected) {
+  auto objRes = toObject(runtime, thisArg);
+  if (LLVM_UNLIKELY(objRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto obj = runtime->makeHandle<JSObject>(*objRes);
+  auto thenRes = JSObject::getNamed_RJS(
+      obj, runtime, Predefined::getSymbolID(Predefined::then));
+  if (LLVM_UNLIKELY(thenRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto then =
+      Handle<Callable>::dyn_vmcast(runtime->makeHandle(std::move(*thenRes)));
+  if (LLVM_UNLIKELY(!then)) {
+    return runtime->raiseTypeError("Property 'then' is not callable");
+  }
+  return Callable::executeCall2(
+             then,
+             runtime,
+             thisArg,
+             onFulfilled.getHermesValue(),
+             onRejected.getHermesValue())
+      .toCallResultHermesValue();
+}
+
+/// Run \p step for each value produced by iterating \p iterable, closing the
+/// iterator if \p step fails. Exceptions thrown by the iteration itself are
+/// returned as well, for the caller to turn into a rejection.
+template <typename F>
+ExecutionStatus forEachIterated(Runtime *runtime, Handle<> iterable, F step) {
+  GCScope gcScope{runtime};
+  auto iterRes = getIterator(runtime, iterable);
+  if (LLVM_UNLIKELY(iterRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto iteratorRecord = *iterRes;
+
+  MutableHandle<> value{runtime};
+  auto marker = gcScope.createMarker();
+  for (;;) {
+    gcScope.flushToMarker(marker);
+    auto nextRes = iteratorStep(runtime, iteratorRecord);
+    if (LLVM_UNLIKELY(nextRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    if (!*nextRes) {
+      return ExecutionStatus::RETURNED;
+    }
+    auto valueRes = JSObject::getNamed_RJS(
+        *nextRes, runtime, Predefined::getSymbolID(Predefined::value));
+    if (LLVM_UNLIKELY(valueRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    value = std::move(*valueRes);
+    if (LLVM_UNLIKELY(step(value) == ExecutionStatus::EXCEPTION)) {
+      return iteratorCloseAndRethrow(runtime, iteratorRecord.iterator);
+    }
+  }
+}
+
+/// If the last operation threw a catchable exception, reject \p promise with
+/// it and return \p promise; otherwise propagate the exception.
+CallResult<HermesValue> rejectWithThrownValue(
+    Runtime *runtime,
+    Handle<JSPromise> promise) {
+  if (isUncatchableError(runtime->getThrownValue())) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto reason = runtime->makeHandle(runtime->getThrownValue());
+  runtime->clearThrownValue();
+  if (LLVM_UNLIKELY(
+          JSPromise::reject(promise, runtime, reason) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return promise.getHermesValue();
+}
+
+/// Count down the elements of a Promise.all() call that are still pending,
+/// and resolve its promise with the values once there are none left.
+ExecutionStatus finishAllElement(
+    Runtime *runtime,
+    Handle<ArrayStorage> record) {
+  double remaining = record->at(AllRecordIndexes::remaining).getNumber() - 1;
+  record->set(
+      AllRecordIndexes::remaining,
+      HermesValue::encodeNumberValue(remaining),
+      &runtime->getHeap());
+  if (remaining != 0) {
+    return ExecutionStatus::RETURNED;
+  }
+  return JSPromise::resolve(
+      runtime->makeHandle(
+          vmcast<JSPromise>(record->at(AllRecordIndexes::promise))),
+      runtime,
+      runtime->makeHandle(record->at(AllRecordIndexes::values)));
+}
+
+/// Store \p value at \p index of the values of a Promise.all() call.
+ExecutionStatus storeAllElement(
+    Runtime *runtime,
+    Handle<ArrayStorage> record,
+    uint32_t index,
+    Handle<> value) {
+  auto values = runtime->makeHandle(
+      vmcast<JSArray>(record->at(AllRecordIndexes::values)));
+  JSArray::setElementAt(values, runtime, index, value);
+  return finishAllElement(runtime, record);
+}
+
+} // namespace
+
+Handle<JSObject> createPromiseConstructor(Runtime *runtime) {
+  auto promisePrototype = Handle<JSObject>::vmcast(&runtime->promisePrototype);
+
+  defineMethod(
+      runtime,
+      promisePrototype,
+      Predefined::getSymbolID(Predefined::then),
+      nullptr,
+      promisePrototypeThen,
+      2);
+
+  defineMethod(
+      runtime,
+      promisePrototype,
+      Predefined::getSymbolID(Predefined::catchStr),
+      nullptr,
+      promisePrototypeCatch,
+      1);
+
+  defineMethod(
+      runtime,
+      promisePrototype,
+      Predefined::getSymbolID(Predefined::finallyStr),
+      nullptr,
+      promisePrototypeFinally,
+      1);
+
+  DefinePropertyFlags dpf = DefinePropertyFlags::getDefaultNewPropertyFlags();
+  dpf.writable = 0;
+  dpf.enumerable = 0;
+  defineProperty(
+      runtime,
+      promisePrototype,
+      Predefined::getSymbolID(Predefined::SymbolToStringTag),
+      runtime->getPredefinedStringHandle(Predefined::Promise),
+      dpf);
+
+  auto cons = defineSystemConstructor<JSPromise>(
+      runtime,
+      Predefined::getSymbolID(Predefined::Promise),
+      promiseConstructor,
+      promisePrototype,
+      1,
+      CellKind::PromiseKind);
+
+  // ES6.0 25.4.5.1
+  defineProperty(
+      runtime,
+      promisePrototype,
+      Predefined::getSymbolID(Predefined::constructor),
+      cons);
+
+  defineMethod(
+      runtime,
+      cons,
+      Predefined::getSymbolID(Predefined::resolve),
+      nullptr,
+      promiseResolve,
+      1);
+
+  defineMethod(
+      runtime,
+      cons,
+      Predefined::getSymbolID(Predefined::reject),
+      nullptr,
+      promiseReject,
+      1);
+
+  defineMethod(
+      runtime,
+      cons,
+      Predefined::getSymbolID(Predefined::all),
+      nullptr,
+      promiseAll,
+      1);
+
+  defineMethod(
+      runtime,
+      cons,
+      Predefined::getSymbolID(Predefined::race),
+      nullptr,
+      promiseRace,
+      1);
+
+  runtime->promiseConstructor = cons.getHermesValue();
+  return cons;
+}
+
+CallResult<HermesValue>
+promiseConstructor(void *, Runtime *runtime, NativeArgs args) {
+  GCScope gcScope{runtime};
+
+  if (LLVM_UNLIKELY(!args.isConstructorCall())) {
+    return runtime->raiseTypeError("Promises must be constructed via new");
+  }
+
+  auto self = args.dyncastThis<JSPromise>();
+  if (LLVM_UNLIKELY(!self)) {
+    return runtime->raiseTypeError(
+        "Promise constructor only applies to Promise objects");
+  }
+
+  auto executor = args.dyncastArg<Callable>(0);
+  if (LLVM_UNLIKELY(!executor)) {
+    return runtime->raiseTypeError(
+        "Promise constructor's argument is not a function");
+  }
+
+  MutableHandle<NativeFunction> resolveFn{runtime};
+  MutableHandle<NativeFunction> rejectFn{runtime};
+  if (LLVM_UNLIKELY(
+          JSPromise::createResolvingFunctions(
+              self, runtime, resolveFn, rejectFn) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto callRes = Callable::executeCall2(
+      executor,
+      runtime,
+      Runtime::getUndefinedValue(),
+      resolveFn.getHermesValue(),
+      rejectFn.getHermesValue());
+  if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
+    if (isUncatchableError(runtime->getThrownValue())) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    // Go through the reject function, which does nothing if the executor
+    // already resolved the promise before throwing.
+    auto reason = runtime->makeHandle(runtime->getThrownValue());
+    runtime->clearThrownValue();
+    if (LLVM_UNLIKELY(
+            Callable::executeCall1(
+                rejectFn,
+                runtime,
+                Runtime::getUndefinedValue(),
+                reason.getHermesValue()) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+  }
+  return self.getHermesValue();
+}
+
+CallResult<HermesValue>
+promisePrototypeThen(void *, Runtime *runtime, NativeArgs args) {
+  GCScope gcScope{runtime};
+
+  auto self = args.dyncastThis<JSPromise>();
+  if (LLVM_UNLIKELY(!self)) {
+    return runtime->raiseTypeError(
+        "Promise.prototype.then() called on a non-promise");
+  }
+  Handle<> onFulfilled = callableOrUndefined(args.getArgHandle(0));
+  Handle<> onRejected = callableOrUndefined(args.getArgHandle(1));
+
+  auto ctorRes = JSObject::getNamed_RJS(
+      self, runtime, Predefined::getSymbolID(Predefined::constructor));
+  if (LLVM_UNLIKELY(ctorRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto ctor = runtime->makeHandle(std::move(*ctorRes));
+
+  if (LLVM_LIKELY(ctor->getRaw() == runtime->promiseConstructor.getRaw())) {
+    auto derivedRes = JSPromise::create(runtime);
+    if (LLVM_UNLIKELY(derivedRes == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    auto derived = runtime->makeHandle(std::move(*derivedRes));
+    if (LLVM_UNLIKELY(
+            JSPromise::addReaction(
+                self, runtime, onFulfilled, onRejected, derived) ==
+            ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
+    return derived.getHermesValue();
+  }
+
+  // A subclass: let its constructor create the derived promise, and settle
+  // it from an intrinsic promise that the reaction settles.
+  auto ctorFn = Handle<Callable>::dyn_vmcast(ctor);
+  if (LLVM_UNLIKELY(!ctorFn)) {
+    return runtime->raiseTypeError("Promise constructor is not a function");
+  }
+  auto recordRes =
+      JSPromise::createRecord(runtime, {self, onFulfilled, onRejected});
+  if (LLVM_UNLIKELY(recordRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  Handle<NativeFunction> executor = JSPromise::createRecordFunction(
+      runtime, nullptr, promiseThenExecutor, 2, *recordRes);
+  return Callable::executeConstruct1(ctorFn, runtime, executor)
+      .toCallResultHermesValue();
+}
+
+CallResult<HermesValue>
+promiseThenExecutor(void *, Runtime *runtime, NativeArgs args) {
+  GCScope gcScope{runtime};
+  auto record = runtime->makeHandle(JSPromise::getCalleeRecord(runtime));
+  auto self = runtime->makeHandle(
+      vmcast<JSPromise>(record->at(ThenExecutorRecordIndexes::promise)));
+  auto onFulfilled =
+      runtime->makeHandle(record->at(ThenExecutorRecordIndexes::onFulfilled));
+  auto onRejected =
+      runtime->makeHandle(record->at(ThenExecutorRecordIndexes::onRejected));
+
+  auto resRes = JSPromise::create(runtime);
+  if (LLVM_UNLIKELY(resRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto res = runtime->makeHandle(std::move(*resRes));
+  if (LLVM_UNLIKELY(
+          JSPromise::addReaction(
+              res,
+              runtime,
+              callableOrUndefined(args.getArgHandle(0)),
+              callableOrUndefined(args.getArgHandle(1)),
+              Runtime::getUndefinedValue()) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (LLVM_UNLIKELY(
+          JSPromise::addReaction(
+              self, runtime, onFulfilled, onRejected, res) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return HermesValue::encodeUndefinedValue();
+}
+
+CallResult<HermesValue>
+promisePrototypeCatch(void *, Runtime *runtime, NativeArgs args) {
+  return invokeThen(
+      runtime,
+      args.getThisHandle(),
+      Runtime::getUndefinedValue(),
+      args.getArgHandle(0));
+}
+
+CallResult<HermesValue>
+promisePrototypeFinally(void *, Runtime *runtime, NativeArgs args) {
+  GCScope gcScope{runtime};
+  auto onFinally = args.getArgHandle(0);
+  if (!vmisa<Callable>(*onFinally)) {
+    return invokeThen(runtime, args.getThisHandle(), onFinally, onFinally);
+  }
+
+  auto recordRes = JSPromise::createRecord(runtime, {onFinally});
+  if (LLVM_UNLIKELY(recordRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  Handle<NativeFunction> thenFinally = JSPromise::createRecordFunction(
+      runtime,
+      /* isThrow */ (void *)false,
+      promiseFinallyHandler,
+      1,
+      *recordRes);
+  Handle<NativeFunction> catchFinally = JSPromise::createRecordFunction(
+      runtime,
+      /* isThrow */ (void *)true,
+      promiseFinallyHandler,
+      1,
+      *recordRes);
+  return invokeThen(runtime, args.getThisHandle(), thenFinally, catchFinally);
+}
+
+/// Handler installed by finally(): calls onFinally, waits for its result and
+/// then restores the original outcome. The record holds onFinally.
+CallResult<HermesValue>
+promiseFinallyHandler(void *ctx, Runtime *runtime, NativeArgs args) {
+  GCScope gcScope{runtime};
+  auto onFinally = runtime->makeHandle(vmcast<Callable>(
+      JSPromise::getCalleeRecord(runtime)->at(FinallyRecordIndexes::value)));
+
+  auto resultRes = Callable::executeCall0(
+      onFinally, runtime, Runtime::getUndefinedValue());
+  if (LLVM_UNLIKELY(resultRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto pRes = JSPromise::promiseResolve(
+      runtime, runtime->makeHandle(std::move(*resultRes)));
+  if (LLVM_UNLIKELY(pRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+
+  auto recordRes = JSPromise::createRecord(runtime, {args.getArgHandle(0)});
+  if (LLVM_UNLIKELY(recordRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  Handle<NativeFunction> thunk = JSPromise::createRecordFunction(
+      runtime, ctx, promiseFinallyThunk, 0, *recordRes);
+  auto derivedRes = JSPromise::create(runtime);
+  if (LLVM_UNLIKELY(derivedRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto derived = runtime->makeHandle(std::move(*derivedRes));
+  if (LLVM_UNLIKELY(
+          JSPromise::addReaction(
+              *pRes,
+              runtime,
+              thunk,
+              Runtime::getUndefinedValue(),
+              derived) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return derived.getHermesValue();
+}
+
+/// Return or throw the value in the record, depending on the context.
+CallResult<HermesValue>
+promiseFinallyThunk(void *ctx, Runtime *runtime, NativeArgs) {
+  HermesValue value =
+      JSPromise::getCalleeRecord(runtime)->at(FinallyRecordIndexes::value);
+  if ((bool)ctx) {
+    return runtime->setThrownValue(value);
+  }
+  return value;
+}
+
+CallResult<HermesValue>
+promiseResolve(void *, Runtime *runtime, NativeArgs args) {
+  auto res = JSPromise::promiseResolve(runtime, args.getArgHandle(0));
+  if (LLVM_UNLIKELY(res == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return res->getHermesValue();
+}
+
+CallResult<HermesValue>
+promiseReject(void *, Runtime *runtime, NativeArgs args) {
+  auto promiseRes = JSPromise::create(runtime);
+  if (LLVM_UNLIKELY(promiseRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  auto promise = runtime->makeHandle(std::move(*promiseRes));
+  if (LLVM_UNLIKELY(
+          JSPromise::reject(promise, runtime, args.getArgHandle(0)) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return promise.getHermesValue();
+}
+
+CallResult<HermesValue>
+promiseAll(void *, Runtime *runtime, NativeArgs args) {
+  GCScope gcScope{runtime};
+
+  MutableHandle<NativeFunction> resolveFn{runtime};
+  MutableHandle<NativeFunction> rejectFn{runtime};
+  auto promiseRes = createPromiseCapability(runtime, resolveFn, rejectFn);
+  if (LLVM_UNLIKELY(promiseRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  Handle<JSPromise> promise = *promiseRes;
+
+  auto valuesRes = JSArray::create(runtime, 0, 0);
+  if (LLVM_UNLIKELY(valuesRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  Handle<JSArray> values = *valuesRes;
+  // The count starts at one so that the promise cannot be resolved before
+  // the iteration is over.
+  auto recordRes = JSPromise::createRecord(
+      runtime, {values, HandleRootOwner::getOneValue(), promise});
+  if (LLVM_UNLIKELY(recordRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  Handle<ArrayStorage> record = *recordRes;
+  auto &heap = runtime->getHeap();
+
+  uint32_t index = 0;
+  MutableHandle<> then{runtime};
+  auto status = forEachIterated(
+      runtime, args.getArgHandle(0), [&](Handle<> value) -> ExecutionStatus {
+        uint32_t i = index++;
+        record->set(
+            AllRecordIndexes::remaining,
+            HermesValue::encodeNumberValue(
+                record->at(AllRecordIndexes::remaining).getNumber() + 1),
+            &heap);
+
+        auto obj = Handle<JSObject>::dyn_vmcast(value);
+        if (!obj) {
+          return storeAllElement(runtime, record, i, value);
+        }
+        auto thenRes = JSObject::getNamed_RJS(
+            obj, runtime, Predefined::getSymbolID(Predefined::then));
+        if (LLVM_UNLIKELY(thenRes == ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        then = std::move(*thenRes);
+        Handle<JSPromise> p = Handle<JSPromise>::dyn_vmcast(obj);
+        if (p && vmisa<NativeFunction>(*then) &&
+            vmcast<NativeFunction>(*then)->getFunctionPtr() ==
+                promisePrototypeThen) {
+          // Like the polyfill, use the outcome of settled promises right
+          // away.
+          JSPromise *source = JSPromise::getSettledSource(*p);
+          if (source->getState() == JSPromise::State::Fulfilled) {
+            return storeAllElement(
+                runtime, record, i, runtime->makeHandle(source->getResult()));
+          }
+          if (source->getState() == JSPromise::State::Rejected) {
+            if (LLVM_UNLIKELY(
+                    JSPromise::reject(
+                        promise,
+                        runtime,
+                        runtime->makeHandle(source->getResult())) ==
+                    ExecutionStatus::EXCEPTION)) {
+              return ExecutionStatus::EXCEPTION;
+            }
+          }
+        } else if (auto thenFn = Handle<Callable>::dyn_vmcast(then)) {
+          auto pRes = JSPromise::create(runtime);
+          if (LLVM_UNLIKELY(pRes == ExecutionStatus::EXCEPTION)) {
+            return ExecutionStatus::EXCEPTION;
+          }
+          p = runtime->makeHandle(std::move(*pRes));
+          if (LLVM_UNLIKELY(
+                  JSPromise::resolveWithThen(p, runtime, obj, thenFn) ==
+                  ExecutionStatus::EXCEPTION)) {
+            return ExecutionStatus::EXCEPTION;
+          }
+        } else {
+          return storeAllElement(runtime, record, i, value);
+        }
+
+        Handle<NativeFunction> resolveElement =
+            JSPromise::createRecordFunction(
+                runtime,
+                reinterpret_cast<void *>(static_cast<uintptr_t>(i)),
+                promiseAllResolveElement,
+                1,
+                record);
+        return JSPromise::addReaction(
+            p,
+            runtime,
+            resolveElement,
+            rejectFn,
+            Runtime::getUndefinedValue());
+      });
+  if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
+    return rejectWithThrownValue(runtime, promise);
+  }
+
+  // Elements fulfilled later are stored within this length.
+  auto lengthRes = JSArray::setLengthProperty(values, runtime, index);
+  if (LLVM_UNLIKELY(lengthRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  if (LLVM_UNLIKELY(
+          finishAllElement(runtime, record) == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return promise.getHermesValue();
+}
+
+CallResult<HermesValue>
+promiseAllResolveElement(void *ctx, Runtime *runtime, NativeArgs args) {
+  GCScope gcScope{runtime};
+  auto record = runtime->makeHandle(JSPromise::getCalleeRecord(runtime));
+  auto index = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(ctx));
+  if (LLVM_UNLIKELY(
+          storeAllElement(runtime, record, index, args.getArgHandle(0)) ==
+          ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  return HermesValue::encodeUndefinedValue();
+}
+
+CallResult<HermesValue>
+promiseRace(void *, Runtime *runtime, NativeArgs args) {
+  GCScope gcScope{runtime};
+
+  MutableHandle<NativeFunction> resolveFn{runtime};
+  MutableHandle<NativeFunction> rejectFn{runtime};
+  auto promiseRes = createPromiseCapability(runtime, resolveFn, rejectFn);
+  if (LLVM_UNLIKELY(promiseRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+  Handle<JSPromise> promise = *promiseRes;
+
+  auto status = forEachIterated(
+      runtime, args.getArgHandle(0), [&](Handle<> value) -> ExecutionStatus {
+        auto pRes = JSPromise::promiseResolve(runtime, value);
+        if (LLVM_UNLIKELY(pRes == ExecutionStatus::EXCEPTION)) {
+          return ExecutionStatus::EXCEPTION;
+        }
+        return JSPromise::addReaction(
+            *pRes, runtime, resolveFn, rejectFn, Runtime::getUndefinedValue());
+      });
+  if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
+    return rejectWithThrownValue(runtime, promise);
+  }
+  return promise.getHermesValue();
+}
+
+} // namespace vm
+} // namespace hermes
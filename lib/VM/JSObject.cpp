@@ -82,10 +82,31 @@ PseudoHandle<JSObject> JSObject::create(
   return JSObjectInit::initToPseudoHandle(runtime, cell);
 }
 
+PseudoHandle<JSObject> JSObject::create(
+    Runtime *runtime,
+    Handle<JSObject> parentHandle,
+    PropStorage::size_type capacity) {
+  return runtime->ignoreAllocationFailure(JSObject::allocatePropStorage(
+      create(runtime, parentHandle), runtime, 0, capacity));
+}
+
 PseudoHandle<JSObject> JSObject::create(Runtime *runtime) {
   return create(runtime, Handle<JSObject>::vmcast(&runtime->objectPrototype));
 }
 
+PseudoHandle<JSObject> JSObject::createLongLived(Runtime *runtime) {
+  auto parentHandle = Handle<JSObject>::vmcast(&runtime->objectPrototype);
+  auto *cell =
+      runtime->makeAFixed<JSObject, HasFinalizer::No, LongLived::Yes>(
+          runtime,
+          &vt.base,
+          parentHandle,
+          runtime->getHiddenClassForPrototype(
+              *parentHandle, numOverlapSlots<JSObject>()),
+          GCPointerBase::YesBarriers());
+  return JSObjectInit::initToPseudoHandle(runtime, cell);
+}
+
 PseudoHandle<JSObject> JSObject::create(
     Runtime *runtime,
     unsigned propertyCount) {
@@ -97,8 +118,10 @@ PseudoHandle<JSObject> JSObject::create(
 
 PseudoHandle<JSObject> JSObject::create(
     Runtime *runtime,
-    Handle<HiddenClass> clazz) {
-  auto obj = JSObject::create(runtime, clazz->getNumProperties());
+    Handle<HiddenClass> clazz,
+    PropStorage::size_type capacity) {
+  auto obj = runtime->ignoreAllocationFailure(JSObject::allocatePropStorage(
+      create(runtime), runtime, clazz->getNumProperties(), capacity));
   obj->clazz_.set(runtime, *clazz, &runtime->getHeap());
   // If the hidden class has index like property, we need to clear the fast path
   // flag.
@@ -2596,6 +2619,55 @@ void JSObject::updatePropertyFlagsWithoutTransitions(
   selfHandle->clazz_.set(runtime, *newClazz, &runtime->getHeap());
 }
 
+void JSObject::convertToCellDictionary(
+    Handle<JSObject> selfHandle,
+    Runtime *runtime) {
+  auto newClazz = HiddenClass::copyToCellDictionary(
+      runtime->makeHandle(selfHandle->clazz_), runtime);
+  selfHandle->clazz_.set(runtime, *newClazz, &runtime->getHeap());
+}
+
+bool JSObject::reshapeDictionary(
+    Handle<JSObject> selfHandle,
+    Runtime *runtime) {
+  if (LLVM_UNLIKELY(
+          selfHandle->flags_.lazyObject || selfHandle->flags_.proxyObject ||
+          selfHandle->flags_.hostObject)) {
+    return false;
+  }
+  GCScope gcScope{runtime};
+  llvh::SmallVector<SlotIndex, 8> oldSlots;
+  auto newClazz = HiddenClass::reshapeDictionary(
+      runtime->makeHandle(selfHandle->clazz_), runtime, oldSlots);
+  if (!newClazz)
+    return false;
+
+  {
+    // Move the values to their new slots. The storage is already large
+    // enough, since the highest old slot is at least the highest new one.
+    NoAllocScope noAlloc{runtime};
+    JSObject *self = *selfHandle;
+    llvh::SmallVector<SmallHermesValue, 8> values;
+    values.reserve(oldSlots.size());
+    for (SlotIndex oldSlot : oldSlots)
+      values.push_back(getNamedSlotValueUnsafe(self, runtime, oldSlot));
+    for (SlotIndex newSlot = 0, e = values.size(); newSlot != e; ++newSlot)
+      setNamedSlotValueUnsafe(self, runtime, newSlot, values[newSlot]);
+    // Clear the old slots which are no longer used to prevent memory leaks.
+    for (SlotIndex oldSlot : oldSlots) {
+      if (oldSlot >= values.size()) {
+        setNamedSlotValueUnsafe(
+            self, runtime, oldSlot, SmallHermesValue::encodeEmptyValue());
+      }
+    }
+    self->clazz_.set(runtime, *newClazz, &runtime->getHeap());
+  }
+#ifdef HERMESVM_PROFILER_BB
+  runtime->recordRecoveredHiddenClass(*newClazz);
+#endif
+  return true;
+}
+
 CallResult<bool> JSObject::isExtensible(
     PseudoHandle<JSObject> self,
     Runtime *runtime) {
@@ -0,0 +1,587 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/VM/JSPromise.h"
+
+#include "hermes/VM/BuildMetadata.h"
+#include "hermes/VM/JSNativeFunctions.h"
+#include "hermes/VM/Operations.h"
+#include "hermes/VM/StackFrame-inline.h"
+
+namespace hermes {
+namespace vm {
+
+namespace {
+
+/// The internal slots of the functions created by createRecordFunction.
+struct RecordFunctionSlotIndexes {
+  enum { record, COUNT };
+};
+
+/// The record shared by the two resolving functions of a promise. Its
+/// promise is cleared once either function has been called.
+struct ResolvingRecordIndexes {
+  enum { promise, COUNT };
+};
+
+/// The record of the thunks passed to setImmediate when the engine job queue
+/// is disabled.
+struct JobThunkRecordIndexes {
+  enum { handler, target, argument, rejected, COUNT };
+};
+
+ArrayStorage *getRecord(NativeFunction *fn, Runtime *runtime) {
+  return vmcast<ArrayStorage>(
+      NativeFunction::getAdditionalSlotValue(
+          fn, runtime, RecordFunctionSlotIndexes::record)
+          .unboxToHV(runtime));
+}
+
+/// Move the pending exception into \p out and clear it, unless it is
+/// uncatchable, in which case it must keep unwinding.
+/// \return whether the exception was taken.
+bool takeCatchableException(Runtime *runtime, MutableHandle<> &out) {
+  if (isUncatchableError(runtime->getThrownValue()))
+    return false;
+  out = runtime->getThrownValue();
+  runtime->clearThrownValue();
+  return true;
+}
+
+/// Mark the resolving functions sharing \p record as used.
+/// \return the promise they resolve, or null if they were already used.
+JSPromise *claimResolvingFunctions(ArrayStorage *record, Runtime *runtime) {
+  HermesValue promise = record->at(ResolvingRecordIndexes::promise);
+  if (!promise.isObject())
+    return nullptr;
+  record->set(
+      ResolvingRecordIndexes::promise,
+      HermesValue::encodeUndefinedValue(),
+      &runtime->getHeap());
+  return vmcast<JSPromise>(promise);
+}
+
+/// \return whether \p value is the intrinsic Promise.prototype.then.
+bool isIntrinsicThen(HermesValue value) {
+  auto *fn = dyn_vmcast<NativeFunction>(value);
+  return fn && fn->getFunctionPtr() == promisePrototypeThen;
+}
+
+/// Body of the resolve and reject functions created by
+/// createResolvingFunctions.
+CallResult<HermesValue>
+runResolvingFunction(Runtime *runtime, NativeArgs args, bool isReject) {
+  JSPromise *promise =
+      claimResolvingFunctions(JSPromise::getCalleeRecord(runtime), runtime);
+  if (!promise)
+    return HermesValue::encodeUndefinedValue();
+  auto promiseHandle = runtime->makeHandle(promise);
+  auto status = isReject
+      ? JSPromise::reject(promiseHandle, runtime, args.getArgHandle(0))
+      : JSPromise::resolve(promiseHandle, runtime, args.getArgHandle(0));
+  if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  return HermesValue::encodeUndefinedValue();
+}
+
+} // namespace
+
+//===----------------------------------------------------------------------===//
+// class JSPromise
+
+const ObjectVTable JSPromise::vt{
+    VTable(CellKind::PromiseKind, cellSize<JSPromise>()),
+    JSPromise::_getOwnIndexedRangeImpl,
+    JSPromise::_haveOwnIndexedImpl,
+    JSPromise::_getOwnIndexedPropertyFlagsImpl,
+    JSPromise::_getOwnIndexedImpl,
+    JSPromise::_setOwnIndexedImpl,
+    JSPromise::_deleteOwnIndexedImpl,
+    JSPromise::_checkAllOwnIndexedImpl,
+};
+
+void PromiseBuildMeta(const GCCell *cell, Metadata::Builder &mb) {
+  mb.addJSObjectOverlapSlots(JSObject::numOverlapSlots<JSPromise>());
+  ObjectBuildMeta(cell, mb);
+  const auto *self = static_cast<const JSPromise *>(cell);
+  mb.setVTable(&JSPromise::vt.base);
+  mb.addField("result", &self->result_);
+  mb.addField("reactionOnFulfilled", &self->reactionOnFulfilled_);
+  mb.addField("reactionOnRejected", &self->reactionOnRejected_);
+  mb.addField("reactionTarget", &self->reactionTarget_);
+  mb.addField("moreReactions", &self->moreReactions_);
+}
+
+CallResult<PseudoHandle<JSPromise>> JSPromise::create(
+    Runtime *runtime,
+    Handle<JSObject> parentHandle) {
+  auto *cell = runtime->makeAFixed<JSPromise>(
+      runtime,
+      parentHandle,
+      runtime->getHiddenClassForPrototype(
+          *parentHandle, numOverlapSlots<JSPromise>()));
+  return JSObjectInit::initToPseudoHandle(runtime, cell);
+}
+
+CallResult<PseudoHandle<JSPromise>> JSPromise::create(Runtime *runtime) {
+  return create(runtime, Handle<JSObject>::vmcast(&runtime->promisePrototype));
+}
+
+JSPromise *JSPromise::getSettledSource(JSPromise *self) {
+  while (self->state_ == State::Adopted)
+    self = vmcast<JSPromise>(self->result_);
+  return self;
+}
+
+ExecutionStatus JSPromise::resolve(
+    Handle<JSPromise> self,
+    Runtime *runtime,
+    Handle<> resolution) {
+  if (LLVM_UNLIKELY(self->state_ != State::Pending))
+    return ExecutionStatus::RETURNED;
+
+  MutableHandle<> reason{runtime};
+  auto obj = Handle<JSObject>::dyn_vmcast(resolution);
+  if (!obj)
+    return settle(self, runtime, State::Fulfilled, resolution);
+
+  if (LLVM_UNLIKELY(obj.get() == self.get())) {
+    (void)runtime->raiseTypeError("A promise cannot be resolved with itself.");
+    if (!takeCatchableException(runtime, reason))
+      return ExecutionStatus::EXCEPTION;
+    return reject(self, runtime, reason);
+  }
+
+  auto thenRes = JSObject::getNamed_RJS(
+      obj, runtime, Predefined::getSymbolID(Predefined::then));
+  if (LLVM_UNLIKELY(thenRes == ExecutionStatus::EXCEPTION)) {
+    if (!takeCatchableException(runtime, reason))
+      return ExecutionStatus::EXCEPTION;
+    return reject(self, runtime, reason);
+  }
+  Handle<> then = runtime->makeHandle(std::move(*thenRes));
+
+  if (auto promise = Handle<JSPromise>::dyn_vmcast(obj)) {
+    if (isIntrinsicThen(*then)) {
+      // Adopt the state of the other promise right away, forwarding the
+      // reactions registered so far.
+      if (LLVM_UNLIKELY(getSettledSource(*promise) == self.get())) {
+        (void)runtime->raiseTypeError(
+            "A promise cannot be resolved with itself.");
+        if (!takeCatchableException(runtime, reason))
+          return ExecutionStatus::EXCEPTION;
+        return reject(self, runtime, reason);
+      }
+      return settle(self, runtime, State::Adopted, promise);
+    }
+  }
+
+  auto thenFn = Handle<Callable>::dyn_vmcast(then);
+  if (!thenFn)
+    return settle(self, runtime, State::Fulfilled, resolution);
+  return resolveWithThen(self, runtime, obj, thenFn);
+}
+
+ExecutionStatus JSPromise::resolveWithThen(
+    Handle<JSPromise> self,
+    Runtime *runtime,
+    Handle<JSObject> thenable,
+    Handle<Callable> then) {
+  MutableHandle<NativeFunction> resolveFn{runtime};
+  MutableHandle<NativeFunction> rejectFn{runtime};
+  if (LLVM_UNLIKELY(
+          createResolvingFunctions(self, runtime, resolveFn, rejectFn) ==
+          ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  auto callRes = Callable::executeCall2(
+      then,
+      runtime,
+      thenable,
+      resolveFn.getHermesValue(),
+      rejectFn.getHermesValue());
+  if (LLVM_LIKELY(callRes != ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::RETURNED;
+  MutableHandle<> reason{runtime};
+  if (!takeCatchableException(runtime, reason))
+    return ExecutionStatus::EXCEPTION;
+  if (!claimResolvingFunctions(getRecord(*resolveFn, runtime), runtime))
+    return ExecutionStatus::RETURNED;
+  return reject(self, runtime, reason);
+}
+
+ExecutionStatus
+JSPromise::reject(Handle<JSPromise> self, Runtime *runtime, Handle<> reason) {
+  if (LLVM_UNLIKELY(self->state_ != State::Pending))
+    return ExecutionStatus::RETURNED;
+  return settle(self, runtime, State::Rejected, reason);
+}
+
+ExecutionStatus JSPromise::settle(
+    Handle<JSPromise> self,
+    Runtime *runtime,
+    State state,
+    Handle<> result) {
+  assert(self->state_ == State::Pending && "promise is already settled");
+  self->state_ = state;
+  self->result_.set(*result, &runtime->getHeap());
+
+  if (state == State::Rejected && !self->isHandled_) {
+    if (LLVM_UNLIKELY(
+            trackRejection(self, runtime, false) ==
+            ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+  }
+
+  if (self->reactionOnFulfilled_.isEmpty())
+    return ExecutionStatus::RETURNED;
+
+  // Take the reactions out of the promise before running anything.
+  GCScope gcScope{runtime};
+  auto &heap = runtime->getHeap();
+  MutableHandle<> onFulfilled{runtime, self->reactionOnFulfilled_};
+  MutableHandle<> onRejected{runtime, self->reactionOnRejected_};
+  MutableHandle<> target{runtime, self->reactionTarget_};
+  MutableHandle<ArrayStorage> more{runtime, self->moreReactions_.get(runtime)};
+  self->reactionOnFulfilled_.setNonPtr(HermesValue::encodeEmptyValue(), &heap);
+  self->reactionOnRejected_.setNonPtr(
+      HermesValue::encodeUndefinedValue(), &heap);
+  self->reactionTarget_.setNonPtr(HermesValue::encodeUndefinedValue(), &heap);
+  self->moreReactions_.setNull(&heap);
+
+  const uint32_t count = more ? more->size() / kReactionSize : 0;
+  auto marker = gcScope.createMarker();
+  for (uint32_t i = 0;; ++i) {
+    ExecutionStatus status;
+    if (state == State::Adopted) {
+      status = addReaction(
+          Handle<JSPromise>::vmcast(result),
+          runtime,
+          onFulfilled,
+          onRejected,
+          target);
+    } else {
+      bool rejected = state == State::Rejected;
+      status = enqueueReactionJob(
+          runtime,
+          rejected ? onRejected : onFulfilled,
+          target,
+          result,
+          rejected);
+    }
+    if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    if (i == count)
+      return ExecutionStatus::RETURNED;
+    gcScope.flushToMarker(marker);
+    onFulfilled = more->at(i * kReactionSize);
+    onRejected = more->at(i * kReactionSize + 1);
+    target = more->at(i * kReactionSize + 2);
+  }
+}
+
+ExecutionStatus JSPromise::addReaction(
+    Handle<JSPromise> self,
+    Runtime *runtime,
+    Handle<> onFulfilled,
+    Handle<> onRejected,
+    Handle<> target) {
+  assert(
+      (onFulfilled->isUndefined() || vmisa<Callable>(*onFulfilled)) &&
+      (onRejected->isUndefined() || vmisa<Callable>(*onRejected)) &&
+      (target->isUndefined() || vmisa<JSPromise>(*target)) &&
+      "invalid reaction");
+  auto source = runtime->makeHandle(getSettledSource(*self));
+
+  if (source->state_ == State::Rejected && !source->isHandled_) {
+    if (LLVM_UNLIKELY(
+            trackRejection(source, runtime, true) ==
+            ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+  }
+  source->isHandled_ = true;
+
+  switch (source->state_) {
+    case State::Fulfilled:
+    case State::Rejected: {
+      bool rejected = source->state_ == State::Rejected;
+      return enqueueReactionJob(
+          runtime,
+          rejected ? onRejected : onFulfilled,
+          target,
+          runtime->makeHandle(source->result_),
+          rejected);
+    }
+    case State::Pending:
+      break;
+    case State::Adopted:
+      llvm_unreachable("adopted promises were followed above");
+  }
+
+  auto &heap = runtime->getHeap();
+  if (source->reactionOnFulfilled_.isEmpty()) {
+    source->reactionOnFulfilled_.set(*onFulfilled, &heap);
+    source->reactionOnRejected_.set(*onRejected, &heap);
+    source->reactionTarget_.set(*target, &heap);
+    return ExecutionStatus::RETURNED;
+  }
+
+  MutableHandle<ArrayStorage> more{
+      runtime, source->moreReactions_.get(runtime)};
+  if (!more) {
+    auto moreRes = ArrayStorage::create(runtime, kReactionSize);
+    if (LLVM_UNLIKELY(moreRes == ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+    more = vmcast<ArrayStorage>(*moreRes);
+  }
+  for (Handle<> value : {onFulfilled, onRejected, target}) {
+    if (LLVM_UNLIKELY(
+            ArrayStorage::push_back(more, runtime, value) ==
+            ExecutionStatus::EXCEPTION))
+      return ExecutionStatus::EXCEPTION;
+  }
+  source->moreReactions_.set(runtime, *more, &heap);
+  return ExecutionStatus::RETURNED;
+}
+
+ExecutionStatus JSPromise::createResolvingFunctions(
+    Handle<JSPromise> self,
+    Runtime *runtime,
+    MutableHandle<NativeFunction> &resolveOut,
+    MutableHandle<NativeFunction> &rejectOut) {
+  auto recordRes = createRecord(runtime, {self});
+  if (LLVM_UNLIKELY(recordRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  resolveOut = *createRecordFunction(
+      runtime, nullptr, promiseResolveFunction, 1, *recordRes);
+  rejectOut = *createRecordFunction(
+      runtime, nullptr, promiseRejectFunction, 1, *recordRes);
+  return ExecutionStatus::RETURNED;
+}
+
+CallResult<Handle<ArrayStorage>> JSPromise::createRecord(
+    Runtime *runtime,
+    llvh::ArrayRef<Handle<>> values) {
+  auto recordRes = ArrayStorage::create(runtime, values.size(), values.size());
+  if (LLVM_UNLIKELY(recordRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  auto *record = vmcast<ArrayStorage>(*recordRes);
+  for (size_t i = 0, e = values.size(); i != e; ++i)
+    record->set(i, *values[i], &runtime->getHeap());
+  return runtime->makeHandle(record);
+}
+
+Handle<NativeFunction> JSPromise::createRecordFunction(
+    Runtime *runtime,
+    void *context,
+    NativeFunctionPtr functionPtr,
+    unsigned paramCount,
+    Handle<ArrayStorage> record) {
+  Handle<NativeFunction> fn = NativeFunction::createWithoutPrototype(
+      runtime,
+      context,
+      functionPtr,
+      Predefined::getSymbolID(Predefined::emptyString),
+      paramCount,
+      RecordFunctionSlotIndexes::COUNT);
+  // Encoding may allocate, so it must happen before reading the raw pointer.
+  auto shv = SmallHermesValue::encodeHermesValue(
+      record.getHermesValue(), runtime);
+  NativeFunction::setAdditionalSlotValue(
+      *fn, runtime, RecordFunctionSlotIndexes::record, shv);
+  return fn;
+}
+
+ArrayStorage *JSPromise::getCalleeRecord(Runtime *runtime) {
+  return getRecord(
+      vmcast<NativeFunction>(
+          runtime->getCurrentFrame()->getCalleeClosureUnsafe()),
+      runtime);
+}
+
+CallResult<Handle<JSPromise>> JSPromise::promiseResolve(
+    Runtime *runtime,
+    Handle<> value) {
+  if (auto promise = Handle<JSPromise>::dyn_vmcast(value))
+    return promise;
+  auto promiseRes = create(runtime);
+  if (LLVM_UNLIKELY(promiseRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  auto promise = runtime->makeHandle(std::move(*promiseRes));
+  if (LLVM_UNLIKELY(
+          resolve(promise, runtime, value) == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  return promise;
+}
+
+ExecutionStatus JSPromise::enqueueReactionJob(
+    Runtime *runtime,
+    Handle<> handler,
+    Handle<> target,
+    Handle<> argument,
+    bool rejected) {
+  if (runtime->useJobQueue()) {
+    runtime->enqueuePromiseJob(*handler, *target, *argument, rejected);
+    return ExecutionStatus::RETURNED;
+  }
+
+  // Without the engine job queue, every job is a task scheduled through the
+  // host's setImmediate, like the JS polyfill used to do.
+  auto setImmediateRes = JSObject::getNamed_RJS(
+      runtime->getGlobal(),
+      runtime,
+      Predefined::getSymbolID(Predefined::setImmediate));
+  if (LLVM_UNLIKELY(setImmediateRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  auto setImmediate = Handle<Callable>::dyn_vmcast(
+      runtime->makeHandle(std::move(*setImmediateRes)));
+  if (LLVM_UNLIKELY(!setImmediate)) {
+    return runtime->raiseTypeError(
+        "Promise jobs cannot be scheduled: setImmediate is not a function");
+  }
+
+  auto recordRes = createRecord(
+      runtime,
+      {handler,
+       target,
+       argument,
+       runtime->makeHandle(HermesValue::encodeBoolValue(rejected))});
+  if (LLVM_UNLIKELY(recordRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  Handle<NativeFunction> thunk =
+      createRecordFunction(runtime, nullptr, promiseJobThunk, 0, *recordRes);
+  return Callable::executeCall1(
+             setImmediate,
+             runtime,
+             Runtime::getUndefinedValue(),
+             thunk.getHermesValue())
+      .getStatus();
+}
+
+ExecutionStatus JSPromise::runReactionJob(
+    Runtime *runtime,
+    Handle<> handler,
+    Handle<> target,
+    Handle<> argument,
+    bool rejected) {
+  if (auto inner = Handle<GeneratorInnerFunction>::dyn_vmcast(handler)) {
+    return asyncFunctionResume(
+        runtime,
+        inner,
+        Handle<JSPromise>::vmcast(target),
+        argument,
+        rejected ? GeneratorInnerFunction::Action::Throw
+                 : GeneratorInnerFunction::Action::Next);
+  }
+
+  auto targetPromise = Handle<JSPromise>::dyn_vmcast(target);
+  auto handlerFn = Handle<Callable>::dyn_vmcast(handler);
+  if (!handlerFn) {
+    // Pass the outcome through to the target.
+    if (!targetPromise)
+      return ExecutionStatus::RETURNED;
+    return rejected ? reject(targetPromise, runtime, argument)
+                    : resolve(targetPromise, runtime, argument);
+  }
+
+  auto callRes = Callable::executeCall1(
+      handlerFn, runtime, Runtime::getUndefinedValue(), *argument);
+  if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
+    MutableHandle<> reason{runtime};
+    if (!takeCatchableException(runtime, reason))
+      return ExecutionStatus::EXCEPTION;
+    if (!targetPromise)
+      return ExecutionStatus::RETURNED;
+    return reject(targetPromise, runtime, reason);
+  }
+  if (!targetPromise)
+    return ExecutionStatus::RETURNED;
+  return resolve(
+      targetPromise, runtime, runtime->makeHandle(std::move(*callRes)));
+}
+
+ExecutionStatus JSPromise::asyncFunctionResume(
+    Runtime *runtime,
+    Handle<GeneratorInnerFunction> inner,
+    Handle<JSPromise> outer,
+    Handle<> value,
+    GeneratorInnerFunction::Action action) {
+  auto resultRes =
+      GeneratorInnerFunction::callInnerFunction(inner, runtime, value, action);
+  if (LLVM_UNLIKELY(resultRes == ExecutionStatus::EXCEPTION)) {
+    inner->setState(GeneratorInnerFunction::State::Completed);
+    MutableHandle<> reason{runtime};
+    if (!takeCatchableException(runtime, reason))
+      return ExecutionStatus::EXCEPTION;
+    return reject(outer, runtime, reason);
+  }
+  Handle<> result = runtime->makeHandle(std::move(*resultRes));
+  if (inner->getState() == GeneratorInnerFunction::State::Completed)
+    return resolve(outer, runtime, result);
+
+  // The body suspended at an await, yielding the awaited value. Awaiting a
+  // primitive resumes in the next job, like awaiting a fulfilled promise, so
+  // skip creating one.
+  if (!result->isObject()) {
+    return enqueueReactionJob(
+        runtime, inner, outer, result, /* rejected */ false);
+  }
+  auto promiseRes = promiseResolve(runtime, result);
+  if (LLVM_UNLIKELY(promiseRes == ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  return addReaction(*promiseRes, runtime, inner, inner, outer);
+}
+
+ExecutionStatus JSPromise::trackRejection(
+    Handle<JSPromise> self,
+    Runtime *runtime,
+    bool handled) {
+  auto tracker = Handle<Callable>::dyn_vmcast(
+      Handle<>(&runtime->promiseRejectionTracker_));
+  if (LLVM_LIKELY(!tracker))
+    return ExecutionStatus::RETURNED;
+  return Callable::executeCall3(
+             tracker,
+             runtime,
+             Runtime::getUndefinedValue(),
+             self.getHermesValue(),
+             HermesValue::encodeBoolValue(handled),
+             self->result_)
+      .getStatus();
+}
+
+//===----------------------------------------------------------------------===//
+// Native functions used by the promise machinery.
+
+CallResult<HermesValue>
+promiseResolveFunction(void *, Runtime *runtime, NativeArgs args) {
+  return runResolvingFunction(runtime, args, false);
+}
+
+CallResult<HermesValue>
+promiseRejectFunction(void *, Runtime *runtime, NativeArgs args) {
+  return runResolvingFunction(runtime, args, true);
+}
+
+CallResult<HermesValue>
+promiseJobThunk(void *, Runtime *runtime, NativeArgs args) {
+  auto record = runtime->makeHandle(JSPromise::getCalleeRecord(runtime));
+  auto handler =
+      runtime->makeHandle(record->at(JobThunkRecordIndexes::handler));
+  auto target = runtime->makeHandle(record->at(JobThunkRecordIndexes::target));
+  auto argument =
+      runtime->makeHandle(record->at(JobThunkRecordIndexes::argument));
+  bool rejected = record->at(JobThunkRecordIndexes::rejected).getBool();
+  if (LLVM_UNLIKELY(
+          JSPromise::runReactionJob(
+              runtime, handler, target, argument, rejected) ==
+          ExecutionStatus::EXCEPTION))
+    return ExecutionStatus::EXCEPTION;
+  return HermesValue::encodeUndefinedValue();
+}
+
+} // namespace vm
+} // namespace hermes
@@ -19,7 +19,123 @@ void JSWeakMapImplBase::WeakMapImplBaseBuildMeta(
   mb.addJSObjectOverlapSlots(JSObject::numOverlapSlots<JSWeakMapImplBase>());
   ObjectBuildMeta(cell, mb);
   const auto *self = static_cast<const JSWeakMapImplBase *>(cell);
-  mb.addField("valueStorage", &self->valueStorage_);
+  mb.addField("table", &self->table_);
+}
+
+uint32_t JSWeakMapImplBase::capacity(PointerBase *base) const {
+  BigStorage *table = table_.get(base);
+  return table ? table->size() / kEntrySize : 0;
+}
+
+uint32_t JSWeakMapImplBase::hashKey(JSObject *key) {
+  return llvh::hash_value(key->getAlreadyAssignedObjectID());
+}
+
+uint32_t JSWeakMapImplBase::findEntry(
+    PointerBase *base,
+    JSObject *key,
+    uint32_t hash) const {
+  BigStorage *table = table_.get(base);
+  if (!table) {
+    return kNotFound;
+  }
+  const uint32_t mask = table->size() / kEntrySize - 1;
+  // The table always has unused entries, so this terminates.
+  for (uint32_t i = hash & mask;; i = (i + 1) & mask) {
+    const HermesValue entryKey = table->at(i * kEntrySize);
+    if (entryKey.isEmpty()) {
+      return kNotFound;
+    }
+    if (isLiveKey(entryKey)) {
+      // A slot whose object was collected can never match a live key.
+      const WeakRefSlot *slot = getKeySlot(entryKey);
+      if (slot->hasPointer() && slot->getPointer() == key) {
+        return i;
+      }
+    }
+  }
+}
+
+bool JSWeakMapImplBase::insertEntry(
+    BigStorage *table,
+    GC *gc,
+    uint32_t hash,
+    WeakRefSlot *slot,
+    HermesValue value) {
+  const uint32_t mask = table->size() / kEntrySize - 1;
+  for (uint32_t i = hash & mask;; i = (i + 1) & mask) {
+    const HermesValue entryKey = table->at(i * kEntrySize);
+    if (!isLiveKey(entryKey)) {
+      table->setNonPtr(
+          i * kEntrySize, HermesValue::encodeNativePointer(slot), gc);
+      table->set(i * kEntrySize + 1, value, gc);
+      return !entryKey.isEmpty();
+    }
+  }
+}
+
+void JSWeakMapImplBase::deleteEntry(
+    PointerBase *base,
+    GC *gc,
+    uint32_t index) {
+  BigStorage *table = table_.getNonNull(base);
+  assert(isLiveKey(table->at(index * kEntrySize)) && "entry isn't in use");
+  table->setNonPtr(index * kEntrySize, deletedKey(), gc);
+  table->set(index * kEntrySize + 1, HermesValue::encodeEmptyValue(), gc);
+  --numEntries_;
+  ++numDeleted_;
+}
+
+ExecutionStatus JSWeakMapImplBase::rehash(
+    Handle<JSWeakMapImplBase> self,
+    Runtime *runtime) {
+  // Entries whose keys have been collected are dropped below, but counting
+  // them here keeps this a single pass over the table.
+  uint32_t newCapacity = kInitialCapacity;
+  while (newCapacity / 2 <= self->numEntries_) {
+    if (LLVM_UNLIKELY(newCapacity > BigStorage::maxElements() / 4)) {
+      return runtime->raiseRangeError("Out of space for elements in map");
+    }
+    newCapacity *= 2;
+  }
+  auto tableRes = BigStorage::create(
+      runtime, newCapacity * kEntrySize, newCapacity * kEntrySize);
+  if (LLVM_UNLIKELY(tableRes == ExecutionStatus::EXCEPTION)) {
+    return ExecutionStatus::EXCEPTION;
+  }
+
+  // No allocations from here on, so the entries can't be cleared by the GC
+  // while they are being moved. The allocation above may have cleared some,
+  // which only leaves more room in the new table.
+  NoAllocScope noAlloc{runtime};
+  WeakRefLock lk{runtime->getHeap().weakRefMutex()};
+  GC *gc = &runtime->getHeap();
+  BigStorage *newTable = tableRes->get();
+  uint32_t numEntries = 0;
+  if (BigStorage *table = self->table_.get(runtime)) {
+    for (uint32_t i = 0, e = table->size(); i < e; i += kEntrySize) {
+      const HermesValue entryKey = table->at(i);
+      if (!isLiveKey(entryKey)) {
+        continue;
+      }
+      WeakRefSlot *slot = getKeySlot(entryKey);
+      if (!slot->hasPointer()) {
+        // The key was collected; leave its slot to be freed by the GC.
+        continue;
+      }
+      insertEntry(
+          newTable,
+          gc,
+          hashKey(vmcast<JSObject>(slot->getPointer())),
+          slot,
+          table->at(i + 1));
+      ++numEntries;
+    }
+  }
+  self->table_.set(runtime, newTable, gc);
+  self->numEntries_ = numEntries;
+  self->numDeleted_ = 0;
+  return ExecutionStatus::RETURNED;
 }
 
 /// Set a key/value, overwriting the previous value at that key,
@@ -29,46 +145,37 @@ ExecutionStatus JSWeakMapImplBase::setValue(
     Runtime *runtime,
     Handle<JSObject> key,
     Handle<> value) {
-  {
-    // No allocations should occur while a WeakRefKey is live.
-    NoAllocScope noAlloc{runtime};
-    WeakRefKey mapKey(
-        WeakRef<JSObject>{&runtime->getHeap(), key},
-        runtime->gcStableHashHermesValue(key));
-    DenseMapT::iterator it = self->map_.find(mapKey);
-
-    if (it != self->map_.end()) {
-      // Key already exists, update existing value.
-      assert(
-          it->second < self->valueStorage_.get(runtime)->size() &&
-          "invalid index");
-      self->valueStorage_.get(runtime)->set(
-          it->second, *value, &runtime->getHeap());
-      return ExecutionStatus::RETURNED;
-    }
+  const uint32_t hash =
+      llvh::hash_value(JSObject::getObjectID(*key, runtime));
+  const uint32_t index = self->findEntry(runtime, *key, hash);
+  if (index != kNotFound) {
+    // Key already exists, update existing value.
+    self->table_.getNonNull(runtime)->set(
+        index * kEntrySize + 1, *value, &runtime->getHeap());
+    return ExecutionStatus::RETURNED;
   }
 
-  // Index in valueStorage_ in which to place the new element.
-  auto cr = getFreeValueStorageIndex(self, runtime);
-  if (LLVM_UNLIKELY(cr == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
+  // Keep at least a quarter of the entries unused, so lookups stay short.
+  const uint32_t capacity = self->capacity(runtime);
+  if ((self->numEntries_ + self->numDeleted_ + 1) * 4 > capacity * 3) {
+    if (LLVM_UNLIKELY(rehash(self, runtime) == ExecutionStatus::EXCEPTION)) {
+      return ExecutionStatus::EXCEPTION;
+    }
   }
-  uint32_t i = *cr;
 
-  {
-    // No allocations should occur while a WeakRefKey is live.
-    NoAllocScope noAlloc{runtime};
-    // Holding the WeakRefLock will prevent the weak ref from getting cleared.
-    WeakRefLock lk{runtime->getHeap().weakRefMutex()};
-    WeakRefKey mapKey(
-        WeakRef<JSObject>{&runtime->getHeap(), key},
-        runtime->gcStableHashHermesValue(key));
-    auto result = self->map_.try_emplace(mapKey, i);
-    (void)result;
-    assert(result.second && "unable to add a new value to map");
+  NoAllocScope noAlloc{runtime};
+  // Holding the WeakRefLock will prevent the weak ref from getting cleared.
+  WeakRefLock lk{runtime->getHeap().weakRefMutex()};
+  WeakRef<JSObject> ref{&runtime->getHeap(), key};
+  if (insertEntry(
+          self->table_.getNonNull(runtime),
+          &runtime->getHeap(),
+          hash,
+          ref.unsafeGetSlot(),
+          *value)) {
+    --self->numDeleted_;
   }
-
-  self->valueStorage_.get(runtime)->set(i, *value, &runtime->getHeap());
+  ++self->numEntries_;
   return ExecutionStatus::RETURNED;
 }
 
@@ -80,45 +187,30 @@ bool JSWeakMapImplBase::deleteValue(
     Handle<JSObject> key) {
   WeakRefLock lk{runtime->getHeap().weakRefMutex()};
   NoAllocScope noAlloc{runtime};
-  WeakRefKey mapKey(
-      WeakRef<JSObject>{&runtime->getHeap(), key},
-      runtime->gcStableHashHermesValue(key));
-  DenseMapT::iterator it = self->map_.find(mapKey);
-  if (it == self->map_.end()) {
+  const uint32_t index = self->findEntry(
+      runtime, *key, llvh::hash_value(JSObject::getObjectID(*key, runtime)));
+  if (index == kNotFound) {
     return false;
   }
-  self->deleteInternal(runtime, &runtime->getHeap(), it);
+  self->deleteEntry(runtime, &runtime->getHeap(), index);
   return true;
 }
 
 // Only during GC.
-bool JSWeakMapImplBase::clearEntryDirect(GC *gc, const WeakRefKey &key) {
+void JSWeakMapImplBase::clearEntryDirect(GC *gc, GCHermesValue &value) {
   assert(gc->calledByGC() && "Should only be used by the GC implementation.");
-  DenseMapT::iterator it = map_.find(key);
-  if (it == map_.end()) {
-    return false;
-  }
-  it->first.ref.clear();
-  valueStorage_.get(gc->getPointerBase())
-      ->atRef(it->second)
-      .setInGC(HermesValue::encodeEmptyValue(), gc);
-  return true;
+  // The key is in the slot right before the value.
+  GCHermesValue &key = *(&value - 1);
+  assert(isLiveKey(key) && "entry isn't in use");
+  key.setNonPtr(deletedKey(), gc);
+  value.setInGC(HermesValue::encodeEmptyValue(), gc);
+  --numEntries_;
+  ++numDeleted_;
 }
 
-GCHermesValue *JSWeakMapImplBase::getValueDirect(
-    GC *gc,
-    const WeakRefKey &key) {
+GCPointerBase &JSWeakMapImplBase::getTableRef(GC *gc) {
   assert(gc->calledByGC() && "Should only be used by the GC implementation.");
-  DenseMapT::iterator it = map_.find(key);
-  if (it == map_.end()) {
-    return nullptr;
-  }
-  return &valueStorage_.get(gc->getPointerBase())->atRef(it->second);
-}
-
-GCPointerBase &JSWeakMapImplBase::getValueStorageRef(GC *gc) {
-  assert(gc->calledByGC() && "Should only be used by the GC implementation.");
-  return valueStorage_;
+  return table_;
 }
 
 /// \return true if the \p key exists in the map.
@@ -126,187 +218,58 @@ bool JSWeakMapImplBase::hasValue(
     Handle<JSWeakMapImplBase> self,
     Runtime *runtime,
     Handle<JSObject> key) {
-  NoAllocScope noAlloc{runtime};
-  WeakRefKey mapKey(
-      WeakRef<JSObject>{&runtime->getHeap(), key},
-      runtime->gcStableHashHermesValue(key));
-  DenseMapT::iterator it = self->map_.find_as(mapKey);
-  return it != self->map_.end();
+  return self->findEntry(
+             runtime,
+             *key,
+             llvh::hash_value(JSObject::getObjectID(*key, runtime))) !=
+      kNotFound;
 }
 
 HermesValue JSWeakMapImplBase::getValue(
     Handle<JSWeakMapImplBase> self,
     Runtime *runtime,
     Handle<JSObject> key) {
-  NoAllocScope noAlloc{runtime};
-  WeakRefKey mapKey(
-      WeakRef<JSObject>{&runtime->getHeap(), key},
-      runtime->gcStableHashHermesValue(key));
-  DenseMapT::iterator it = self->map_.find(mapKey);
-  if (it == self->map_.end()) {
+  const uint32_t index = self->findEntry(
+      runtime, *key, llvh::hash_value(JSObject::getObjectID(*key, runtime)));
+  if (index == kNotFound) {
     return HermesValue::encodeUndefinedValue();
   }
-  return self->valueStorage_.get(runtime)->at(it->second);
+  return self->table_.getNonNull(runtime)->at(index * kEntrySize + 1);
 }
 
 uint32_t JSWeakMapImplBase::debugFreeSlotsAndGetSize(
     PointerBase *base,
     GC *gc,
     JSWeakMapImplBase *self) {
-  /// Free up any freeable slots, so the count is more accurate.
-  if (self->hasFreeableSlots_) {
-    // There are freeable slots: find and delete them.
-    self->findAndDeleteFreeSlots(base, gc);
-  }
-  return self->map_.size();
-}
-
-JSWeakMapImplBase::KeyIterator JSWeakMapImplBase::keys_begin() {
-  return KeyIterator{map_.begin()};
-}
-
-JSWeakMapImplBase::KeyIterator JSWeakMapImplBase::keys_end() {
-  return KeyIterator{map_.end()};
-}
-
-JSObject *detail::WeakRefKey::getObject(GC *gc) const {
-  assert(gc->calledByGC() && "Should only be used by the GC implementation.");
-  return getNoHandle(ref, gc);
-}
-
-void JSWeakMapImplBase::_markWeakImpl(GCCell *cell, WeakRefAcceptor &acceptor) {
-  auto *self = reinterpret_cast<JSWeakMapImplBase *>(cell);
-  for (auto it = self->map_.begin(); it != self->map_.end(); ++it) {
-    // We must mark the weak ref regardless of whether the ref is valid here,
-    // because JSWeakMapImplBase still has a pointer from map_ into the
-    // reference. If we were to skip marking this particular ref, it could be
-    // freed before we have a chance to remove the pointer from map_.
-    // Then, if the GC runs before we call deleteInternal on the ref,
-    // we would attempt to call markWeakRef on a freed ref, which is a violation
-    // of the markWeakRef contract.
-    acceptor.accept(it->first.ref);
-    if (!it->first.ref.isValid()) {
-      // Set the hasFreeableSlots_ to indicate that this slot can be
-      // cleaned up the next time we add an element to this map.
-      self->hasFreeableSlots_ = true;
-    }
-  }
-}
-
-HeapSnapshot::NodeID JSWeakMapImplBase::getMapID(GC *gc) {
-  assert(map_.size() && "Shouldn't call getMapID on an empty map");
-  GCBase::IDTracker &tracker = gc->getIDTracker();
-  const auto id = gc->getObjectID(this);
-  auto &nativeIDList = tracker.getExtraNativeIDs(id);
-  if (nativeIDList.empty()) {
-    nativeIDList.push_back(tracker.nextNativeID());
-  }
-  return nativeIDList[0];
-}
-
-void JSWeakMapImplBase::_snapshotAddEdgesImpl(
-    GCCell *cell,
-    GC *gc,
-    HeapSnapshot &snap) {
-  auto *const self = vmcast<JSWeakMapImplBase>(cell);
-  JSObject::_snapshotAddEdgesImpl(self, gc, snap);
-  if (self->map_.size()) {
-    snap.addNamedEdge(
-        HeapSnapshot::EdgeType::Internal, "map", self->getMapID(gc));
-  }
-}
-
-void JSWeakMapImplBase::_snapshotAddNodesImpl(
-    GCCell *cell,
-    GC *gc,
-    HeapSnapshot &snap) {
-  auto *const self = vmcast<JSWeakMapImplBase>(cell);
-  if (self->map_.size()) {
-    snap.beginNode();
-    snap.endNode(
-        HeapSnapshot::NodeType::Native,
-        "DenseMap",
-        self->getMapID(gc),
-        self->map_.getMemorySize(),
-        0);
-  }
-}
-
-/// Mark weak references and remove any invalid weak refs.
-void JSWeakMapImplBase::findAndDeleteFreeSlots(PointerBase *base, GC *gc) {
+  // Remove the entries whose keys were collected, so the count is accurate.
   WeakRefLock lk{gc->weakRefMutex()};
-  for (auto it = map_.begin(); it != map_.end(); ++it) {
-    if (!it->first.ref.isValid()) {
-      // If invalid, clear the value and remove the key from the map.
-      deleteInternal(base, gc, it);
+  for (uint32_t i = 0, e = self->capacity(base); i < e; ++i) {
+    const HermesValue entryKey =
+        self->table_.getNonNull(base)->at(i * kEntrySize);
+    if (isLiveKey(entryKey) && !getKeySlot(entryKey)->hasPointer()) {
+      self->deleteEntry(base, gc, i);
     }
   }
-  hasFreeableSlots_ = false;
+  return self->numEntries_;
 }
 
-void JSWeakMapImplBase::deleteInternal(
-    PointerBase *base,
-    GC *gc,
-    JSWeakMapImplBase::DenseMapT::iterator it) {
-  assert(it != map_.end() && "Invalid iterator to deleteInternal");
-  valueStorage_.getNonNull(base)->setNonPtr(
-      it->second, HermesValue::encodeNativeUInt32(freeListHead_), gc);
-  freeListHead_ = it->second;
-  map_.erase(it);
-}
-
-CallResult<uint32_t> JSWeakMapImplBase::getFreeValueStorageIndex(
-    Handle<JSWeakMapImplBase> self,
-    Runtime *runtime) {
-  if (self->freeListHead_ == kFreeListInvalid && self->hasFreeableSlots_) {
-    // No elements in the free list and there are freeable slots.
-    // Try to find some.
-    self->findAndDeleteFreeSlots(runtime, &runtime->getHeap());
-  }
-
-  // Index in valueStorage_ in which to place the new element.
-  uint32_t i;
-  // True if using the nextIndex field to get i.
-  bool useNextIndex;
-
-  if (self->freeListHead_ == kFreeListInvalid) {
-    // No elements in the free list.
-    i = self->nextIndex_;
-    if (LLVM_UNLIKELY(self->nextIndex_ == UINT32_MAX)) {
-      return runtime->raiseRangeError("Out of space for elements in map");
-    }
-    useNextIndex = true;
-  } else {
-    // Free list has an element, use it.
-    i = self->freeListHead_;
-    useNextIndex = false;
+void JSWeakMapImplBase::_markWeakImpl(GCCell *cell, WeakRefAcceptor &acceptor) {
+  auto *self = reinterpret_cast<JSWeakMapImplBase *>(cell);
+  BigStorage *table = self->table_.get(acceptor.getPointerBase());
+  if (!table) {
+    return;
   }
-
-  auto storageHandle = runtime->makeMutableHandle(self->valueStorage_);
-  if (i >= storageHandle->size()) {
-    if (LLVM_UNLIKELY(
-            BigStorage::resize(
-                storageHandle,
-                runtime,
-                std::max(i + 1, storageHandle->size() * 2)) ==
-            ExecutionStatus::EXCEPTION)) {
-      return ExecutionStatus::EXCEPTION;
+  for (uint32_t i = 0, e = table->size(); i < e; i += kEntrySize) {
+    const HermesValue entryKey = table->at(i);
+    if (!isLiveKey(entryKey)) {
+      continue;
     }
+    // We must mark the weak ref regardless of whether the ref is valid here,
+    // because the table still points to it until the entry is removed.
+    // Otherwise it could be freed and reused for another object.
+    WeakRef<JSObject> ref{getKeySlot(entryKey)};
+    acceptor.accept(ref);
   }
-
-  // Update internal state here to ensure we don't corrupt it on exception.
-  if (useNextIndex) {
-    ++self->nextIndex_;
-  } else {
-    // Set the start of the free list to the next element.
-    // If the next element is kFreeListInvalid, the free list is now empty.
-    self->freeListHead_ = storageHandle->at(i).getNativeUInt32();
-  }
-
-  assert(i < storageHandle->size() && "invalid index");
-  self->valueStorage_.set(runtime, *storageHandle, &runtime->getHeap());
-
-  return i;
 }
 
 template <CellKind C>
@@ -332,16 +295,16 @@ const ObjectVTable JSWeakMapImpl<C>::vt{
     VTable(
         C,
         cellSize<JSWeakMapImpl>(),
-        JSWeakMapImpl::_finalizeImpl,
+        nullptr,
         JSWeakMapImpl::_markWeakImpl,
-        JSWeakMapImpl::_mallocSizeImpl,
+        nullptr,
         nullptr,
         nullptr,
         VTable::HeapSnapshotMetadata{
             HeapSnapshot::NodeType::Object,
             nullptr,
-            _snapshotAddEdgesImpl,
-            _snapshotAddNodesImpl,
+            JSWeakMapImpl::_snapshotAddEdgesImpl,
+            nullptr,
             nullptr}),
     JSWeakMapImpl::_getOwnIndexedRangeImpl,
     JSWeakMapImpl::_haveOwnIndexedImpl,
@@ -356,18 +319,11 @@ template <CellKind C>
 CallResult<PseudoHandle<JSWeakMapImpl<C>>> JSWeakMapImpl<C>::create(
     Runtime *runtime,
     Handle<JSObject> parentHandle) {
-  auto valueRes = BigStorage::create(runtime, 1);
-  if (LLVM_UNLIKELY(valueRes == ExecutionStatus::EXCEPTION)) {
-    return ExecutionStatus::EXCEPTION;
-  }
-  auto valueStorage = runtime->makeHandle<BigStorage>(std::move(*valueRes));
-
-  auto *cell = runtime->makeAFixed<JSWeakMapImpl<C>, HasFinalizer::Yes>(
+  auto *cell = runtime->makeAFixed<JSWeakMapImpl<C>>(
       runtime,
       parentHandle,
       runtime->getHiddenClassForPrototype(
-          *parentHandle, numOverlapSlots<JSWeakMapImpl>()),
-      valueStorage);
+          *parentHandle, numOverlapSlots<JSWeakMapImpl>()));
   return JSObjectInit::initToPseudoHandle(runtime, cell);
 }
 
@@ -59,15 +59,24 @@ bool InlineCacheProfiler::insertICMiss(
 
 bool InlineCacheProfiler::insertICHit(
     CodeBlock *codeblock,
-    uint32_t instOffset) {
+    uint32_t instOffset,
+    ClassId classId) {
   // if not exist, create inline caching entry for the source location
   ICMiss &icMiss = getICMissBySourceLocation(codeblock, instOffset);
-  icMiss.incrementHit();
+  bool recovered = recoveredClasses_.count(classId);
+  icMiss.incrementHit(recovered);
 
   ++totalHits_;
+  if (recovered)
+    ++totalRecoveredHits_;
   return true;
 }
 
+void InlineCacheProfiler::insertRecoveredClass(ClassId classId) {
+  recoveredClasses_.insert(classId);
+  ++totalRecoveries_;
+}
+
 JSArray *&InlineCacheProfiler::getHiddenClassArray() {
   return cachedHiddenClassesRawPtr_;
 }
@@ -176,7 +185,8 @@ void InlineCacheProfiler::dumpInfoOfSourceLocation(
            << (1. * icMiss.missCount) / (icMiss.missCount + icMiss.hitCount);
     std::string missRatio = stream.str();
     ostream << "total access: " << icMiss.missCount + icMiss.hitCount
-            << ", miss ratio: " << missRatio << "\n";
+            << ", miss ratio: " << missRatio
+            << ", recovered hits: " << icMiss.recoveredHitCount << "\n";
   } else {
     ostream << "[No Loc]\n";
   }
@@ -187,8 +197,12 @@ void InlineCacheProfiler::dumpInfoOfSourceLocation(
 /// hidden class layouts at the source location.
 /// The source locations are ranked in the descending order of IC misses.
 ///
+/// The ranking is preceded by a summary of the cache hits on hidden classes
+/// that objects recovered instead of staying in dictionary mode.
+///
 /// An example of output for a specific source location is as follows:
-/// [filename:line:column] total access: 2661, miss ratio: 0.3
+/// [filename:line:column] total access: 2661, miss ratio: 0.3, recovered
+/// hits: 0
 ///  property: children, inline cache misses: 427
 ///    <type, domNamespace, children, childIndex, context, footer>
 ///    <domNamespace, type, children, childIndex, context, footer>
@@ -204,6 +218,10 @@ void InlineCacheProfiler::dumpRankedInlineCachingMisses(
   std::shared_ptr<InlineCacheProfiler::ICMissList> icInfoList =
       getRankedInlineCachingMisses();
 
+  ostream << "recovered hidden classes: " << totalRecoveries_
+          << ", recovered hits: " << totalRecoveredHits_ << " of "
+          << totalHits_ << "\n\n";
+
   uint64_t recordPrinted = 0;
   // enumerate each source location where inline caching miss happens
   for (auto &cacheMissEntry : *icInfoList) {
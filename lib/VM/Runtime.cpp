@@ -28,6 +28,7 @@
 #include "hermes/VM/JSError.h"
 #include "hermes/VM/JSLib.h"
 #include "hermes/VM/JSLib/RuntimeCommonStorage.h"
+#include "hermes/VM/JSPromise.h"
 #include "hermes/VM/MockedEnvironment.h"
 #include "hermes/VM/Operations.h"
 #include "hermes/VM/PredefinedStringIDs.h"
@@ -162,6 +163,10 @@ Runtime::Runtime(
       hasES6Proxy_(runtimeConfig.getES6Proxy()),
       hasIntl_(runtimeConfig.getIntl()),
       shouldRandomizeMemoryLayout_(runtimeConfig.getRandomizeMemoryLayout()),
+      dictionaryThreshold_(runtimeConfig.getDictionaryThreshold()),
+      dictionaryReshapeThreshold_(std::min(
+          runtimeConfig.getDictionaryReshapeThreshold(),
+          HiddenClass::kMaxDictionaryReshapeThreshold)),
       bytecodeWarmupPercent_(runtimeConfig.getBytecodeWarmupPercent()),
       trackIO_(runtimeConfig.getTrackIO()),
       vmExperimentFlags_(runtimeConfig.getVMExperimentFlags()),
@@ -181,6 +186,11 @@ Runtime::Runtime(
   const bool isSnapshot = std::strstr(__FILE__, "hermes-snapshot");
   crashMgr_->setCustomData("HermesIsSnapshot", isSnapshot ? "true" : "false");
 #endif
+  if (LLVM_UNLIKELY(
+          dictionaryThreshold_ < InternalProperty::NumInternalProperties ||
+          dictionaryThreshold_ > HiddenClass::kMaxDictionaryThreshold)) {
+    hermes_fatal("RuntimeConfig dictionaryThreshold out of range");
+  }
   auto maxNumRegisters = runtimeConfig.getMaxNumRegisters();
   if (LLVM_UNLIKELY(maxNumRegisters > kMaxSupportedNumRegisters)) {
     hermes_fatal("RuntimeConfig maxNumRegisters too big");
@@ -267,6 +277,9 @@ Runtime::Runtime(
 
   global_ =
       JSObject::create(this, Handle<JSObject>(this, nullptr)).getHermesValue();
+  // Global variables are read and written through property caches, which
+  // must stay usable when globals are deleted or redefined.
+  JSObject::convertToCellDictionary(getGlobal(), this);
 
   JSLibFlags jsLibFlags{};
   jsLibFlags.enableHermesInternal = runtimeConfig.getEnableHermesInternal();
@@ -436,8 +449,11 @@ void Runtime::markRoots(
   {
     MarkRootsPhaseTimer timer(this, RootAcceptor::Section::Jobs);
     acceptor.beginRootSection(RootAcceptor::Section::Jobs);
-    for (Callable *&f : jobQueue_)
-      acceptor.acceptPtr(f);
+    for (Job &job : jobQueue_) {
+      acceptor.accept(job.handler);
+      acceptor.accept(job.target);
+      acceptor.accept(job.argument);
+    }
     acceptor.endRootSection();
   }
 
@@ -1521,6 +1537,12 @@ void Runtime::initJSBuiltins(
     auto getRes = JSObject::getNamed_RJS(
         jsBuiltinsObj, this, Predefined::getSymbolID((Predefined::Str)symID));
     assert(getRes == ExecutionStatus::RETURNED && "Failed to get JS builtin.");
+    // Builtins that already have a native implementation, e.g. spawnAsync
+    // when Promise is enabled, are not provided by the internal bytecode.
+    if (getRes->getHermesValue().isUndefined()) {
+      assert(builtins[builtinIndex] && "JS builtin is missing.");
+      continue;
+    }
     JSFunction *jsFunc = vmcast<JSFunction>(getRes->getHermesValue());
 
     builtins[builtinIndex] = jsFunc;
@@ -1608,21 +1630,37 @@ void Runtime::freezeBuiltins() {
 
 ExecutionStatus Runtime::drainJobs() {
   GCScope gcScope{this};
-  MutableHandle<Callable> job{this};
+  MutableHandle<> handler{this};
+  MutableHandle<> target{this};
+  MutableHandle<> argument{this};
+  auto marker = gcScope.createMarker();
   // Note that new jobs can be enqueued during the draining.
   while (!jobQueue_.empty()) {
-    GCScopeMarkerRAII marker{gcScope};
+    gcScope.flushToMarker(marker);
 
-    job = jobQueue_.front();
+    const Job &job = jobQueue_.front();
+    handler = job.handler;
+    target = job.target;
+    argument = job.argument;
+    Job::Kind kind = job.kind;
     jobQueue_.pop_front();
 
-    // Jobs are guaranteed to behave as thunks.
-    auto callRes =
-        Callable::executeCall0(job, this, Runtime::getUndefinedValue());
+    ExecutionStatus status;
+    if (kind == Job::Kind::Thunk) {
+      // Jobs enqueued by the embedder are guaranteed to behave as thunks.
+      status = Callable::executeCall0(
+                   Handle<Callable>::vmcast(handler),
+                   this,
+                   Runtime::getUndefinedValue())
+                   .getStatus();
+    } else {
+      status = JSPromise::runReactionJob(
+          this, handler, target, argument, kind == Job::Kind::Rejected);
+    }
 
     // Early return to signal the caller. Note that the exceptional job has been
     // popped, so re-invocation would pick up from the next available job.
-    if (LLVM_UNLIKELY(callRes == ExecutionStatus::EXCEPTION)) {
+    if (LLVM_UNLIKELY(status == ExecutionStatus::EXCEPTION)) {
       return ExecutionStatus::EXCEPTION;
     }
   }
@@ -1897,7 +1935,8 @@ void Runtime::recordHiddenClass(
 
   // inline caching hit
   if (objectHiddenClass == cachedHiddenClass) {
-    inlineCacheProfiler_.insertICHit(codeBlock, offset);
+    inlineCacheProfiler_.insertICHit(
+        codeBlock, offset, getHeap().getObjectID(objectHiddenClass));
     return;
   }
 
@@ -1918,6 +1957,10 @@ void Runtime::recordHiddenClass(
       codeBlock, offset, symbolID, objectHiddenClassId, cachedHiddenClassId);
 }
 
+void Runtime::recordRecoveredHiddenClass(HiddenClass *hc) {
+  inlineCacheProfiler_.insertRecoveredClass(getHeap().getObjectID(hc));
+}
+
 void Runtime::getInlineCacheProfilerInfo(llvh::raw_ostream &ostream) {
   inlineCacheProfiler_.dumpRankedInlineCachingMisses(this, ostream);
 }
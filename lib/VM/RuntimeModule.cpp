@@ -44,16 +44,17 @@ SymbolID RuntimeModule::createSymbolFromStringIDMayAllocate(
     OptValue<uint32_t> mhash) {
   // Use manual pointer arithmetic to avoid out of bounds errors on empty
   // string accesses.
-  auto strStorage = bcProvider_->getStringStorage();
   if (entry.isUTF16()) {
     const char16_t *s =
-        (const char16_t *)(strStorage.begin() + entry.getOffset());
+        (const char16_t *)bcProvider_->getStringStorageRange(
+            entry.getOffset(), entry.getLength() * sizeof(char16_t));
     UTF16Ref str{s, entry.getLength()};
     uint32_t hash = mhash ? *mhash : hashString(str);
     return mapStringMayAllocate(str, stringID, hash);
   } else {
     // ASCII.
-    const char *s = (const char *)strStorage.begin() + entry.getOffset();
+    const char *s = (const char *)bcProvider_->getStringStorageRange(
+        entry.getOffset(), entry.getLength());
     ASCIIRef str{s, entry.getLength()};
     uint32_t hash = mhash ? *mhash : hashString(str);
     return mapStringMayAllocate(str, stringID, hash);
@@ -322,16 +323,17 @@ StringPrimitive *RuntimeModule::getStringPrimFromStringIDMayAllocate(
 
 std::string RuntimeModule::getStringFromStringID(StringID stringID) {
   auto entry = bcProvider_->getStringTableEntry(stringID);
-  auto strStorage = bcProvider_->getStringStorage();
   if (entry.isUTF16()) {
     const char16_t *s =
-        (const char16_t *)(strStorage.begin() + entry.getOffset());
+        (const char16_t *)bcProvider_->getStringStorageRange(
+            entry.getOffset(), entry.getLength() * sizeof(char16_t));
     std::string out;
     convertUTF16ToUTF8WithReplacements(out, UTF16Ref{s, entry.getLength()});
     return out;
   } else {
     // ASCII.
-    const char *s = (const char *)strStorage.begin() + entry.getOffset();
+    const char *s = (const char *)bcProvider_->getStringStorageRange(
+        entry.getOffset(), entry.getLength());
     return std::string{s, entry.getLength()};
   }
 }
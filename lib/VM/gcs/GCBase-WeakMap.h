@@ -13,81 +13,11 @@
 #include "hermes/VM/JSWeakMapImpl.h"
 #include "hermes/VM/SkipWeakRefsAcceptor.h"
 
-#include "llvh/ADT/DenseMap.h"
-#include "llvh/ADT/DenseSet.h"
+#include <algorithm>
 
 namespace hermes {
 namespace vm {
 
-/*static*/
-template <typename IsMarkedFunc>
-void GCBase::clearEntriesWithUnreachableKeys(
-    GC *gc,
-    JSWeakMap *weakMap,
-    IsMarkedFunc objIsMarked) {
-  for (auto iter = weakMap->keys_begin(), end = weakMap->keys_end();
-       iter != end;
-       iter++) {
-    JSObject *keyObj = iter->getObject(gc);
-    if (!keyObj || !objIsMarked(keyObj)) {
-      weakMap->clearEntryDirect(gc, *iter);
-    }
-  }
-}
-
-/*static*/
-template <typename Acceptor, typename ObjIsMarkedFunc, typename MarkFromValFunc>
-bool GCBase::markFromReachableWeakMapKeys(
-    GC *gc,
-    JSWeakMap *weakMap,
-    Acceptor &acceptor,
-    llvh::DenseMap<JSWeakMap *, std::vector<detail::WeakRefKey *>>
-        *unreachableKeys,
-    ObjIsMarkedFunc objIsMarked,
-    MarkFromValFunc markFromVal) {
-  std::vector<detail::WeakRefKey *> *keyList = nullptr;
-  auto keyListIter = unreachableKeys->find(weakMap);
-  if (keyListIter == unreachableKeys->end()) {
-    (*unreachableKeys)[weakMap] = GCBase::buildKeyList(gc, weakMap);
-    keyList = &(*unreachableKeys)[weakMap];
-  } else {
-    keyList = &keyListIter->second;
-  }
-  bool newlyMarkedValue = false;
-  // Find any reachable keys, mark from the corresponding value, and
-  // remove them from the list.
-  auto eraseFrom = std::remove_if(
-      keyList->begin(),
-      keyList->end(),
-      [weakMap, gc, objIsMarked, markFromVal, &newlyMarkedValue](
-          detail::WeakRefKey *key) {
-        GCCell *cell = key->getObject(gc);
-        if (!cell) {
-          // Remove key from list.
-          return true;
-        }
-
-        if (objIsMarked(cell)) {
-          GCHermesValue *valPtr = weakMap->getValueDirect(gc, *key);
-          assert(valPtr != nullptr && "Key is not in the map?");
-          if (valPtr->isPointer()) {
-            GCCell *valCell = reinterpret_cast<GCCell *>(valPtr->getPointer());
-
-            if (markFromVal(valCell, *valPtr)) {
-              newlyMarkedValue = true;
-            }
-          }
-
-          // Key was reachable; remove from list.
-          return true;
-        }
-        // Key was unreachable; do not remove from list.
-        return false;
-      });
-  keyList->erase(eraseFrom, keyList->end());
-  return newlyMarkedValue;
-}
-
 /*static*/
 template <
     typename Acceptor,
@@ -103,11 +33,16 @@ gcheapsize_t GCBase::completeWeakMapMarking(
     MarkFromValFunc markFromVal,
     DrainMarkStackFunc drainMarkStack,
     CheckMarkStackOverflowFunc checkMarkStackOverflow) {
-  // If a WeakMap is present as a key in this map, the corresponding list
-  // is a superset of the unreachable keys in the WeakMap.  (The set last
-  // found to be unreachable, some of which may now be reachable.)
-  llvh::DenseMap<JSWeakMap *, std::vector<detail::WeakRefKey *>>
-      unreachableKeys;
+  /// An entry whose key has not been found reachable yet.
+  struct PendingEntry {
+    JSWeakMap *weakMap;
+    JSObject *key;
+    GCHermesValue *value;
+  };
+  // The entries of the scanned WeakMaps whose keys are not known to be
+  // reachable. Nothing moves until marking is complete, so the pointers into
+  // the tables stay valid.
+  std::vector<PendingEntry> pendingEntries;
 
   /// A specialized acceptor, which does not mark weak refs.  We will
   /// revisit the WeakMaps with an acceptor that does, at the end.
@@ -117,9 +52,10 @@ gcheapsize_t GCBase::completeWeakMapMarking(
   // we make it false at the start of each loop iteration.
   bool newReachableValueFound = true;
 
-  // The set of weak maps that have already been scanned -- we do the
-  // initial scan of each weak map only once.
-  llvh::DenseSet<JSWeakMap *> scannedWeakMaps;
+  // The number of weak maps at the start of reachableWeakMaps that have
+  // already been scanned -- we do the initial scan of each weak map only once.
+  // Each reachable weak map is only added once.
+  size_t numScannedWeakMaps = 0;
 
   /// The total size of the reachable WeakMaps.
   gcheapsize_t weakMapAllocBytes = 0;
@@ -127,46 +63,63 @@ gcheapsize_t GCBase::completeWeakMapMarking(
     newReachableValueFound = false;
     // Note that new reachable weak maps may be discovered during the loop, so
     // reachableWeakMap.size() may increase during the loop.
-    for (unsigned i = 0; i < reachableWeakMaps.size(); i++) {
-      JSWeakMap *weakMap = reachableWeakMaps[i];
-
-      if (scannedWeakMaps.count(weakMap) == 0) {
-        weakMapAllocBytes += weakMap->getAllocatedSize();
-        // We need to scan the weak map here, to ensure that objects
-        // reachable from it (e.g., hidden class) are marked.  But we
-        // have to make one exception: the valueStorage field.  The
-        // whole point of weak map marking is to mark only the value
-        // fields that correspond to already-reachable keys; if we
-        // marked and drained, we would mark the value storage
-        // normally, and thus mark *all* objects reachable from it.
-        // So we temporarily null out the field, and restore it after.
-        auto &valueStorageRef = weakMap->getValueStorageRef(gc);
-        CompressedPointer valueStorage = valueStorageRef;
-        valueStorageRef.setInGC(CompressedPointer{nullptr});
-        gc->markCell(weakMap, skipWeakAcceptor);
-        drainMarkStack(acceptor);
-        valueStorageRef.setInGC(valueStorage);
-        scannedWeakMaps.insert(weakMap);
-        // This handles an obscure potential bug: if we've already
-        // determined reachable keys for weak map 0, the scanning
-        // above of weak map 1 may have made otherwise-unreachable
-        // keys in weak map 0 reachable.  (Perhaps weak map 1 has a
-        // property that is also a key in map 0.)  Therefore, to be
-        // safe, make sure we make another pass through this loop
-        // whenever we do any scanning.
-        newReachableValueFound = true;
-      }
-
-      if (markFromReachableWeakMapKeys(
-              gc,
-              weakMap,
-              acceptor,
-              &unreachableKeys,
-              objIsMarked,
-              markFromVal)) {
-        newReachableValueFound = true;
-      }
+    for (; numScannedWeakMaps < reachableWeakMaps.size();
+         ++numScannedWeakMaps) {
+      JSWeakMap *weakMap = reachableWeakMaps[numScannedWeakMaps];
+      weakMapAllocBytes += weakMap->getAllocatedSize();
+      // We need to scan the weak map here, to ensure that objects
+      // reachable from it (e.g., hidden class) are marked.  But we
+      // have to make one exception: the table field.  The whole point
+      // of weak map marking is to mark only the values that correspond
+      // to already-reachable keys; if we marked and drained, we would
+      // mark the table normally, and thus mark *all* objects reachable
+      // from it.  So we temporarily null out the field, and restore it
+      // after.
+      auto &tableRef = weakMap->getTableRef(gc);
+      CompressedPointer table = tableRef;
+      tableRef.setInGC(CompressedPointer{nullptr});
+      gc->markCell(weakMap, skipWeakAcceptor);
+      tableRef.setInGC(table);
+
+      // Mark from the values of the entries whose keys are already known to
+      // be reachable, and remember the others. Keys that were already
+      // collected can never become reachable again.
+      weakMap->forEachEntryDirect(
+          gc, [&](JSObject *key, GCHermesValue &value) {
+            if (!key) {
+              weakMap->clearEntryDirect(gc, value);
+            } else if (!objIsMarked(key)) {
+              pendingEntries.push_back({weakMap, key, &value});
+            } else if (
+                value.isPointer() &&
+                markFromVal(static_cast<GCCell *>(value.getPointer()), value)) {
+              newReachableValueFound = true;
+            }
+          });
+      // Draining once per weak map rather than once per value keeps the
+      // overhead of each drain out of large maps.
+      drainMarkStack(acceptor);
     }
+
+    // Scanning the weak maps and marking from values may have made some of
+    // the pending keys reachable, even those of weak maps that were scanned
+    // before. Mark from their values, and remove them from the list.
+    auto eraseFrom = std::remove_if(
+        pendingEntries.begin(),
+        pendingEntries.end(),
+        [&](const PendingEntry &entry) {
+          if (!objIsMarked(entry.key)) {
+            return false;
+          }
+          GCHermesValue &value = *entry.value;
+          if (value.isPointer() &&
+              markFromVal(static_cast<GCCell *>(value.getPointer()), value)) {
+            newReachableValueFound = true;
+          }
+          return true;
+        });
+    pendingEntries.erase(eraseFrom, pendingEntries.end());
+    drainMarkStack(acceptor);
   } while (newReachableValueFound);
 
   // If mark stack overflow occurred, terminate.
@@ -177,23 +130,24 @@ gcheapsize_t GCBase::completeWeakMapMarking(
     return 0;
   }
 
+  // Whatever is still pending has an unreachable key.
+  for (const PendingEntry &entry : pendingEntries) {
+    entry.weakMap->clearEntryDirect(gc, *entry.value);
+  }
+
 #ifndef NDEBUG
   const auto numReachableWeakMaps = reachableWeakMaps.size();
 #endif
   for (auto *weakMap : reachableWeakMaps) {
-    clearEntriesWithUnreachableKeys(gc, weakMap, objIsMarked);
-    // Previously we scanned the weak map while its value storage was
+    // Previously we scanned the weak map while its table was
     // temporarily nulled out, using an acceptor that skipped weak
     // references.  Now scan again, so that we mark both the weak
-    // references and the value storage, and everything reachable from
-    // them.  The values in the the value storage corresponding to
-    // reachable keys have already been marked from, and values
-    // corresponding to unreachable keys have been cleared.  But it is
-    // still necessary to mark the value storage: for example, if it
-    // is a SegmentedArray, we need to mark any reachable array
-    // segment objects.  Note that we might visit some already-visited
-    // fields, pointing to already-marked objects; this is why we
-    // require the acceptor to be idempotent.
+    // references of the remaining keys and the table, and everything
+    // reachable from them.  The values in the table have either been
+    // marked from or cleared.  But it is still necessary to mark the
+    // table itself, including any of its segments.  Note that we might
+    // visit some already-visited fields, pointing to already-marked
+    // objects; this is why we require the acceptor to be idempotent.
     gc->markCell(weakMap, acceptor);
     drainMarkStack(acceptor);
   }
@@ -32,6 +32,11 @@ static const char *kCompacteeNameForCrashMgr = "COMPACT";
 // We have a target max pause time of 50ms.
 static constexpr size_t kTargetMaxPauseMs = 50;
 
+// Segments that are at most this full are sparse enough that compacting them
+// is worthwhile. The sparsest segment may still be compacted when the heap is
+// over its target and no segment is this sparse.
+static constexpr double kSparseSegmentRatio = 0.5;
+
 // A free list cell is always variable-sized.
 const VTable HadesGC::OldGen::FreelistCell::vt{
     CellKind::FreelistKind,
@@ -286,6 +291,13 @@ class HadesGC::CollectionStats final {
     sizeAfter_ = sz;
   }
 
+  /// Record how many allocation sites started allocating in the old gen
+  /// because of this collection.
+  void setPretenuredSites(uint32_t numSites) {
+    if (numSites)
+      addCollectionType("pretenure");
+  }
+
   /// Record that a collection is beginning right now.
   void setBeginTime() {
     assert(beginTime_ == Clock::time_point{} && "Begin time already set");
@@ -694,9 +706,11 @@ class HadesGC::MarkAcceptor final : public RootAndSlotAcceptor,
   void acceptHeap(GCCell *cell, const void *heapLoc) {
     assert(cell && "Cannot pass null pointer to acceptHeap");
     assert(!gc.inYoungGen(heapLoc) && "YG slot found in OG marking");
-    if (gc.compactee_.contains(cell) && !gc.compactee_.contains(heapLoc)) {
-      // This is a pointer in the heap pointing into the compactee, dirty the
-      // corresponding card.
+    if (gc.compactee_.contains(cell) &&
+        !AlignedStorage::containedInSame(cell, heapLoc)) {
+      // This is a pointer in the heap pointing into a compactee, dirty the
+      // corresponding card. Pointers from other compactees are included,
+      // since the compactees are evacuated one at a time.
       HeapSegment::cardTableCovering(heapLoc)->dirtyCardForAddress(heapLoc);
     }
     if (HeapSegment::getCellMarkBit(cell)) {
@@ -798,6 +812,10 @@ class HadesGC::MarkAcceptor final : public RootAndSlotAcceptor,
     }
   }
 
+  PointerBase *getPointerBase() const override {
+    return pointerBase_;
+  }
+
   /// Set the drain rate that'll be used for any future calls to drain APIs.
   void setDrainRate(size_t rate) {
     assert(!kConcurrentGC && "Drain rate is only used by incremental GC.");
@@ -876,6 +894,38 @@ class HadesGC::MarkAcceptor final : public RootAndSlotAcceptor,
     return !localWorklist_.empty();
   }
 
+  /// Mark from the values of the entries of the reachable WeakMaps whose keys
+  /// are already marked. This does most of the work of completeWeakMapMarking
+  /// while the mutator is still running, leaving little for the STW pause.
+  /// Marking these values early is safe since marked keys stay marked: at
+  /// worst, an entry deleted later keeps its value alive until the next
+  /// collection.
+  /// \return true if any value was newly marked, in which case its transitive
+  /// closure is left on the worklist.
+  bool markReachableWeakMapValues() {
+    assert(gc.gcMutex_ && "Must hold the GC lock while accessing mark bits.");
+    // The mutator only changes keys and tables while holding the weak ref
+    // mutex, and values are read with concurrentRead by accept.
+    WeakRefLock lk{gc.weakRefMutex()};
+    const size_t numPending = localWorklist_.size();
+    const size_t numWeakMaps = reachableWeakMaps_.size();
+    // Values that are WeakMaps are added to reachableWeakMaps_, so it may grow
+    // during the loop.
+    for (size_t i = 0; i < reachableWeakMaps_.size(); ++i) {
+      reachableWeakMaps_[i]->forEachEntryDirect(
+          &gc, [this](JSObject *key, GCHermesValue &value) {
+            // Tables in the YG are left for the STW pause, since they might
+            // be evacuated before then.
+            if (key && HeapSegment::getCellMarkBit(key) &&
+                !gc.inYoungGen(&value)) {
+              accept(value);
+            }
+          });
+    }
+    return localWorklist_.size() != numPending ||
+        reachableWeakMaps_.size() != numWeakMaps;
+  }
+
   MarkWorklist &globalWorklist() {
     return globalWorklist_;
   }
@@ -1303,6 +1353,8 @@ HadesGC::HadesGC(
        // At least one YG segment and one OG segment.
        static_cast<size_t>(2)});
   oldGen_.setTargetSizeBytes((initHeapSegments - 1) * HeapSegment::maxSize());
+  if (gcConfig.getAllocationSitePretenuring())
+    getAllocationSiteTracker().enable();
 }
 
 HadesGC::~HadesGC() {
@@ -1322,6 +1374,8 @@ void HadesGC::getHeapInfo(HeapInfo &info) {
   // If YG isn't empty, its bytes haven't been accounted for yet, add them here.
   info.totalAllocatedBytes = totalAllocatedBytes_ + youngGen().used();
   info.va = info.heapSize;
+  info.fragmentedBytes = oldGen_.size() - oldGen_.allocatedBytes();
+  info.numCompactedSegments = numCompactedSegments_;
 }
 
 void HadesGC::getHeapInfoWithMallocSize(HeapInfo &info) {
@@ -1439,6 +1493,12 @@ void HadesGC::printStats(JSONEmitter &json) {
   json.emitKeyValue("collector", getKindAsStr());
   json.emitKey("stats");
   json.openDict();
+  const auto &siteStats = getAllocationSiteTracker().getStats();
+  json.emitKeyValue("sampledObjects", siteStats.sampledObjects);
+  json.emitKeyValue("survivedSampledObjects", siteStats.survivedObjects);
+  json.emitKeyValue("pretenuredSites", siteStats.pretenuredSites);
+  json.emitKeyValue("pretenuredObjects", siteStats.pretenuredObjects);
+  json.emitKeyValue("pretenuredBytes", siteStats.pretenuredBytes);
   json.closeDict();
   json.closeDict();
 }
@@ -1448,14 +1508,22 @@ std::string HadesGC::getKindAsStr() const {
 }
 
 void HadesGC::collect(std::string cause, bool /*canEffectiveOOM*/) {
-  {
-    // Wait for any existing collections to finish before starting a new one.
-    std::lock_guard<Mutex> lk{gcMutex_};
-    // Disable the YG promotion mode. A forced GC via collect will do a full
-    // collection immediately anyway, so there's no need to avoid collecting YG.
-    // This is especially important when the forced GC is a memory warning.
-    promoteYGToOG_ = false;
-    waitForCollectionToFinish(cause);
+  while (true) {
+    {
+      // Wait for any existing collections to finish before starting a new one.
+      std::lock_guard<Mutex> lk{gcMutex_};
+      // Disable the YG promotion mode. A forced GC via collect will do a full
+      // collection immediately anyway, so there's no need to avoid collecting
+      // YG. This is especially important when the forced GC is a memory
+      // warning.
+      promoteYGToOG_ = false;
+      waitForCollectionToFinish(cause);
+      // A new OG collection can't start until every compactee left by the
+      // previous one has been evacuated.
+      if (!compactee_.evacActive())
+        break;
+    }
+    youngGenCollection(cause, /*forceOldGenCollection*/ false);
   }
   // This function should block until a collection finishes.
   // YG needs to be empty in order to do an OG collection.
@@ -1465,13 +1533,18 @@ void HadesGC::collect(std::string cause, bool /*canEffectiveOOM*/) {
     std::lock_guard<Mutex> lk{gcMutex_};
     waitForCollectionToFinish(cause);
   }
-  // Start a second YG collection to complete any pending compaction.
-  // Since YG is empty, this will only be evacuating the compactee.
-  // Note that it's possible for this call to start another OG collection if the
-  // occupancy target is >= 75%. That doesn't break the contract of this
+  // Start more YG collections to complete any pending compaction. Since YG is
+  // empty, these will only be evacuating the compactees, one per collection.
+  // Note that it's possible for the last call to start another OG collection if
+  // the occupancy target is >= 75%. That doesn't break the contract of this
   // function though, and we don't want to bother with waiting for that
   // collection to complete because it won't find any garbage anyway.
-  youngGenCollection(std::move(cause), /*forceOldGenCollection*/ false);
+  bool evacActive;
+  do {
+    youngGenCollection(cause, /*forceOldGenCollection*/ false);
+    std::lock_guard<Mutex> lk{gcMutex_};
+    evacActive = compactee_.evacActive();
+  } while (evacActive);
 }
 
 void HadesGC::waitForCollectionToFinish(std::string cause) {
@@ -1677,9 +1750,11 @@ void HadesGC::incrementalCollect(bool backgroundThread) {
     case Phase::Mark:
       if (!kConcurrentGC && ygCollectionStats_)
         ygCollectionStats_->addCollectionType("marking");
-      // Drain some work from the mark worklist. If the work has finished
-      // completely, move on to CompleteMarking.
-      if (!oldGenMarker_->drainSomeWork())
+      // Drain some work from the mark worklist. Once it is empty, mark from
+      // the values of WeakMaps whose keys are reachable. If that doesn't find
+      // any more work, move on to CompleteMarking.
+      if (!oldGenMarker_->drainSomeWork() &&
+          !oldGenMarker_->markReachableWeakMapValues())
         concurrentPhase_ = Phase::CompleteMarking;
       break;
     case Phase::CompleteMarking:
@@ -1700,7 +1775,7 @@ void HadesGC::incrementalCollect(bool backgroundThread) {
         // Finish any collection bookkeeping.
         ogCollectionStats_->setEndTime();
         ogCollectionStats_->setAfterSize(segmentFootprint());
-        compacteeHandleForSweep_.reset();
+        compacteeHandlesForSweep_.clear();
         concurrentPhase_ = Phase::None;
         if (!backgroundThread)
           checkTripwireAndResetStats();
@@ -1714,51 +1789,124 @@ void HadesGC::incrementalCollect(bool backgroundThread) {
 void HadesGC::prepareCompactee(bool forceCompaction) {
   assert(gcMutex_);
   assert(
-      compactee_.empty() &&
+      compactee_.empty() && !compactee_.evacActive() &&
       "Ongoing compaction at the start of an OG collection.");
   if (promoteYGToOG_)
     return;
 
-  llvh::Optional<size_t> compacteeIdx;
+  llvh::SmallVector<size_t, CompacteeState::kMaxSegments> compacteeIdxs;
   // We should compact if the actual size of the heap is more than 5% larger
-  // than the target size. Since the selected segment will be removed from the
+  // than the target size. Since the selected segments will be removed from the
   // heap, we only want to compact if there are at least 2 segments in the OG.
-  double threshold = oldGen_.targetSizeBytes() * 1.05;
+  const uint64_t targetSize = oldGen_.targetSizeBytes();
+  double threshold = targetSize * 1.05;
   if ((forceCompaction || oldGen_.size() > threshold) &&
       oldGen_.numSegments() > 1) {
-    // Select the one with the fewest allocated bytes, to
-    // minimise scanning and copying. We intentionally avoid selecting the very
-    // last segment, since that is going to be the most recently added segment
-    // and is unlikely to be fragmented enough to be a good compaction
-    // candidate.
-    uint64_t minBytes = HeapSegment::maxSize();
-    for (size_t i = 0; i < oldGen_.numSegments() - 1; ++i) {
-      const size_t curBytes = oldGen_.allocatedBytes(i);
-      if (curBytes < minBytes) {
-        compacteeIdx = i;
-        minBytes = curBytes;
-      }
+    // Select the segments with the fewest allocated bytes, to minimise
+    // scanning and copying. We intentionally avoid selecting the very last
+    // segment, since that is going to be the most recently added segment and
+    // is unlikely to be fragmented enough to be a good compaction candidate.
+    llvh::SmallVector<std::pair<uint64_t, size_t>, 16> candidates;
+    for (size_t i = 0; i < oldGen_.numSegments() - 1; ++i)
+      candidates.emplace_back(oldGen_.allocatedBytes(i), i);
+    std::sort(candidates.begin(), candidates.end());
+    // Remove enough segments to bring the heap back to its target size. A
+    // forced compaction removes as many sparse segments as it can.
+    size_t maxCompactees = CompacteeState::kMaxSegments;
+    if (!forceCompaction && oldGen_.size() > targetSize) {
+      const uint64_t excessSegments = llvh::divideCeil(
+          oldGen_.size() - targetSize, HeapSegment::maxSize());
+      maxCompactees = std::min<uint64_t>(maxCompactees, excessSegments);
+    }
+    const uint64_t sparseBytes =
+        HeapSegment::maxSize() * kSparseSegmentRatio;
+    for (const auto &candidate : candidates) {
+      if (compacteeIdxs.size() >= maxCompactees)
+        break;
+      // Always compact the sparsest segment, and only add others if they are
+      // sparse enough to make evacuating them worthwhile.
+      if (!compacteeIdxs.empty() && candidate.first > sparseBytes)
+        break;
+      compacteeIdxs.push_back(candidate.second);
     }
   }
 #ifdef HERMESVM_SANITIZE_HANDLES
   // Handle-SAN forces a compaction on random segments to move the heap.
   if (sanitizeRate_ && oldGen_.numSegments()) {
     std::uniform_int_distribution<> distrib(0, oldGen_.numSegments() - 1);
-    compacteeIdx = distrib(randomEngine_);
+    compacteeIdxs.assign(1, distrib(randomEngine_));
   }
 #endif
 
-  if (compacteeIdx) {
-    compactee_.allocatedBytes = oldGen_.allocatedBytes(*compacteeIdx);
-    compactee_.segment =
-        std::make_shared<HeapSegment>(oldGen_.removeSegment(*compacteeIdx));
+  // Remove the segments from the back, so that the remaining indices stay
+  // valid.
+  std::sort(compacteeIdxs.begin(), compacteeIdxs.end(), std::greater<size_t>());
+  for (size_t idx : compacteeIdxs) {
+    const uint32_t allocatedBytes = oldGen_.allocatedBytes(idx);
+    auto segment = std::make_shared<HeapSegment>(oldGen_.removeSegment(idx));
     addSegmentExtentToCrashManager(
-        *compactee_.segment, kCompacteeNameForCrashMgr);
-    compactee_.start = compactee_.segment->lowLim();
-    compactee_.startCP = CompressedPointer(
-        getPointerBase(),
-        reinterpret_cast<GCCell *>(compactee_.segment->lowLim()));
-    compacteeHandleForSweep_ = compactee_.segment;
+        *segment,
+        std::string(kCompacteeNameForCrashMgr) +
+            std::to_string(
+                SegmentInfo::segmentIndexFromStart(segment->lowLim())));
+    compacteeHandlesForSweep_.push_back(segment);
+    compactee_.add(getPointerBase(), std::move(segment), allocatedBytes);
+  }
+  compactee_.sortByAllocatedBytes();
+}
+
+void HadesGC::CompacteeState::add(
+    PointerBase *base,
+    std::shared_ptr<HeapSegment> segment,
+    uint32_t allocatedBytes) {
+  assert(segments.size() < kMaxSegments && "Too many compactee segments");
+  assert(!evacActive() && "Cannot add a compactee during evacuation");
+  segments.push_back({std::move(segment), allocatedBytes});
+  updateStarts(base);
+}
+
+void HadesGC::CompacteeState::sortByAllocatedBytes() {
+  assert(!evacActive() && "Cannot reorder compactees during evacuation");
+  std::stable_sort(
+      segments.begin(), segments.end(), [](const Entry &a, const Entry &b) {
+        return a.allocatedBytes < b.allocatedBytes;
+      });
+}
+
+void HadesGC::CompacteeState::startEvacuation(PointerBase *base) {
+  evacStart = front().lowLim();
+  evacStartCP =
+      CompressedPointer(base, reinterpret_cast<GCCell *>(front().lowLim()));
+}
+
+std::shared_ptr<HadesGC::HeapSegment>
+HadesGC::CompacteeState::finishEvacuation(PointerBase *base) {
+  assert(evacActive() && "No compactee is being evacuated");
+  assert(front().lowLim() == evacStart && "Evacuated the wrong segment");
+  std::shared_ptr<HeapSegment> segment = std::move(segments.front().segment);
+  segments.erase(segments.begin());
+  updateStarts(base);
+  if (segments.empty()) {
+    evacStart = reinterpret_cast<void *>(kInvalidCompacteeStart);
+    evacStartCP = CompressedPointer::fromRaw(kInvalidCompacteeStart);
+  } else {
+    startEvacuation(base);
+  }
+  return segment;
+}
+
+void HadesGC::CompacteeState::updateStarts(PointerBase *base) {
+  starts = invalidStarts();
+  startCPs = invalidStarts();
+  filter = 0;
+  filterCP = 0;
+  for (size_t i = 0; i < segments.size(); ++i) {
+    char *const lowLim = segments[i].segment->lowLim();
+    starts[i] = reinterpret_cast<uintptr_t>(lowLim);
+    startCPs[i] =
+        CompressedPointer(base, reinterpret_cast<GCCell *>(lowLim)).getRaw();
+    filter |= filterBit(starts[i]);
+    filterCP |= filterBit(startCPs[i]);
   }
 }
 
@@ -1773,7 +1921,7 @@ void HadesGC::updateOldGenThreshold() {
   const double preAllocated = ogCollectionStats_->beforeAllocatedBytes();
   assert(markedBytes <= preAllocated && "Cannot mark more than was allocated");
   const double postAllocated =
-      oldGen_.allocatedBytes() + compactee_.allocatedBytes;
+      oldGen_.allocatedBytes() + compactee_.allocatedBytes();
   assert(postAllocated >= preAllocated && "Cannot free memory during marking");
 
   // Calculate the number of bytes marked for each byte allocated into the old
@@ -1841,8 +1989,8 @@ void HadesGC::completeMarking() {
   completeWeakMapMarking(*oldGenMarker_);
   // Update the compactee tracking pointers so that the next YG collection will
   // do a compaction.
-  compactee_.evacStart = compactee_.start;
-  compactee_.evacStartCP = compactee_.startCP;
+  if (!compactee_.empty())
+    compactee_.startEvacuation(getPointerBase());
   assert(
       oldGenMarker_->globalWorklist().empty() &&
       "Marking worklist wasn't drained");
@@ -1887,8 +2035,8 @@ void HadesGC::finalizeAllLocked() {
     assert(cell->isValid() && "Invalid cell in finalizeAll");
     cell->getVT()->finalizeIfExists(cell, this);
   };
-  if (compactee_.segment)
-    compactee_.segment->forCompactedObjs(finalizeCallback, getPointerBase());
+  for (const auto &entry : compactee_.segments)
+    entry.segment->forCompactedObjs(finalizeCallback, getPointerBase());
 
   for (HeapSegment &seg : oldGen_)
     seg.forAllObjs(finalizeCallback);
@@ -2165,11 +2313,11 @@ void HadesGC::forAllObjs(const std::function<void(GCCell *)> &callback) {
     else
       seg.forAllObjs(skipGarbageCallback);
   }
-  if (compactee_.segment) {
+  for (const auto &entry : compactee_.segments) {
     if (!compactee_.evacActive())
-      compactee_.segment->forAllObjs(callback);
+      entry.segment->forAllObjs(callback);
     else
-      compactee_.segment->forAllObjs(skipGarbageCallback);
+      entry.segment->forAllObjs(skipGarbageCallback);
   }
 }
 
@@ -2305,16 +2453,31 @@ uint32_t HadesGC::OldGen::getFreelistBucket(uint32_t size) {
     return bucket;
   }
   // Otherwise, index into the large portion of the freelist, which is based on
-  // powers of 2
-
-  auto bucket =
-      kNumSmallFreelistBuckets + llvh::Log2_32(size) - kLogMinSizeForLargeBlock;
+  // powers of 2, each split into equally sized ranges.
+  const uint32_t log = llvh::Log2_32(size);
+  const uint32_t subBucket = (size >> (log - kLogNumLargeFreelistSubBuckets)) &
+      (kNumLargeFreelistSubBuckets - 1);
+  auto bucket = kNumSmallFreelistBuckets +
+      ((log - kLogMinSizeForLargeBlock) << kLogNumLargeFreelistSubBuckets) +
+      subBucket;
   assert(
       bucket < kNumFreelistBuckets &&
       "Block size must be within the freelist range!");
   return bucket;
 }
 
+uint32_t HadesGC::OldGen::getFitFreelistBucket(uint32_t size) {
+  const uint32_t bucket = getFreelistBucket(size);
+  if (size < kMinSizeForLargeBlock)
+    return bucket;
+  // A large bucket holds every size from the start of its range, so it can
+  // only be used if size is exactly the start of the range.
+  const uint32_t log = llvh::Log2_32(size);
+  const uint32_t rangeMask =
+      (uint32_t{1} << (log - kLogNumLargeFreelistSubBuckets)) - 1;
+  return (size & rangeMask) ? bucket + 1 : bucket;
+}
+
 GCCell *HadesGC::OldGen::search(uint32_t sz) {
   size_t bucket = getFreelistBucket(sz);
   if (bucket < kNumSmallFreelistBuckets) {
@@ -2334,10 +2497,36 @@ GCCell *HadesGC::OldGen::search(uint32_t sz) {
     // Make sure we start searching at the smallest possible size that could fit
     bucket = getFreelistBucket(sz + minAllocationSize());
   }
-  // Once we're examining the rest of the free list, it's a first-fit algorithm.
-  // This approach approximates finding the smallest possible fit.
+  // Segregated fit: every cell in the buckets from fitBucket onwards can be
+  // split to make room for sz, so the first cell of the first non-empty one is
+  // taken without looking at any other cells.
+  const size_t fitBucket = getFitFreelistBucket(sz + minAllocationSize());
+  const size_t splitBucket =
+      freelistBucketBitArray_.findNextSetBitFrom(fitBucket);
+  if (splitBucket < kNumFreelistBuckets) {
+    const size_t segmentIdx =
+        freelistBucketSegmentBitArray_[splitBucket].find_first();
+    auto *cell = vmcast<FreelistCell>(
+        freelistSegmentsBuckets_[segmentIdx][splitBucket].getNonNull(
+            gc_->getPointerBase()));
+    assert(
+        cell->getAllocatedSize() >= sz + minAllocationSize() &&
+        "Cell in a fitting bucket is too small");
+    auto newCell = cell->carve(sz);
+    // Since the size of cell has changed, we may need to add it to a different
+    // free list bucket.
+    if (getFreelistBucket(cell->getAllocatedSize()) != splitBucket) {
+      removeCellFromFreelist(splitBucket, segmentIdx);
+      addCellToFreelist(cell, segmentIdx);
+    }
+    __asan_unpoison_memory_region(newCell, sz);
+    return finishAlloc(newCell, sz, segmentIdx);
+  }
+  // Otherwise, the only cells left that may fit are in the buckets between
+  // bucket and fitBucket, which also hold cells that are too small. Use
+  // first-fit on those, which approximates finding the smallest possible fit.
   bucket = freelistBucketBitArray_.findNextSetBitFrom(bucket);
-  for (; bucket < kNumFreelistBuckets;
+  for (; bucket < fitBucket;
        bucket = freelistBucketBitArray_.findNextSetBitFrom(bucket + 1)) {
     for (size_t segmentIdx : freelistBucketSegmentBitArray_[bucket]) {
       assert(
@@ -2472,10 +2661,12 @@ void HadesGC::youngGenCollection(
         heapBytes.before, externalBytes.before, segmentFootprint());
     ygCollectionStats_->addCollectionType("promotion");
     assert(!doCompaction && "Cannot do compactions during YG promotions.");
+    // Every sampled object was promoted, which says nothing about its site.
+    getAllocationSiteTracker().clearSamples();
   } else {
     auto &yg = youngGen();
 
-    if (compactee_.segment) {
+    if (!compactee_.empty()) {
       EvacAcceptor<true> acceptor{*this};
       youngGenEvacuateImpl(acceptor, doCompaction);
       // The remaining bytes after the collection is just the number of bytes
@@ -2491,6 +2682,13 @@ void HadesGC::youngGenCollection(
       // Now that all YG objects have been marked, update weak references.
       updateWeakReferencesForYoungGen();
     }
+    // Evacuated objects have a forwarding pointer until the YG is reset, so
+    // this is the last point at which the sampled allocations can be checked.
+    ygCollectionStats_->setPretenuredSites(
+        getAllocationSiteTracker().updateSurvival(
+            [this](GCCell *cell) {
+              return inYoungGen(cell) && cell->hasMarkedForwardingPointer();
+            }));
     // Inform trackers about objects that died during this YG collection.
     if (isTrackingIDs()) {
       auto trackerCallback = [this](GCCell *cell) {
@@ -2503,7 +2701,7 @@ void HadesGC::youngGenCollection(
       };
       yg.forCompactedObjs(trackerCallback, getPointerBase());
       if (doCompaction) {
-        compactee_.segment->forCompactedObjs(trackerCallback, getPointerBase());
+        compactee_.front().forCompactedObjs(trackerCallback, getPointerBase());
       }
     }
     // Run finalizers for young gen objects.
@@ -2521,10 +2719,10 @@ void HadesGC::youngGenCollection(
 
     if (doCompaction) {
       ygCollectionStats_->addCollectionType("compact");
-      heapBytes.before += compactee_.allocatedBytes;
+      heapBytes.before += compactee_.segments.front().allocatedBytes;
       uint64_t ogExternalBefore = oldGen_.externalBytes();
       // Run finalisers on compacted objects.
-      compactee_.segment->forCompactedObjs(
+      compactee_.front().forCompactedObjs(
           [this](GCCell *cell) { cell->getVT()->finalizeIfExists(cell, this); },
           getPointerBase());
       const uint64_t externalCompactedBytes =
@@ -2535,12 +2733,16 @@ void HadesGC::youngGenCollection(
       externalBytes.after += externalCompactedBytes;
 
       const size_t segIdx =
-          SegmentInfo::segmentIndexFromStart(compactee_.segment->lowLim());
+          SegmentInfo::segmentIndexFromStart(compactee_.front().lowLim());
       segmentIndices_.push_back(segIdx);
       removeSegmentExtentFromCrashManager(std::to_string(segIdx));
-      removeSegmentExtentFromCrashManager(kCompacteeNameForCrashMgr);
+      removeSegmentExtentFromCrashManager(
+          std::string(kCompacteeNameForCrashMgr) + std::to_string(segIdx));
 
-      compactee_ = {};
+      // Free the segment, unless sweeping still needs it, and move on to the
+      // next compactee, which the next YG collection will evacuate.
+      compactee_.finishEvacuation(getPointerBase());
+      ++numCompactedSegments_;
     }
 
     // Move external memory accounting from YG to OG as well.
@@ -2715,7 +2917,8 @@ void HadesGC::updateYoungGenSizeFactor() {
 template <bool CompactionEnabled>
 void HadesGC::scanDirtyCardsForSegment(
     SlotVisitor<EvacAcceptor<CompactionEnabled>> &visitor,
-    HeapSegment &seg) {
+    HeapSegment &seg,
+    bool visitUnmarked) {
   const auto &cardTable = seg.cardTable();
   // Use level instead of end in case the OG segment is still in bump alloc
   // mode.
@@ -2723,13 +2926,6 @@ void HadesGC::scanDirtyCardsForSegment(
   size_t from = cardTable.addressToIndex(seg.start());
   const size_t to = cardTable.addressToIndex(origSegLevel - 1) + 1;
 
-  // If a compaction is taking place during sweeping, we may scan cards that
-  // contain dead objects which in turn point to dead objects in the compactee.
-  // In order to avoid promoting these dead objects, we should skip unmarked
-  // objects altogether when compaction and sweeping happen at the same time.
-  const bool visitUnmarked =
-      !CompactionEnabled || concurrentPhase_ != Phase::Sweep;
-
   while (const auto oiBegin = cardTable.findNextDirtyCard(from, to)) {
     const auto iBegin = *oiBegin;
 
@@ -2797,6 +2993,17 @@ void HadesGC::scanDirtyCards(EvacAcceptor<CompactionEnabled> &acceptor) {
   SlotVisitor<EvacAcceptor<CompactionEnabled>> visitor{acceptor};
   const bool preparingCompaction =
       CompactionEnabled && !compactee_.evacActive();
+  // Cards also record pointers into the compactees that are evacuated by
+  // later YG collections, so they can only be cleared once this collection
+  // evacuates the last one.
+  const bool keepCards = preparingCompaction ||
+      (CompactionEnabled && compactee_.segments.size() > 1);
+  // If a compaction is taking place during sweeping, we may scan cards that
+  // contain dead objects which in turn point to dead objects in the compactee.
+  // In order to avoid promoting these dead objects, we should skip unmarked
+  // objects altogether when compaction and sweeping happen at the same time.
+  const bool visitUnmarked =
+      !CompactionEnabled || concurrentPhase_ != Phase::Sweep;
   // The acceptors in this loop can grow the old gen by adding another
   // segment, if there's not enough room to evac the YG objects discovered.
   // Since segments are always placed at the end, we can use indices instead
@@ -2808,18 +3015,26 @@ void HadesGC::scanDirtyCards(EvacAcceptor<CompactionEnabled> &acceptor) {
     // It is safe to hold this reference across a push_back into
     // oldGen_.segments_ since references into a deque are not invalidated.
     HeapSegment &seg = oldGen_[i];
-    scanDirtyCardsForSegment(visitor, seg);
+    scanDirtyCardsForSegment(visitor, seg, visitUnmarked);
     // Do not clear the card table if the OG thread is currently marking to
-    // prepare for a compaction. Note that we should clear the card tables if
-    // the compaction is currently ongoing.
-    if (!preparingCompaction)
+    // prepare for a compaction, or if there are compactees left to evacuate
+    // after this collection. Note that we should clear the card tables if the
+    // last compaction is currently ongoing.
+    if (!keepCards)
       seg.cardTable().clear();
   }
 
+  if (!CompactionEnabled)
+    return;
   // No need to search dirty cards in the compactee segment if it is
-  // currently being evacuated, since it will be scanned fully.
-  if (preparingCompaction)
-    scanDirtyCardsForSegment(visitor, *compactee_.segment);
+  // currently being evacuated, since it will be scanned fully. The others
+  // are never swept, so once marking is complete their dead objects may point
+  // to freed memory and must be skipped.
+  for (const auto &entry : compactee_.segments) {
+    HeapSegment &seg = *entry.segment;
+    if (!compactee_.evacContains(seg.lowLim()))
+      scanDirtyCardsForSegment(visitor, seg, preparingCompaction);
+  }
 }
 
 void HadesGC::finalizeYoungGenObjects() {
@@ -2918,9 +3133,6 @@ void HadesGC::completeWeakMapMarking(MarkAcceptor &acceptor) {
           return false;
         }
         acceptor.accept(valRef);
-        // The weak ref lock is held throughout this entire section, so no need
-        // to re-lock it.
-        acceptor.drainAllWork();
         return true;
       },
       /*drainMarkStack*/
@@ -428,7 +428,6 @@ void MallocGC::completeWeakMapMarking(MarkingAcceptor &acceptor) {
           return false;
         }
         acceptor.accept(valRef);
-        drainMarkStack(acceptor);
         return true;
       },
       /*drainMarkStack*/
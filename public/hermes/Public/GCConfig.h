@@ -190,6 +190,10 @@ enum class GCEventKind {
   /* Whether to use mprotect on GC metadata between GCs. */               \
   F(constexpr, bool, ProtectMetadata, false)                              \
                                                                           \
+  /* Whether allocation sites whose objects usually survive young gen */  \
+  /* collections should allocate directly in the old gen. */              \
+  F(constexpr, bool, AllocationSitePretenuring, true)                     \
+                                                                          \
   /* Callout for an analytics event. */                                   \
   F(HERMES_NON_CONSTEXPR,                                                 \
     std::function<void(const GCAnalyticsEvent &)>,                        \
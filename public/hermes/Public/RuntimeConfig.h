@@ -108,6 +108,16 @@ class PinnedHermesValue;
   /* Choose whether generators are enabled. */                         \
   F(constexpr, bool, EnableGenerator, true)                            \
                                                                        \
+  /* Number of properties after which an object's hidden class */      \
+  /* switches to dictionary mode. */                                   \
+  F(constexpr, unsigned, DictionaryThreshold, 64)                      \
+                                                                       \
+  /* Number of uncached property accesses to an object in */           \
+  /* non-cacheable dictionary mode, without any change to its */       \
+  /* properties, after which it is given a shared class again. */      \
+  /* 0 disables re-shaping. */                                         \
+  F(constexpr, unsigned, DictionaryReshapeThreshold, 8)                \
+                                                                       \
   /* An interface for managing crashes. */                             \
   F(HERMES_NON_CONSTEXPR,                                              \
     std::shared_ptr<CrashManager>,                                     \
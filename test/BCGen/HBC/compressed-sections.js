@@ -0,0 +1,37 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O -emit-binary -compress-sections -target=HBC -out=%t.hbc %s && %hermes %t.hbc | %FileCheck --match-full-lines %s
+// RUN: %hbcdump %t.hbc -show-section-compression | %FileCheck --match-full-lines --check-prefix=DUMP %s
+
+var obj = {a: 1, b: "two", c: [3, 4, 5], d: null};
+print(JSON.stringify(obj));
+// CHECK: {"a":1,"b":"two","c":[3,4,5],"d":null}
+
+var arr = ["repeated string", "repeated string", "another string", 1.5];
+print(arr.join(","));
+// CHECK-NEXT: repeated string,repeated string,another string,1.5
+
+function thrower() {
+  throw new Error("boom");
+}
+try {
+  thrower();
+} catch (e) {
+  // Reading the stack needs the compressed debug info.
+  print(e.stack.split("\n")[1]);
+}
+// CHECK-NEXT:     at thrower ({{.*}}compressed-sections.js:20:{{[0-9]+}})
+
+// DUMP: Load time: {{[0-9]+}}us
+// DUMP-NEXT: Section compression:
+// DUMP-NEXT:   String storage: stored {{[0-9]+}} bytes, raw {{[0-9]+}} bytes ({{.*}}), 1 blocks, decompressed in {{[0-9]+}}us
+// DUMP-NEXT:   Array buffer: stored {{.*}}
+// DUMP-NEXT:   Object key buffer: stored {{.*}}
+// DUMP-NEXT:   Object value buffer: stored {{.*}}
+// DUMP-NEXT:   Debug info: stored {{.*}}
+// DUMP-NEXT:   Total: stored {{[0-9]+}} bytes, raw {{[0-9]+}} bytes
@@ -0,0 +1,40 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -commonjs -fstatic-require -fstatic-builtins -dump-ir %s %S/m3.js -O | %FileCheck --match-full-lines %s
+// RUN: %hermes -commonjs -fstatic-require -fstatic-builtins -O %s %S/m3.js | %FileCheck --match-full-lines --check-prefix=EXEC %s
+
+// Small functions exported from another module are inlined after the require
+// has been resolved statically, unless the export may have been reassigned.
+
+var m3 = require('./m3.js');
+
+exports.useAdd = function(x) {
+  return m3.add(x, 1);
+};
+
+print(exports.useAdd(41));
+print(m3.reassigned());
+print(m3.late());
+
+// CHECK-LABEL:function cjs_module(exports, require, module) : undefined
+// CHECK:  %9 = LoadPropertyInst %0, "reassigned" : string
+// CHECK-NEXT:  %10 = CallInst %9, %0
+// CHECK:  %13 = LoadPropertyInst %0, "late" : string
+// CHECK-NEXT:  %14 = CallInst %13, %0
+
+// CHECK-LABEL:function ""(x) : string|number
+// CHECK-NEXT:frame = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = BinaryOperatorInst '+', %x, 1 : number
+// CHECK-NEXT:  %1 = ReturnInst %0 : string|number
+// CHECK-NEXT:function_end
+
+// EXEC: m3: init
+// EXEC-NEXT: 42
+// EXEC-NEXT: 2
+// EXEC-NEXT: 3
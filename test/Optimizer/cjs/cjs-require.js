@@ -18,26 +18,30 @@ function bar() {
 
 exports.bar = bar;
 
-//CHKOPT-LABEL:Function<cjs_module>(4 params, 10 registers, 0 symbols):
+//CHKOPT-LABEL:Function<cjs_module>(4 params, 11 registers, 0 symbols):
 //CHKOPT-NEXT:Offset in debug table: {{.*}}
-//CHKOPT-NEXT:    LoadConstUInt8    r2, 1
-//CHKOPT-NEXT:    CallBuiltin       r1, "HermesBuiltin.requireFast", 2
-//CHKOPT-NEXT:    GetByIdShort      r0, r1, 1, "foo"
-//CHKOPT-NEXT:    Call1             r0, r0, r1
-//CHKOPT-NEXT:    CreateEnvironment r0
-//CHKOPT-NEXT:    CreateClosure     r1, r0, 2
-//CHKOPT-NEXT:    LoadParam         r0, 1
-//CHKOPT-NEXT:    PutById           r0, r1, 1, "bar"
+//CHKOPT-NEXT:    LoadConstUInt8    r3, 1
+//CHKOPT-NEXT:    CallBuiltin       r0, "HermesBuiltin.requireFast", 2
+//CHKOPT-NEXT:    GetGlobalObject   r0
+//CHKOPT-NEXT:    TryGetById        r2, r0, 1, "print"
 //CHKOPT-NEXT:    LoadConstUndefined r0
+//CHKOPT-NEXT:    LoadConstString   r1, "foo"
+//CHKOPT-NEXT:    Call2             r1, r2, r0, r1
+//CHKOPT-NEXT:    CreateEnvironment r1
+//CHKOPT-NEXT:    CreateClosure     r2, r1, 2
+//CHKOPT-NEXT:    LoadParam         r1, 1
+//CHKOPT-NEXT:    PutById           r1, r2, 1, "bar"
 //CHKOPT-NEXT:    Ret               r0
 
-//CHKOPT-LABEL:Function<bar>(1 params, 10 registers, 0 symbols):
+//CHKOPT-LABEL:Function<bar>(1 params, 11 registers, 0 symbols):
 //CHKOPT-NEXT:Offset in debug table: {{.*}}
-//CHKOPT-NEXT:    LoadConstUInt8    r2, 2
-//CHKOPT-NEXT:    CallBuiltin       r1, "HermesBuiltin.requireFast", 2
-//CHKOPT-NEXT:    GetByIdShort      r0, r1, 1, "baz"
-//CHKOPT-NEXT:    Call1             r0, r0, r1
+//CHKOPT-NEXT:    LoadConstUInt8    r3, 2
+//CHKOPT-NEXT:    CallBuiltin       r0, "HermesBuiltin.requireFast", 2
+//CHKOPT-NEXT:    GetGlobalObject   r0
+//CHKOPT-NEXT:    TryGetById        r2, r0, 1, "print"
 //CHKOPT-NEXT:    LoadConstUndefined r0
+//CHKOPT-NEXT:    LoadConstString   r1, "baz"
+//CHKOPT-NEXT:    Call2             r1, r2, r0, r1
 //CHKOPT-NEXT:    Ret               r0
 
 //CHKDBG-LABEL: Function<cjs_module>(4 params, 21 registers, 5 symbols):
@@ -0,0 +1,26 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: true
+
+exports.add = function(a, b) {
+  return a + b;
+};
+
+exports.reassigned = function() {
+  return 1;
+};
+
+print('m3: init');
+
+exports.reassigned = function() {
+  return 2;
+};
+
+exports.late = function() {
+  return 3;
+};
@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -dump-ir %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O %s | %FileCheck --match-full-lines --check-prefix=EXEC %s
+
+function arrayLoop(arr, a, b) {
+  var x = a | 0, y = b | 0;
+  var sum = 0;
+  for (var i = 0; i < arr.length; i++) {
+    sum += arr[i] * (x * y + 1);
+  }
+  return sum;
+}
+
+function capturedLoop(k) {
+  var scale = k | 0;
+  return function(n) {
+    var s = 0;
+    for (var i = 0; i < 100; i++)
+      s += scale;
+    return s;
+  };
+}
+
+function mergedEntry(c, a) {
+  var x = a | 0;
+  var i = 0;
+  if (c) i = 1;
+  while (i < 10) {
+    i += x * 2;
+  }
+  return i;
+}
+
+function clobberedLoop(k) {
+  var scale = k | 0;
+  function bump() {
+    scale++;
+  }
+  return function() {
+    var s = 0;
+    for (var i = 0; i < 3; i++) {
+      s += scale;
+      bump();
+    }
+    return s;
+  };
+}
+
+print(arrayLoop([1, 2, 3], 2, 3), capturedLoop(2)(), mergedEntry(true, 3));
+print(clobberedLoop(1)());
+// EXEC: 42 200 13
+// EXEC-NEXT: 6
+
+// CHECK-LABEL:function arrayLoop(arr, a, b) : string|number
+// CHECK-NEXT:frame = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = AsInt32Inst %a
+// CHECK-NEXT:  %1 = AsInt32Inst %b
+// CHECK-NEXT:  %2 = LoadPropertyInst %arr, "length" : string
+// CHECK-NEXT:  %3 = BinaryOperatorInst '<', 0 : number, %2
+// CHECK-NEXT:  %4 = CondBranchInst %3 : boolean, %BB1, %BB2
+// CHECK-NEXT:%BB1:
+// CHECK-NEXT:  %5 = BinaryOperatorInst '*', %0 : number, %1 : number
+// CHECK-NEXT:  %6 = BinaryOperatorInst '+', %5 : number, 1 : number
+// CHECK-NEXT:  %7 = BranchInst %BB3
+// CHECK-NEXT:%BB3:
+// CHECK-NEXT:  %8 = PhiInst 0 : number, %BB1, %12 : string|number, %BB3
+// CHECK-NEXT:  %9 = PhiInst 0 : number, %BB1, %13 : number, %BB3
+// CHECK-NEXT:  %10 = LoadPropertyInst %arr, %9 : number
+// CHECK-NEXT:  %11 = BinaryOperatorInst '*', %10, %6 : number
+// CHECK-NEXT:  %12 = BinaryOperatorInst '+', %8 : string|number, %11 : number
+// CHECK-NEXT:  %13 = BinaryOperatorInst '+', %9 : number, 1 : number
+// CHECK-NEXT:  %14 = LoadPropertyInst %arr, "length" : string
+// CHECK-NEXT:  %15 = BinaryOperatorInst '<', %13 : number, %14
+// CHECK-NEXT:  %16 = CondBranchInst %15 : boolean, %BB3, %BB2
+// CHECK-NEXT:%BB2:
+// CHECK-NEXT:  %17 = PhiInst 0 : number, %BB0, %12 : string|number, %BB3
+// CHECK-NEXT:  %18 = ReturnInst %17 : string|number
+// CHECK-NEXT:function_end
+
+// CHECK-LABEL:function ""(n) : string|number
+// CHECK-NEXT:frame = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = LoadFrameInst [scale@capturedLoop] : number
+// CHECK-NEXT:  %1 = BranchInst %BB1
+// CHECK-NEXT:%BB1:
+// CHECK-NEXT:  %2 = PhiInst 0 : number, %BB0, %4 : string|number, %BB1
+// CHECK-NEXT:  %3 = PhiInst 0 : number, %BB0, %5 : number, %BB1
+// CHECK-NEXT:  %4 = BinaryOperatorInst '+', %2 : string|number, %0 : number
+// CHECK-NEXT:  %5 = BinaryOperatorInst '+', %3 : number, 1 : number
+// CHECK-NEXT:  %6 = BinaryOperatorInst '<', %5 : number, 100 : number
+// CHECK-NEXT:  %7 = CondBranchInst %6 : boolean, %BB1, %BB2
+// CHECK-NEXT:%BB2:
+// CHECK-NEXT:  %8 = ReturnInst %4 : string|number
+// CHECK-NEXT:function_end
+
+// CHECK-LABEL:function mergedEntry(c, a) : string|number
+// CHECK-NEXT:frame = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = AsInt32Inst %a
+// CHECK-NEXT:  %1 = CondBranchInst %c, %BB1, %BB2
+// CHECK-NEXT:%BB1:
+// CHECK-NEXT:  %2 = BranchInst %BB2
+// CHECK-NEXT:%BB3:
+// CHECK-NEXT:  %3 = BinaryOperatorInst '*', %0 : number, 2 : number
+// CHECK-NEXT:  %4 = BranchInst %BB4
+// CHECK-NEXT:%BB4:
+// CHECK-NEXT:  %5 = PhiInst %11 : number, %BB3, %6 : string|number, %BB4
+// CHECK-NEXT:  %6 = BinaryOperatorInst '+', %5 : string|number, %3 : number
+// CHECK-NEXT:  %7 = BinaryOperatorInst '<', %6 : string|number, 10 : number
+// CHECK-NEXT:  %8 = CondBranchInst %7 : boolean, %BB4, %BB5
+// CHECK-NEXT:%BB5:
+// CHECK-NEXT:  %9 = PhiInst %11 : number, %BB2, %6 : string|number, %BB4
+// CHECK-NEXT:  %10 = ReturnInst %9 : string|number
+// CHECK-NEXT:%BB2:
+// CHECK-NEXT:  %11 = PhiInst 1 : number, %BB1, 0 : number, %BB0
+// CHECK-NEXT:  %12 = BinaryOperatorInst '<', %11 : number, 10 : number
+// CHECK-NEXT:  %13 = CondBranchInst %12 : boolean, %BB3, %BB5
+// CHECK-NEXT:function_end
+
+// CHECK-LABEL:function " 1#"() : string|number
+// CHECK-NEXT:frame = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = BranchInst %BB1
+// CHECK-NEXT:%BB1:
+// CHECK-NEXT:  %1 = PhiInst 0 : number, %BB0, %4 : string|number, %BB1
+// CHECK-NEXT:  %2 = PhiInst 0 : number, %BB0, %7 : number, %BB1
+// CHECK-NEXT:  %3 = LoadFrameInst [scale@clobberedLoop] : undefined|number
+// CHECK-NEXT:  %4 = BinaryOperatorInst '+', %1 : string|number, %3 : undefined|number
+// CHECK-NEXT:  %5 = LoadFrameInst [bump@clobberedLoop] : closure
+// CHECK-NEXT:  %6 = CallInst %5 : closure, undefined : undefined
+// CHECK-NEXT:  %7 = BinaryOperatorInst '+', %2 : number, 1 : number
+// CHECK-NEXT:  %8 = BinaryOperatorInst '<', %7 : number, 3 : number
+// CHECK-NEXT:  %9 = CondBranchInst %8 : boolean, %BB1, %BB2
+// CHECK-NEXT:%BB2:
+// CHECK-NEXT:  %10 = ReturnInst %4 : string|number
+// CHECK-NEXT:function_end
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermesc -O -dump-ir %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O %s | %FileCheck --match-full-lines --check-prefix=EXEC %s
+
+function literal(a, b) {
+  var p = {x: a, y: b};
+  return p.x + p.y;
+}
+
+function inlinedPoint(a, b) {
+  function point(x, y) {
+    return {x: x, y: y};
+  }
+  var p = point(a, b);
+  p.x = p.x * 2;
+  return p.x * p.y;
+}
+
+function conditionalStore(a, c) {
+  var o = {x: a, x: 2};
+  if (c) o.x = 3;
+  return o.x;
+}
+
+function escapes(a) {
+  var o = {x: a};
+  sink(o);
+  return o.x;
+}
+
+function readsPrototype(a) {
+  var o = {x: a};
+  return o.toString;
+}
+
+function addsProperty(a) {
+  var o = {x: a};
+  o.y = 1;
+  return o.y;
+}
+
+function sink() {}
+
+print(literal(1, 2), inlinedPoint(3, 4), conditionalStore(1, true));
+print(escapes(5), typeof readsPrototype(6), addsProperty(7));
+// EXEC: 3 24 3
+// EXEC-NEXT: 5 function 1
+
+// CHECK-LABEL:function literal(a, b) : string|number
+// CHECK-NEXT:frame = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = BinaryOperatorInst '+', %a, %b
+// CHECK-NEXT:  %1 = ReturnInst %0 : string|number
+// CHECK-NEXT:function_end
+
+// CHECK-LABEL:function inlinedPoint(a, b) : number
+// CHECK-NEXT:frame = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = BinaryOperatorInst '*', %a, 2 : number
+// CHECK-NEXT:  %1 = BinaryOperatorInst '*', %0 : number, %b
+// CHECK-NEXT:  %2 = ReturnInst %1 : number
+// CHECK-NEXT:function_end
+
+// CHECK-LABEL:function conditionalStore(a, c) : number
+// CHECK-NEXT:frame = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = CondBranchInst %c, %BB1, %BB2
+// CHECK-NEXT:%BB1:
+// CHECK-NEXT:  %1 = BranchInst %BB2
+// CHECK-NEXT:%BB2:
+// CHECK-NEXT:  %2 = PhiInst 3 : number, %BB1, 2 : number, %BB0
+// CHECK-NEXT:  %3 = ReturnInst %2 : number
+// CHECK-NEXT:function_end
+
+// CHECK-LABEL:function escapes(a)
+// CHECK-NEXT:frame = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = AllocObjectLiteralInst "x" : string, %a
+// CHECK:function_end
+
+// CHECK-LABEL:function readsPrototype(a)
+// CHECK-NEXT:frame = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = AllocObjectLiteralInst "x" : string, %a
+// CHECK-NEXT:  %1 = LoadPropertyInst %0 : object, "toString" : string
+// CHECK:function_end
+
+// CHECK-LABEL:function addsProperty(a)
+// CHECK-NEXT:frame = []
+// CHECK-NEXT:%BB0:
+// CHECK-NEXT:  %0 = AllocObjectLiteralInst "x" : string, %a
+// CHECK-NEXT:  %1 = StorePropertyInst 1 : number, %0 : object, "y" : string
+// CHECK:function_end
@@ -13,5 +13,5 @@
 
 async function empty() {};
 print(empty())
-// ON: [object Object]
+// ON: [object Promise]
 // OFF: Uncaught TypeError: Cannot execute a bytecode having async functions when Promise is disabled.
@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -Xdictionary-reshape-threshold=1 %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -Xdictionary-reshape-threshold=0 -Xdictionary-threshold=8 %s | %FileCheck --match-full-lines %s
+
+// Objects leave dictionary mode when their last property is deleted, or when
+// they are re-shaped after they stop changing. Check that their properties,
+// values and order are preserved.
+
+print('dictionary-reshape');
+// CHECK-LABEL: dictionary-reshape
+
+var o = {a: 1, b: 2, c: 3};
+delete o.c;
+print(JSON.stringify(o));
+// CHECK-NEXT: {"a":1,"b":2}
+o.c = 4;
+o.d = 5;
+print(JSON.stringify(o));
+// CHECK-NEXT: {"a":1,"b":2,"c":4,"d":5}
+delete o.d;
+delete o.c;
+delete o.b;
+o.x = 6;
+print(JSON.stringify(o));
+// CHECK-NEXT: {"a":1,"x":6}
+
+function readXY(obj) {
+  return obj.p3 + ',' + obj.p7;
+}
+function writeP4(obj, v) {
+  obj.p4 = v;
+}
+
+function test(n) {
+  var m = {};
+  for (var i = 0; i < n; i++) {
+    m['p' + i] = i;
+  }
+  // Turn m into a dictionary that can't be cached.
+  delete m.p0;
+  delete m.p2;
+  delete m.p5;
+  m.q = 'q';
+  Object.defineProperty(m, 'acc', {
+    get: function() {
+      return this.p3 * 10;
+    },
+    configurable: true,
+    enumerable: true,
+  });
+  Object.defineProperty(m, 'ro', {value: 'ro', enumerable: true});
+
+  var res;
+  for (var i = 0; i < 20; i++) {
+    res = readXY(m);
+    writeP4(m, i);
+  }
+  m.ro = 'changed';
+  print(n, res, m.p4, m.acc, m.ro, Object.keys(m).join());
+
+  delete m.p1;
+  m.z = 'z';
+  for (var i = 0; i < 20; i++) {
+    res = readXY(m);
+  }
+  print(res, m.p1, JSON.stringify(Object.getOwnPropertyDescriptor(m, 'ro')));
+  print(Object.keys(m).join());
+}
+
+test(8);
+// CHECK-NEXT: 8 3,7 19 30 ro p1,p3,p4,p6,p7,q,acc,ro
+// CHECK-NEXT: 3,7 undefined {"value":"ro","writable":false,"enumerable":true,"configurable":false}
+// CHECK-NEXT: p3,p4,p6,p7,q,acc,ro,z
+test(12);
+// CHECK-NEXT: 12 3,7 19 30 ro p1,p3,p4,p6,p7,p8,p9,p10,p11,q,acc,ro
+// CHECK-NEXT: 3,7 undefined {"value":"ro","writable":false,"enumerable":true,"configurable":false}
+// CHECK-NEXT: p3,p4,p6,p7,p8,p9,p10,p11,q,acc,ro,z
+
+// Objects with reserved slots.
+var a = [1, 2, 3];
+a.x = 1;
+a.y = 2;
+a.z = 3;
+delete a.x;
+delete a.y;
+for (var i = 0; i < 20; i++) {
+  readXY(a);
+}
+a.push(4);
+print(a.length, a.z, a.join());
+// CHECK-NEXT: 4 3 1,2,3,4
+
+var e = new Error('msg');
+e.x = 1;
+e.y = 2;
+delete e.x;
+delete e.message;
+for (var i = 0; i < 20; i++) {
+  readXY(e);
+}
+print(e.y, e.message, typeof e.stack);
+// CHECK-NEXT: 2  string
@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -non-strict -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -non-strict -O0 %s | %FileCheck --match-full-lines %s
+
+// Global accesses are cached. Check that the caches observe deletion and
+// redefinition of the globals they refer to.
+
+var counter = 0;
+function read() {
+  return 'cell' in globalThis ? cell : 'missing';
+}
+function write(v) {
+  cell = v;
+}
+
+globalThis.cell = 1;
+for (var i = 0; i < 3; ++i) {
+  write(i);
+  read();
+}
+print(read());
+// CHECK: 2
+
+delete globalThis.cell;
+print(read());
+// CHECK-NEXT: missing
+
+Object.defineProperty(globalThis, 'cell', {
+  get: function() {
+    return 'getter ' + ++counter;
+  },
+  set: function(v) {
+    print('setter', v);
+  },
+  configurable: true,
+});
+print(read(), read());
+// CHECK-NEXT: getter 1 getter 2
+write(10);
+// CHECK-NEXT: setter 10
+
+Object.defineProperty(globalThis, 'cell', {
+  value: 'data',
+  writable: false,
+  configurable: true,
+});
+write(11);
+print(read());
+// CHECK-NEXT: data
+
+Object.defineProperty(globalThis, 'cell', {writable: true});
+write(12);
+print(read());
+// CHECK-NEXT: 12
+
+// Redefining a builtin global is seen by cached reads of it.
+function abs(x) {
+  return Math.abs(x);
+}
+print(abs(-1));
+// CHECK-NEXT: 1
+var realMath = Math;
+Math = {abs: function() { return 'patched'; }};
+print(abs(-1));
+// CHECK-NEXT: patched
+delete globalThis.Math;
+try {
+  abs(-1);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: ReferenceError
+globalThis.Math = realMath;
+print(abs(-3));
+// CHECK-NEXT: 3
+
+// Freezing the global object makes cached writes fail.
+var frozen = 1;
+function writeFrozen(v) {
+  'use strict';
+  frozen = v;
+}
+writeFrozen(2);
+Object.freeze(globalThis);
+try {
+  writeFrozen(3);
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+print(frozen);
+// CHECK-NEXT: 2
@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O0 %s 2>&1 | %FileCheck --match-full-lines %s
+// RUN: %hermes -lazy -O0 %s 2>&1 | %FileCheck --match-full-lines %s
+
+// Function bodies are skipped during preparsing by matching brackets, so
+// braces inside regexps, strings, templates and comments must not confuse
+// it, and neither must '/' used as division.
+
+function regexps() {
+  var re1 = /}/;
+  var re2 = /[}{)(]/g;
+  if (re1.test("}")) /}/.test("x");
+  var x = [/]/][0];
+  return re1.source + re2.source + x.source;
+}
+print(regexps());
+// CHECK: }[}{)(]]
+
+function divisions(a, b) {
+  var c = (a + b) / 2 / 1;
+  var d = a++ / 2;
+  var arr = [4];
+  var e = arr[0] / 2;
+  c /= 1;
+  return c + d + e + this / 1;
+}
+print(divisions.call(6, 4, 2));
+// CHECK: 13
+
+function strings() {
+  // A comment with a } brace.
+  /* And { another } one. */
+  var s = "}" + '{' + "\"}";
+  return s;
+}
+print(strings());
+// CHECK: }{"}
+
+function templates(a) {
+  var t = `}${a + `{${`}`}`}{`;
+  var o = {a: {b: `${{}}`}};
+  return t + o.a.b + `${(() => { return "}"; })()}`;
+}
+print(templates(1));
+// CHECK: }1{}{[object Object]}
+
+function nested() {
+  "use strict";
+  function inner() {
+    return this;
+  }
+  var obj = {
+    method() {
+      return "m}";
+    },
+    get g() {
+      return "g{";
+    },
+  };
+  var arrow = () => {
+    return "a}";
+  };
+  return inner() + obj.method() + obj.g + arrow();
+}
+print(nested());
+// CHECK: undefinedm}g{a}
+
+function ambiguous() {
+  {
+  }
+  /x/g.test("x") ? print("regexp") : print("div");
+  var v = {} / 2;
+  return v;
+}
+print(ambiguous());
+// CHECK-NEXT: regexp
+// CHECK-NEXT: NaN
+
+function* gen() {
+  var yield_ = yield /x/;
+  return yield_;
+}
+print(gen().next().value.source);
+// CHECK-NEXT: x
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -Xdictionary-threshold=8 %s | %FileCheck --match-full-lines %s
+
+// Objects are allocated with room for as many properties as their allocation
+// site produced before. Check that objects with fewer or more properties than
+// that are still correct.
+
+print('object-slack');
+// CHECK-LABEL: object-slack
+
+function Point(n) {
+  for (var i = 0; i < n; i++) {
+    this['p' + i] = i;
+  }
+}
+
+function describe(o) {
+  var keys = Object.keys(o);
+  var sum = 0;
+  for (var i = 0; i < keys.length; i++) {
+    sum += o[keys[i]];
+  }
+  return keys.length + ' ' + sum;
+}
+
+print(describe(new Point(12)));
+// CHECK-NEXT: 12 66
+print(describe(new Point(3)));
+// CHECK-NEXT: 3 3
+var big = new Point(20);
+gc();
+print(describe(big));
+// CHECK-NEXT: 20 190
+var small = new Point(2);
+small.x = 10;
+print(describe(small));
+// CHECK-NEXT: 3 11
+print(describe(Reflect.construct(Point, [7])));
+// CHECK-NEXT: 7 21
+var Bound = Point.bind(null, 9);
+print(describe(new Bound()));
+// CHECK-NEXT: 9 36
+
+function Other() {
+  this.a = 1;
+  return {b: 2};
+}
+print(JSON.stringify(new Other()), JSON.stringify(new Other()));
+// CHECK-NEXT: {"b":2} {"b":2}
+
+function literal(x) {
+  return {a: x, b: 1, c: 2, d: 3, e: 4, f: 5, g: x, h: x, i: 6, j: x};
+}
+var lit = literal(7);
+delete lit.b;
+lit.z = 8;
+print(JSON.stringify(lit));
+// CHECK-NEXT: {"a":7,"c":2,"d":3,"e":4,"f":5,"g":7,"h":7,"i":6,"j":7,"z":8}
@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -O %s | %FileCheck --match-full-lines %s
+// RUN: %hermes -O -gc-pretenure=0 %s | %FileCheck --match-full-lines %s
+
+// Allocation sites whose objects survive young generation collections start
+// allocating directly in the old generation. Check that objects, arrays and
+// closures allocated either way behave the same.
+
+print('pretenure');
+// CHECK-LABEL: pretenure
+
+function makeEntry(i) {
+  var o = {};
+  o.id = i;
+  o.list = [i, i + 1, i + 2];
+  o.get = function() {
+    return this.id + o.list[2];
+  };
+  return o;
+}
+
+var table = [];
+for (var i = 0; i < 200000; i++) {
+  table.push(makeEntry(i));
+  // Short-lived garbage from another site, to trigger collections.
+  var tmp = [i, {x: i}];
+}
+gc();
+
+var sum = 0;
+for (var i = 0; i < table.length; i++) {
+  var e = table[i];
+  sum += e.get() - e.list[0] - e.list[1];
+}
+print(table.length, sum);
+// CHECK-NEXT: 200000 200000
+
+// Mutate the old objects so they point at new ones.
+for (var i = 0; i < table.length; i += 1000) {
+  table[i].list.push({v: i});
+  table[i].next = makeEntry(-i);
+}
+gc();
+var count = 0;
+for (var i = 0; i < table.length; i += 1000) {
+  count += table[i].list[3].v === i && table[i].next.get() === 2 - 2 * i;
+}
+print(count);
+// CHECK-NEXT: 200
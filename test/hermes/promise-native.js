@@ -0,0 +1,163 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// RUN: %hermes -Xvm-experiment-flags=16384 %s | %FileCheck --match-full-lines %s
+// RUN: %hermesc -O -emit-binary -out %t.hbc %s && %hermes -Xvm-experiment-flags=16384 %t.hbc | %FileCheck --match-full-lines %s
+
+// Each task below checks the jobs queued by the previous one, which have all
+// run by then since they are microtasks.
+
+print('promise native');
+// CHECK-LABEL: promise native
+
+var p = Promise.resolve(1);
+print(Object.prototype.toString.call(p), p instanceof Promise);
+// CHECK-NEXT: [object Promise] true
+print(Promise.resolve(p) === p);
+// CHECK-NEXT: true
+
+try {
+  Promise(function() {});
+} catch (e) {
+  print(e.name, e.message);
+}
+// CHECK-NEXT: TypeError Promises must be constructed via new
+try {
+  new Promise(1);
+} catch (e) {
+  print(e.name, e.message);
+}
+// CHECK-NEXT: TypeError Promise constructor's argument is not a function
+try {
+  Promise.prototype.then.call({});
+} catch (e) {
+  print(e.name);
+}
+// CHECK-NEXT: TypeError
+
+var log = [];
+function flush(label) {
+  print(label + ':', log.join(' '));
+  log = [];
+}
+
+// Reactions run in registration order, after the current script.
+var a = Promise.resolve('a');
+a.then(function(v) { log.push(v + 1); });
+a.then(function(v) { log.push(v + 2); });
+a.then(function(v) { log.push(v + 3); }).then(function() { log.push('a4'); });
+new Promise(function(res) {
+  log.push('executor');
+  res();
+});
+log.push('sync');
+
+setTimeout(function() {
+  flush('order');
+// CHECK-NEXT: order: executor sync a1 a2 a3 a4
+
+  // Handlers are skipped and values and reasons flow through.
+  Promise.reject('r')
+    .then(function() { log.push('not called'); })
+    .catch(function(e) { log.push('caught ' + e); return 'c'; })
+    .finally(function() { log.push('finally'); return 'ignored'; })
+    .then(function(v) { log.push('after ' + v); });
+  // Throwing from a handler rejects the derived promise.
+  Promise.resolve()
+    .then(function() { throw 't'; })
+    .then(null, function(e) { log.push('rethrown ' + e); });
+  // A throwing finally() callback replaces the outcome.
+  Promise.resolve(1)
+    .finally(function() { throw 'f'; })
+    .catch(function(e) { log.push('finally threw ' + e); });
+}, 0);
+
+setTimeout(function() {
+  flush('chain');
+// CHECK-NEXT: chain: caught r rethrown t finally threw f finally after c
+
+  // Thenables are called synchronously and settle the promise once.
+  var thenable = {
+    then: function(res, rej) {
+      log.push('then called');
+      res('th');
+      rej('ignored');
+      res('ignored');
+    },
+  };
+  Promise.resolve(thenable).then(function(v) { log.push('thenable ' + v); });
+  var throwing = {
+    get then() {
+      throw 'getter';
+    },
+  };
+  Promise.resolve(throwing).catch(function(e) { log.push('thenable ' + e); });
+  // A promise cannot be resolved with itself.
+  var self = new Promise(function(res) {
+    Promise.resolve().then(function() { res(self); });
+  });
+  self.catch(function(e) { log.push(e.name); });
+}, 0);
+
+setTimeout(function() {
+  flush('thenables');
+// CHECK-NEXT: thenables: then called thenable th thenable getter TypeError
+
+  var pending;
+  var later = new Promise(function(res) { pending = res; });
+  Promise.all([1, Promise.resolve(2), later, { then: function(r) { r(4); } }])
+    .then(function(v) { log.push('all ' + v.length + ' ' + v.join(',')); });
+  Promise.all([]).then(function(v) { log.push('empty ' + v.length); });
+  Promise.all(new Set(['s'])).then(function(v) { log.push('set ' + v); });
+  Promise.all([Promise.reject('x'), later])
+    .catch(function(e) { log.push('all rejected ' + e); });
+  Promise.all(5).catch(function(e) { log.push('all ' + e.name); });
+  Promise.race([later, Promise.resolve('fast')])
+    .then(function(v) { log.push('race ' + v); });
+  pending(3);
+}, 0);
+
+setTimeout(function() {
+  flush('combinators');
+// CHECK-NEXT: combinators: empty 0 set s all rejected x all TypeError race fast all 4 1,2,3,4
+
+  // Subclasses get instances of themselves from then().
+  function MyPromise(executor) {
+    var p = new Promise(executor);
+    Object.setPrototypeOf(p, MyPromise.prototype);
+    return p;
+  }
+  MyPromise.prototype = Object.create(Promise.prototype, {
+    constructor: {value: MyPromise},
+  });
+  var derived = new MyPromise(function(res) { res(1); }).then(function(v) {
+    log.push('sub ' + v);
+  });
+  log.push(derived instanceof MyPromise);
+}, 0);
+
+setTimeout(function() {
+  flush('subclass');
+// CHECK-NEXT: subclass: true sub 1
+
+  async function add(x, y) {
+    var a = await x;
+    var b = await Promise.resolve(y);
+    return a + b;
+  }
+  async function fail() {
+    await null;
+    throw new Error('async');
+  }
+  add(1, 2).then(function(v) { log.push('add ' + v); });
+  fail().catch(function(e) { log.push(e.message); });
+}, 0);
+
+setTimeout(function() {
+  flush('async');
+// CHECK-NEXT: async: async add 3
+}, 0);
@@ -16,12 +16,14 @@
 #include "llvh/ADT/SmallVector.h"
 #include "llvh/Support/CommandLine.h"
 #include "llvh/Support/FileSystem.h"
+#include "llvh/Support/Format.h"
 #include "llvh/Support/InitLLVM.h"
 #include "llvh/Support/MemoryBuffer.h"
 #include "llvh/Support/PrettyStackTrace.h"
 #include "llvh/Support/Signals.h"
 #include "llvh/Support/raw_ostream.h"
 
+#include <chrono>
 #include <iostream>
 #include <map>
 #include <sstream>
@@ -98,12 +100,78 @@ static llvh::cl::opt<bool> HumanizeSectionRanges(
     llvh::cl::init(false),
     llvh::cl::desc("Print bytecode section ranges in hex format"));
 
+static llvh::cl::opt<bool> ShowSectionCompression(
+    "show-section-compression",
+    llvh::cl::init(false),
+    llvh::cl::desc(
+        "Show the stored and decompressed size of each compressed section, "
+        "and the time taken to load the bytecode and decompress each section"));
+
 static bool executeCommand(
     llvh::raw_ostream &os,
     ProfileAnalyzer &analyzer,
     BytecodeDisassembler &disassembler,
     const std::string &commandWithOptions);
 
+/// Create a provider over \p bytecode without copying or taking ownership.
+static std::unique_ptr<BCProviderFromBuffer> createUnownedProvider(
+    llvh::ArrayRef<uint8_t> bytecode) {
+  return BCProviderFromBuffer::createBCProviderFromBuffer(
+             std::make_unique<hermes::Buffer>(bytecode.data(), bytecode.size()))
+      .first;
+}
+
+/// Print the stored and decompressed size of each compressed section of
+/// \p bytecode to \p os, along with the time taken to construct a provider
+/// and to decompress each section from a freshly constructed provider.
+static void printSectionCompression(
+    llvh::ArrayRef<uint8_t> bytecode,
+    llvh::raw_ostream &os) {
+  using Clock = std::chrono::steady_clock;
+  auto elapsedUs = [](Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               Clock::now() - start)
+        .count();
+  };
+
+  auto start = Clock::now();
+  auto provider = createUnownedProvider(bytecode);
+  os << "Load time: " << elapsedUs(start) << "us\n";
+  if (!provider->hasCompressedSections()) {
+    os << "Bytecode has no compressed sections.\n";
+    return;
+  }
+
+  os << "Section compression:\n";
+  uint64_t totalStored = 0;
+  uint64_t totalRaw = 0;
+  for (size_t i = 0; i < static_cast<size_t>(CompressedSectionKind::_count);
+       ++i) {
+    auto kind = static_cast<CompressedSectionKind>(i);
+    const CompressedSection *section = provider->getCompressedSection(kind);
+    uint32_t stored = section->getStored().size();
+    uint32_t raw = section->getRawSize();
+    totalStored += stored;
+    totalRaw += raw;
+
+    // Decompress from a fresh provider so earlier accesses are not cached.
+    auto fresh = createUnownedProvider(bytecode);
+    start = Clock::now();
+    fresh->getCompressedSection(kind)->getAll();
+    auto decompressUs = elapsedUs(start);
+
+    os << "  " << compressedSectionName(kind) << ": stored " << stored
+       << " bytes, raw " << raw << " bytes";
+    if (raw) {
+      os << llvh::format(" (%.1f%%)", 100.0 * stored / raw);
+    }
+    os << ", " << section->getBlockCount() << " blocks, decompressed in "
+       << decompressUs << "us\n";
+  }
+  os << "  Total: stored " << totalStored << " bytes, raw " << totalRaw
+     << " bytes\n";
+}
+
 /// Wrapper around std::getline().
 /// Read a line from cin, storing it into \p line.
 /// \return true if we have a line, false if input was exhausted.
@@ -524,6 +592,8 @@ int main(int argc, char **argv) {
     if (ShowSectionRanges) {
       BytecodeSectionWalker walker(bytecodeStart, std::move(ret.first), output);
       walker.printSectionRanges(HumanizeSectionRanges);
+    } else if (ShowSectionCompression) {
+      printSectionCompression(ret.first->getRawBuffer(), output);
     } else {
       enterCommandLoop(
           output,
@@ -98,12 +98,15 @@ static int executeHBCBytecodeFromCL(
                   .withShouldReleaseUnused(vm::kReleaseUnusedNone)
                   .withAllocInYoung(cl::GCAllocYoung)
                   .withRevertToYGAtTTI(cl::GCRevertToYGAtTTI)
+                  .withAllocationSitePretenuring(cl::GCPretenure)
                   .build())
           .withEnableEval(cl::EnableEval)
           .withVerifyEvalIR(cl::VerifyIR)
           .withOptimizedEval(cl::OptimizedEval)
           .withAsyncBreakCheckInEval(cl::EmitAsyncBreakCheck)
           .withVMExperimentFlags(cl::VMExperimentFlags)
+          .withDictionaryThreshold(cl::DictionaryThreshold)
+          .withDictionaryReshapeThreshold(cl::DictionaryReshapeThreshold)
           .withES6Promise(cl::ES6Promise)
           .withES6Proxy(cl::ES6Proxy)
           .withIntl(cl::Intl)
@@ -162,6 +165,8 @@ static vm::RuntimeConfig getReplRuntimeConfig() {
               .withShouldRecordStats(cl::GCPrintStats)
               .build())
       .withVMExperimentFlags(cl::VMExperimentFlags)
+      .withDictionaryThreshold(cl::DictionaryThreshold)
+      .withDictionaryReshapeThreshold(cl::DictionaryReshapeThreshold)
       .withES6Promise(cl::ES6Promise)
       .withES6Proxy(cl::ES6Proxy)
       .withIntl(cl::Intl)
@@ -0,0 +1,31 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+(function() {
+  var numIter = 2000;
+  var len = 100;
+
+  async function addOne(value) {
+    return value + 1;
+  }
+
+  async function run() {
+    var sum = 0;
+    for (var i = 0; i < numIter; i++) {
+      for (var j = 0; j < len; j++) {
+        sum = await addOne(sum);
+      }
+    }
+    return sum;
+  }
+
+  run().then(function() {
+    print('done');
+  });
+})();
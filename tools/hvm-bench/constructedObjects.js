@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+(function() {
+  var numIter = 2000000;
+
+  // Constructors and object literals creating objects with more properties
+  // than fit in the direct property slots.
+  function Record(i) {
+    this.id = i;
+    this.name = 'record';
+    this.x = i + 1;
+    this.y = i + 2;
+    this.z = i + 3;
+    this.w = i + 4;
+    this.h = i + 5;
+    this.dx = 0;
+    this.dy = 0;
+    this.dz = 0;
+    this.color = 'red';
+    this.visible = true;
+    this.parent = null;
+    this.prev = null;
+    this.next = null;
+  }
+
+  function makeEntry(i) {
+    return {
+      key: i,
+      value: 'v',
+      left: null,
+      right: null,
+      depth: 0,
+      size: i,
+      weight: i,
+      color: 0,
+      hash: i * 31,
+      visited: false,
+      count: i + 1,
+      min: i,
+      max: i,
+      parent: null,
+      record: null,
+    };
+  }
+
+  var live = [];
+  var sum = 0;
+  for (var i = 0; i < numIter; i++) {
+    var r = new Record(i);
+    var e = makeEntry(i);
+    e.record = r;
+    live[i % 10000] = e;
+    sum += r.h + e.size;
+  }
+
+  print('done');
+})();
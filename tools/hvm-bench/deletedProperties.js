@@ -0,0 +1,43 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+(function() {
+  var numObjs = 1000;
+  var numIter = 3000;
+  var numTemp = 1000000;
+
+  // Option objects which have a few entries removed before being read many
+  // times, which leaves them in dictionary mode.
+  var objs = [];
+  for (var i = 0; i < numObjs; i++) {
+    var o = {id: i, x: 1, y: 2, w: 3, h: 4, color: 'red', tmp1: 0, tmp2: 0};
+    delete o.tmp1;
+    delete o.tmp2;
+    o.extra = i;
+    delete o.extra;
+    objs.push(o);
+  }
+  var sum = 0;
+  for (var it = 0; it < numIter; it++) {
+    for (var i = 0; i < numObjs; i++) {
+      var o = objs[i];
+      sum += o.x + o.y + o.w + o.h + o.id;
+    }
+  }
+
+  // A temporary property which is repeatedly added and deleted again.
+  var p = {a: 1, b: 2};
+  for (var i = 0; i < numTemp; i++) {
+    p.tmp = i;
+    sum += p.a + p.b + p.tmp;
+    delete p.tmp;
+  }
+
+  print('done');
+})();
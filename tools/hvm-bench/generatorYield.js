@@ -0,0 +1,56 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+(function() {
+  var numIter = 2;
+  var len = 1000000;
+
+  // Enough locals live across the yield to give the generator a large frame,
+  // and enough iterations for its saved frame to move to the old generation.
+  function* values(n) {
+    var a0 = n * 1, a1 = n * 2, a2 = n * 3, a3 = n * 4;
+    var a4 = n * 5, a5 = n * 6, a6 = n * 7, a7 = n * 8;
+    var b0 = n * 9, b1 = n * 10, b2 = n * 11, b3 = n * 12;
+    var b4 = n * 13, b5 = n * 14, b6 = n * 15, b7 = n * 16;
+    var c0 = n * 17, c1 = n * 18, c2 = n * 19, c3 = n * 20;
+    var c4 = n * 21, c5 = n * 22, c6 = n * 23, c7 = n * 24;
+    var d0 = n * 25, d1 = n * 26, d2 = n * 27, d3 = n * 28;
+    var d4 = n * 29, d5 = n * 30, d6 = n * 31, d7 = n * 32;
+    var e0 = n * 33, e1 = n * 34, e2 = n * 35, e3 = n * 36;
+    var e4 = n * 37, e5 = n * 38, e6 = n * 39, e7 = n * 40;
+    var f0 = n * 41, f1 = n * 42, f2 = n * 43, f3 = n * 44;
+    var f4 = n * 45, f5 = n * 46, f6 = n * 47, f7 = n * 48;
+    var g0 = n * 49, g1 = n * 50, g2 = n * 51, g3 = n * 52;
+    var g4 = n * 53, g5 = n * 54, g6 = n * 55, g7 = n * 56;
+    var h0 = n * 57, h1 = n * 58, h2 = n * 59, h3 = n * 60;
+    var h4 = n * 61, h5 = n * 62, h6 = n * 63, h7 = n * 64;
+    for (var i = 0; i < n; i++) {
+      yield i;
+    }
+    return (
+      a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7 +
+      b0 + b1 + b2 + b3 + b4 + b5 + b6 + b7 +
+      c0 + c1 + c2 + c3 + c4 + c5 + c6 + c7 +
+      d0 + d1 + d2 + d3 + d4 + d5 + d6 + d7 +
+      e0 + e1 + e2 + e3 + e4 + e5 + e6 + e7 +
+      f0 + f1 + f2 + f3 + f4 + f5 + f6 + f7 +
+      g0 + g1 + g2 + g3 + g4 + g5 + g6 + g7 +
+      h0 + h1 + h2 + h3 + h4 + h5 + h6 + h7
+    );
+  }
+
+  var sum = 0;
+  for (var i = 0; i < numIter; i++) {
+    for (var v of values(len)) {
+      sum += v;
+    }
+  }
+
+  print('done');
+})();
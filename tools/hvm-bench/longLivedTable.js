@@ -0,0 +1,38 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+(function() {
+  var numEntries = 1000000;
+  var numLookups = 2000000;
+
+  // A large lookup table built up front. Almost everything allocated while
+  // building it stays alive, so young generation collections mostly copy it.
+  function makeEntry(i) {
+    var e = {};
+    e.key = i;
+    e.tags = [i & 7, i & 15];
+    e.score = function() {
+      return e.key + e.tags[1];
+    };
+    return e;
+  }
+  var table = [];
+  for (var i = 0; i < numEntries; i++) {
+    table.push(makeEntry(i));
+  }
+
+  // Short-lived allocations while the table is in use.
+  var sum = 0;
+  for (var i = 0; i < numLookups; i++) {
+    var tmp = [i, i + 1];
+    sum += table[(i * 7) % numEntries].score() + tmp[1];
+  }
+
+  print('done');
+})();
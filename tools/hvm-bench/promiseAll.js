@@ -0,0 +1,30 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+(function() {
+  var numIter = 2000;
+  var len = 100;
+
+  var a = Array(len);
+  for (var i = 0; i < len; i++) {
+    a[i] = Promise.resolve(i);
+  }
+
+  var p = Promise.resolve();
+  function step() {
+    return Promise.all(a);
+  }
+  for (var i = 0; i < numIter; i++) {
+    p = p.then(step);
+  }
+
+  p.then(function() {
+    print('done');
+  });
+})();
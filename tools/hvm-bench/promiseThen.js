@@ -0,0 +1,29 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+(function() {
+  var numIter = 2000;
+  var len = 100;
+
+  function addOne(value) {
+    return value + 1;
+  }
+
+  // Each iteration builds a chain of len reactions on a settled promise.
+  var p = Promise.resolve(0);
+  for (var i = 0; i < numIter; i++) {
+    for (var j = 0; j < len; j++) {
+      p = p.then(addOne);
+    }
+  }
+
+  p.then(function() {
+    print('done');
+  });
+})();
@@ -0,0 +1,29 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+(function() {
+  var numLive = 100000;
+  var numIter = 3000000;
+
+  // A large ring of objects of many different sizes, each of which survives
+  // long enough to be promoted to the old generation before it is replaced.
+  // The replaced objects leave free cells of assorted sizes in the old
+  // generation, which later promotions have to be allocated into.
+  var ring = new Array(numLive);
+  for (var i = 0; i < numIter; i++) {
+    var len = (i * 7) % 97;
+    var arr = new Array(len);
+    for (var j = 0; j < len; j++) {
+      arr[j] = j;
+    }
+    ring[(i * 31) % numLive] = {id: i, items: arr, name: 'item' + (i % 1000)};
+  }
+
+  print('done');
+})();
@@ -0,0 +1,45 @@
+/**
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * @format
+ */
+
+(function() {
+  var numMaps = 5000;
+  var keysPerMap = 20;
+  var numIter = 3000000;
+
+  // Thousands of memoization caches keyed by long-lived objects, which every
+  // old generation collection has to trace as ephemerons.
+  var keys = [];
+  for (var i = 0; i < 2000; i++) {
+    keys.push({id: i});
+  }
+  var maps = [];
+  for (var m = 0; m < numMaps; m++) {
+    var wm = new WeakMap();
+    for (var k = 0; k < keysPerMap; k++) {
+      wm.set(keys[(m * 7 + k * 13) % keys.length], {value: [m, k]});
+    }
+    maps.push(wm);
+  }
+
+  // Allocate enough to trigger several old generation collections.
+  var live = [];
+  var hits = 0;
+  for (var i = 0; i < numIter; i++) {
+    live[i % 50000] = {a: i, b: [i]};
+    if (i % 1000 === 0) {
+      var wm = maps[i % numMaps];
+      wm.set(keys[i % keys.length], {value: i});
+      if (wm.get(keys[(i * 3) % keys.length])) {
+        hits++;
+      }
+    }
+  }
+
+  print('done');
+})();
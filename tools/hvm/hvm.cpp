@@ -119,7 +119,10 @@ int main(int argc, char **argv) {
                       GCPrintStats && !cl::StableInstructionCount)
                   .withShouldReleaseUnused(vm::kReleaseUnusedNone)
                   .withName("hvm")
+                  .withAllocationSitePretenuring(cl::GCPretenure)
                   .build())
+          .withDictionaryThreshold(cl::DictionaryThreshold)
+          .withDictionaryReshapeThreshold(cl::DictionaryReshapeThreshold)
           .withES6Promise(cl::ES6Promise)
           .withES6Proxy(cl::ES6Proxy)
           .withIntl(cl::Intl)
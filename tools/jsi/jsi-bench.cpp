@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+//===----------------------------------------------------------------------===//
+/// \file
+/// Micro-benchmarks for the overhead of the JSI layer: creating and releasing
+/// values, property access through JSI, and calls between JS and host
+/// functions, and the batched property and array APIs on HermesRuntime
+/// compared with their per-element equivalents. Each benchmark reports the
+/// average time per operation, which for the array and property batches is
+/// one element, and for the startup benchmarks is creating a runtime, loading
+/// a bundle and making the first call into it.
+//===----------------------------------------------------------------------===//
+
+#include "hermes/CompileJS.h"
+#include "hermes/hermes.h"
+
+#include "llvh/Support/CommandLine.h"
+#include "llvh/Support/Format.h"
+#include "llvh/Support/InitLLVM.h"
+#include "llvh/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace facebook;
+using facebook::hermes::HermesRuntime;
+
+static llvh::cl::opt<unsigned> Iterations(
+    "iterations",
+    llvh::cl::desc("number of operations per benchmark"),
+    llvh::cl::init(1000000));
+
+static llvh::cl::opt<std::string> Filter(
+    "filter",
+    llvh::cl::desc("only run benchmarks whose name contains this string"),
+    llvh::cl::init(""));
+
+namespace {
+
+struct Benchmark {
+  const char *name;
+  std::function<void(HermesRuntime &, unsigned)> run;
+  /// How many times more expensive an operation is than a typical JSI call.
+  /// The benchmark runs Iterations / cost operations.
+  unsigned cost = 1;
+};
+
+/// Create an object per iteration and release it immediately.
+void createRelease(jsi::Runtime &rt, unsigned n) {
+  for (unsigned i = 0; i < n; ++i) {
+    jsi::Object obj(rt);
+    (void)obj;
+  }
+}
+
+/// Keep a window of live objects, so that releases are interleaved with
+/// allocations as they are in host code that holds on to values.
+void createReleaseWindow(jsi::Runtime &rt, unsigned n) {
+  constexpr unsigned kWindow = 1024;
+  std::vector<jsi::Object> window;
+  window.reserve(kWindow);
+  for (unsigned i = 0; i < n; ++i) {
+    if (window.size() < kWindow)
+      window.emplace_back(rt);
+    else
+      window[i % kWindow] = jsi::Object(rt);
+  }
+}
+
+void getProperty(jsi::Runtime &rt, unsigned n) {
+  jsi::Object obj(rt);
+  auto name = jsi::PropNameID::forAscii(rt, "x");
+  obj.setProperty(rt, name, 1);
+  double sum = 0;
+  for (unsigned i = 0; i < n; ++i)
+    sum += obj.getProperty(rt, name).getNumber();
+  if (sum != n)
+    llvh::errs() << "unexpected sum\n";
+}
+
+void setProperty(jsi::Runtime &rt, unsigned n) {
+  jsi::Object obj(rt);
+  auto name = jsi::PropNameID::forAscii(rt, "x");
+  for (unsigned i = 0; i < n; ++i)
+    obj.setProperty(rt, name, static_cast<double>(i));
+}
+
+/// Read an object valued property, so that every get creates a new value.
+void getObjectProperty(jsi::Runtime &rt, unsigned n) {
+  jsi::Object obj(rt);
+  auto name = jsi::PropNameID::forAscii(rt, "child");
+  obj.setProperty(rt, name, jsi::Object(rt));
+  for (unsigned i = 0; i < n; ++i) {
+    jsi::Value child = obj.getProperty(rt, name);
+    (void)child;
+  }
+}
+
+void callHostFunction(jsi::Runtime &rt, unsigned n) {
+  auto add = jsi::Function::createFromHostFunction(
+      rt,
+      jsi::PropNameID::forAscii(rt, "add"),
+      2,
+      [](jsi::Runtime &, const jsi::Value &, const jsi::Value *args, size_t) {
+        return jsi::Value(args[0].getNumber() + args[1].getNumber());
+      });
+  rt.global().setProperty(rt, "add", add);
+  auto loop = rt.evaluateJavaScript(
+                    std::make_shared<jsi::StringBuffer>(
+                        "(function(n) {"
+                        "  var s = 0;"
+                        "  for (var i = 0; i < n; ++i) s = add(s, 1);"
+                        "  return s;"
+                        "})"),
+                    "jsi-bench.js")
+                  .asObject(rt)
+                  .asFunction(rt);
+  loop.call(rt, static_cast<double>(n));
+}
+
+void callJSFunction(jsi::Runtime &rt, unsigned n) {
+  auto identity = rt.evaluateJavaScript(
+                        std::make_shared<jsi::StringBuffer>(
+                            "(function(o) { return o; })"),
+                        "jsi-bench.js")
+                      .asObject(rt)
+                      .asFunction(rt);
+  jsi::Object arg(rt);
+  for (unsigned i = 0; i < n; ++i) {
+    jsi::Value res = identity.call(rt, arg);
+    (void)res;
+  }
+}
+
+/// Number of properties or elements transferred by each batched call.
+constexpr unsigned kBatch = 64;
+
+jsi::Object makeBatchObject(
+    jsi::Runtime &rt,
+    std::vector<jsi::PropNameID> &names) {
+  jsi::Object obj(rt);
+  for (unsigned i = 0; i < kBatch; ++i) {
+    names.push_back(jsi::PropNameID::forUtf8(rt, "p" + std::to_string(i)));
+    obj.setProperty(rt, names.back(), static_cast<double>(i));
+  }
+  return obj;
+}
+
+void getProperties(HermesRuntime &rt, unsigned n) {
+  std::vector<jsi::PropNameID> names;
+  jsi::Object obj = makeBatchObject(rt, names);
+  for (unsigned i = 0; i < n; i += kBatch) {
+    for (unsigned j = 0; j < kBatch; ++j) {
+      jsi::Value v = obj.getProperty(rt, names[j]);
+      (void)v;
+    }
+  }
+}
+
+void getPropertiesBatched(HermesRuntime &rt, unsigned n) {
+  std::vector<jsi::PropNameID> names;
+  jsi::Object obj = makeBatchObject(rt, names);
+  jsi::Value out[kBatch];
+  for (unsigned i = 0; i < n; i += kBatch)
+    rt.getProperties(obj, names.data(), kBatch, out);
+}
+
+jsi::Array makeBatchArray(jsi::Runtime &rt) {
+  jsi::Array arr(rt, kBatch);
+  for (unsigned i = 0; i < kBatch; ++i)
+    arr.setValueAtIndex(rt, i, static_cast<double>(i));
+  return arr;
+}
+
+void getArrayElements(HermesRuntime &rt, unsigned n) {
+  jsi::Array arr = makeBatchArray(rt);
+  double sum = 0;
+  for (unsigned i = 0; i < n; i += kBatch) {
+    for (unsigned j = 0; j < kBatch; ++j)
+      sum += arr.getValueAtIndex(rt, j).getNumber();
+  }
+  (void)sum;
+}
+
+void getArrayNumbers(HermesRuntime &rt, unsigned n) {
+  jsi::Array arr = makeBatchArray(rt);
+  double out[kBatch];
+  for (unsigned i = 0; i < n; i += kBatch)
+    rt.getArrayNumbers(arr, 0, kBatch, out);
+}
+
+void setArrayElements(HermesRuntime &rt, unsigned n) {
+  jsi::Array arr(rt, kBatch);
+  for (unsigned i = 0; i < n; i += kBatch) {
+    for (unsigned j = 0; j < kBatch; ++j)
+      arr.setValueAtIndex(rt, j, static_cast<double>(i + j));
+  }
+}
+
+void setArrayNumbers(HermesRuntime &rt, unsigned n) {
+  jsi::Array arr(rt, kBatch);
+  double values[kBatch];
+  for (unsigned i = 0; i < n; i += kBatch) {
+    for (unsigned j = 0; j < kBatch; ++j)
+      values[j] = i + j;
+    rt.setArrayNumbers(arr, 0, values, kBatch);
+  }
+}
+
+class NamedHostObject : public jsi::HostObject {
+ public:
+  jsi::Value get(jsi::Runtime &rt, const jsi::PropNameID &name) override {
+    return name.utf8(rt) == "y" ? 2 : 1;
+  }
+};
+
+class SlotHostObject : public facebook::hermes::FixedHostObject {
+ public:
+  jsi::Value getSlot(jsi::Runtime &, size_t index) override {
+    return index == 1 ? 2 : 1;
+  }
+};
+
+/// Read a host object property from JS \p n times.
+void readHostObject(HermesRuntime &rt, jsi::Object ho, unsigned n) {
+  rt.global().setProperty(rt, "ho", ho);
+  auto loop = rt.evaluateJavaScript(
+                    std::make_shared<jsi::StringBuffer>(
+                        "(function(n) {"
+                        "  var s = 0;"
+                        "  for (var i = 0; i < n; ++i) s += ho.y;"
+                        "  return s;"
+                        "})"),
+                    "jsi-bench.js")
+                  .asObject(rt)
+                  .asFunction(rt);
+  loop.call(rt, static_cast<double>(n));
+}
+
+void getHostObjectProperty(HermesRuntime &rt, unsigned n) {
+  readHostObject(
+      rt,
+      jsi::Object::createFromHostObject(
+          rt, std::make_shared<NamedHostObject>()),
+      n);
+}
+
+void getFixedHostObjectProperty(HermesRuntime &rt, unsigned n) {
+  auto names = jsi::PropNameID::names(rt, "x", "y");
+  auto props = rt.createHostPropertySet(names.data(), names.size());
+  readHostObject(
+      rt,
+      rt.createFixedHostObject(props, std::make_shared<SlotHostObject>()),
+      n);
+}
+
+/// A bundle shaped like the output of a module bundler: a module table of
+/// factory functions, each defining a few functions and object literals, and
+/// an entry point which requires all of them.
+std::string makeStartupBundle() {
+  constexpr unsigned kModules = 200;
+  std::string src = "var modules = [];\n";
+  for (unsigned i = 0; i < kModules; ++i) {
+    std::string n = std::to_string(i);
+    src += "modules.push(function(exports) {\n";
+    src += "  var config = {name: 'module" + n + "', id: " + n + "};\n";
+    src += "  config.flags = [1, 2, 3];\n";
+    src += "  exports.get" + n + " = function(x) { return x + config.id; };\n";
+    src += "  exports.describe" + n + " = function() {\n";
+    src += "    return config.name + ':' + config.flags.length;\n";
+    src += "  };\n";
+    src += "});\n";
+  }
+  src += "var exports = {};\n";
+  src += "for (var i = 0; i < modules.length; ++i) modules[i](exports);\n";
+  src += "(function main(x) { return exports.get0(x); })\n";
+  return src;
+}
+
+/// Create a runtime, load the startup bundle with \p load and call the
+/// function it returns, \p n times.
+void startup(
+    unsigned n,
+    const std::function<jsi::Value(HermesRuntime &)> &load) {
+  for (unsigned i = 0; i < n; ++i) {
+    auto rt = facebook::hermes::makeHermesRuntime();
+    jsi::Value res = load(*rt).asObject(*rt).asFunction(*rt).call(*rt, 1);
+    if (res.getNumber() != 1)
+      llvh::errs() << "unexpected result\n";
+  }
+}
+
+void startupFromSource(HermesRuntime &, unsigned n) {
+  auto source = std::make_shared<jsi::StringBuffer>(makeStartupBundle());
+  startup(n, [&source](HermesRuntime &rt) {
+    return rt.evaluateJavaScript(source, "bundle.js");
+  });
+}
+
+std::shared_ptr<jsi::StringBuffer> compileStartupBundle() {
+  std::string bytecode;
+  if (!::hermes::compileJS(makeStartupBundle(), bytecode, true))
+    llvh::report_fatal_error("failed to compile the startup bundle");
+  return std::make_shared<jsi::StringBuffer>(std::move(bytecode));
+}
+
+void startupFromBytecode(HermesRuntime &, unsigned n) {
+  auto bytecode = compileStartupBundle();
+  startup(n, [&bytecode](HermesRuntime &rt) {
+    return rt.evaluateJavaScript(bytecode, "bundle.js");
+  });
+}
+
+void startupFromBytecodeImage(HermesRuntime &, unsigned n) {
+  auto image =
+      HermesRuntime::prepareBytecodeImage(compileStartupBundle(), "bundle.js");
+  startup(n, [&image](HermesRuntime &rt) {
+    return rt.evaluatePreparedJavaScript(image);
+  });
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  llvh::InitLLVM initLLVM(argc, argv);
+  llvh::cl::ParseCommandLineOptions(argc, argv, "Hermes JSI benchmarks\n");
+
+  const Benchmark benchmarks[] = {
+      {"create-release", createRelease},
+      {"create-release-window", createReleaseWindow},
+      {"get-property", getProperty},
+      {"get-object-property", getObjectProperty},
+      {"set-property", setProperty},
+      {"call-host-function", callHostFunction},
+      {"call-js-function", callJSFunction},
+      {"get-properties", getProperties},
+      {"get-properties-batched", getPropertiesBatched},
+      {"get-array-elements", getArrayElements},
+      {"get-array-numbers", getArrayNumbers},
+      {"set-array-elements", setArrayElements},
+      {"set-array-numbers", setArrayNumbers},
+      {"get-host-object-property", getHostObjectProperty},
+      {"get-fixed-host-object-property", getFixedHostObjectProperty},
+      {"startup-source", startupFromSource, 10000},
+      {"startup-bytecode", startupFromBytecode, 10000},
+      {"startup-bytecode-image", startupFromBytecodeImage, 10000},
+  };
+
+  for (const Benchmark &bench : benchmarks) {
+    if (!llvh::StringRef(bench.name).contains(Filter))
+      continue;
+    // Use a fresh runtime for each benchmark so they don't affect each other.
+    auto rt = facebook::hermes::makeHermesRuntime();
+    unsigned iterations = std::max(1u, Iterations / bench.cost);
+    auto start = std::chrono::steady_clock::now();
+    bench.run(*rt, iterations);
+    std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    llvh::outs() << llvh::format(
+        "%-32s %8.1f ns/op\n", bench.name, elapsed.count() / iterations);
+  }
+  return EXIT_SUCCESS;
+}
@@ -10,6 +10,8 @@
 #include <hermes/CompileJS.h>
 #include <hermes/hermes.h>
 
+#include <thread>
+
 using namespace facebook::jsi;
 using namespace facebook::hermes;
 
@@ -104,6 +106,39 @@ TEST_F(HermesRuntimeTest, ArrayBufferTest) {
   EXPECT_EQ(buffer[1], 5678);
 }
 
+TEST_F(HermesRuntimeTest, ExternalArrayBufferTest) {
+  std::vector<uint8_t> data(64);
+  data[0] = 42;
+  bool finalized = false;
+  {
+    auto runtime = makeHermesRuntime();
+    ArrayBuffer buffer = runtime->createExternalArrayBuffer(
+        data.data(), data.size(), [&finalized] { finalized = true; });
+    // The buffer aliases the external memory in both directions.
+    EXPECT_EQ(buffer.data(*runtime), data.data());
+    EXPECT_EQ(buffer.size(*runtime), 64);
+    runtime->global().setProperty(*runtime, "buffer", buffer);
+    auto eval = runtime->global().getPropertyAsFunction(*runtime, "eval");
+    EXPECT_EQ(
+        eval.call(*runtime, "new Uint8Array(buffer)[0]").getNumber(), 42);
+    eval.call(*runtime, "new Uint8Array(buffer)[1] = 7");
+    EXPECT_EQ(data[1], 7);
+    EXPECT_EQ(
+        eval.call(*runtime, "buffer.slice(0, 2).byteLength").getNumber(), 2);
+    EXPECT_FALSE(finalized);
+  }
+  EXPECT_TRUE(finalized);
+
+  // An empty external buffer is still released.
+  finalized = false;
+  {
+    auto runtime = makeHermesRuntime();
+    runtime->createExternalArrayBuffer(
+        nullptr, 0, [&finalized] { finalized = true; });
+  }
+  EXPECT_TRUE(finalized);
+}
+
 TEST_F(HermesRuntimeTest, BytecodeTest) {
   const uint8_t shortBytes[] = {1, 2, 3};
   EXPECT_FALSE(HermesRuntime::isHermesBytecode(shortBytes, 0));
@@ -136,6 +171,39 @@ TEST_F(HermesRuntimeTest, PreparedJavaScriptBytecodeTest) {
   EXPECT_EQ(rt->global().getProperty(*rt, "q").getNumber(), 2);
 }
 
+TEST(HermesRuntimeBytecodeImageTest, SharedBetweenThreads) {
+  std::string bytecode;
+  ASSERT_TRUE(hermes::compileJS(
+      "var names = ['alpha', 'beta', 'gamma'];"
+      "function sum(n) { var s = 0; for (var i = 0; i < n; ++i) s += i;"
+      "  return s; }"
+      "names.join() + ':' + sum(100)",
+      bytecode));
+  auto image = HermesRuntime::prepareBytecodeImage(
+      std::make_shared<StringBuffer>(bytecode), "image.js");
+  EXPECT_THROW(
+      HermesRuntime::prepareBytecodeImage(
+          std::make_shared<StringBuffer>("1 + 1"), "source.js"),
+      JSINativeException);
+
+  constexpr unsigned kThreads = 4;
+  std::vector<std::string> results(kThreads);
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&image, &results, t] {
+      auto runtime = makeHermesRuntime();
+      for (int i = 0; i < 2; ++i)
+        results[t] = runtime->evaluatePreparedJavaScript(image)
+                         .getString(*runtime)
+                         .utf8(*runtime);
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  for (const auto &result : results)
+    EXPECT_EQ(result, "alpha,beta,gamma:4950");
+}
+
 TEST_F(HermesRuntimeTest, JumpTableBytecodeTest) {
   std::string code = R"xyz(
     (function(){
@@ -220,9 +288,11 @@ TEST_F(HermesRuntimeDeathTest, ValueTest) {
 
 TEST_F(HermesRuntimeTest, DontGrowWhenMoveObjectOutOfValue) {
   Value val = Object(*rt);
+  Value keepAlive;
   auto rootsDelta = HermesTestHelper::calculateRootsListChange(*rt, [&]() {
     Object obj = std::move(val).getObject(*rt);
-    (void)obj;
+    // Released values are no longer counted, so keep the moved object alive.
+    keepAlive = std::move(obj);
   });
   EXPECT_EQ(rootsDelta, 0);
 }
@@ -399,6 +469,60 @@ TEST_F(HermesRuntimeTest, HostObjectWithOwnProperties) {
 }
 
 // TODO mhorowitz: move this to jsi/testlib.cpp once we have impls for all VMs
+TEST_F(HermesRuntimeTest, FixedHostObjectTest) {
+  class Point : public FixedHostObject {
+   public:
+    double coords[2] = {1, 2};
+    int slowGets = 0;
+
+    Value getSlot(Runtime &, size_t index) override {
+      return coords[index];
+    }
+    void setSlot(Runtime &, size_t index, const Value &value) override {
+      coords[index] = value.getNumber();
+    }
+    Value get(Runtime &rt, const PropNameID &name) override {
+      ++slowGets;
+      return String::createFromUtf8(rt, name.utf8(rt));
+    }
+  };
+
+  std::vector<PropNameID> names = PropNameID::names(*rt, "x", "y");
+  auto props = rt->createHostPropertySet(names.data(), names.size());
+  auto point = std::make_shared<Point>();
+  Object obj = rt->createFixedHostObject(props, point);
+  EXPECT_EQ(obj.getHostObject(*rt), point);
+  rt->global().setProperty(*rt, "p", obj);
+  rt->global().setProperty(
+      *rt, "q", rt->createFixedHostObject(props, std::make_shared<Point>()));
+
+  EXPECT_EQ(eval("p.x + p.y").getNumber(), 3);
+  eval("p.x = 10");
+  EXPECT_EQ(point->coords[0], 10);
+  EXPECT_EQ(eval("q.x").getNumber(), 1);
+  EXPECT_EQ(point->slowGets, 0);
+  // Names outside the set use the regular HostObject interface.
+  EXPECT_EQ(eval("p.other").getString(*rt).utf8(*rt), "other");
+  EXPECT_EQ(point->slowGets, 1);
+  EXPECT_EQ(
+      eval("JSON.stringify(Object.keys(p)) + JSON.stringify(Object.keys(q))")
+          .getString(*rt)
+          .utf8(*rt),
+      "[\"x\",\"y\"][\"x\",\"y\"]");
+
+  std::vector<PropNameID> dup = PropNameID::names(*rt, "x", "x");
+  EXPECT_THROW(rt->createHostPropertySet(dup.data(), dup.size()), JSError);
+
+  class ReadOnly : public FixedHostObject {
+    Value getSlot(Runtime &, size_t) override {
+      return 0;
+    }
+  };
+  rt->global().setProperty(
+      *rt, "r", rt->createFixedHostObject(props, std::make_shared<ReadOnly>()));
+  EXPECT_THROW(eval("r.y = 1"), JSError);
+}
+
 TEST_F(HermesRuntimeTest, WeakReferences) {
   Object o = eval("({one: 1})").getObject(*rt);
   WeakObject wo = WeakObject(*rt, o);
@@ -531,6 +655,71 @@ TEST_F(HermesRuntimeTest, GlobalObjectTest) {
   EXPECT_EQ(eval("f(10)").getNumber(), 15);
 }
 
+TEST_F(HermesRuntimeTest, BatchedPropertiesTest) {
+  Object obj =
+      eval("({a: 1, b: 'two', get c() { return this.a + 1; }, 0: true})")
+          .getObject(*rt);
+  PropNameID names[] = {PropNameID::forAscii(*rt, "a"),
+                        PropNameID::forAscii(*rt, "b"),
+                        PropNameID::forAscii(*rt, "c"),
+                        PropNameID::forAscii(*rt, "0"),
+                        PropNameID::forAscii(*rt, "missing")};
+  Value out[5];
+  rt->getProperties(obj, names, 5, out);
+  EXPECT_EQ(out[0].getNumber(), 1);
+  EXPECT_EQ(out[1].getString(*rt).utf8(*rt), "two");
+  EXPECT_EQ(out[2].getNumber(), 2);
+  EXPECT_TRUE(out[3].getBool());
+  EXPECT_TRUE(out[4].isUndefined());
+
+  Value values[] = {Value(10), Value(*rt, String::createFromAscii(*rt, "x"))};
+  rt->setProperties(obj, names, values, 2);
+  EXPECT_EQ(obj.getProperty(*rt, "a").getNumber(), 10);
+  EXPECT_EQ(obj.getProperty(*rt, "c").getNumber(), 11);
+  EXPECT_EQ(obj.getProperty(*rt, "b").getString(*rt).utf8(*rt), "x");
+
+  // Exceptions thrown by setters propagate and stop the batch.
+  Object frozen = eval("Object.freeze({a: 1})").getObject(*rt);
+  EXPECT_THROW(rt->setProperties(frozen, names, values, 2), JSError);
+}
+
+TEST_F(HermesRuntimeTest, BatchedArrayTest) {
+  Array arr =
+      eval("var arr = [1, 'two', , 4]; arr").getObject(*rt).getArray(*rt);
+  eval("Array.prototype[2] = 'inherited'");
+  Value out[4];
+  rt->getArrayValues(arr, 0, 4, out);
+  EXPECT_EQ(out[0].getNumber(), 1);
+  EXPECT_EQ(out[1].getString(*rt).utf8(*rt), "two");
+  EXPECT_EQ(out[2].getString(*rt).utf8(*rt), "inherited");
+  EXPECT_EQ(out[3].getNumber(), 4);
+  eval("delete Array.prototype[2]");
+
+  Value values[] = {Value(true), Value::null()};
+  rt->setArrayValues(arr, 1, values, 2);
+  EXPECT_EQ(
+      eval("JSON.stringify(arr)").getString(*rt).utf8(*rt), "[1,true,null,4]");
+
+  EXPECT_THROW(rt->getArrayValues(arr, 3, 2, out), JSError);
+  EXPECT_THROW(rt->setArrayValues(arr, 5, values, 0), JSError);
+  // Empty ranges at the end of the array are allowed.
+  rt->getArrayValues(arr, 4, 0, out);
+
+  Array nums = Array(*rt, 1000);
+  std::vector<double> in(1000);
+  for (size_t i = 0; i < in.size(); ++i)
+    in[i] = i * 0.5;
+  rt->setArrayNumbers(nums, 0, in.data(), in.size());
+  rt->global().setProperty(*rt, "nums", nums);
+  EXPECT_EQ(eval("nums[999]").getNumber(), 499.5);
+  std::vector<double> back(10);
+  rt->getArrayNumbers(nums, 990, 10, back.data());
+  for (size_t i = 0; i < back.size(); ++i)
+    EXPECT_EQ(back[i], in[990 + i]);
+
+  EXPECT_THROW(rt->getArrayNumbers(arr, 0, 2, back.data()), JSError);
+}
+
 class HermesRuntimeTestWithDisableGenerator : public HermesRuntimeTestBase {
  public:
   HermesRuntimeTestWithDisableGenerator()
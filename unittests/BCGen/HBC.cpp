@@ -140,9 +140,9 @@ TEST(HBCBytecodeGen, IntegrationTest) {
   SourceMapGenerator sourceMap;
   sourceMap.addSource("main.js");
   BM->populateSourceMap(&sourceMap);
-  const auto &mappings = sourceMap.getMappingsLines();
+  const auto &mappings = sourceMap.getMappingsLineSizes();
   EXPECT_EQ(mappings.size(), 1u);
-  EXPECT_EQ(mappings[0].size(), 2u);
+  EXPECT_EQ(mappings[0], 2u);
 }
 
 TEST(HBCBytecodeGen, StripDebugInfo) {
@@ -1269,4 +1269,42 @@ TEST(JSLexerTest, PrevTokenEndLocTest) {
   }
 }
 
+
+TEST(JSLexerTest, LongRunsTest) {
+  // Runs of whitespace, comment, string and identifier characters are
+  // skipped in blocks, so check every length around the block size.
+  JSLexer::Allocator alloc;
+  SourceErrorManager sm;
+  DiagContext diag(sm);
+
+  for (unsigned len = 1; len < 40; ++len) {
+    std::string run(len, 'a');
+    std::string src = std::string(len, ' ') + run + "\t" +
+        std::string(len, '\t') + "'" + run + "\\n" + run + "\"'" +
+        " /*" + run + "*" + run + "*/ \"" + run + "\u00e9\" //" + run +
+        "\n" + run + "_$0";
+
+    JSLexer lex(src, sm, alloc);
+    ASSERT_EQ(TokenKind::identifier, lex.advance()->getKind());
+    EXPECT_EQ(run, lex.getCurToken()->getIdentifier()->str());
+    EXPECT_EQ(src.data() + len, lex.getCurToken()->getStartLoc().getPointer());
+
+    ASSERT_EQ(TokenKind::string_literal, lex.advance()->getKind());
+    EXPECT_EQ(
+        run + "\n" + run + "\"",
+        lex.getCurToken()->getStringLiteral()->str());
+
+    ASSERT_EQ(TokenKind::string_literal, lex.advance()->getKind());
+    EXPECT_EQ(run + "\u00e9", lex.getCurToken()->getStringLiteral()->str());
+    EXPECT_FALSE(lex.isNewLineBeforeCurrentToken());
+
+    ASSERT_EQ(TokenKind::identifier, lex.advance()->getKind());
+    EXPECT_EQ(run + "_$0", lex.getCurToken()->getIdentifier()->str());
+    EXPECT_TRUE(lex.isNewLineBeforeCurrentToken());
+
+    ASSERT_EQ(TokenKind::eof, lex.advance()->getKind());
+  }
+  EXPECT_EQ(0, diag.getErrCount());
+}
+
 } // namespace
@@ -110,7 +110,7 @@ void verifySegment(
 
 TEST(SourceMap, Basic) {
   SourceMapGenerator map;
-  EXPECT_EQ(map.getMappingsLines().size(), 0u);
+  EXPECT_EQ(map.getMappingsLineSizes().size(), 0u);
 
   std::vector<std::string> sources{"file1", "file2"};
   for (const auto &source : sources) {
@@ -137,9 +137,9 @@ TEST(SourceMap, Basic) {
     map.addMappingsLine(segments, i++);
   }
 
-  ASSERT_EQ(map.getMappingsLines().size(), 2u);
-  EXPECT_EQ(map.getMappingsLines()[0].size(), 5u);
-  EXPECT_EQ(map.getMappingsLines()[1].size(), 4u);
+  ASSERT_EQ(map.getMappingsLineSizes().size(), 2u);
+  EXPECT_EQ(map.getMappingsLineSizes()[0], 5u);
+  EXPECT_EQ(map.getMappingsLineSizes()[1], 4u);
 
   std::vector<uint32_t> functionOffsets1 = {20, 23, 50, 789};
   std::vector<uint32_t> functionOffsets2 = {1, 255, 300, 500};
@@ -519,6 +519,132 @@ TEST(SourceMap, GenerateWithFbMetadata) {
       R"#("AAAA,CCAA;"})#");
 }
 
+/// Test that a streamed map is written as mappings are added, in pieces.
+TEST(SourceMap, StreamedOutput) {
+  SourceMapGenerator gen;
+  gen.addSource("file1");
+  gen.addSource("file2");
+
+  std::string storage;
+  llvh::raw_string_ostream OS(storage);
+  gen.streamTo(OS);
+
+  SourceMap::SegmentList line0 = {
+      loc(0, 0, 1, 1), loc(2, 0, 2, 1), loc(3, 0, 3, 1)};
+  SourceMap::SegmentList line0Rest = {loc(4), loc(5, 0, 3, 2)};
+  SourceMap::SegmentList line2 = {loc(0, 1, 6, 6), loc(1, 1, 7, 2)};
+  gen.startMappingsLine(0);
+  gen.addMappings(line0);
+  gen.addMappings(line0Rest);
+  OS.flush();
+  EXPECT_EQ(storage, R"#({"version":3,"mappings":"AAAC,EACA,CACA,C,CAAC)#");
+
+  gen.addMappingsLine(line2, 2);
+  gen.outputAsJSON(OS);
+  EXPECT_EQ(
+      OS.str(),
+      R"#({"version":3,"mappings":"AAAC,EACA,CACA,C,CAAC;;ACGI,CACJ;",)#"
+      R"#("sources":["file1","file2"]})#");
+  ASSERT_EQ(gen.getMappingsLineSizes().size(), 3u);
+  EXPECT_EQ(gen.getMappingsLineSizes()[0], 5u);
+  EXPECT_EQ(gen.getMappingsLineSizes()[1], 0u);
+  EXPECT_EQ(gen.getMappingsLineSizes()[2], 2u);
+}
+
+/// Test that an index map has a section per line, which parses back to the
+/// same mappings.
+TEST(SourceMap, IndexMap) {
+  SourceMapGenerator gen{SourceMapGenerator::Format::Index};
+  std::vector<std::string> sources{"file1", "file2"};
+  for (const auto &source : sources) {
+    gen.addSource(source);
+  }
+
+  SourceMap::SegmentList line0 = {loc(0, 0, 1, 1), loc(2, 0, 2, 1)};
+  SourceMap::SegmentList line2 = {loc(0, 1, 6, 6), loc(3, 1, 7, 3)};
+  gen.addMappingsLine(line0, 0);
+  gen.addMappingsLine(line2, 2);
+  gen.addFunctionOffsets({1, 2}, 0);
+
+  std::string storage;
+  llvh::raw_string_ostream OS(storage);
+  gen.outputAsJSON(OS);
+  EXPECT_EQ(
+      OS.str(),
+      R"#({"version":3,"sections":[)#"
+      R"#({"offset":{"line":0,"column":0},"map":{"version":3,)#"
+      R"#("mappings":"AAAC,EACA","sources":["file1","file2"]}},)#"
+      R"#({"offset":{"line":2,"column":0},"map":{"version":3,)#"
+      R"#("mappings":"ACKM,GACH","sources":["file1","file2"]}}],)#"
+      R"#("x_hermes_function_offsets":{"0":[1,2]}})#");
+
+  // Streaming gives the same output.
+  SourceMapGenerator streamedGen{SourceMapGenerator::Format::Index};
+  for (const auto &source : sources) {
+    streamedGen.addSource(source);
+  }
+  std::string streamed;
+  llvh::raw_string_ostream streamedOS(streamed);
+  streamedGen.streamTo(streamedOS);
+  streamedGen.addMappingsLine(line0, 0);
+  streamedGen.addMappingsLine(line2, 2);
+  streamedGen.addFunctionOffsets({1, 2}, 0);
+  streamedGen.outputAsJSON(streamedOS);
+  EXPECT_EQ(streamedOS.str(), storage);
+
+  SourceErrorManager sm;
+  SimpleDiagHandlerRAII diagHandler(sm);
+  std::unique_ptr<SourceMap> sourceMap = SourceMapParser::parse(storage, sm);
+  ASSERT_TRUE(sourceMap);
+  ASSERT_EQ(sourceMap->getLines().size(), 3u);
+  EXPECT_TRUE(sourceMap->getLines()[1].empty());
+  for (const auto &seg : line0) {
+    verifySegment(*sourceMap, /*generatedLine*/ 1, sources, seg);
+  }
+  for (const auto &seg : line2) {
+    verifySegment(*sourceMap, /*generatedLine*/ 3, sources, seg);
+  }
+}
+
+/// Test that the sections of an index map are placed at their offsets, with
+/// their sources merged.
+TEST(SourceMap, ParseIndexMap) {
+  SourceErrorManager sm;
+  SimpleDiagHandlerRAII diagHandler(sm);
+  std::unique_ptr<SourceMap> sourceMap = SourceMapParser::parse(
+      R"#({"version":3,"sections":[
+            {"offset":{"line":0,"column":0},
+             "map":{"version":3,"sources":["a.js"],"mappings":"AAAA"}},
+            {"offset":{"line":0,"column":10},
+             "map":{"version":3,"sourceRoot":"/r/",
+                    "sources":["b.js","a.js"],"mappings":"AAAA,CCCC"}}]})#",
+      sm);
+  ASSERT_TRUE(sourceMap);
+  EXPECT_EQ(
+      sourceMap->getAllFullPathSources(),
+      (std::vector<std::string>{"a.js", "/r/b.js", "/r/a.js"}));
+  ASSERT_EQ(sourceMap->getLines().size(), 1u);
+  ASSERT_EQ(sourceMap->getLines()[0].size(), 3u);
+
+  auto loc = sourceMap->getLocationForAddress(1, 11);
+  ASSERT_TRUE(loc.hasValue());
+  EXPECT_EQ(loc->fileName, "/r/b.js");
+  EXPECT_EQ(loc->line, 1u);
+  loc = sourceMap->getLocationForAddress(1, 12);
+  ASSERT_TRUE(loc.hasValue());
+  EXPECT_EQ(loc->fileName, "/r/a.js");
+  EXPECT_EQ(loc->line, 2u);
+  EXPECT_EQ(loc->column, 2u);
+
+  EXPECT_FALSE(SourceMapParser::parse(
+      R"#({"version":3,"sections":[
+            {"offset":{"line":2,"column":0},
+             "map":{"version":3,"sources":[],"mappings":";;"}},
+            {"offset":{"line":0,"column":0},
+             "map":{"version":3,"sources":[],"mappings":""}}]})#",
+      sm));
+}
+
 /// Test to make sure we can properly parse empty lines.
 TEST(SourceMap, EmptyLines) {
   SourceErrorManager sm;
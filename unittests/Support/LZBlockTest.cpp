@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "hermes/Support/LZBlock.h"
+
+#include "gtest/gtest.h"
+
+#include <random>
+#include <string>
+
+using namespace hermes;
+
+namespace {
+
+std::vector<uint8_t> roundTrip(llvh::ArrayRef<uint8_t> input) {
+  std::vector<uint8_t> compressed;
+  lzblock::compress(input, compressed);
+  std::vector<uint8_t> output(input.size());
+  EXPECT_TRUE(lzblock::decompress(compressed, output));
+  return output;
+}
+
+llvh::ArrayRef<uint8_t> bytes(const std::string &str) {
+  return {reinterpret_cast<const uint8_t *>(str.data()), str.size()};
+}
+
+TEST(LZBlockTest, Empty) {
+  std::vector<uint8_t> compressed;
+  lzblock::compress({}, compressed);
+  EXPECT_EQ(1u, compressed.size());
+  std::vector<uint8_t> output;
+  EXPECT_TRUE(lzblock::decompress(compressed, output));
+}
+
+TEST(LZBlockTest, ShortLiterals) {
+  for (const char *str : {"a", "ab", "abc", "abcd", "abcde"}) {
+    std::string s{str};
+    EXPECT_EQ(bytes(s).vec(), roundTrip(bytes(s)));
+  }
+}
+
+TEST(LZBlockTest, RepetitiveInputCompresses) {
+  std::string s;
+  for (int i = 0; i < 1000; ++i)
+    s += "function foo() { return bar; } ";
+  std::vector<uint8_t> compressed;
+  lzblock::compress(bytes(s), compressed);
+  EXPECT_LT(compressed.size(), s.size() / 10);
+  EXPECT_EQ(bytes(s).vec(), roundTrip(bytes(s)));
+}
+
+TEST(LZBlockTest, LongRunsAndLiterals) {
+  // Long runs exercise overlapping matches and length extension bytes.
+  std::string s(100000, 'x');
+  EXPECT_EQ(bytes(s).vec(), roundTrip(bytes(s)));
+
+  std::mt19937 rng(42);
+  std::vector<uint8_t> random(70000);
+  for (auto &b : random)
+    b = rng();
+  EXPECT_EQ(random, roundTrip(random));
+}
+
+TEST(LZBlockTest, RejectsMalformedInput) {
+  std::string s;
+  for (int i = 0; i < 100; ++i)
+    s += "hello world ";
+  std::vector<uint8_t> compressed;
+  lzblock::compress(bytes(s), compressed);
+
+  // Wrong output size.
+  std::vector<uint8_t> small(s.size() - 1);
+  EXPECT_FALSE(lzblock::decompress(compressed, small));
+  std::vector<uint8_t> large(s.size() + 1);
+  EXPECT_FALSE(lzblock::decompress(compressed, large));
+
+  // Truncated input.
+  std::vector<uint8_t> output(s.size());
+  EXPECT_FALSE(lzblock::decompress(
+      llvh::makeArrayRef(compressed).drop_back(), output));
+
+  // Back reference before the start of the output.
+  const uint8_t badOffset[] = {0x10, 'a', 0x05, 0x00, 0x00};
+  std::vector<uint8_t> out5(5);
+  EXPECT_FALSE(lzblock::decompress(badOffset, out5));
+}
+
+} // namespace
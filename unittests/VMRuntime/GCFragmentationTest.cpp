@@ -15,6 +15,7 @@
 #include "hermes/VM/GCCell.h"
 
 #include <deque>
+#include <vector>
 
 using namespace hermes::vm;
 
@@ -64,4 +65,45 @@ TEST(GCFragmentationTest, TestCoalescing) {
   }
 }
 
+#ifdef HERMESVM_GC_HADES
+TEST(GCFragmentationTest, TestCompactsMultipleSegments) {
+  // Leave several old generation segments mostly empty, and check that a full
+  // collection evacuates more than one of them.
+  static const size_t kNumSegments = 16;
+  static const size_t kNumFilledSegments = 6;
+  static const size_t kHeapSize = AlignedHeapSegment::maxSize() * kNumSegments;
+  static const GCConfig kGCConfig = TestGCConfigFixedSize(kHeapSize);
+
+  auto runtime = DummyRuntime::create(kGCConfig);
+  DummyRuntime &rt = *runtime;
+
+  using SixtyFourthCell = EmptyCell<AlignedHeapSegment::maxSize() / 64>;
+
+  GCScope scope(&rt);
+  // Only every eighth cell stays alive.
+  std::vector<Handle<SixtyFourthCell>> live;
+  for (size_t i = 0; i < 64 * kNumFilledSegments; i++) {
+    auto *cell = SixtyFourthCell::createLongLived(rt);
+    if (i % 8 == 0)
+      live.push_back(rt.makeHandle(cell));
+  }
+  const auto firstID = rt.getHeap().getObjectID(*live.front());
+  // Segments are selected by how full they were after the last sweep, so the
+  // first collection only finds out how sparse they are.
+  rt.collect();
+
+  GC::HeapInfo before;
+  rt.getHeap().getHeapInfo(before);
+  rt.collect();
+  GC::HeapInfo after;
+  rt.getHeap().getHeapInfo(after);
+
+  EXPECT_GE(after.numCompactedSegments, before.numCompactedSegments + 2);
+  EXPECT_LT(after.heapSize, before.heapSize);
+  EXPECT_LT(after.fragmentedBytes, before.fragmentedBytes);
+  // The surviving cells moved, but kept their identity.
+  EXPECT_EQ(firstID, rt.getHeap().getObjectID(*live.front()));
+}
+#endif
+
 } // namespace
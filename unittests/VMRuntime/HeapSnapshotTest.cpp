@@ -23,6 +23,7 @@
 #include "llvh/ADT/StringRef.h"
 #include "llvh/Support/raw_ostream.h"
 
+#include <algorithm>
 #include <chrono>
 #include <set>
 #include <sstream>
@@ -861,7 +862,6 @@ TEST_F(HeapSnapshotRuntimeTest, WeakMapTest) {
   Handle<JSWeakMap> map = runtime->makeHandle(std::move(*mapResult));
   Handle<JSObject> key = runtime->makeHandle(JSObject::create(runtime));
   Handle<JSObject> value = runtime->makeHandle(JSObject::create(runtime));
-  // Add a key so the DenseMap will exist.
   ASSERT_FALSE(isException(JSWeakMap::setValue(map, runtime, key, value)));
 
   JSONObject *root = TAKE_SNAPSHOT(runtime->getHeap(), jsonFactory);
@@ -880,8 +880,8 @@ TEST_F(HeapSnapshotRuntimeTest, WeakMapTest) {
           "WeakMap",
           mapID,
           map->getAllocatedSize(),
-          firstNamed + 3));
-  EXPECT_EQ(nodesAndEdges.second.size(), firstNamed + 3);
+          firstNamed + 2));
+  EXPECT_EQ(nodesAndEdges.second.size(), firstNamed + 2);
 
   // Test the weak edge.
   EXPECT_EQ(
@@ -890,19 +890,14 @@ TEST_F(HeapSnapshotRuntimeTest, WeakMapTest) {
           HeapSnapshot::EdgeType::Weak,
           "0",
           runtime->getHeap().getObjectID(key.get())));
-  // Test the native edge.
-  const auto nativeMapID = map->getMapID(&runtime->getHeap());
-  EXPECT_EQ(
-      nodesAndEdges.second[firstNamed + 2],
-      Edge(HeapSnapshot::EdgeType::Internal, "map", nativeMapID));
-  EXPECT_EQ(
-      FIND_NODE_FOR_ID(nativeMapID, nodes, strings),
-      Node(
-          HeapSnapshot::NodeType::Native,
-          "DenseMap",
-          nativeMapID,
-          map->getMallocSize(),
-          0));
+  // The entry is held by the table, which is an internal field.
+  EXPECT_TRUE(std::any_of(
+      nodesAndEdges.second.begin(),
+      nodesAndEdges.second.end(),
+      [](const Edge &edge) {
+        return edge.type == HeapSnapshot::EdgeType::Internal &&
+            edge.name == "table";
+      }));
 }
 
 TEST_F(HeapSnapshotRuntimeTest, PropertyUpdatesTest) {
@@ -449,6 +449,174 @@ TEST_F(HiddenClassTest, ForEachProperty) {
   EXPECT_EQ(expectedProperties, propertiesNoAlloc);
 }
 
+TEST_F(HiddenClassTest, CellDictionary) {
+  GCScope gcScope{runtime, "HiddenClassTest.CellDictionary", 48};
+
+  auto aHnd = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"a"));
+  auto bHnd = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"b"));
+  auto cHnd = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"c"));
+
+  MutableHandle<HiddenClass> x{
+      runtime,
+      vmcast<HiddenClass>(
+          runtime->ignoreAllocationFailure(HiddenClass::createRoot(runtime)))};
+  for (auto sym : {*aHnd, *bHnd}) {
+    auto addRes = HiddenClass::addProperty(
+        x, runtime, sym, PropertyFlags::defaultNewNamedPropertyFlags());
+    ASSERT_RETURNED(addRes);
+    x = *addRes->first;
+  }
+
+  x = *HiddenClass::copyToCellDictionary(x, runtime);
+  ASSERT_TRUE(x->isDictionary());
+  ASSERT_TRUE(x->isDictionaryCellMode());
+  ASSERT_TRUE(x->canCachePropertyWrites());
+
+  // Adding a property doesn't change existing slots, so the class is kept.
+  auto addRes = HiddenClass::addProperty(
+      x, runtime, *cHnd, PropertyFlags::defaultNewNamedPropertyFlags());
+  ASSERT_RETURNED(addRes);
+  ASSERT_EQ(*x, *addRes->first);
+
+  // Every deletion and update produces a new cacheable class.
+  NamedPropertyDescriptor desc;
+  for (auto sym : {*aHnd, *bHnd}) {
+    auto found = HiddenClass::findProperty(
+        x, runtime, sym, PropertyFlags::invalid(), desc);
+    ASSERT_TRUE(found);
+    auto x1 = HiddenClass::deleteProperty(x, runtime, *found);
+    ASSERT_NE(*x, *x1);
+    ASSERT_FALSE(x1->isDictionaryNoCache());
+    ASSERT_TRUE(x1->isDictionaryCellMode());
+    x = *x1;
+  }
+
+  auto found = HiddenClass::findProperty(
+      x, runtime, *cHnd, PropertyFlags::invalid(), desc);
+  ASSERT_TRUE(found);
+  desc.flags.accessor = true;
+  auto x2 = HiddenClass::updateProperty(x, runtime, *found, desc.flags);
+  ASSERT_NE(*x, *x2);
+  ASSERT_FALSE(x2->isDictionaryNoCache());
+
+  PropertyFlags clearFlags;
+  clearFlags.configurable = true;
+  auto x3 = HiddenClass::updatePropertyFlagsWithoutTransitions(
+      x2, runtime, clearFlags, PropertyFlags{}, llvh::None);
+  ASSERT_NE(*x2, *x3);
+  ASSERT_TRUE(x3->isDictionaryCellMode());
+}
+
+TEST_F(HiddenClassTest, DeleteLastProperty) {
+  GCScope gcScope{runtime, "HiddenClassTest.DeleteLastProperty", 48};
+
+  auto aHnd = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"a"));
+  auto bHnd = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"b"));
+
+  MutableHandle<HiddenClass> x{
+      runtime,
+      vmcast<HiddenClass>(
+          runtime->ignoreAllocationFailure(HiddenClass::createRoot(runtime)))};
+  MutableHandle<HiddenClass> xa{runtime};
+  for (auto sym : {*aHnd, *bHnd}) {
+    xa = *x;
+    auto addRes = HiddenClass::addProperty(
+        x, runtime, sym, PropertyFlags::defaultNewNamedPropertyFlags());
+    ASSERT_RETURNED(addRes);
+    x = *addRes->first;
+  }
+  Handle<HiddenClass> xab = x;
+
+  // Deleting the last added property returns to the parent class.
+  NamedPropertyDescriptor desc;
+  auto found = HiddenClass::findProperty(
+      xab, runtime, *bHnd, PropertyFlags::invalid(), desc);
+  ASSERT_TRUE(found);
+  auto x1 = HiddenClass::deleteProperty(xab, runtime, *found);
+  ASSERT_EQ(*xa, *x1);
+  ASSERT_FALSE(x1->isDictionary());
+
+  // Adding it again finds the existing class in the same slot.
+  auto addRes = HiddenClass::addProperty(
+      x1, runtime, *bHnd, PropertyFlags::defaultNewNamedPropertyFlags());
+  ASSERT_RETURNED(addRes);
+  ASSERT_EQ(*xab, *addRes->first);
+  ASSERT_EQ(1u, addRes->second);
+
+  // Deleting an earlier property still switches to dictionary mode.
+  found = HiddenClass::findProperty(
+      xab, runtime, *aHnd, PropertyFlags::invalid(), desc);
+  ASSERT_TRUE(found);
+  auto x2 = HiddenClass::deleteProperty(xab, runtime, *found);
+  ASSERT_TRUE(x2->isDictionary());
+}
+
+TEST_F(HiddenClassTest, ReshapeDictionary) {
+  GCScope gcScope{runtime, "HiddenClassTest.ReshapeDictionary", 48};
+
+  auto aHnd = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"a"));
+  auto bHnd = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"b"));
+  auto cHnd = *runtime->getIdentifierTable().getSymbolHandle(
+      runtime, createUTF16Ref(u"c"));
+
+  MutableHandle<HiddenClass> x{
+      runtime, runtime->getHiddenClassForPrototypeRaw(nullptr, 0)};
+  for (auto sym : {*aHnd, *bHnd, *cHnd}) {
+    auto addRes = HiddenClass::addProperty(
+        x, runtime, sym, PropertyFlags::defaultNewNamedPropertyFlags());
+    ASSERT_RETURNED(addRes);
+    x = *addRes->first;
+  }
+
+  // Delete x.a and x.b, then add x.a again, which makes x non-cacheable and
+  // gives x.a the slot that x.b had.
+  NamedPropertyDescriptor desc;
+  for (auto sym : {*aHnd, *bHnd}) {
+    auto found = HiddenClass::findProperty(
+        x, runtime, sym, PropertyFlags::invalid(), desc);
+    ASSERT_TRUE(found);
+    x = *HiddenClass::deleteProperty(x, runtime, *found);
+  }
+  auto addRes = HiddenClass::addProperty(
+      x, runtime, *aHnd, PropertyFlags::defaultNewNamedPropertyFlags());
+  ASSERT_RETURNED(addRes);
+  ASSERT_EQ(1u, addRes->second);
+  ASSERT_TRUE(x->isDictionaryNoCache());
+
+  // x is re-shaped once enough accesses were recorded.
+  unsigned threshold = runtime->getDictionaryReshapeThreshold();
+  ASSERT_NE(0u, threshold);
+  for (unsigned i = 1; i < threshold; ++i)
+    ASSERT_FALSE(x->recordNoCacheAccess(runtime));
+  ASSERT_TRUE(x->recordNoCacheAccess(runtime));
+  ASSERT_FALSE(x->recordNoCacheAccess(runtime));
+
+  llvh::SmallVector<SlotIndex, 4> oldSlots;
+  auto reshaped = HiddenClass::reshapeDictionary(x, runtime, oldSlots);
+  ASSERT_TRUE(reshaped);
+  ASSERT_FALSE(reshaped->isDictionary());
+  ASSERT_EQ(2u, reshaped->getNumProperties());
+  EXPECT_EQ((llvh::SmallVector<SlotIndex, 4>{2, 1}), oldSlots);
+
+  // The class is shared with objects that added the same properties.
+  Handle<HiddenClass> y =
+      runtime->getHiddenClassForPrototype(*runtime->getGlobal(), 0);
+  for (auto sym : {*cHnd, *aHnd}) {
+    auto addRes = HiddenClass::addProperty(
+        y, runtime, sym, PropertyFlags::defaultNewNamedPropertyFlags());
+    ASSERT_RETURNED(addRes);
+    y = addRes->first;
+  }
+  EXPECT_EQ(*reshaped, *y);
+}
+
 TEST_F(HiddenClassTest, ReservedSlots) {
   auto aHnd = *runtime->getIdentifierTable().getSymbolHandle(
       runtime, createUTF16Ref(u"a"));
@@ -867,13 +867,6 @@ foo();
           "col": 1,
           "children": []
         },
-        {
-          "name": "global",
-          "scriptName": "JavaScript",
-          "line": 2,
-          "col": 1,
-          "children": []
-        },
         {
           "name": "global",
           "scriptName": "JavaScript",